@@ -0,0 +1,629 @@
+/**
+ * @file benchmark.c
+ * @brief Reproducible performance benchmark for the spell checker
+ *
+ * Generates a synthetic dictionary and document at a configurable scale,
+ * then times each stage of the pipeline on its own:
+ *
+ * - load_dictionary()       dictionary file -> Trie
+ * - load_text_file()        document file -> tokens
+ * - trie_search()           one lookup per document token
+ * - generate_suggestions()  per-misspelling latency (p50 / p99)
+ * - spell_check_document()  end to end
+ *
+ * Results are printed and written as JSON so that runs can be compared
+ * between releases. The same seed and options always produce the same
+ * input files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "include/trie.h"
+#include "include/file_io.h"
+#include "include/spell_check.h"
+#include "include/edit_distance.h"
+#include "include/timing.h"
+
+#define BENCH_WORDS_PER_LINE 12
+
+/**
+ * Benchmark settings from the command line
+ */
+typedef struct BenchConfig {
+    int dictionary_words;       // Distinct words in the generated dictionary
+    int document_words;         // Words in the generated document
+    double error_rate;          // Probability that a document word gets a typo
+    double repetition;          // Zipf exponent of word choice (0 = uniform)
+    int suggestion_samples;     // Misspellings timed with generate_suggestions()
+    unsigned long seed;         // Random seed
+    int load_threads;           // Threads used to load the dictionary
+    bool compact;               // Freeze the dictionary before checking
+    SuggestionEngine engine;    // Suggestion engine under test
+    bool keep_files;            // Keep the generated input files
+    const char* workdir;        // Directory for the generated files
+    const char* output;         // JSON results file
+} BenchConfig;
+
+/**
+ * Timing of one stage
+ */
+typedef struct StageResult {
+    double seconds;             // Wall-clock duration
+    long items;                 // Words, lookups or suggestions processed
+} StageResult;
+
+/**
+ * Generated words and the state needed to sample them
+ */
+typedef struct Generator {
+    uint64_t state;             // xorshift64* state
+    char** words;               // Dictionary words, most frequent first
+    int word_count;
+    double* cumulative;         // Cumulative Zipf weights for sampling
+    uint64_t* fingerprints;     // Open-addressing set of word hashes
+    size_t fingerprint_mask;
+    char** typos;               // Misspellings planted in the document
+    int typo_count;
+    int typo_capacity;
+} Generator;
+
+/**
+ * Relative frequencies of 'a'..'z' in English text (per 1000 letters)
+ */
+static const int letter_weights[26] = {
+    82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24,
+    67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1
+};
+
+/**
+ * Relative frequencies of word lengths 2..14
+ */
+static const int length_weights[13] = { 6, 12, 16, 16, 14, 11, 9, 6, 4, 3, 1, 1, 1 };
+
+/**
+ * Next pseudo-random number (xorshift64*)
+ */
+static uint64_t next_random(Generator* gen) {
+    gen->state ^= gen->state >> 12;
+    gen->state ^= gen->state << 25;
+    gen->state ^= gen->state >> 27;
+    return gen->state * 2685821657736338717ULL;
+}
+
+/**
+ * Uniform double in [0, 1)
+ */
+static double random_unit(Generator* gen) {
+    return (double)(next_random(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Pick an index of a weight table
+ */
+static int random_weighted(Generator* gen, const int* weights, int count) {
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        total += weights[i];
+    }
+
+    int pick = (int)(next_random(gen) % (uint64_t)total);
+    for (int i = 0; i < count; i++) {
+        pick -= weights[i];
+        if (pick < 0) {
+            return i;
+        }
+    }
+    return count - 1;
+}
+
+/**
+ * Random lowercase letter with English frequencies
+ */
+static char random_letter(Generator* gen) {
+    return (char)('a' + random_weighted(gen, letter_weights, 26));
+}
+
+/**
+ * 64-bit FNV-1a hash of a word, never 0 (0 marks empty set slots)
+ */
+static uint64_t word_fingerprint(const char* word) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char* p = word; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 1099511628211ULL;
+    }
+    return hash ? hash : 1;
+}
+
+/**
+ * Look up a word in the fingerprint set, optionally adding it
+ * @return true if the word was already present
+ */
+static bool fingerprint_seen(Generator* gen, const char* word, bool add) {
+    uint64_t hash = word_fingerprint(word);
+    size_t slot = (size_t)hash & gen->fingerprint_mask;
+    while (gen->fingerprints[slot] != 0) {
+        if (gen->fingerprints[slot] == hash) {
+            return true;
+        }
+        slot = (slot + 1) & gen->fingerprint_mask;
+    }
+    if (add) {
+        gen->fingerprints[slot] = hash;
+    }
+    return false;
+}
+
+/**
+ * Generate the distinct dictionary words and the Zipf sampling table
+ */
+static bool generate_words(Generator* gen, const BenchConfig* config) {
+    size_t slots = 1024;
+    while (slots < (size_t)config->dictionary_words * 2) {
+        slots *= 2;
+    }
+    gen->fingerprints = (uint64_t*)calloc(slots, sizeof(uint64_t));
+    gen->fingerprint_mask = slots - 1;
+    gen->words = (char**)calloc((size_t)config->dictionary_words, sizeof(char*));
+    gen->cumulative = (double*)malloc((size_t)config->dictionary_words * sizeof(double));
+    if (!gen->fingerprints || !gen->words || !gen->cumulative) {
+        return false;
+    }
+
+    char word[16];
+    long attempts = 0;
+    while (gen->word_count < config->dictionary_words) {
+        // Short words run out quickly; give up instead of looping forever
+        if (++attempts > (long)config->dictionary_words * 50) {
+            fprintf(stderr, "Error: Cannot generate %d distinct words\n", config->dictionary_words);
+            return false;
+        }
+
+        // No letter more than three times in a row: load_dictionary() rejects those
+        int length = 2 + random_weighted(gen, length_weights, 13);
+        for (int i = 0; i < length; i++) {
+            do {
+                word[i] = random_letter(gen);
+            } while (i >= 3 && word[i] == word[i - 1] && word[i] == word[i - 2] && word[i] == word[i - 3]);
+        }
+        word[length] = '\0';
+        if (fingerprint_seen(gen, word, true)) {
+            continue;
+        }
+
+        gen->words[gen->word_count] = (char*)malloc((size_t)length + 1);
+        if (!gen->words[gen->word_count]) {
+            return false;
+        }
+        memcpy(gen->words[gen->word_count], word, (size_t)length + 1);
+        gen->word_count++;
+    }
+
+    // Word i is drawn with weight 1 / (i + 1)^repetition
+    double total = 0.0;
+    for (int i = 0; i < gen->word_count; i++) {
+        total += 1.0 / pow((double)(i + 1), config->repetition);
+        gen->cumulative[i] = total;
+    }
+    return true;
+}
+
+/**
+ * Draw a dictionary word index from the Zipf distribution
+ */
+static int sample_word(Generator* gen) {
+    double target = random_unit(gen) * gen->cumulative[gen->word_count - 1];
+    int low = 0;
+    int high = gen->word_count - 1;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (gen->cumulative[middle] <= target) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * Apply one random typo (substitution, deletion, insertion, transposition)
+ */
+static void make_typo(Generator* gen, const char* word, char* typo) {
+    size_t length = strlen(word);
+    size_t at = (size_t)(next_random(gen) % length);
+    int operation = (int)(next_random(gen) % 4);
+    if (length < 3 && operation == 1) {
+        operation = 2;                  // Keep at least two letters
+    }
+
+    memcpy(typo, word, length + 1);
+    switch (operation) {
+        case 0:
+            typo[at] = (char)('a' + (typo[at] - 'a' + 1 + (int)(next_random(gen) % 25)) % 26);
+            break;
+        case 1:
+            memmove(typo + at, typo + at + 1, length - at);
+            break;
+        case 2:
+            memmove(typo + at + 1, typo + at, length - at + 1);
+            typo[at] = random_letter(gen);
+            break;
+        default:
+            if (at + 1 == length) {
+                at--;
+            }
+            typo[at] = word[at + 1];
+            typo[at + 1] = word[at];
+            break;
+    }
+}
+
+/**
+ * Remember a planted misspelling for the suggestion latency stage
+ */
+static bool record_typo(Generator* gen, const char* typo, int limit) {
+    if (gen->typo_count >= limit) {
+        return true;
+    }
+    if (gen->typo_count == gen->typo_capacity) {
+        int capacity = gen->typo_capacity ? gen->typo_capacity * 2 : 256;
+        char** typos = (char**)realloc(gen->typos, (size_t)capacity * sizeof(char*));
+        if (!typos) {
+            return false;
+        }
+        gen->typos = typos;
+        gen->typo_capacity = capacity;
+    }
+
+    size_t length = strlen(typo) + 1;
+    gen->typos[gen->typo_count] = (char*)malloc(length);
+    if (!gen->typos[gen->typo_count]) {
+        return false;
+    }
+    memcpy(gen->typos[gen->typo_count++], typo, length);
+    return true;
+}
+
+/**
+ * Write the dictionary file with a frequency column (Zipf counts)
+ */
+static bool write_dictionary(const Generator* gen, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot create '%s'\n", path);
+        return false;
+    }
+
+    for (int i = 0; i < gen->word_count; i++) {
+        long count = (long)(10000000.0 / (double)(i + 1)) + 1;
+        fprintf(file, "%s %ld\n", gen->words[i], count);
+    }
+    return fclose(file) == 0;
+}
+
+/**
+ * Write the document, planting typos at the configured rate
+ */
+static bool write_document(Generator* gen, const BenchConfig* config, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot create '%s'\n", path);
+        return false;
+    }
+
+    char typo[32];
+    bool ok = true;
+    for (int i = 0; ok && i < config->document_words; i++) {
+        const char* word = gen->words[sample_word(gen)];
+        if (random_unit(gen) < config->error_rate) {
+            make_typo(gen, word, typo);
+            if (!fingerprint_seen(gen, typo, false)) {
+                ok = record_typo(gen, typo, config->suggestion_samples);
+            }
+            word = typo;
+        }
+
+        bool end_of_line = (i + 1) % BENCH_WORDS_PER_LINE == 0 || i + 1 == config->document_words;
+        fputs(word, file);
+        fputs(end_of_line ? ".\n" : " ", file);
+    }
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ * Free all generator state
+ */
+static void free_generator(Generator* gen) {
+    for (int i = 0; i < gen->word_count; i++) {
+        free(gen->words[i]);
+    }
+    for (int i = 0; i < gen->typo_count; i++) {
+        free(gen->typos[i]);
+    }
+    free(gen->words);
+    free(gen->typos);
+    free(gen->cumulative);
+    free(gen->fingerprints);
+    memset(gen, 0, sizeof(Generator));
+}
+
+/**
+ * Items per second of a stage, 0 when it took no measurable time
+ */
+static double per_second(const StageResult* stage) {
+    return stage->seconds > 0.0 ? (double)stage->items / stage->seconds : 0.0;
+}
+
+/**
+ * Print usage information
+ */
+static void print_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("Options:\n");
+    printf("  --words N        Distinct dictionary words (default 100000)\n");
+    printf("  --doc-words N    Words in the generated document (default 200000)\n");
+    printf("  --error-rate R   Fraction of document words with a typo (default 0.05)\n");
+    printf("  --repetition S   Zipf exponent of word choice, 0 = uniform (default 1.0)\n");
+    printf("  --samples N      Misspellings timed for suggestion latency (default 2000)\n");
+    printf("  --seed N         Random seed (default 42)\n");
+    printf("  --load-threads N Load the dictionary with N threads (default 1)\n");
+    printf("  --compact        Freeze the dictionary before checking\n");
+    printf("  --engine NAME    Suggestion engine: trie (default), symspell or scan\n");
+    printf("  --workdir DIR    Directory for the generated files (default .)\n");
+    printf("  --keep           Keep the generated dictionary and document\n");
+    printf("  --output FILE    JSON results file (default bench_results.json)\n");
+}
+
+/**
+ * Parse command line options
+ * @return false on invalid options
+ */
+static bool parse_options(int argc, char* argv[], BenchConfig* config) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--words") == 0 && has_value) {
+            config->dictionary_words = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--doc-words") == 0 && has_value) {
+            config->document_words = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--error-rate") == 0 && has_value) {
+            config->error_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--repetition") == 0 && has_value) {
+            config->repetition = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--samples") == 0 && has_value) {
+            config->suggestion_samples = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            config->seed = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--load-threads") == 0 && has_value) {
+            config->load_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            config->compact = true;
+        } else if (strcmp(argv[i], "--engine") == 0 && has_value) {
+            const char* name = argv[++i];
+            if (strcmp(name, "trie") == 0) {
+                config->engine = SUGGESTION_ENGINE_TRIE;
+            } else if (strcmp(name, "symspell") == 0) {
+                config->engine = SUGGESTION_ENGINE_SYMSPELL;
+            } else if (strcmp(name, "scan") == 0) {
+                config->engine = SUGGESTION_ENGINE_SCAN;
+            } else {
+                fprintf(stderr, "Error: Unknown suggestion engine '%s' (use trie, symspell or scan)\n", name);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--workdir") == 0 && has_value) {
+            config->workdir = argv[++i];
+        } else if (strcmp(argv[i], "--keep") == 0) {
+            config->keep_files = true;
+        } else if (strcmp(argv[i], "--output") == 0 && has_value) {
+            config->output = argv[++i];
+        } else {
+            fprintf(stderr, "Error: Unknown option '%s'\n\n", argv[i]);
+            return false;
+        }
+    }
+
+    if (config->dictionary_words < 1 || config->document_words < 1 || config->suggestion_samples < 0 || config->load_threads < 1 ||
+        config->error_rate < 0.0 || config->error_rate > 1.0 || config->repetition < 0.0) {
+        fprintf(stderr, "Error: Invalid benchmark size, thread count, error rate or repetition\n\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char* argv[]) {
+    BenchConfig config = { 100000, 200000, 0.05, 1.0, 2000, 42, 1, false, SUGGESTION_ENGINE_TRIE, false, ".", "bench_results.json" };
+    if (argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
+        print_usage(argv[0]);
+        return 0;
+    }
+    if (!parse_options(argc, argv, &config)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    char dictionary_path[1024];
+    char document_path[1024];
+    snprintf(dictionary_path, sizeof(dictionary_path), "%s/bench_dictionary.txt", config.workdir);
+    snprintf(document_path, sizeof(document_path), "%s/bench_document.txt", config.workdir);
+
+    // Generate the inputs (not timed)
+    printf("Generating %d dictionary words and a %d word document (seed %lu)...\n",
+           config.dictionary_words, config.document_words, config.seed);
+    Generator gen;
+    memset(&gen, 0, sizeof(Generator));
+    gen.state = config.seed * 2654435761UL + 0x9E3779B97F4A7C15ULL;
+    bool generated = generate_words(&gen, &config) &&
+                     write_dictionary(&gen, dictionary_path) &&
+                     write_document(&gen, &config, document_path);
+    if (!generated) {
+        fprintf(stderr, "Error: Failed to generate benchmark inputs\n");
+        free_generator(&gen);
+        return 1;
+    }
+
+    StageResult load_dict = { 0.0, 0 }, freeze = { 0.0, 0 }, index = { 0.0, 0 };
+    StageResult load_text = { 0.0, 0 }, search = { 0.0, 0 }, suggest = { 0.0, 0 }, check = { 0.0, 0 };
+
+    // Stage: load_dictionary
+    Trie* dictionary = trie_create();
+    double start = timing_now_seconds();
+    bool loaded = dictionary && load_dictionary_parallel(dictionary_path, dictionary, config.load_threads);
+    load_dict.seconds = timing_now_seconds() - start;
+    if (!loaded) {
+        fprintf(stderr, "Error: Failed to load the generated dictionary\n");
+        trie_destroy(dictionary);
+        free_generator(&gen);
+        return 1;
+    }
+    load_dict.items = dictionary->total_words;
+
+    if (config.compact) {
+        start = timing_now_seconds();
+        trie_freeze(dictionary);
+        freeze.seconds = timing_now_seconds() - start;
+        freeze.items = dictionary->total_words;
+    }
+    if (config.engine != SUGGESTION_ENGINE_TRIE) {
+        start = timing_now_seconds();
+        set_suggestion_engine(config.engine, dictionary);
+        index.seconds = timing_now_seconds() - start;
+        index.items = dictionary->total_words;
+    }
+
+    // Stage: load_text_file
+    start = timing_now_seconds();
+    TextDocument* document = load_text_file(document_path);
+    load_text.seconds = timing_now_seconds() - start;
+    if (!document) {
+        fprintf(stderr, "Error: Failed to load the generated document\n");
+        set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+        trie_destroy(dictionary);
+        free_generator(&gen);
+        return 1;
+    }
+    load_text.items = document->total_words;
+
+    // Stage: trie_search, one lookup per token
+    long found = 0;
+    start = timing_now_seconds();
+    for (int i = 0; i < document->token_count; i++) {
+        found += trie_search(dictionary, document->tokens[i].word);
+    }
+    search.seconds = timing_now_seconds() - start;
+    search.items = document->token_count;
+
+    // Stage: generate_suggestions, timed per misspelling
+    double* latencies = (double*)malloc(((size_t)gen.typo_count + 1) * sizeof(double));
+    long suggestions_returned = 0;
+    for (int i = 0; latencies && i < gen.typo_count; i++) {
+        int count = 0;
+        double call_start = timing_now_seconds();
+        char** suggestions = generate_suggestions(gen.typos[i], dictionary, &count);
+        latencies[i] = (timing_now_seconds() - call_start) * 1e6;
+        suggest.seconds += latencies[i] / 1e6;
+
+        for (int j = 0; j < count; j++) {
+            free(suggestions[j]);
+        }
+        free(suggestions);
+        suggestions_returned += count;
+    }
+    suggest.items = latencies ? gen.typo_count : 0;
+    double p50 = timing_percentile(latencies, (size_t)suggest.items, 50.0);
+    double p99 = timing_percentile(latencies, (size_t)suggest.items, 99.0);
+    double max_latency = suggest.items > 0 ? latencies[suggest.items - 1] : 0.0;
+
+    // Stage: spell_check_document, end to end
+    start = timing_now_seconds();
+    SpellCheckResult* result = spell_check_document(document, dictionary);
+    check.seconds = timing_now_seconds() - start;
+    check.items = result ? result->total_words_checked : 0;
+    int errors_found = result ? result->error_count : 0;
+
+    size_t peak_rss = timing_peak_rss_bytes();
+
+    // Report
+    static const char* const engine_names[] = { "trie", "symspell", "scan" };
+    const char* index_stage = (config.engine == SUGGESTION_ENGINE_SYMSPELL) ? "build_symspell_index"
+                                                                            : "build_scan_index";
+    printf("\n=== BENCHMARK RESULTS ===\n");
+    printf("Edit distance kernel: %s\n", edit_distance_kernel_name());
+    printf("%-22s %10s %14s\n", "Stage", "Seconds", "Items/s");
+    printf("%-22s %10.4f %14.0f\n", "load_dictionary", load_dict.seconds, per_second(&load_dict));
+    if (config.compact) {
+        printf("%-22s %10.4f %14.0f\n", "trie_freeze", freeze.seconds, per_second(&freeze));
+    }
+    if (config.engine != SUGGESTION_ENGINE_TRIE) {
+        printf("%-22s %10.4f %14.0f\n", index_stage, index.seconds, per_second(&index));
+    }
+    printf("%-22s %10.4f %14.0f\n", "load_text_file", load_text.seconds, per_second(&load_text));
+    printf("%-22s %10.4f %14.0f\n", "trie_search", search.seconds, per_second(&search));
+    printf("%-22s %10.4f %14.0f\n", "generate_suggestions", suggest.seconds, per_second(&suggest));
+    printf("%-22s %10.4f %14.0f\n", "spell_check_document", check.seconds, per_second(&check));
+    printf("Suggestion latency: p50 %.1f us, p99 %.1f us, max %.1f us (%ld misspellings)\n",
+           p50, p99, max_latency, suggest.items);
+    printf("Errors found: %d of %ld words\n", errors_found, check.items);
+    printf("Peak RSS: %zu bytes\n", peak_rss);
+
+    FILE* json = fopen(config.output, "w");
+    bool written = json != NULL;
+    if (written) {
+        fprintf(json, "{\n");
+        fprintf(json, "  \"config\": {\"dictionary_words\": %d, \"document_words\": %d, \"error_rate\": %g, "
+                      "\"repetition\": %g, \"suggestion_samples\": %d, \"seed\": %lu, \"load_threads\": %d, \"compact\": %s, "
+                      "\"engine\": \"%s\", \"kernel\": \"%s\"},\n",
+                config.dictionary_words, config.document_words, config.error_rate, config.repetition,
+                config.suggestion_samples, config.seed, config.load_threads, config.compact ? "true" : "false",
+                engine_names[config.engine], edit_distance_kernel_name());
+        fprintf(json, "  \"stages\": {\n");
+        fprintf(json, "    \"load_dictionary\": {\"seconds\": %.6f, \"words\": %ld, \"words_per_second\": %.0f},\n",
+                load_dict.seconds, load_dict.items, per_second(&load_dict));
+        if (config.compact) {
+            fprintf(json, "    \"trie_freeze\": {\"seconds\": %.6f, \"words\": %ld, \"words_per_second\": %.0f},\n",
+                    freeze.seconds, freeze.items, per_second(&freeze));
+        }
+        if (config.engine != SUGGESTION_ENGINE_TRIE) {
+            fprintf(json, "    \"%s\": {\"seconds\": %.6f, \"words\": %ld, \"words_per_second\": %.0f},\n",
+                    index_stage, index.seconds, index.items, per_second(&index));
+        }
+        fprintf(json, "    \"load_text_file\": {\"seconds\": %.6f, \"words\": %ld, \"words_per_second\": %.0f},\n",
+                load_text.seconds, load_text.items, per_second(&load_text));
+        fprintf(json, "    \"trie_search\": {\"seconds\": %.6f, \"lookups\": %ld, \"found\": %ld, "
+                      "\"lookups_per_second\": %.0f},\n",
+                search.seconds, search.items, found, per_second(&search));
+        fprintf(json, "    \"generate_suggestions\": {\"seconds\": %.6f, \"misspellings\": %ld, "
+                      "\"suggestions\": %ld, \"per_second\": %.0f, \"p50_us\": %.2f, \"p99_us\": %.2f, "
+                      "\"max_us\": %.2f},\n",
+                suggest.seconds, suggest.items, suggestions_returned, per_second(&suggest), p50, p99, max_latency);
+        fprintf(json, "    \"spell_check_document\": {\"seconds\": %.6f, \"words\": %ld, \"errors\": %d, "
+                      "\"words_per_second\": %.0f}\n",
+                check.seconds, check.items, errors_found, per_second(&check));
+        fprintf(json, "  },\n");
+        fprintf(json, "  \"peak_rss_bytes\": %zu\n", peak_rss);
+        fprintf(json, "}\n");
+        written = fclose(json) == 0;
+        printf("Results written to %s\n", config.output);
+    } else {
+        fprintf(stderr, "Warning: Cannot write results to '%s'\n", config.output);
+    }
+
+    // Cleanup
+    free(latencies);
+    free_spell_check_result(result);
+    free_text_document(document);
+    set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+    trie_destroy(dictionary);
+    free_generator(&gen);
+    if (!config.keep_files) {
+        remove(dictionary_path);
+        remove(document_path);
+    }
+
+    return written ? 0 : 1;
+}
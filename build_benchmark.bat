@@ -0,0 +1,77 @@
+@echo off
+echo Building Spell Checker Benchmark...
+
+REM Benchmarks need optimized objects; keep them apart from the debug build
+if not exist obj\bench mkdir obj\bench
+
+set CFLAGS=-Wall -Wextra -std=c99 -O2 -g -Iinclude
+
+REM Compile source files
+echo Compiling source files...
+gcc %CFLAGS% -c benchmark.c -o obj/bench/benchmark.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/spell_check.c -o obj/bench/spell_check.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/api_client.c -o obj/bench/api_client.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/api_cache.c -o obj/bench/api_cache.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/trie.c -o obj/bench/trie.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/compact_trie.c -o obj/bench/compact_trie.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/dawg.c -o obj/bench/dawg.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/word_set.c -o obj/bench/word_set.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/utf8.c -o obj/bench/utf8.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/symspell.c -o obj/bench/symspell.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/length_index.c -o obj/bench/length_index.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/memory_budget.c -o obj/bench/memory_budget.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/ngram_model.c -o obj/bench/ngram_model.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/file_io.c -o obj/bench/file_io.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/edit_distance.c -o obj/bench/edit_distance.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/timing.c -o obj/bench/timing.o
+if errorlevel 1 goto error
+
+gcc %CFLAGS% -c src/profile.c -o obj/bench/profile.o
+if errorlevel 1 goto error
+
+REM Link executable
+echo Linking executable...
+gcc obj/bench/benchmark.o obj/bench/spell_check.o obj/bench/api_client.o obj/bench/api_cache.o obj/bench/trie.o obj/bench/compact_trie.o obj/bench/dawg.o obj/bench/word_set.o obj/bench/symspell.o obj/bench/length_index.o obj/bench/memory_budget.o obj/bench/ngram_model.o obj/bench/file_io.o obj/bench/utf8.o obj/bench/edit_distance.o obj/bench/timing.o obj/bench/profile.o -o benchmark.exe -lcurl -lcjson -lpthread -lpsapi
+if errorlevel 1 goto error
+
+echo Build successful! Executable: benchmark.exe
+echo.
+echo Usage: benchmark.exe [--words N] [--doc-words N] [--error-rate R] [--repetition S] [--output FILE]
+echo        benchmark.exe --help
+goto end
+
+:error
+echo Benchmark build failed!
+exit /b 1
+
+:end
@@ -7,7 +7,10 @@ if errorlevel 1 goto error
 gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/api_client.c -o obj/api_client.o
 if errorlevel 1 goto error
 
-gcc obj/test_api.o obj/api_client.o -o test_api.exe -lcurl -lcjson
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/api_cache.c -o obj/api_cache.o
+if errorlevel 1 goto error
+
+gcc obj/test_api.o obj/api_client.o obj/api_cache.o -o test_api.exe -lcurl -lcjson -lpthread
 if errorlevel 1 goto error
 
 echo Build successful! Executable: test_api.exe
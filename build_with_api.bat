@@ -15,18 +15,60 @@ if errorlevel 1 goto error
 gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/api_client.c -o obj/api_client.o
 if errorlevel 1 goto error
 
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/api_cache.c -o obj/api_cache.o
+if errorlevel 1 goto error
+
 gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/trie.c -o obj/trie.o
 if errorlevel 1 goto error
 
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/compact_trie.c -o obj/compact_trie.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/dawg.c -o obj/dawg.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/word_set.c -o obj/word_set.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/utf8.c -o obj/utf8.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/symspell.c -o obj/symspell.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/length_index.c -o obj/length_index.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/dictionary_handle.c -o obj/dictionary_handle.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/server.c -o obj/server.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/output_writer.c -o obj/output_writer.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/memory_budget.c -o obj/memory_budget.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/ngram_model.c -o obj/ngram_model.o
+if errorlevel 1 goto error
+
 gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/file_io.c -o obj/file_io.o
 if errorlevel 1 goto error
 
 gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/edit_distance.c -o obj/edit_distance.o
 if errorlevel 1 goto error
 
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/timing.c -o obj/timing.o
+if errorlevel 1 goto error
+
+gcc -Wall -Wextra -std=c99 -g -Iinclude -c src/profile.c -o obj/profile.o
+if errorlevel 1 goto error
+
 REM Link executable with libcurl and cJSON
 echo Linking executable...
-gcc obj/main.o obj/spell_check.o obj/api_client.o obj/trie.o obj/file_io.o obj/edit_distance.o -o spell_checker_api.exe -lcurl -lcjson
+gcc obj/main.o obj/spell_check.o obj/api_client.o obj/api_cache.o obj/trie.o obj/compact_trie.o obj/dawg.o obj/word_set.o obj/symspell.o obj/length_index.o obj/memory_budget.o obj/ngram_model.o obj/dictionary_handle.o obj/server.o obj/output_writer.o obj/file_io.o obj/utf8.o obj/edit_distance.o obj/timing.o obj/profile.o -o spell_checker_api.exe -lcurl -lcjson -lpthread -lws2_32 -lpsapi
 if errorlevel 1 goto error
 
 echo Build successful! Executable: spell_checker_api.exe
@@ -0,0 +1,134 @@
+#ifndef API_CACHE_H
+#define API_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * @file api_cache.h
+ * @brief Result cache for Merriam-Webster API lookups
+ *
+ * Remembers whether the API knew a word so that the same unknown token does
+ * not cost a network round trip in every document and every run. Both
+ * positive ("word exists") and negative ("word not found") answers are
+ * cached, each with its own time-to-live; failed requests are never cached.
+ *
+ * The cache has two layers:
+ * - An in-memory LRU of bounded size (hash table plus recency list), used
+ *   for every lookup.
+ * - An optional append-only log on disk. Every stored result is appended
+ *   as one text line, and the log is replayed into the LRU when the cache
+ *   is opened, so answers survive across runs. Records that have expired
+ *   or have been superseded are dropped by compacting the log on open.
+ *
+ * Log Format (one record per line, later records win):
+ * @code
+ * <unix_time> <0|1> <word>
+ * @endcode
+ *
+ * All functions are thread-safe; a single mutex guards the cache.
+ *
+ * Usage Example:
+ * @code
+ * APICache* cache = api_cache_open("api_cache.log", API_CACHE_DEFAULT_CAPACITY);
+ * bool found;
+ * if (!api_cache_lookup(cache, "serendipity", &found)) {
+ *     found = ask_the_network("serendipity");
+ *     api_cache_store(cache, "serendipity", found);
+ * }
+ * api_cache_close(cache);
+ * @endcode
+ */
+
+/**
+ * @brief Default number of words kept in memory
+ */
+#define API_CACHE_DEFAULT_CAPACITY 10000
+
+/**
+ * @brief Default lifetime of cached answers in seconds
+ *
+ * Dictionaries rarely drop words, so positive answers live much longer
+ * than negative ones, which may change as the dictionary grows.
+ */
+#define API_CACHE_POSITIVE_TTL (30L * 24 * 60 * 60)
+#define API_CACHE_NEGATIVE_TTL (7L * 24 * 60 * 60)
+
+/**
+ * @brief Longest word the cache stores; longer words are never cached
+ */
+#define API_CACHE_MAX_WORD_LENGTH 64
+
+/**
+ * @brief Opaque cache handle
+ */
+typedef struct APICache APICache;
+
+/**
+ * @brief Create a cache, optionally backed by a log file
+ *
+ * When log_file is given, existing records are replayed into memory
+ * (expired ones are skipped, malformed lines such as a truncated last
+ * record are ignored) and new results are appended to it. A missing file
+ * is created on the first store.
+ *
+ * @param log_file Path of the persistent log, or NULL for a memory-only cache
+ * @param capacity Maximum number of words kept in memory (> 0)
+ * @return New cache, or NULL on error (invalid capacity, allocation failure,
+ *         log file cannot be opened for appending)
+ *
+ * @post Caller must call api_cache_close() on the returned pointer
+ *
+ * Time Complexity: O(R) where R is the number of records in the log
+ * Space Complexity: O(capacity)
+ */
+APICache* api_cache_open(const char* log_file, int capacity);
+
+/**
+ * @brief Look up a cached answer
+ *
+ * A hit marks the word as most recently used. Expired entries are removed
+ * and reported as misses.
+ *
+ * @param cache Cache handle (can be NULL, which always misses)
+ * @param word Normalized word to look up
+ * @param found Receives the cached answer on a hit
+ * @return true on a hit, false on a miss
+ *
+ * Time Complexity: O(1) expected
+ */
+bool api_cache_lookup(APICache* cache, const char* word, bool* found);
+
+/**
+ * @brief Store an answer in memory and append it to the log
+ *
+ * Inserting into a full cache evicts the least recently used word from
+ * memory; its record stays in the log.
+ *
+ * @param cache Cache handle (can be NULL, which is a no-op)
+ * @param word Normalized word
+ * @param found Whether the API knows the word
+ *
+ * Time Complexity: O(1) expected
+ */
+void api_cache_store(APICache* cache, const char* word, bool found);
+
+/**
+ * @brief Get the number of words currently held in memory
+ *
+ * @param cache Cache handle
+ * @return Number of cached words, or 0 if cache is NULL
+ */
+int api_cache_size(APICache* cache);
+
+/**
+ * @brief Close the log and free the cache
+ *
+ * @param cache Cache handle (can be NULL)
+ *
+ * @note Safe to call with NULL pointer (no-op)
+ */
+void api_cache_close(APICache* cache);
+
+#endif // API_CACHE_H
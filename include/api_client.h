@@ -11,6 +11,15 @@
  * This module provides integration with the Merriam-Webster Dictionary API
  * to validate words that are not found in the local Trie dictionary.
  * Uses libcurl for HTTP requests and cJSON for JSON parsing.
+ *
+ * Lookups may be issued from several threads at once (for example by
+ * spell_check_document_parallel()); the shared statistics are protected
+ * by a mutex. api_client_init() and api_client_cleanup() must not run
+ * concurrently with lookups.
+ *
+ * Answers are cached (see api_cache.h): every initialized client keeps an
+ * in-memory LRU, and api_client_set_cache_file() persists answers across
+ * runs. Only network requests count towards total_requests.
  */
 
 /**
@@ -35,6 +44,8 @@ typedef struct {
     int words_not_found;       // Words not found in API
     long total_response_time;  // Total response time in ms
     double avg_response_time;  // Average response time in ms
+    int cache_hits;            // Lookups answered by the result cache
+    int cache_misses;          // Lookups that had to go to the network
 } APIStats;
 
 /**
@@ -45,11 +56,24 @@ typedef struct {
  */
 bool api_client_init(const char* api_key);
 
+/**
+ * @brief Persist API answers in a cache log file
+ * 
+ * Replaces the in-memory cache with one backed by the given append-only
+ * log, loading the answers stored by previous runs.
+ * 
+ * @param cache_file Path of the cache log (created if missing)
+ * @return true on success, false if the client is not initialized or the
+ *         log cannot be opened (the previous cache is kept)
+ */
+bool api_client_set_cache_file(const char* cache_file);
+
 /**
  * @brief Fetch word validation from Merriam-Webster API
  * 
- * Makes an HTTP GET request to the Merriam-Webster Dictionary API
- * to check if a word exists and retrieve its definition.
+ * Answers from the result cache when possible. Otherwise makes an HTTP GET
+ * request to the Merriam-Webster Dictionary API to check if a word exists,
+ * and caches the answer unless the request failed.
  * 
  * @param word The word to look up (must not be NULL)
  * @return 1 if word exists in dictionary, 0 if not found, -1 on error
@@ -59,11 +83,50 @@ bool api_client_init(const char* api_key);
  */
 int fetch_from_api(const char* word);
 
+/**
+ * @brief Validate many words with concurrent requests
+ * 
+ * Answers cached words immediately and fetches the rest through the
+ * curl multi interface, keeping up to the configured number of requests in
+ * flight. Transfer handles are reused so connections to the API host stay
+ * alive between words; a batch of unknown words therefore costs a few round
+ * trips instead of one per word. The call returns once every word has an
+ * answer (or has failed), and every answer is cached.
+ * 
+ * @param words Words to look up (duplicates are fetched more than once; pass unique words)
+ * @param count Number of words
+ * @param results Receives, per word, 1 if it exists, 0 if not found, -1 on error
+ * @return Number of words answered (results not -1), or -1 on invalid parameters
+ *         or when the client is not initialized
+ * 
+ * @note This function is thread-safe
+ * @see api_client_set_batch_limits()
+ */
+int fetch_batch_from_api(const char* const* words, int count, int* results);
+
+/**
+ * @brief Configure concurrency and rate limit of batch lookups
+ * 
+ * @param max_concurrent Maximum requests in flight at once (clamped to 1..64, default 8)
+ * @param max_requests_per_second Maximum requests started per second (0 = unlimited, the default)
+ * 
+ * @note Call before checking; not synchronized with running batches
+ */
+void api_client_set_batch_limits(int max_concurrent, int max_requests_per_second);
+
+/**
+ * @brief Suppress the per-word status lines printed for each lookup
+ * 
+ * @param quiet true to print nothing for words found or not found; request failures still go to stderr
+ */
+void api_client_set_quiet(bool quiet);
+
 /**
  * @brief Fetch detailed word information from API
  * 
  * Returns a complete APIResponse structure with word validation,
- * definition, and performance metrics.
+ * definition, and performance metrics. Always makes a request, since
+ * definitions are not cached, but stores the answer in the cache.
  * 
  * @param word The word to look up (must not be NULL)
  * @return APIResponse structure (caller must free with free_api_response)
@@ -73,10 +136,25 @@ APIResponse* fetch_word_details(const char* word);
 /**
  * @brief Get current API statistics
  * 
- * @return Pointer to current API statistics (do not free)
+ * @deprecated Use get_api_stats_copy(). Kept for existing callers: takes
+ * a snapshot under the stats lock into a buffer owned by the calling
+ * thread, which that thread's next call overwrites.
+ * 
+ * @return Pointer to a snapshot of the API statistics (do not free; overwritten by the next call)
  */
 const APIStats* get_api_stats(void);
 
+/**
+ * @brief Copy current API statistics into caller storage
+ * 
+ * Takes a consistent snapshot of the statistics under the stats lock.
+ * 
+ * @param out Receives the statistics (ignored if NULL)
+ * 
+ * @note Thread-safe
+ */
+void get_api_stats_copy(APIStats* out);
+
 /**
  * @brief Reset API statistics
  */
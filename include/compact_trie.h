@@ -0,0 +1,278 @@
+#ifndef COMPACT_TRIE_H
+#define COMPACT_TRIE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "trie.h"
+
+/**
+ * @file compact_trie.h
+ * @brief Frozen, read-only compact Trie layout for fast dictionary queries
+ *
+ * The pointer-based Trie spends 26 child pointers on every node, most of
+ * them NULL, and every lookup step follows a pointer to an unrelated heap
+ * block. A CompactTrie is built once from a fully loaded Trie and stores
+ * the same tree in level order inside one contiguous allocation:
+ *
+ * - The children of a node occupy consecutive slots, so a node only needs
+ *   the index of its first child and a child count.
+ * - Edge labels live in a separate byte array parallel to the nodes, so
+ *   scanning a node's children touches a single cache line.
+ *
+ * Each node takes sizeof(CompactTrieNode) + 1 bytes instead of
+ * sizeof(TrieNode), and lookups walk indices within one block of memory.
+ * The structure is immutable; rebuild it after changing the source Trie.
+ *
+ * Because the layout contains no pointers it can be written to disk as-is
+ * (compact_trie_save()) and later memory-mapped and queried in place
+ * (compact_trie_map()), with no parsing and no per-node allocation. The
+ * mapped pages are shared through the page cache by every process that
+ * loads the same file.
+ *
+ * Compiled File Format (version 2, native byte order):
+ * - CompactTrieFileHeader (magic "SPCKDICT", version, counts, checksum)
+ * - Node array (node_count * sizeof(CompactTrieNode))
+ * - Label array (node_count bytes)
+ *
+ * Time Complexity:
+ * - Build: O(N) where N is the number of nodes in the source Trie
+ * - Search: O(m * c) where m is word length, c is the children scanned per level (<= 26 for ASCII words)
+ *
+ * Usage Example:
+ * @code
+ * Trie* dict = trie_create();
+ * load_dictionary("words.txt", dict);
+ *
+ * CompactTrie* frozen = compact_trie_build(dict);
+ * if (compact_trie_search(frozen, "hello")) {
+ *     printf("Word found!\n");
+ * }
+ * compact_trie_destroy(frozen);
+ * @endcode
+ */
+
+/**
+ * @brief Index value marking "no node" in a CompactTrie
+ */
+#define COMPACT_TRIE_NO_NODE UINT32_MAX
+
+/**
+ * @brief Magic bytes and format version of compiled dictionary files
+ */
+#define COMPACT_TRIE_MAGIC "SPCKDICT"
+#define COMPACT_TRIE_FORMAT_VERSION 2
+
+/**
+ * @brief A single node of the compact level-order layout
+ *
+ * The label of the edge leading into node i is stored separately in
+ * CompactTrie::labels[i]. Node 0 is the root (empty string).
+ */
+typedef struct CompactTrieNode {
+    uint32_t first_child;     ///< Index of the first child (children are contiguous)
+    uint32_t word_count;      ///< Statistics: number of words ending at this node
+    uint16_t child_count;     ///< Number of children
+    uint8_t is_end_of_word;   ///< Non-zero if this node ends a valid word
+    uint8_t frequency_bound;  ///< Encoded bound on the highest word_count in this subtree (see trie_encode_frequency_bound())
+} CompactTrieNode;
+
+/**
+ * @brief Header at the start of a compiled dictionary file
+ *
+ * The payload (node array followed by label array) starts at header_size.
+ * byte_order holds 0x01020304 as written by the compiling machine, so files
+ * from a machine of different endianness are rejected instead of misread.
+ */
+typedef struct CompactTrieFileHeader {
+    char magic[8];            ///< COMPACT_TRIE_MAGIC (not NUL-terminated)
+    uint32_t version;         ///< COMPACT_TRIE_FORMAT_VERSION
+    uint32_t byte_order;      ///< 0x01020304 in the writer's native byte order
+    uint32_t header_size;     ///< sizeof(CompactTrieFileHeader) at write time
+    uint32_t node_size;       ///< sizeof(CompactTrieNode) at write time
+    uint32_t node_count;      ///< Number of nodes in the payload
+    int32_t total_words;      ///< Number of unique words stored
+    uint64_t payload_size;    ///< Size of the payload in bytes
+    uint64_t checksum;        ///< FNV-1a 64-bit hash of the payload
+} CompactTrieFileHeader;
+
+/**
+ * @brief Frozen Trie stored as index-linked nodes in one contiguous block
+ */
+typedef struct CompactTrie {
+    CompactTrieNode* nodes;   ///< Node array in level order, nodes[0] is the root
+    unsigned char* labels;    ///< labels[i] is the character leading into nodes[i]
+    uint32_t node_count;      ///< Number of nodes (including the root)
+    int total_words;          ///< Number of unique words stored
+    void* storage;            ///< Single allocation (or file mapping) backing nodes and labels
+    size_t storage_size;      ///< Size of the storage block in bytes
+    bool mapped;              ///< True if storage is a read-only file mapping
+    void* map_handle;         ///< Platform mapping handle (Windows only)
+} CompactTrie;
+
+/**
+ * @brief Build a compact read-only copy of a pointer-based Trie
+ *
+ * Performs a breadth-first traversal of the source Trie, assigning node
+ * indices in level order so that every node's children are adjacent.
+ * The source Trie is not modified and may be destroyed afterwards.
+ *
+ * @param trie Fully loaded source Trie (must not be NULL)
+ * @return Newly allocated CompactTrie, or NULL on error (NULL parameter, memory allocation failure)
+ *
+ * @post Caller must call compact_trie_destroy() on the returned pointer
+ *
+ * Time Complexity: O(N) where N is the number of nodes
+ * Space Complexity: O(N) in one contiguous allocation
+ */
+CompactTrie* compact_trie_build(const Trie* trie);
+
+/**
+ * @brief Search for a complete word in the compact Trie
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @param word Word to search for
+ * @return true if word exists, false otherwise (including NULL parameters)
+ *
+ * Time Complexity: O(m * c) where m is word length, c is children per level
+ * Space Complexity: O(1)
+ */
+bool compact_trie_search(const CompactTrie* ctrie, const char* word);
+
+/**
+ * @brief Get the frequency (word_count) of a stored word
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @param word Word to look up
+ * @return Frequency of the word, or 0 if it is not stored (including NULL parameters)
+ *
+ * Time Complexity: O(m * c) where m is word length, c is children per level
+ */
+int compact_trie_get_frequency(const CompactTrie* ctrie, const char* word);
+
+/**
+ * @brief Check whether any stored word starts with the given prefix
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @param prefix Prefix to look for (empty prefix matches any non-empty trie)
+ * @return true if at least one word has this prefix, false otherwise
+ *
+ * Time Complexity: O(m * c) where m is prefix length
+ * Space Complexity: O(1)
+ */
+bool compact_trie_starts_with(const CompactTrie* ctrie, const char* prefix);
+
+/**
+ * @brief Find words within a bounded edit distance of a query
+ *
+ * Same contract and result ordering as trie_fuzzy_search(), evaluated over
+ * the compact layout.
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @param word Query word (at most TRIE_MAX_WORD_LENGTH characters)
+ * @param max_distance Maximum edit distance of reported words (>= 0)
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer
+ * @return Number of matches written, or 0 on error
+ *
+ * Time Complexity: O(V * m) where V is the number of nodes visited
+ * Space Complexity: O((m + max_distance) * m) for the DP rows
+ */
+int compact_trie_fuzzy_search(const CompactTrie* ctrie, const char* word, int max_distance,
+                              TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Find the most frequent words starting with a prefix
+ *
+ * Same contract and result ordering as trie_complete(), evaluated over
+ * the compact layout.
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @param prefix Prefix to complete
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer
+ * @return Number of matches written, or 0 on error
+ *
+ * Time Complexity: O(m * c + E * log Q) where E is the number of nodes expanded, Q the queue size
+ */
+int compact_trie_complete(const CompactTrie* ctrie, const char* prefix, TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Get all words stored in the compact Trie, in alphabetical order
+ *
+ * Same ownership rules as trie_get_all_words().
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @param words Pointer to array of strings (allocated by this function)
+ * @param count Pointer to store number of words found
+ *
+ * Time Complexity: O(N * L) where N is number of words, L is average length
+ */
+void compact_trie_get_all_words(const CompactTrie* ctrie, char*** words, int* count);
+
+/**
+ * @brief Write a compact Trie to a compiled dictionary file
+ *
+ * Writes the file header followed by the node and label arrays exactly as
+ * they are laid out in memory, so the file can be mapped and used in place.
+ *
+ * @param ctrie Pointer to the CompactTrie (must not be NULL)
+ * @param filename Output path (overwritten if it exists)
+ * @return true on success, false on error (NULL parameters, file cannot be written)
+ *
+ * Time Complexity: O(N) where N is the number of nodes
+ * Space Complexity: O(1)
+ */
+bool compact_trie_save(const CompactTrie* ctrie, const char* filename);
+
+/**
+ * @brief Map a compiled dictionary file and query it in place
+ *
+ * Memory-maps the file read-only and validates its header (magic, version,
+ * byte order, node layout, sizes) and payload checksum. The returned
+ * CompactTrie points directly into the mapping; nothing is parsed or
+ * copied, and the mapping is released by compact_trie_destroy().
+ *
+ * @param filename Path to a file written by compact_trie_save()
+ * @return Mapped CompactTrie, or NULL on error (file missing, invalid or corrupted)
+ *
+ * @post Caller must call compact_trie_destroy() on the returned pointer
+ *
+ * Time Complexity: O(S) for the checksum, where S is the file size
+ * Space Complexity: O(1) beyond the shared file mapping
+ */
+CompactTrie* compact_trie_map(const char* filename);
+
+/**
+ * @brief Check whether a file starts with the compiled dictionary magic
+ *
+ * @param filename Path to check
+ * @return true if the file looks like a compiled dictionary, false otherwise
+ *
+ * Time Complexity: O(1)
+ */
+bool compact_trie_is_compiled_file(const char* filename);
+
+/**
+ * @brief Get exact memory usage of the compact Trie in bytes
+ *
+ * @param ctrie Pointer to the CompactTrie
+ * @return Bytes used by the structure and its storage block (mapped size for
+ *         a compiled file), or 0 if NULL
+ *
+ * Time Complexity: O(1)
+ */
+size_t compact_trie_get_memory_usage(const CompactTrie* ctrie);
+
+/**
+ * @brief Destroy a compact Trie and free its storage
+ *
+ * Frees the storage block, or unmaps it for a trie from compact_trie_map().
+ *
+ * @param ctrie Pointer to the CompactTrie (can be NULL)
+ *
+ * @note Safe to call with NULL pointer (no-op)
+ */
+void compact_trie_destroy(CompactTrie* ctrie);
+
+#endif // COMPACT_TRIE_H
@@ -0,0 +1,244 @@
+#ifndef DAWG_H
+#define DAWG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "trie.h"
+
+/**
+ * @file dawg.h
+ * @brief Minimal acyclic automaton (DAWG) sharing both prefixes and suffixes
+ *
+ * A trie shares prefixes only, so "walking", "talking" and "parking" each
+ * store their own "-ing". A DAWG (directed acyclic word graph) is the
+ * minimal deterministic automaton accepting the same words: any two nodes
+ * with the same set of endings are merged into one state, so every common
+ * suffix is stored once. On large word lists this takes a small fraction
+ * of the nodes of the trie.
+ *
+ * Construction is incremental over sorted input (Daciuk, Mihov, Watson and
+ * Watson, 2000): only the path of the most recently added word is mutable,
+ * and whenever the next word leaves part of that path behind, the finished
+ * states are replaced by an equivalent registered state or registered
+ * themselves. The automaton is therefore minimal at every step and never
+ * holds the unminimized trie.
+ *
+ * Merged states cannot carry per-word data, so frequencies live in an
+ * array indexed by the word's rank in sorted order. Every state records
+ * how many words it accepts, which turns following a word's path into
+ * computing its rank (a minimal perfect hash); the array is omitted when
+ * every frequency is 1.
+ *
+ * Layout, in one contiguous allocation:
+ * - State array: first edge, edge count, accepted-word count, final flag
+ *   and a frequency bound for completion (see trie_encode_frequency_bound())
+ * - Edge target array and edge label array; a state's edges are
+ *   contiguous and sorted by label
+ * - Frequency array (optional)
+ *
+ * The automaton is immutable; rebuild it after changing the source words.
+ *
+ * Time Complexity:
+ * - Build: O(N * L * log A) where N is the number of words, L the average length, A the alphabet
+ * - Search: O(m * c) where m is word length, c is the edges scanned per state
+ *
+ * Usage Example:
+ * @code
+ * DawgBuilder* builder = dawg_builder_create();
+ * dawg_builder_add(builder, "parking", 7, 1);
+ * dawg_builder_add(builder, "walking", 7, 1);   // Shares "-king" with "parking"
+ * Dawg* dawg = dawg_builder_finish(builder);
+ *
+ * if (dawg_search(dawg, "walking")) {
+ *     printf("Found, %u states\n", dawg->state_count);
+ * }
+ * dawg_destroy(dawg);
+ * @endcode
+ */
+
+/**
+ * @brief A single state of the automaton
+ *
+ * State 0 is the root. The edges of state i are
+ * [first_edge, first_edge + edge_count) in the edge arrays.
+ */
+typedef struct DawgState {
+    uint32_t first_edge;      ///< Index of the first outgoing edge
+    uint32_t word_count;      ///< Number of words accepted from this state (its endings)
+    uint16_t edge_count;      ///< Number of outgoing edges
+    uint8_t is_final;         ///< Non-zero if a word can end in this state
+    uint8_t frequency_bound;  ///< Encoded bound on the frequency of any word through this state
+} DawgState;
+
+/**
+ * @brief Frozen minimal automaton in one contiguous block
+ */
+typedef struct Dawg {
+    DawgState* states;        ///< State array, states[0] is the root
+    uint32_t* targets;        ///< targets[e] is the state edge e leads to
+    unsigned char* labels;    ///< labels[e] is the byte on edge e
+    uint32_t* frequencies;    ///< Frequency of each word by rank, NULL if all are 1
+    uint32_t state_count;     ///< Number of states
+    uint32_t edge_count;      ///< Number of edges
+    int total_words;          ///< Number of words accepted
+    void* storage;            ///< Single allocation backing all arrays
+    size_t storage_size;      ///< Size of the storage block in bytes
+} Dawg;
+
+/**
+ * @brief Incremental builder of a Dawg (opaque)
+ */
+typedef struct DawgBuilder DawgBuilder;
+
+/**
+ * @brief Start building a Dawg
+ *
+ * @return New builder, or NULL on memory allocation failure
+ *
+ * @post Caller must pass the builder to dawg_builder_finish() or dawg_builder_destroy()
+ */
+DawgBuilder* dawg_builder_create(void);
+
+/**
+ * @brief Add the next word
+ *
+ * Words must arrive in strictly increasing byte order, which is the order
+ * trie_get_all_words() produces.
+ *
+ * @param builder Builder from dawg_builder_create()
+ * @param word Word bytes (need not be NUL-terminated; a-z and UTF-8 bytes >= 0x80)
+ * @param length Length of the word (1..TRIE_MAX_WORD_LENGTH)
+ * @param frequency Frequency stored with the word (>= 1)
+ * @return true on success, false on error (NULL parameters, bad length or frequency, word out of order, memory allocation failure)
+ *
+ * Time Complexity: O(m * log A) amortized, where m is the word length
+ */
+bool dawg_builder_add(DawgBuilder* builder, const char* word, size_t length, int frequency);
+
+/**
+ * @brief Finish the automaton and release the builder
+ *
+ * @param builder Builder from dawg_builder_create() (always released)
+ * @return The Dawg, or NULL on error (NULL parameter, an earlier add failed, memory allocation failure)
+ *
+ * @post Caller must call dawg_destroy() on the returned pointer
+ */
+Dawg* dawg_builder_finish(DawgBuilder* builder);
+
+/**
+ * @brief Abandon a builder
+ *
+ * @param builder Builder to release (can be NULL)
+ */
+void dawg_builder_destroy(DawgBuilder* builder);
+
+/**
+ * @brief Build the minimal automaton of a Trie's words
+ *
+ * Feeds the Trie's words with their frequencies to a builder in sorted
+ * order, straight from the tree (pointer or compact layout); the Trie is
+ * not modified.
+ *
+ * @param trie Source Trie (must not be NULL or already minimized)
+ * @return The Dawg, or NULL on error (NULL parameter, memory allocation failure)
+ *
+ * Time Complexity: O(N * L * log A) where N is the number of words, L the average length
+ */
+Dawg* dawg_build(const Trie* trie);
+
+/**
+ * @brief Search for a complete word
+ *
+ * @param dawg Pointer to the Dawg
+ * @param word Word to search for (ASCII letters are folded)
+ * @return true if word is accepted, false otherwise (including NULL parameters)
+ *
+ * Time Complexity: O(m * c) where m is word length, c is edges per state
+ */
+bool dawg_search(const Dawg* dawg, const char* word);
+
+/**
+ * @brief Get the frequency of a word
+ *
+ * @param dawg Pointer to the Dawg
+ * @param word Word to look up
+ * @return Frequency of the word, or 0 if it is not accepted (including NULL parameters)
+ *
+ * Time Complexity: O(m * c) where m is word length, c is edges per state
+ */
+int dawg_get_frequency(const Dawg* dawg, const char* word);
+
+/**
+ * @brief Check whether any accepted word starts with the given prefix
+ *
+ * @param dawg Pointer to the Dawg
+ * @param prefix Prefix to look for (empty prefix matches any non-empty automaton)
+ * @return true if at least one word has this prefix, false otherwise
+ */
+bool dawg_starts_with(const Dawg* dawg, const char* prefix);
+
+/**
+ * @brief Find words within a bounded edit distance of a query
+ *
+ * Same contract and result ordering as trie_fuzzy_search(). The walk
+ * enumerates paths, so it visits the same prefixes as the trie walk and
+ * prunes them the same way; shared suffix states are read from cache
+ * more often but scored once per path.
+ *
+ * @param dawg Pointer to the Dawg
+ * @param word Query word (at most TRIE_MAX_WORD_LENGTH characters)
+ * @param max_distance Maximum edit distance of reported words (>= 0)
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer
+ * @return Number of matches written, or 0 on error
+ *
+ * Time Complexity: O(V * m) where V is the number of path prefixes visited
+ * Space Complexity: O((m + max_distance) * m) for the DP rows
+ */
+int dawg_fuzzy_search(const Dawg* dawg, const char* word, int max_distance, TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Find the most frequent words starting with a prefix
+ *
+ * Same contract and result ordering as trie_complete(). A state's
+ * frequency bound covers every word through it under any prefix, so it
+ * prunes less tightly than in a trie.
+ *
+ * @param dawg Pointer to the Dawg
+ * @param prefix Prefix to complete
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer
+ * @return Number of matches written, or 0 on error
+ */
+int dawg_complete(const Dawg* dawg, const char* prefix, TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Get all accepted words, in alphabetical order
+ *
+ * Same ownership rules as trie_get_all_words().
+ *
+ * @param dawg Pointer to the Dawg
+ * @param words Pointer to array of strings (allocated by this function)
+ * @param count Pointer to store number of words found
+ *
+ * Time Complexity: O(N * L) where N is number of words, L is average length
+ */
+void dawg_get_all_words(const Dawg* dawg, char*** words, int* count);
+
+/**
+ * @brief Get exact memory usage of the Dawg in bytes
+ *
+ * @param dawg Pointer to the Dawg
+ * @return Bytes used by the structure and its storage block, or 0 if NULL
+ */
+size_t dawg_get_memory_usage(const Dawg* dawg);
+
+/**
+ * @brief Destroy a Dawg and free its storage
+ *
+ * @param dawg Pointer to the Dawg (can be NULL)
+ */
+void dawg_destroy(Dawg* dawg);
+
+#endif // DAWG_H
@@ -0,0 +1,191 @@
+#ifndef DICTIONARY_HANDLE_H
+#define DICTIONARY_HANDLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "trie.h"
+
+/**
+ * @file dictionary_handle.h
+ * @brief Shared read-only dictionary that can be reloaded while in use
+ *
+ * A long-running service checks text on many threads against one
+ * dictionary, and the dictionary file changes under it. A DictionaryHandle
+ * owns the current dictionary version (a frozen Trie) and replaces it
+ * without ever blocking a reader:
+ *
+ * - Readers register once per thread and bracket each check with
+ *   dictionary_read_begin() / dictionary_read_end(). Both are a handful of
+ *   atomic loads and stores on the reader's own cache line: no locks, no
+ *   shared counters.
+ * - A reload builds the new Trie completely off to the side (parse, then
+ *   trie_freeze()), then publishes it with one atomic pointer exchange.
+ *   Checks that started earlier keep the version they began with; checks
+ *   that start later see the new one.
+ * - The old version is reclaimed with epoch-based reclamation: it is
+ *   retired at the current epoch and freed only once no reader is still
+ *   inside a read section that began at or before that epoch. Freeing is
+ *   attempted after each reload and on every watcher tick, never waited for.
+ *
+ * Reloads can be run synchronously (dictionary_handle_reload()) or by a
+ * background watcher thread that reloads when the file's modification time
+ * changes or when asked to (dictionary_handle_request_reload()). A failed
+ * reload keeps the current version.
+ *
+ * @note SUGGESTION_ENGINE_SYMSPELL and SUGGESTION_ENGINE_SCAN index one
+ *       fixed Trie; with a handle, keep the default trie engine so
+ *       suggestions follow reloads.
+ *
+ * Usage Example:
+ * @code
+ * DictionaryHandle* handle = dictionary_handle_open("words.txt");
+ * dictionary_handle_start_watcher(handle, 5000);
+ *
+ * // On each worker thread
+ * DictionaryReader* reader = dictionary_reader_register(handle);
+ * Trie* dictionary = dictionary_read_begin(reader);
+ * SpellCheckResult* result = spell_check_document(doc, dictionary);
+ * dictionary_read_end(reader);
+ * dictionary_reader_unregister(reader);
+ *
+ * dictionary_handle_close(handle);
+ * @endcode
+ */
+
+/**
+ * @brief Maximum number of simultaneously registered readers
+ */
+#define DICTIONARY_MAX_READERS 128
+
+/**
+ * @brief Opaque handle owning the current dictionary version
+ */
+typedef struct DictionaryHandle DictionaryHandle;
+
+/**
+ * @brief Opaque per-thread reader registration
+ */
+typedef struct DictionaryReader DictionaryReader;
+
+/**
+ * @brief Load a dictionary file and wrap it in a reloadable handle
+ *
+ * The file is loaded with load_dictionary() (text or compiled) and frozen.
+ * Later reloads read the same path.
+ *
+ * @param filename Path to the dictionary file (must not be NULL)
+ * @return New handle, or NULL on error (file cannot be loaded, memory allocation failure)
+ *
+ * @post Caller must call dictionary_handle_close() on the returned pointer
+ */
+DictionaryHandle* dictionary_handle_open(const char* filename);
+
+/**
+ * @brief Reload the dictionary file now, on the calling thread
+ *
+ * Builds the new version, publishes it and frees retired versions that no
+ * reader can still see. Readers are never blocked; concurrent reloads are
+ * serialized.
+ *
+ * @param handle Dictionary handle
+ * @return true if a new version was published, false on error (the current version stays)
+ *
+ * Time Complexity: O(N) to load N words, O(1) to publish
+ */
+bool dictionary_handle_reload(DictionaryHandle* handle);
+
+/**
+ * @brief Start a background thread that reloads the dictionary when it changes
+ *
+ * Every interval_ms milliseconds the thread frees retired versions and
+ * checks the file's modification time, reloading when it differs from the
+ * loaded version's.
+ *
+ * @param handle Dictionary handle
+ * @param interval_ms Polling interval in milliseconds (> 0)
+ * @return true if the watcher runs (including already running), false on error
+ */
+bool dictionary_handle_start_watcher(DictionaryHandle* handle, int interval_ms);
+
+/**
+ * @brief Ask the watcher thread to reload as soon as possible
+ *
+ * Returns immediately. Without a running watcher, the request is served
+ * by the next dictionary_handle_reload() call instead (which always reloads).
+ *
+ * @param handle Dictionary handle (can be NULL, which is a no-op)
+ */
+void dictionary_handle_request_reload(DictionaryHandle* handle);
+
+/**
+ * @brief Get the number of the version currently published
+ *
+ * Starts at 1 for the initially loaded dictionary and grows by one with
+ * every successful reload.
+ *
+ * @param handle Dictionary handle
+ * @return Current generation, or 0 if handle is NULL
+ */
+unsigned long dictionary_handle_generation(DictionaryHandle* handle);
+
+/**
+ * @brief Register the calling thread as a reader
+ *
+ * @param handle Dictionary handle
+ * @return Reader registration, or NULL if all DICTIONARY_MAX_READERS slots are taken
+ *
+ * @post Call dictionary_reader_unregister() before the thread exits
+ */
+DictionaryReader* dictionary_reader_register(DictionaryHandle* handle);
+
+/**
+ * @brief Release a reader registration
+ *
+ * @param reader Registration (can be NULL); must not be inside a read section
+ */
+void dictionary_reader_unregister(DictionaryReader* reader);
+
+/**
+ * @brief Enter a read section and get the current dictionary
+ *
+ * The returned Trie stays valid, and unchanged, until the matching
+ * dictionary_read_end(), even if a reload publishes a newer version in
+ * the meantime. Read sections of one reader must not nest.
+ *
+ * @param reader Registration of the calling thread
+ * @return Current dictionary (never NULL for a valid reader)
+ *
+ * Time Complexity: O(1), wait-free
+ */
+Trie* dictionary_read_begin(DictionaryReader* reader);
+
+/**
+ * @brief Get the generation of the dictionary returned by dictionary_read_begin()
+ *
+ * Unlike dictionary_handle_generation(), this names the version the open
+ * read section actually uses, even if a reload has published a newer one.
+ *
+ * @param reader Registration of the calling thread, inside a read section
+ * @return Generation of the version being read
+ */
+unsigned long dictionary_read_generation(const DictionaryReader* reader);
+
+/**
+ * @brief Leave a read section
+ *
+ * @param reader Registration of the calling thread
+ *
+ * Time Complexity: O(1), wait-free
+ */
+void dictionary_read_end(DictionaryReader* reader);
+
+/**
+ * @brief Stop the watcher and free every dictionary version
+ *
+ * @param handle Dictionary handle (can be NULL)
+ *
+ * @pre No reader is inside a read section
+ */
+void dictionary_handle_close(DictionaryHandle* handle);
+
+#endif // DICTIONARY_HANDLE_H
@@ -27,6 +27,18 @@
  * Time Complexity: O(m * n) where m and n are the lengths of the input strings
  * Space Complexity: O(min(m, n)) with space optimization, O(m * n) for operation tracking
  * 
+ * Hot paths should use the allocation-free functions: compute_edit_distance()
+ * itself runs the bit-parallel kernel for dictionary-sized words, and the
+ * *_bounded() variants take caller-owned scratch rows plus a max_distance
+ * cutoff so they can stop as soon as the bound is out of reach.
+ * 
+ * Bounds up to EDIT_DISTANCE_MAX_BANDED (the suggestion path always uses 2)
+ * are served by kernels specialized per bound at compile time: a cell more
+ * than k diagonals away from the main one already costs more than k edits,
+ * so only a band of 2k + 1 cells per row is evaluated, in fixed-size rows
+ * on the stack. A bounded comparison then costs O(k * m) whatever the
+ * lengths of the words.
+ * 
  * Usage Example:
  * @code
  * int distance = compute_edit_distance("kitten", "sitting");
@@ -38,6 +50,34 @@
  * @endcode
  */
 
+/**
+ * @brief Number of ints of scratch compute_edit_distance_bounded() needs
+ * 
+ * @param target_len Length of the second (target) string
+ */
+#define EDIT_DISTANCE_SCRATCH_SIZE(target_len) (2 * ((size_t)(target_len) + 1))
+
+/**
+ * @brief Largest bound served by the banded kernels
+ * 
+ * compute_edit_distance_bounded() and compute_weighted_distance_bounded()
+ * dispatch bounds 0..3 to a kernel generated for that bound, and use the
+ * general algorithms above it. edit_distance_within() keeps the
+ * bit-parallel kernel, which is faster still for dictionary-sized words.
+ */
+#define EDIT_DISTANCE_MAX_BANDED 3
+
+/**
+ * @brief Costs used by compute_weighted_distance()
+ * 
+ * Typing errors are not uniform: hitting a neighbouring key or swapping two
+ * letters is far more common than an arbitrary substitution, so those edits
+ * cost less than a plain insertion, deletion or substitution.
+ */
+#define EDIT_COST_DEFAULT 1.0f        ///< Insertion, deletion, unrelated substitution
+#define EDIT_COST_ADJACENT_KEY 0.6f   ///< Substitution by a neighbouring QWERTY key
+#define EDIT_COST_TRANSPOSE 0.5f      ///< Swap of two adjacent letters ("teh" -> "the")
+
 /**
  * @brief Edit operation types for tracking transformations
  * 
@@ -88,14 +128,19 @@ typedef struct EditResult {
  * in word1, compute the next row based on the recurrence relation. The final
  * value in the last position gives the minimum edit distance.
  * 
+ * When the shorter string has at most 64 characters the DP is evaluated with
+ * the bit-parallel kernel instead (see edit_distance_within()), and nothing
+ * is allocated. Longer strings use two rows on the stack, or on the heap
+ * beyond 256 characters.
+ * 
  * @param word1 First string (source)
  * @param word2 Second string (target)
  * @return Minimum number of operations to transform word1 into word2, or -1 on error
  * 
  * @pre word1 != NULL && word2 != NULL
  * 
- * Time Complexity: O(m * n) where m = len(word1), n = len(word2)
- * Space Complexity: O(min(m, n))
+ * Time Complexity: O(max(m, n)) up to 64 characters, O(m * n) beyond
+ * Space Complexity: O(1) up to 64 characters, O(n) beyond
  * 
  * Example:
  * @code
@@ -105,6 +150,38 @@ typedef struct EditResult {
  */
 int compute_edit_distance(const char* word1, const char* word2);
 
+/**
+ * @brief Compute a bounded edit distance using caller-owned scratch rows
+ * 
+ * Same DP as compute_edit_distance(), but allocation-free and thresholded:
+ * pairs whose length difference exceeds max_distance are rejected
+ * immediately, and the row loop stops as soon as every cell of a row exceeds
+ * max_distance, since no later row can get back under the bound. Reuse one
+ * scratch buffer across calls in a loop. Bounds up to
+ * EDIT_DISTANCE_MAX_BANDED run the banded kernel and leave scratch unused.
+ * 
+ * @param word1 First string (source)
+ * @param word2 Second string (target)
+ * @param max_distance Largest distance of interest (>= 0)
+ * @param scratch Buffer of at least EDIT_DISTANCE_SCRATCH_SIZE(strlen(word2)) ints
+ * @param scratch_size Number of ints in scratch
+ * @return Exact distance if <= max_distance, max_distance + 1 if above,
+ *         or -1 on error (NULL input, negative bound, scratch too small)
+ * 
+ * Time Complexity: O(k * m) for k = max_distance <= EDIT_DISTANCE_MAX_BANDED, otherwise
+ *                  O(m * n) worst case, stopping at the first row above the bound
+ * Space Complexity: O(1) beyond the caller's scratch
+ * 
+ * Example:
+ * @code
+ * int scratch[EDIT_DISTANCE_SCRATCH_SIZE(64)];
+ * int dist = compute_edit_distance_bounded("kitten", "sitting", 2, scratch, EDIT_DISTANCE_SCRATCH_SIZE(64));
+ * // Returns 3 (above the bound of 2)
+ * @endcode
+ */
+int compute_edit_distance_bounded(const char* word1, const char* word2, int max_distance,
+                                  int* scratch, size_t scratch_size);
+
 /**
  * @brief Compute edit distance and track the sequence of operations
  * 
@@ -123,7 +200,7 @@ int compute_edit_distance(const char* word1, const char* word2);
  * @post Caller must call free_edit_result() on returned pointer
  * 
  * Time Complexity: O(m * n) where m = len(word1), n = len(word2)
- * Space Complexity: O(m * n) for the full DP matrix
+ * Space Complexity: O(m * n) for the full DP matrix (one flat allocation)
  * 
  * Example:
  * @code
@@ -154,6 +231,7 @@ EditResult* compute_edit_operations(const char* word1, const char* word2);
  * Space Complexity: O(target_len)
  * 
  * @note Useful for implementing suggestion generation with distance thresholds
+ * @note Allocates the returned row; loops should use get_distance_row_bounded()
  * 
  * Example:
  * @code
@@ -164,6 +242,149 @@ EditResult* compute_edit_operations(const char* word1, const char* word2);
  */
 int* get_distance_row(const char* word, const char* target, int target_len);
 
+/**
+ * @brief Compute the last DP row into caller-owned buffers with a cutoff
+ * 
+ * Allocation-free form of get_distance_row(). The computation stops as soon
+ * as every cell of a row exceeds max_distance; row is then left undefined,
+ * since no prefix of target can be within the bound of word.
+ * 
+ * @param word Source word
+ * @param target Target word
+ * @param target_len Length of target word
+ * @param max_distance Largest distance of interest (>= 0)
+ * @param row Receives the last DP row (target_len + 1 ints)
+ * @param scratch Working row (target_len + 1 ints)
+ * @return Minimum value of the row if <= max_distance, max_distance + 1 if the
+ *         computation stopped early, or -1 on error
+ * 
+ * Time Complexity: O(len(word) * target_len) worst case
+ * Space Complexity: O(1) beyond the caller's buffers
+ * 
+ * Example:
+ * @code
+ * int row[5], scratch[5];
+ * if (get_distance_row_bounded("hello", "help", 4, 2, row, scratch) <= 2) {
+ *     // row[4] == 2
+ * }
+ * @endcode
+ */
+int get_distance_row_bounded(const char* word, const char* target, int target_len, int max_distance,
+                             int* row, int* scratch);
+
+/**
+ * @brief Compute a keyboard-aware weighted edit distance
+ * 
+ * Optimal string alignment (restricted Damerau-Levenshtein) distance where
+ * each edit has its own cost: EDIT_COST_ADJACENT_KEY for substituting a
+ * letter by one of its QWERTY neighbours, EDIT_COST_TRANSPOSE for swapping
+ * two adjacent letters, and EDIT_COST_DEFAULT for everything else. Used to
+ * rank suggestions that the plain Levenshtein distance cannot tell apart.
+ * Letters are compared case-insensitively for adjacency only.
+ * 
+ * @param typed String as typed (source)
+ * @param candidate Candidate correction (target)
+ * @return Weighted cost of transforming typed into candidate, or -1.0f on error
+ * 
+ * Time Complexity: O(m * n) where m = len(typed), n = len(candidate)
+ * Space Complexity: O(n), on the stack for words up to 64 characters
+ * 
+ * Example:
+ * @code
+ * compute_weighted_distance("teh", "the");   // 0.5 (one transposition)
+ * compute_weighted_distance("hrllo", "hello"); // 0.6 (r is next to e)
+ * compute_weighted_distance("hkllo", "hello"); // 1.0
+ * @endcode
+ */
+float compute_weighted_distance(const char* typed, const char* candidate);
+
+/**
+ * @brief Compute the weighted distance of a pair known to be close
+ * 
+ * Same result as compute_weighted_distance() when the Levenshtein distance
+ * of the pair is at most max_distance, which is the case for every
+ * suggestion candidate (its fuzzy search distance can be passed directly).
+ * Every weighted edit costs at most one and only insertions and deletions
+ * leave the main diagonal, so the banded kernel for max_distance is exact.
+ * Bounds above EDIT_DISTANCE_MAX_BANDED, and pairs whose lengths differ by
+ * more than max_distance, fall back to compute_weighted_distance().
+ * 
+ * @param typed String as typed (source)
+ * @param candidate Candidate correction (target)
+ * @param max_distance Upper bound on the Levenshtein distance of the pair (>= 0)
+ * @return Weighted cost (exact when the weighted distance is at most max_distance,
+ *         above max_distance otherwise), or -1.0f on error
+ * 
+ * Time Complexity: O(k * m) for k = max_distance <= EDIT_DISTANCE_MAX_BANDED
+ * Space Complexity: O(k) on the stack
+ * 
+ * Example:
+ * @code
+ * compute_weighted_distance_bounded("teh", "the", 2);   // 0.5, as compute_weighted_distance()
+ * @endcode
+ */
+float compute_weighted_distance_bounded(const char* typed, const char* candidate, int max_distance);
+
+/**
+ * @brief Check whether two strings are within a maximum edit distance
+ * 
+ * Exact, allocation-free alternative to comparing compute_edit_distance()
+ * against a bound. When the shorter string has at most 64 characters (always
+ * true for dictionary words, see is_valid_word()) it runs the bit-parallel
+ * algorithm of Myers/Hyyro: the whole DP column lives in two 64-bit words and
+ * each character of the longer string costs a handful of word operations.
+ * It stops as soon as the bound can no longer be met. Longer inputs fall
+ * back to compute_edit_distance().
+ * 
+ * @param word1 First string
+ * @param word2 Second string
+ * @param max_distance Largest distance accepted (>= 0)
+ * @param distance Receives the exact distance when within the bound (can be NULL)
+ * @return true if the distance is <= max_distance, false otherwise or on invalid input
+ * 
+ * Time Complexity: O(n) for n = len of the longer string (O(m * n) beyond 64 characters)
+ * Space Complexity: O(1) - 2KB of stack for the match masks
+ * 
+ * Example:
+ * @code
+ * int d;
+ * if (edit_distance_within("kitten", "sitting", 3, &d)) {
+ *     // d == 3
+ * }
+ * @endcode
+ */
+bool edit_distance_within(const char* word1, const char* word2, int max_distance, int* distance);
+
+/**
+ * @brief Score many candidate strings against one word with a distance bound
+ * 
+ * Batch form of edit_distance_within() for suggestion verification. The
+ * word's match masks are built once; candidates failing the length filter
+ * are skipped, and the rest are scored with the bit-parallel kernel. On CPUs
+ * with AVX2 (detected at runtime) four candidates are scored per
+ * instruction, one per 64-bit lane. Results are exact and identical on
+ * every kernel.
+ * 
+ * @param word Word to compare against (bit-parallel when 1..64 characters)
+ * @param candidates Candidate strings (NULL entries are skipped)
+ * @param count Number of candidates
+ * @param max_distance Largest distance accepted (>= 0)
+ * @param distances Receives, per candidate, its distance or -1 if above the bound
+ * @return Number of candidates within the bound
+ * 
+ * Time Complexity: O(count * n) where n is the candidate length
+ * Space Complexity: O(1)
+ */
+int edit_distance_batch_within(const char* word, const char* const* candidates, int count,
+                               int max_distance, int* distances);
+
+/**
+ * @brief Name of the kernel selected for this CPU
+ * 
+ * @return "avx2" when the AVX2 batch kernel is in use, otherwise "bit-parallel"
+ */
+const char* edit_distance_kernel_name(void);
+
 /**
  * @brief Free memory allocated for EditResult structure
  * 
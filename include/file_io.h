@@ -2,6 +2,7 @@
 #define FILE_IO_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include "trie.h"
 
 /**
@@ -38,18 +39,34 @@
  * @endcode
  */
 
+/**
+ * @brief Size of the read buffer used by stream_text_file()
+ */
+#define STREAM_CHUNK_SIZE 65536
+
+/**
+ * @brief Longest word normalize_word() accepts; longer tokens are rejected
+ */
+#define MAX_WORD_INPUT_LENGTH 100
+
 /**
  * @brief TextToken structure representing a single token from text processing
  * 
  * Stores both normalized and original forms of words to enable accurate
  * dictionary lookup while preserving formatting for user-friendly reporting.
  * Includes position information for precise error location reporting.
+ * 
+ * Tokens own no memory: in a TextDocument both strings point into blocks
+ * owned by the document, and the span (offset, length) locates the original
+ * word in TextDocument::text. Copy a string if it must outlive the document.
  */
 typedef struct TextToken {
-    char* word;           ///< Normalized word (lowercase, no punctuation) for dictionary lookup
-    char* original_word;  ///< Original word preserving case/punctuation for reporting
+    const char* word;          ///< Normalized word (lowercase, no punctuation) for dictionary lookup
+    const char* original_word; ///< Original word preserving case/punctuation for reporting
+    size_t offset;        ///< Byte offset of the original word in the source text
+    size_t length;        ///< Length of the original word in bytes
     int line_number;      ///< Line number where token was found (1-based)
-    int position;         ///< Character position within the line (0-based)
+    int position;         ///< Byte position within the line (0-based)
 } TextToken;
 
 /**
@@ -58,14 +75,36 @@ typedef struct TextToken {
  * Represents a complete tokenized document with metadata for processing
  * and statistics. Maintains filename for error reporting and provides
  * both unique and total word counts for analysis.
+ * 
+ * The file is read once into text. Each original word is terminated in place
+ * by writing '\0' over the boundary byte that follows it, and normalized
+ * words are packed into the single words block, so a document holds a fixed
+ * number of allocations regardless of its length.
  */
 typedef struct TextDocument {
     TextToken* tokens;    ///< Array of tokens extracted from the document
     int token_count;      ///< Number of unique tokens in the document
     int total_words;      ///< Total word count including duplicates and skipped tokens
     char* filename;       ///< Source filename for error reporting
+    char* text;           ///< Whole file contents; token boundaries are overwritten with '\0'
+    size_t text_size;     ///< Size of the file contents in bytes
+    char* words;          ///< Shared block holding every token's normalized word
+    double tokenize_seconds; ///< Wall-clock time spent splitting the text into tokens
+    size_t memory_used;   ///< Bytes held by the document (charged to MEMORY_COMPONENT_DOCUMENTS)
 } TextDocument;
 
+/**
+ * @brief Callback receiving each token produced by stream_text_file()
+ * 
+ * The token's strings point into buffers reused for the next token, so they
+ * are only valid for the duration of the call.
+ * 
+ * @param token Token found in the stream
+ * @param user_data Caller-supplied pointer passed through from stream_text_file()
+ * @return true to continue streaming, false to stop early
+ */
+typedef bool (*TokenCallback)(const TextToken* token, void* user_data);
+
 /**
  * @brief Load dictionary from file into Trie data structure
  * 
@@ -77,14 +116,21 @@ typedef struct TextDocument {
  * - Empty lines are skipped
  * - Words are normalized to lowercase
  * - Invalid characters are filtered out
- * - Duplicate words are handled gracefully
+ * - Duplicate words are handled gracefully (their frequencies add up)
+ * - A line may end with a whitespace-separated count ("the 56271872"),
+ *   stored as the word's frequency to rank suggestions; without one a
+ *   word has frequency 1
  * 
  * @param filename Path to dictionary file (must not be NULL)
  * @param trie Pointer to Trie to populate (must not be NULL)
  * @return true if loading successful, false on error (file not found, invalid format, memory allocation failure)
  * 
  * @pre filename != NULL && trie != NULL
- * @post On success, trie contains all valid words from the file
+ * @post On success, trie contains all valid words from the file and its
+ *       exact lookup table is built (see trie_build_word_set())
+ * 
+ * @note A compiled dictionary (see compile_dictionary()) is detected by its
+ * magic header and loaded with load_compiled_dictionary() instead of being parsed
  * 
  * Time Complexity: O(n * m) where n = number of words, m = average word length
  * Space Complexity: O(n * m) for the trie storage
@@ -101,19 +147,110 @@ typedef struct TextDocument {
  */
 bool load_dictionary(const char* filename, Trie* trie);
 
+/**
+ * @brief Load a text dictionary using several threads
+ * 
+ * Produces the same Trie as load_dictionary() (same words, frequencies,
+ * total_words and duplicate handling) and the same messages, but builds
+ * it in bulk instead of line by line:
+ * 1. The file is read in one piece and cut into line-aligned chunks that
+ *    worker threads split, normalize and validate independently, keeping
+ *    the accepted words bucketed by first letter.
+ * 2. Builder threads each turn some of the 26 letters into Tries of their
+ *    own, inserting that letter's words in file order.
+ * 3. The per-letter Tries are grafted under the root (see trie_graft()).
+ * 
+ * Falls back to load_dictionary() for one thread, for a compiled dictionary
+ * or a non-empty Trie, and when memory runs out. Warnings about individual
+ * lines are printed in file order once parsing finishes.
+ * 
+ * @param filename Path to dictionary file (must not be NULL)
+ * @param trie Pointer to Trie to populate (must not be NULL)
+ * @param thread_count Number of threads to use (capped at 64)
+ * @return true if loading successful, false on error (same cases as load_dictionary())
+ * 
+ * @note Arena slack differs from a serial load, so trie_get_memory_usage() may differ slightly
+ * 
+ * Time Complexity: O(n * m / T) for T threads with balanced letters
+ * Space Complexity: O(S) for a copy of the file of size S, plus the trie storage
+ * 
+ * Example:
+ * @code
+ * Trie* dictionary = trie_create();
+ * if (load_dictionary_parallel("all_languages.txt", dictionary, 8)) {
+ *     printf("Dictionary loaded with %d words\n", dictionary->total_words);
+ * }
+ * @endcode
+ */
+bool load_dictionary_parallel(const char* filename, Trie* trie, int thread_count);
+
+/**
+ * @brief Silence the progress lines of the loaders
+ * 
+ * @param quiet true to skip the "Successfully loaded" and "Compiled" lines and send warnings to stderr
+ * 
+ * @note Not synchronized; call before loading
+ */
+void file_io_set_quiet(bool quiet);
+
+/**
+ * @brief Compile a loaded dictionary into a binary file for instant startup
+ * 
+ * Freezes the Trie into its compact layout (see trie_freeze()) and writes
+ * that layout to a versioned, checksummed binary file which
+ * load_compiled_dictionary() can map and query in place.
+ * 
+ * @param trie Loaded dictionary (must not be NULL, is frozen by this call)
+ * @param output_filename Path of the compiled dictionary to write
+ * @return true on success, false on error (memory allocation failure, file cannot be written)
+ * 
+ * Time Complexity: O(N) where N is the number of trie nodes
+ * Space Complexity: O(N) for the compact image
+ * 
+ * Example:
+ * @code
+ * Trie* dictionary = trie_create();
+ * if (load_dictionary("english_words.txt", dictionary)) {
+ *     compile_dictionary(dictionary, "english_words.dict");
+ * }
+ * trie_destroy(dictionary);
+ * @endcode
+ */
+bool compile_dictionary(Trie* trie, const char* output_filename);
+
+/**
+ * @brief Load a compiled dictionary by memory-mapping it
+ * 
+ * Maps a file written by compile_dictionary() and attaches it to the
+ * Trie, which then answers queries directly from the mapped pages. There
+ * is no parsing and no per-node allocation, and the pages are shared with
+ * other processes using the same file.
+ * 
+ * @param filename Path to compiled dictionary (must not be NULL)
+ * @param trie Empty Trie to attach the dictionary to (must not be NULL)
+ * @return true on success, false on error (file missing, incompatible version, checksum mismatch)
+ * 
+ * Time Complexity: O(S) to verify the checksum, where S is the file size
+ * Space Complexity: O(N * L) for the exact lookup table, beyond the shared mapping
+ */
+bool load_compiled_dictionary(const char* filename, Trie* trie);
+
 /**
  * @brief Load and tokenize text file for spell checking
  * 
  * Reads a text file and tokenizes it into individual words while preserving
- * position information and original formatting. Uses stream-based processing
- * to handle large files efficiently.
+ * position information and original formatting. Works without per-word
+ * allocations: the file is read into one buffer, words are normalized in a
+ * scratch buffer and only valid ones are kept.
  * 
  * Tokenization Rules:
- * - Word boundaries: whitespace, punctuation, line breaks
+ * - Text is UTF-8; word boundaries are whitespace, punctuation, symbols
+ *   and line breaks (see utf8.h)
  * - Preserves original case and punctuation in original_word field
  * - Normalizes words for dictionary lookup in word field
  * - Tracks line numbers and character positions
  * - Handles various text encodings and line endings
+ * - No maximum line length; lines containing control characters or malformed UTF-8 are skipped
  * 
  * @param filename Path to text file to process (must not be NULL)
  * @return Pointer to TextDocument structure, or NULL on error (file not found, memory allocation failure)
@@ -122,7 +259,7 @@ bool load_dictionary(const char* filename, Trie* trie);
  * @post Caller must call free_text_document() on returned pointer
  * 
  * Time Complexity: O(n) where n = file size in characters
- * Space Complexity: O(w) where w = number of words in the file
+ * Space Complexity: O(n + w) where w = number of words in the file
  * 
  * Example:
  * @code
@@ -135,6 +272,103 @@ bool load_dictionary(const char* filename, Trie* trie);
  */
 TextDocument* load_text_file(const char* filename);
 
+/**
+ * @brief Estimate the memory load_text_file() would use for a file
+ *
+ * The text and normalized-word blocks are counted exactly from the file size;
+ * the token array is assumed to need one slot per 4 bytes, which covers prose
+ * and the doubling slack of the array. Lets callers decide between loading a
+ * file whole and streaming it under a MEMORY_COMPONENT_DOCUMENTS budget.
+ *
+ * @param filename Path to the text file
+ * @return Estimated bytes, or 0 if the file cannot be examined
+ */
+size_t estimate_text_file_memory(const char* filename);
+
+/**
+ * @brief Load and tokenize a text file without printing anything
+ * 
+ * Same as load_text_file(), except that neither errors nor skipped lines
+ * are reported. Meant for callers that load many files at once, such as
+ * spell_check_batch(), and report failures themselves.
+ * 
+ * @param filename Path to text file to process (must not be NULL)
+ * @return Pointer to TextDocument structure, or NULL on error (file not found, read error, memory allocation failure)
+ * 
+ * @post Caller must call free_text_document() on returned pointer
+ */
+TextDocument* load_text_file_quiet(const char* filename);
+
+/**
+ * @brief Tokenize text already in memory
+ * 
+ * Same tokenization as load_text_file() for text received some other way,
+ * such as the body of a network request. The text is copied, so the
+ * caller keeps ownership of its buffer. Nothing is printed; lines with
+ * control characters or malformed UTF-8 are skipped silently. The document's filename
+ * is NULL.
+ * 
+ * @param text Text to tokenize (need not be NUL-terminated)
+ * @param size Length of text in bytes
+ * @return Pointer to TextDocument structure, or NULL on error (NULL text, memory allocation failure)
+ * 
+ * @post Caller must call free_text_document() on returned pointer
+ * 
+ * Time Complexity: O(n) where n = size
+ * Space Complexity: O(n + w) where w = number of words in the text
+ */
+TextDocument* load_text_buffer(const char* text, size_t size);
+
+/**
+ * @brief Tokenize a text file in fixed-size chunks, one callback per token
+ * 
+ * Streaming counterpart of load_text_file(): the file is read in blocks of
+ * STREAM_CHUNK_SIZE bytes and every valid token is handed to the callback
+ * as soon as its end is seen. Memory use is bounded by the chunk size and
+ * the longest token, independent of file and line length; there is no
+ * maximum line length.
+ * 
+ * Tokenization Rules: same word boundaries, normalization, validation,
+ * line numbers and positions as load_text_file(). Lines are not buffered,
+ * so instead of skipping a whole line containing control characters or malformed UTF-8,
+ * only tokens containing them are skipped.
+ * 
+ * @param filename Path to text file to process (must not be NULL)
+ * @param callback Function called for each valid token (must not be NULL)
+ * @param user_data Pointer passed through to the callback
+ * @return true if the file was read to the end or the callback stopped early, false on error
+ * 
+ * Time Complexity: O(n) where n = file size in characters
+ * Space Complexity: O(1) - one chunk buffer plus one token buffer
+ * 
+ * Example:
+ * @code
+ * static bool print_token(const TextToken* token, void* user_data) {
+ *     printf("%d:%d %s\n", token->line_number, token->position, token->word);
+ *     return true;
+ * }
+ * stream_text_file("huge_corpus.txt", print_token, NULL);
+ * @endcode
+ */
+bool stream_text_file(const char* filename, TokenCallback callback, void* user_data);
+
+/**
+ * @brief Normalize a word into a caller-provided buffer without allocating
+ * 
+ * Applies the same rules as normalize_word() to the first len bytes of
+ * word, writing the NUL-terminated result to out.
+ * 
+ * @param word Original word (need not be NUL-terminated)
+ * @param len Number of bytes of word to normalize
+ * @param out Output buffer
+ * @param out_size Size of the output buffer (at least len + 1 to never truncate)
+ * @return Length of the normalized word, or 0 if the word is rejected
+ * 
+ * Time Complexity: O(m) where m = word length
+ * Space Complexity: O(1)
+ */
+size_t normalize_word_into(const char* word, size_t len, char* out, size_t out_size);
+
 /**
  * @brief Normalize word by converting to lowercase and removing punctuation
  * 
@@ -143,7 +377,7 @@ TextDocument* load_text_file(const char* filename);
  * out non-alphabetic characters while preserving the core word.
  * 
  * Normalization Rules:
- * - Convert to lowercase (A-Z → a-z)
+ * - Convert to lowercase (A-Z → a-z, and non-ASCII letters as utf8_to_lower() does)
  * - Remove leading/trailing punctuation
  * - Remove internal non-alphabetic characters
  * - Preserve apostrophes in contractions (don't → dont)
@@ -175,8 +409,9 @@ char* normalize_word(const char* word);
  * Filters out numbers, URLs, email addresses, and other non-word tokens.
  * 
  * Validation Criteria:
- * - Contains at least one alphabetic character
- * - Length between 1 and 50 characters
+ * - Contains only letters (utf8_is_letter()) in well-formed UTF-8
+ * - Length between 2 and 50 characters and at most TRIE_MAX_WORD_LENGTH bytes
+ * - No character repeated more than three times in a row
  * - Not purely numeric
  * - Not a URL or email address
  * - Not excessive punctuation
@@ -203,20 +438,53 @@ bool is_valid_word(const char* word);
 /**
  * @brief Free all memory associated with a TextDocument
  * 
- * Recursively frees all memory allocated for a TextDocument including
- * all tokens, strings, and the document structure itself. Safe to call
- * with NULL pointer.
+ * Frees the token array, the text and words blocks the tokens point into,
+ * and the document structure itself. Safe to call with NULL pointer.
  * 
  * @param doc Pointer to TextDocument to free (can be NULL)
  * 
  * @post All memory associated with doc is freed
  * @post doc pointer becomes invalid
  * 
- * Time Complexity: O(n) where n = number of tokens
+ * Time Complexity: O(1)
  * Space Complexity: O(1)
  * 
  * @note Safe to call with NULL pointer (no-op)
  */
 void free_text_document(TextDocument* doc);
 
+/**
+ * @brief Collect the input files of a batch
+ * 
+ * A directory is searched recursively and the regular files below it are
+ * returned sorted by path. Any other path is read as a list of files, one
+ * per line; surrounding whitespace and blank lines are ignored and the
+ * files keep the order of the list.
+ * 
+ * @param path Directory or list file (must not be NULL)
+ * @param count Receives the number of files (must not be NULL)
+ * @return Newly allocated array of newly allocated paths, or NULL on error (cannot open path, no files, memory allocation failure)
+ * 
+ * @post Caller must call free_file_list() on the returned array
+ * 
+ * Example:
+ * @code
+ * int count;
+ * char** files = list_batch_files("corpus/", &count);
+ * if (files) {
+ *     printf("%d files, first %s\n", count, files[0]);
+ *     free_file_list(files, count);
+ * }
+ * @endcode
+ */
+char** list_batch_files(const char* path, int* count);
+
+/**
+ * @brief Free a list returned by list_batch_files()
+ * 
+ * @param files File list (can be NULL)
+ * @param count Number of files in the list
+ */
+void free_file_list(char** files, int count);
+
 #endif // FILE_IO_H
\ No newline at end of file
@@ -0,0 +1,113 @@
+#ifndef LENGTH_INDEX_H
+#define LENGTH_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "trie.h"
+
+/**
+ * @file length_index.h
+ * @brief Length-partitioned word list with letter signatures for filtered scans
+ *
+ * Two cheap necessary conditions hold for any two words within edit
+ * distance k:
+ *
+ * - Their lengths differ by at most k, since only insertions and deletions
+ *   change the length.
+ * - Their letter-presence signatures differ by at most k bits in each
+ *   direction. A signature has one bit per letter a-z (bytes >= 0x80 share
+ *   the remaining six bits), and an edit adds at most one letter and
+ *   removes at most one, so at most k letters of one word can be missing
+ *   from the other.
+ *
+ * The index groups the dictionary's words by length and keeps their
+ * signatures in one dense array. A lookup only visits the 2k + 1 length
+ * buckets around the query, rejects most of their words with two popcounts
+ * over that array, and verifies the survivors exactly with
+ * edit_distance_batch_within(). It costs a few bytes per word, against the
+ * C(L, k) deletes per word of a symmetric-delete index (see symspell.h).
+ *
+ * Results match trie_fuzzy_search() exactly: all words within the bound,
+ * ordered by distance and then alphabetically.
+ *
+ * Usage Example:
+ * @code
+ * LengthIndex* index = length_index_build(dictionary);
+ * TrieMatch matches[5];
+ * int found = length_index_lookup(index, "helo", 2, matches, 5);
+ * length_index_destroy(index);
+ * @endcode
+ */
+
+/**
+ * @brief Opaque length-partitioned index
+ */
+typedef struct LengthIndex LengthIndex;
+
+/**
+ * @brief Compute the letter-presence signature of a word
+ *
+ * Bit c - 'a' is set for every letter c of the word (ASCII letters are
+ * folded); bytes >= 0x80 set one of bits 26..31.
+ *
+ * @param word Word bytes
+ * @param length Length of the word
+ * @return Signature (0 for an empty word)
+ */
+uint32_t length_index_signature(const char* word, size_t length);
+
+/**
+ * @brief Build the index over every word of a dictionary
+ *
+ * Works with every Trie layout. The index keeps its own copy of the words,
+ * so the Trie may change or be destroyed afterwards (the index then
+ * describes the old contents).
+ *
+ * @param trie Fully loaded dictionary (must not be NULL)
+ * @return New index, or NULL on error (NULL parameter, memory allocation failure)
+ *
+ * @post Caller must call length_index_destroy() on the returned pointer
+ *
+ * Time Complexity: O(N * L) where N is the number of words, L the average length
+ * Space Complexity: O(N * L) for the word copies plus 12 bytes per word
+ */
+LengthIndex* length_index_build(Trie* trie);
+
+/**
+ * @brief Find dictionary words within a bounded edit distance of a query
+ *
+ * Same contract and result ordering as trie_fuzzy_search().
+ *
+ * @param index Index built by length_index_build()
+ * @param word Query word (at most TRIE_MAX_WORD_LENGTH characters)
+ * @param max_distance Maximum edit distance (>= 0)
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer
+ * @return Number of matches written, or 0 on error
+ *
+ * @note Thread-safe: lookups only read the index
+ *
+ * Time Complexity: O(B + C * n) where B is the number of words in the visited
+ *                  length buckets, C the number passing the signature test and
+ *                  n the candidate length
+ */
+int length_index_lookup(const LengthIndex* index, const char* word, int max_distance,
+                        TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Get exact memory usage of the index in bytes
+ *
+ * @param index Index (can be NULL)
+ * @return Bytes allocated by the index, or 0 if NULL
+ */
+size_t length_index_get_memory_usage(const LengthIndex* index);
+
+/**
+ * @brief Destroy an index and free all its memory
+ *
+ * @param index Index to destroy (can be NULL)
+ */
+void length_index_destroy(LengthIndex* index);
+
+#endif // LENGTH_INDEX_H
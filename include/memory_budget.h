@@ -0,0 +1,142 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file memory_budget.h
+ * @brief Process-wide live and peak byte counts per component, with limits
+ *
+ * Each structure already knows its exact size (trie_get_memory_usage(),
+ * SpellCheckResult::memory_used, ...). The owners charge those bytes to
+ * their component when they allocate and release them when they free, so
+ * the counters always show how much every part of the checker holds right
+ * now and the most it has held at once, summed over all instances and
+ * threads.
+ *
+ * A limit set on a component is a budget the component's users consult
+ * before growing it:
+ * - MEMORY_COMPONENT_CACHES: a check resets its word cache once the
+ *   caches are over budget, like a cache that reached its word limit
+ * - MEMORY_COMPONENT_DOCUMENTS: the command line checks a file that would
+ *   not fit in streaming mode instead of loading it whole
+ * - MEMORY_COMPONENT_RESULTS: a finished check keeps its errors' suggestions
+ *   only while they fit, then only the errors, then drops the rest, with a
+ *   warning
+ * The dictionary and index are sized by the word list alone and take no
+ * budget (see memory_component_has_budget()).
+ *
+ * Counters are updated atomically and cost one uncontended atomic add per
+ * allocation they follow (arena chunks, cache entries, whole results), not
+ * per byte or per token.
+ *
+ * Usage Example:
+ * @code
+ * memory_set_limit(MEMORY_COMPONENT_CACHES, 8 * 1024 * 1024);
+ * SpellCheckResult* result = spell_check_document(doc, dictionary);
+ * printf("Peak cache bytes: %zu\n", memory_get_peak(MEMORY_COMPONENT_CACHES));
+ * @endcode
+ */
+
+/**
+ * @brief Parts of the checker whose memory is accounted
+ */
+typedef enum MemoryComponent {
+    MEMORY_COMPONENT_DICTIONARY,    ///< Trie nodes, compact image, DAWG and exact lookup table
+    MEMORY_COMPONENT_INDEX,         ///< Suggestion engine index (symspell or scan) and the context model
+    MEMORY_COMPONENT_DOCUMENTS,     ///< Loaded TextDocuments: text, normalized words and tokens
+    MEMORY_COMPONENT_RESULTS,       ///< SpellCheckResults: errors and their suggestion strings
+    MEMORY_COMPONENT_CACHES,        ///< Per-check word caches of lookup outcomes and suggestions
+    MEMORY_COMPONENT_COUNT
+} MemoryComponent;
+
+/**
+ * @brief Record bytes allocated by a component
+ *
+ * @param component Component holding the bytes
+ * @param bytes Number of bytes allocated
+ *
+ * @note Thread-safe
+ */
+void memory_charge(MemoryComponent component, size_t bytes);
+
+/**
+ * @brief Record bytes freed by a component
+ *
+ * @param component Component that held the bytes
+ * @param bytes Number of bytes freed (previously charged)
+ *
+ * @note Thread-safe
+ */
+void memory_release(MemoryComponent component, size_t bytes);
+
+/**
+ * @brief Get the bytes a component holds right now
+ */
+size_t memory_get_live(MemoryComponent component);
+
+/**
+ * @brief Get the most bytes a component has held at once
+ */
+size_t memory_get_peak(MemoryComponent component);
+
+/**
+ * @brief Get the bytes held by all components together right now
+ */
+size_t memory_get_total_live(void);
+
+/**
+ * @brief Get the most bytes all components have held together at once
+ */
+size_t memory_get_total_peak(void);
+
+/**
+ * @brief Check whether a component's users enforce a budget on it
+ *
+ * @return true for documents, results and caches
+ */
+bool memory_component_has_budget(MemoryComponent component);
+
+/**
+ * @brief Set the budget of a component
+ *
+ * @param component Component to limit
+ * @param bytes Budget in bytes (0 = unlimited, the default)
+ * @return true if set, false if the component takes no budget
+ *
+ * @note Not synchronized with running checks; set limits before checking
+ */
+bool memory_set_limit(MemoryComponent component, size_t bytes);
+
+/**
+ * @brief Get the budget of a component
+ *
+ * @return Budget in bytes, or 0 if unlimited
+ */
+size_t memory_get_limit(MemoryComponent component);
+
+/**
+ * @brief Check whether adding bytes to a component would exceed its budget
+ *
+ * @param component Component to grow
+ * @param bytes Bytes about to be allocated
+ * @return true if the component has a budget and live + bytes is over it
+ */
+bool memory_would_exceed(MemoryComponent component, size_t bytes);
+
+/**
+ * @brief Get the short name of a component ("dictionary", "index", "documents", "results", "caches")
+ */
+const char* memory_component_name(MemoryComponent component);
+
+/**
+ * @brief Parse a byte count with an optional K, M or G suffix (powers of 1024)
+ *
+ * @param text Text such as "512", "64K", "8M" or "2G"
+ * @param bytes Receives the byte count
+ * @return true if the text is a valid size, false otherwise (including NULL parameters)
+ */
+bool memory_parse_size(const char* text, size_t* bytes);
+
+#endif // MEMORY_BUDGET_H
@@ -0,0 +1,258 @@
+#ifndef NGRAM_MODEL_H
+#define NGRAM_MODEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "file_io.h"
+
+/**
+ * @file ngram_model.h
+ * @brief Compressed word n-gram counts for scoring words in their context
+ *
+ * The model holds the counts of every word, word pair and word triple of a
+ * training corpus, tokenized and normalized exactly like checked documents,
+ * with a sentence boundary marker (NGRAM_BOUNDARY) around each sentence.
+ * No strings are stored: an n-gram is a 64-bit hash of its words, kept as a
+ * 32-bit fingerprint in an open-addressing table, and its count is
+ * quantized to one byte on a log2 scale (1/8 steps, about 4% error). Five
+ * bytes per n-gram keep the model small enough to stay cached.
+ *
+ * A compiled model is a header followed by the table, loaded by
+ * memory-mapping it (see ngram_model_load()), like a compiled dictionary.
+ *
+ * Scores use stupid backoff: a trigram's probability is its count over the
+ * count of its first two words, falling back to 0.4 times the bigram
+ * estimate, then 0.16 times the unigram one when the longer n-gram was
+ * never seen.
+ *
+ * Usage Example:
+ * @code
+ * NgramModel* model = ngram_model_build("corpus.txt");
+ * ngram_model_save(model, "corpus.ngm");
+ * ngram_model_destroy(model);
+ *
+ * model = ngram_model_load("corpus.ngm");
+ * uint64_t window[NGRAM_WINDOW] = { ... };  // ngram_word_hash() of 5 consecutive words
+ * float score;
+ * ngram_model_score_batch(model, window, 1, &score);
+ * @endcode
+ */
+
+/**
+ * Longest n-gram stored
+ */
+#define NGRAM_MAX_ORDER 3
+
+/**
+ * Words in a scoring window: two on each side of the scored word
+ */
+#define NGRAM_WINDOW 5
+
+/**
+ * Pseudo-word marking the start and end of a sentence
+ */
+#define NGRAM_BOUNDARY "<s>"
+
+/**
+ * Value of an n-gram lookup that found nothing
+ */
+#define NGRAM_ABSENT (-1.0f)
+
+/**
+ * @brief Opaque n-gram model
+ */
+typedef struct NgramModel NgramModel;
+
+/**
+ * Hash of the empty word, the start of ngram_word_hash_extend() chains
+ */
+#define NGRAM_WORD_HASH_SEED 14695981039346656037ULL
+
+/**
+ * @brief Hash a normalized word
+ *
+ * @param word Word bytes
+ * @param length Number of bytes
+ * @return 64-bit hash used for the word in n-gram keys
+ */
+uint64_t ngram_word_hash(const char* word, size_t length);
+
+/**
+ * @brief Extend the hash of a word's first bytes with the bytes that follow
+ *
+ * ngram_word_hash(w, n) equals ngram_word_hash_extend(NGRAM_WORD_HASH_SEED, w, n),
+ * and hashing can resume at any point, so words sharing a prefix (the
+ * edits of one word) only hash the prefix once.
+ *
+ * @param hash Hash of the bytes so far
+ * @param bytes Bytes to append
+ * @param length Number of bytes
+ * @return Hash of the longer word
+ */
+uint64_t ngram_word_hash_extend(uint64_t hash, const char* bytes, size_t length);
+
+/**
+ * @brief Combine word hashes into the key of an n-gram
+ *
+ * @param word_hashes Hashes of the n-gram's words, in order
+ * @param order Number of words (1 to NGRAM_MAX_ORDER)
+ * @return Key of the n-gram
+ */
+uint64_t ngram_key(const uint64_t* word_hashes, int order);
+
+/**
+ * @brief Check whether a token of a document starts a sentence
+ *
+ * A sentence starts at the first token, after a '.', '!' or '?' between
+ * the previous token and this one, and after a blank line.
+ *
+ * @param doc Tokenized document
+ * @param index Index of the token in doc->tokens
+ * @return true if the token starts a new sentence
+ */
+bool ngram_is_sentence_start(const TextDocument* doc, int index);
+
+/**
+ * @brief Count the n-grams of a text corpus into a new model
+ *
+ * The corpus is loaded with load_text_file(), since sentence boundaries
+ * are found in the text between tokens, and freed once counted.
+ *
+ * @param corpus_filename Path to the training text
+ * @return New model, or NULL on error (file not found, memory allocation failure)
+ *
+ * @post Caller must call ngram_model_destroy() on the returned pointer
+ *
+ * Time Complexity: O(n) where n = corpus size
+ * Space Complexity: O(n + g) where g = number of distinct n-grams
+ */
+NgramModel* ngram_model_build(const char* corpus_filename);
+
+/**
+ * @brief Write a model to a file ngram_model_load() can map
+ *
+ * @param model Model to write
+ * @param filename Path of the compiled model
+ * @return true on success; on failure an error is printed and no file is left behind
+ */
+bool ngram_model_save(const NgramModel* model, const char* filename);
+
+/**
+ * @brief Map a compiled model read-only
+ *
+ * The header and checksum are validated; the table is used in place.
+ *
+ * @param filename Path to a model written by ngram_model_save()
+ * @return New model, or NULL on error (not a model, incompatible or corrupted)
+ *
+ * @post Caller must call ngram_model_destroy() on the returned pointer
+ */
+NgramModel* ngram_model_load(const char* filename);
+
+/**
+ * @brief Check whether a file starts with the compiled model magic
+ *
+ * @param filename Path to check
+ * @return true if the file looks like a compiled model
+ */
+bool ngram_model_is_compiled(const char* filename);
+
+/**
+ * @brief Look up a run of n-gram keys
+ *
+ * Table slots of the whole run are prefetched before any is compared, so
+ * the memory latency of the lookups overlaps.
+ *
+ * @param model Model to query
+ * @param keys Keys from ngram_key()
+ * @param count Number of keys
+ * @param log2_counts Receives the log2 count of each n-gram, or NGRAM_ABSENT
+ */
+void ngram_model_lookup_batch(const NgramModel* model, const uint64_t* keys, int count, float* log2_counts);
+
+/**
+ * @brief Score the middle word of windows of consecutive words
+ *
+ * A window's score is the log2 stupid-backoff probability of the three
+ * trigrams that contain its middle word, so windows differing only in the
+ * middle word compare how well each candidate fits the same context.
+ *
+ * @param model Model to query
+ * @param windows count windows of NGRAM_WINDOW word hashes each
+ * @param count Number of windows
+ * @param scores Receives the score of each window (higher is more likely)
+ *
+ * Time Complexity: O(count) lookups, batched through ngram_model_lookup_batch()
+ */
+void ngram_model_score_batch(const NgramModel* model, const uint64_t* windows, int count, float* scores);
+
+/**
+ * @brief Bound the scores of windows without looking up their trigrams
+ *
+ * A trigram occurs at most as often as the bigram of its last two words,
+ * so the bigrams and unigrams of a window cap its ngram_model_score_batch()
+ * score. Windows whose bound is already too low to matter can be dropped
+ * for the price of their two bigrams with the middle word, as the other
+ * n-grams are shared with every window of the same context.
+ *
+ * @param model Model to query
+ * @param windows count windows of NGRAM_WINDOW word hashes each
+ * @param count Number of windows
+ * @param bounds Receives for each window a value at least its score
+ *
+ * Time Complexity: O(count) lookups, batched through ngram_model_lookup_batch()
+ */
+void ngram_model_bound_batch(const NgramModel* model, const uint64_t* windows, int count, float* bounds);
+
+/**
+ * @brief Score chosen words of a sequence against the two words each side
+ *
+ * scores[j] is the ngram_model_score_batch() score of the window
+ * words[j - 2] to words[j + 2]. Words whose bigrams with both neighbors
+ * were each seen more than 2^screen_log2_count times are taken as fitting
+ * and dropped first, for the price of those bigrams. Overlapping windows
+ * share most of their n-grams, and each is looked up once, so a run of
+ * words scored costs three lookups per word instead of NGRAM_WINDOW
+ * windows' worth.
+ *
+ * @param model Model to query
+ * @param words count word hashes
+ * @param count Number of words
+ * @param screen_log2_count Log2 count both bigrams must exceed for a word to be dropped
+ * @param wanted count flags, the words to score (only 2 to count - 3 can
+ *        be); cleared for the words dropped
+ * @param scores Receives the score of every word left wanted (others are left unset)
+ * @return false on memory allocation failure
+ */
+bool ngram_model_score_sequence(const NgramModel* model, const uint64_t* words, int count, float screen_log2_count,
+                                bool* wanted, float* scores);
+
+/**
+ * @brief Check whether a word occurs in the model
+ */
+bool ngram_model_has_word(const NgramModel* model, uint64_t word_hash);
+
+/**
+ * @brief Get the number of distinct n-grams in the model
+ */
+size_t ngram_model_get_entry_count(const NgramModel* model);
+
+/**
+ * @brief Get the bytes held by the model (heap or mapping)
+ */
+size_t ngram_model_get_memory_usage(const NgramModel* model);
+
+/**
+ * @brief Get the size in bytes of the file ngram_model_save() writes for the model
+ */
+size_t ngram_model_get_file_size(const NgramModel* model);
+
+/**
+ * @brief Free a model or unmap a loaded one
+ *
+ * @param model Model to destroy (can be NULL)
+ */
+void ngram_model_destroy(NgramModel* model);
+
+#endif // NGRAM_MODEL_H
@@ -0,0 +1,130 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "spell_check.h"
+
+/**
+ * @file output_writer.h
+ * @brief Buffered machine-readable report writers (JSON Lines, CSV, binary)
+ *
+ * The human-readable report formats every error through printf, which
+ * costs a format-string parse per field and suits tools poorly. A writer
+ * encodes errors straight from SpellError and SpellCheckResult into its
+ * own buffer and hands the file whole blocks, so a large batch costs a
+ * handful of write calls.
+ *
+ * A report is a sequence of error records, each document's errors followed
+ * by that document's summary record, so streaming checks can write errors
+ * as they are found:
+ *
+ * - JSON Lines: one object per line,
+ *   {"type":"error","document":"a.txt","line":3,"position":5,"word":"teh",
+ *    "original":"Teh,","suggestions":["the","ten"]} ("context":true is added
+ *   for a dictionary word unlikely in its context) and
+ *   {"type":"summary","document":"a.txt","words_checked":120,"errors":1,"failed":false}
+ * - CSV: a header row and one row per error (document, line, position,
+ *   word, original, suggestions joined by ';'); summaries are not written
+ * - Binary: the magic "SPCB" and a version byte, then tagged records with
+ *   little-endian fixed-width integers and length-prefixed strings (see
+ *   output_writer.c)
+ *
+ * Usage Example:
+ * @code
+ * OutputWriter* writer = output_writer_open("report.jsonl", OUTPUT_FORMAT_JSONL);
+ * output_writer_write_result(writer, "input.txt", result);
+ * if (!output_writer_close(writer)) {
+ *     fprintf(stderr, "Error: Failed to write report\n");
+ * }
+ * @endcode
+ */
+
+/**
+ * @brief Report formats
+ */
+typedef enum OutputFormat {
+    OUTPUT_FORMAT_TEXT,     ///< Human-readable report printed by the caller (no writer)
+    OUTPUT_FORMAT_JSONL,    ///< One JSON object per line
+    OUTPUT_FORMAT_CSV,      ///< RFC 4180 rows, errors only
+    OUTPUT_FORMAT_BINARY    ///< Compact tagged records
+} OutputFormat;
+
+/**
+ * @brief Opaque buffered writer
+ */
+typedef struct OutputWriter OutputWriter;
+
+/**
+ * @brief Parse a format name
+ *
+ * @param name One of "text", "jsonl", "csv" or "binary"
+ * @param format Receives the format
+ * @return true if the name is known, false otherwise (including NULL parameters)
+ */
+bool output_format_parse(const char* name, OutputFormat* format);
+
+/**
+ * @brief Open a writer
+ *
+ * Writes the format's header (CSV header row, binary magic) right away.
+ *
+ * @param path File to create, or NULL or "-" for standard output
+ * @param format OUTPUT_FORMAT_JSONL, OUTPUT_FORMAT_CSV or OUTPUT_FORMAT_BINARY
+ * @return New writer, or NULL on error (text format, file cannot be created, memory allocation failure)
+ *
+ * @post Caller must call output_writer_close() on the returned pointer
+ */
+OutputWriter* output_writer_open(const char* path, OutputFormat format);
+
+/**
+ * @brief Write one error record
+ *
+ * @param writer Writer from output_writer_open()
+ * @param document Name of the checked document
+ * @param error Error to write
+ * @return false once any write has failed (the writer then drops further records)
+ */
+bool output_writer_write_error(OutputWriter* writer, const char* document, const SpellError* error);
+
+/**
+ * @brief Write the summary record of a document
+ *
+ * @param writer Writer from output_writer_open()
+ * @param document Name of the checked document
+ * @param result Counts of the check (its errors are not written), or NULL if the document failed
+ * @return false once any write has failed
+ */
+bool output_writer_write_summary(OutputWriter* writer, const char* document, const SpellCheckResult* result);
+
+/**
+ * @brief Write every error of a result followed by its summary
+ *
+ * @param writer Writer from output_writer_open()
+ * @param document Name of the checked document
+ * @param result Result of the check, or NULL if the document failed
+ * @return false once any write has failed
+ *
+ * Time Complexity: O(B) where B is the size of the encoded records
+ */
+bool output_writer_write_result(OutputWriter* writer, const char* document, const SpellCheckResult* result);
+
+/**
+ * @brief Push buffered records to the file
+ *
+ * @param writer Writer from output_writer_open()
+ * @return false once any write has failed
+ */
+bool output_writer_flush(OutputWriter* writer);
+
+/**
+ * @brief Flush and close a writer
+ *
+ * Standard output is flushed but left open.
+ *
+ * @param writer Writer to close (can be NULL)
+ * @return true if every record was written, false otherwise
+ */
+bool output_writer_close(OutputWriter* writer);
+
+#endif // OUTPUT_WRITER_H
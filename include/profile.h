@@ -0,0 +1,117 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @file profile.h
+ * @brief Opt-in hot-path counters and timers
+ *
+ * The search and distance kernels count the work they do (trie nodes
+ * visited, DP cells computed, allocations) into per-thread counters, and
+ * the spell checker brackets its stages with monotonic timers. Both are
+ * inert until profile_set_enabled(true): a disabled counter costs one
+ * predictable branch on a global flag, and a disabled timer is never read.
+ * Defining SPELL_CHECK_NO_PROFILE at build time removes them entirely.
+ *
+ * Counters are thread-local, so parallel checks never contend on them;
+ * callers take a snapshot with profile_read_counters() before and after
+ * a piece of work on the same thread and keep the difference.
+ *
+ * Usage Example:
+ * @code
+ * profile_set_enabled(true);
+ * SpellCheckResult* result = spell_check_document(doc, dictionary);
+ * printf("DP cells: %llu\n", result->profile.dp_cells);
+ * @endcode
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PROFILE_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define PROFILE_THREAD_LOCAL __declspec(thread)
+#else
+#define PROFILE_THREAD_LOCAL
+#endif
+
+/**
+ * @brief Work counters of one thread
+ */
+typedef struct ProfileCounters {
+    unsigned long long trie_nodes_visited;  ///< Trie nodes entered by lookups and fuzzy walks
+    unsigned long long dp_cells;            ///< Edit distance cells computed (bit-parallel columns count m cells)
+    unsigned long long allocations;         ///< Heap allocations made while checking
+    unsigned long long allocated_bytes;     ///< Bytes requested by those allocations
+} ProfileCounters;
+
+/**
+ * @brief Whether profiling is on (read through PROFILE_ENABLED())
+ */
+extern bool g_profile_enabled;
+
+/**
+ * @brief Counters of the calling thread (updated through PROFILE_COUNT())
+ */
+extern PROFILE_THREAD_LOCAL ProfileCounters g_profile_counters;
+
+#ifdef SPELL_CHECK_NO_PROFILE
+#define PROFILE_ENABLED() 0
+#define PROFILE_COUNT(counter, amount) ((void)0)
+#define PROFILE_ALLOCATION(bytes) ((void)0)
+#else
+/**
+ * @brief true when profiling is on
+ */
+#define PROFILE_ENABLED() (g_profile_enabled)
+
+/**
+ * @brief Add amount to one of the calling thread's counters
+ */
+#define PROFILE_COUNT(counter, amount) \
+    do { if (g_profile_enabled) g_profile_counters.counter += (unsigned long long)(amount); } while (0)
+
+/**
+ * @brief Count one heap allocation of the given size
+ */
+#define PROFILE_ALLOCATION(bytes) \
+    do { \
+        if (g_profile_enabled) { \
+            g_profile_counters.allocations++; \
+            g_profile_counters.allocated_bytes += (unsigned long long)(bytes); \
+        } \
+    } while (0)
+#endif
+
+/**
+ * @brief Turn profiling on or off for the whole process
+ *
+ * @param enabled Whether counters and timers should record
+ *
+ * @note Set it before starting work; counters of work already in flight
+ *       are incomplete
+ */
+void profile_set_enabled(bool enabled);
+
+/**
+ * @brief Check whether profiling is on
+ *
+ * @return true if profile_set_enabled(true) was called (and profiling is compiled in)
+ */
+bool profile_is_enabled(void);
+
+/**
+ * @brief Snapshot the calling thread's counters
+ *
+ * @return Copy of the counters accumulated on this thread so far
+ */
+ProfileCounters profile_read_counters(void);
+
+/**
+ * @brief Read the stage timer clock
+ *
+ * @return timing_now_seconds() while profiling, 0 otherwise
+ */
+double profile_clock(void);
+
+#endif // PROFILE_H
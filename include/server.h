@@ -0,0 +1,78 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "dictionary_handle.h"
+
+/**
+ * @file server.h
+ * @brief Long-running HTTP spell check service
+ *
+ * Loads nothing itself: the caller opens a DictionaryHandle once, and every
+ * request is checked against its current version, so a request costs one
+ * JSON parse plus one spell check, never a process start or dictionary load.
+ * Dictionary reloads (see dictionary_handle.h) are picked up between
+ * requests without restarting.
+ *
+ * A fixed pool of worker threads accepts connections on one listening
+ * socket. Each worker owns a DictionaryReader and serves one connection at
+ * a time, keeping HTTP/1.1 connections alive between requests.
+ *
+ * Endpoints (all responses are JSON and allow cross-origin requests):
+ * - POST /check  - body {"texts": ["first text", "second text"]} (or
+ *                  {"text": "..."}); returns one result per text:
+ * @code
+ * {"generation": 3, "results": [
+ *   {"words_checked": 4, "error_count": 1, "errors": [
+ *     {"word": "wrold", "original": "wrold", "line": 1, "position": 6,
+ *      "suggestions": [{"word": "world", "score": 0.5}, ...]}]}]}
+ * @endcode
+ *   With a context model (see set_context_model()), a dictionary word
+ *   unlikely in its context also carries "context": true.
+ * - GET /health  - {"status": "ok", "generation": 3}
+ * - POST /reload - asks the dictionary watcher to reload now (202)
+ */
+
+/**
+ * @brief Default TCP port for server_run()
+ */
+#define SERVER_DEFAULT_PORT 8080
+
+/**
+ * @brief Largest request body accepted; larger requests get 413
+ */
+#define SERVER_MAX_BODY_BYTES (8 * 1024 * 1024)
+
+/**
+ * @brief Settings for server_run()
+ */
+typedef struct ServerConfig {
+    const char* bind_address;       ///< IPv4 address to listen on (NULL for 127.0.0.1)
+    int port;                       ///< TCP port to listen on
+    int thread_count;               ///< Worker threads, i.e. connections served at once (>= 1)
+    DictionaryHandle* dictionary;   ///< Dictionary to check against (must not be NULL)
+} ServerConfig;
+
+/**
+ * @brief Serve spell check requests until stopped
+ *
+ * Installs SIGINT/SIGTERM handlers that call server_stop(), then blocks
+ * until the server is stopped and every worker has finished its current
+ * request.
+ *
+ * @param config Server settings
+ * @return true after a clean stop, false if the server could not start
+ *         (invalid settings, address in use, thread creation failure)
+ */
+bool server_run(const ServerConfig* config);
+
+/**
+ * @brief Ask a running server_run() to return
+ *
+ * Stops accepting connections; requests in progress are completed.
+ * Safe to call from a signal handler.
+ */
+void server_stop(void);
+
+#endif // SERVER_H
@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include "trie.h"
 #include "file_io.h"
+#include "ngram_model.h"
 
 /**
  * Structure representing a single spelling error
@@ -14,11 +15,30 @@ typedef struct SpellError {
     char* original_word;        // Original word with case/punctuation
     int line_number;            // Line number where error was found
     int position;               // Position within the line
-    char** suggestions;         // Array of suggested corrections
-    float* suggestion_scores;   // Scores for each suggestion
+    char** suggestions;         // Array of suggested corrections, best first
+    float* suggestion_scores;   // Ranking cost of each suggestion (lower is better)
     int suggestion_count;       // Number of suggestions
+    bool context_error;         // A dictionary word its context makes unlikely (see set_context_model())
 } SpellError;
 
+/**
+ * Per-stage costs of one check, recorded while profiling is enabled
+ * (see profile.h) and zero otherwise. Stage times are summed over worker
+ * threads, so with several threads they can exceed processing_time.
+ */
+typedef struct SpellCheckProfile {
+    double tokenize_seconds;    // Splitting the input into tokens
+    double lookup_seconds;      // Dictionary lookups of words not yet cached
+    double suggestion_seconds;  // Generating suggestions for misspellings
+    double api_seconds;         // Validating unknown words through the API
+    double context_seconds;     // Scoring dictionary words against their context
+    int suggestion_calls;       // Misspellings suggestions were generated for
+    unsigned long long trie_nodes_visited; // Trie nodes entered by lookups and fuzzy search
+    unsigned long long dp_cells;           // Edit distance cells computed
+    unsigned long long allocations;        // Heap allocations made by the checker
+    unsigned long long allocated_bytes;    // Bytes requested by those allocations
+} SpellCheckProfile;
+
 /**
  * Structure containing spell check results
  */
@@ -26,20 +46,241 @@ typedef struct SpellCheckResult {
     SpellError* errors;         // Array of spelling errors
     int error_count;            // Number of errors found
     int total_words_checked;    // Total words processed
-    double processing_time;     // Time taken (simplified)
-    size_t memory_used;         // Memory used (simplified)
+    double processing_time;     // Wall-clock seconds spent checking
+    size_t memory_used;         // Bytes held by the result, its errors and their suggestions
+    int cache_hits;             // Words answered from the per-run word cache
+    int cache_misses;           // Unique words that needed a dictionary lookup
+    SpellCheckProfile profile;  // Stage timings and work counters (profiling only)
 } SpellCheckResult;
 
 /**
- * Perform spell checking on a text document
+ * Perform spell checking on a text document.
+ * Lookup outcomes and suggestions are memoized per normalized word for the
+ * duration of the call, so repeated words cost a single hash probe.
  */
 SpellCheckResult* spell_check_document(TextDocument* doc, Trie* dictionary);
 
 /**
- * Generate spelling suggestions for a misspelled word
+ * Perform spell checking with the tokens split across thread_count workers.
+ * The dictionary is only read, so it is shared by all threads; each worker
+ * fills its own error buffer and the buffers are merged in token order, so
+ * the result is identical to spell_check_document().
+ */
+SpellCheckResult* spell_check_document_parallel(TextDocument* doc, Trie* dictionary, int thread_count);
+
+/**
+ * Callback receiving each spelling error found by spell_check_stream().
+ * The error and its strings are only valid during the call; copy what you
+ * need. Return false to stop checking early.
+ */
+typedef bool (*SpellErrorCallback)(const SpellError* error, void* user_data);
+
+/**
+ * Spell check a file without loading it into a TextDocument. The file is
+ * tokenized in fixed-size chunks (see stream_text_file()) and each error
+ * is passed to callback as soon as it is found, so memory stays bounded
+ * regardless of file size. If summary is not NULL it receives the counts
+ * of the run (its errors array is left NULL). Returns false if the file
+ * cannot be read. The context model (see set_context_model()) is not
+ * applied: a token is checked before the words after it are read.
+ */
+bool spell_check_stream(const char* filename, Trie* dictionary,
+                        SpellErrorCallback callback, void* user_data, SpellCheckResult* summary);
+
+/**
+ * One document of a spell_check_batch() run, handed to its callback
+ */
+typedef struct SpellCheckBatchItem {
+    int index;                  // Position of the document in the input list
+    const char* filename;       // Path as given in the input list
+    SpellCheckResult* result;   // Errors and stats, NULL if the file could not be read or checked
+    int token_count;            // Tokens in the document
+    size_t bytes;               // Size of the document in bytes
+    double load_seconds;        // Reading and tokenizing the file
+} SpellCheckBatchItem;
+
+/**
+ * Callback receiving each document of a batch, in input order. The item
+ * and its result are only valid during the call; copy what you need.
+ * Calls never overlap. Return false to stop the batch early.
+ */
+typedef bool (*SpellBatchCallback)(const SpellCheckBatchItem* item, void* user_data);
+
+/**
+ * Totals of a spell_check_batch() run
+ */
+typedef struct SpellCheckBatchSummary {
+    int documents_checked;      // Documents read and checked
+    int documents_failed;       // Documents that could not be read or checked
+    int total_words_checked;    // Words checked over all documents
+    int total_errors;           // Errors found over all documents
+    double elapsed_seconds;     // Wall-clock seconds for the whole batch
+    int tasks_run;              // Load and check tasks executed by the pool
+    int tasks_stolen;           // Check tasks a worker took from another worker's queue
+} SpellCheckBatchSummary;
+
+/**
+ * Spell check many files against one shared dictionary. thread_count
+ * workers (the calling thread included) each keep a double-ended queue of
+ * check tasks. A worker with an empty queue steals the oldest task from
+ * another worker, and only when there is nothing to steal does it read
+ * and tokenize the next file. Documents above a few thousand tokens are
+ * split into several check tasks, so a large file is checked by every
+ * idle worker instead of stalling the rest. Each document's result is
+ * identical to spell_check_document(). Results are passed to callback in
+ * input order as soon as all earlier documents are done, then freed. If
+ * summary is not NULL it receives the totals. Returns false on invalid
+ * parameters or if the pool cannot be set up; unreadable files are
+ * reported through the callback rather than failing the batch.
+ */
+bool spell_check_batch(const char* const* filenames, int file_count, Trie* dictionary, int thread_count,
+                       SpellBatchCallback callback, void* user_data, SpellCheckBatchSummary* summary);
+
+/**
+ * Incremental spell checking of a text that keeps being edited, such as
+ * an editor buffer. The session owns a copy of the text in a gap buffer
+ * and its tokens, each with its check outcome, in a gap array parked at
+ * the last edit; tokens behind the gap count their offset and line from
+ * the end of the text, so an edit never renumbers the rest of the
+ * document. An edit re-tokenizes only the lines it touches. Tokens on
+ * those lines whose text and sentence-start status did not change keep
+ * their error and suggestions; only the others are checked again. The
+ * cost of an edit therefore depends on the length of the edited lines
+ * and the distance from the previous edit, not on the document size.
+ * A session must not be used from several threads at once.
+ */
+typedef struct SpellSession SpellSession;
+
+/**
+ * What one spell_session_edit() re-tokenized and re-checked
+ */
+typedef struct SpellSessionEdit {
+    size_t start;               // First byte of the re-tokenized lines, in the edited text
+    size_t end;                 // One past their last byte
+    int tokens_removed;         // Tokens the lines held before the edit
+    int tokens_added;           // Tokens they hold now
+    int tokens_checked;         // New tokens actually checked (the others kept their outcome)
+    int errors_removed;         // Errors the lines held before the edit
+    int errors_added;           // Errors they hold now
+    double processing_time;     // Wall-clock seconds the edit took
+} SpellSessionEdit;
+
+/**
+ * Start a session on a copy of text and check all of it. The dictionary
+ * must outlive the session. Sessions only report spelling errors: the
+ * context model (see set_context_model()) is not applied, since an edit
+ * would change the context of words outside the lines it rechecks.
+ * Returns NULL on invalid parameters or memory allocation failure.
+ */
+SpellSession* spell_session_create(Trie* dictionary, const char* text, size_t length);
+
+/**
+ * Replace removed bytes at offset with inserted_length bytes of inserted
+ * (either may be zero) and re-check the affected lines. If edit is not
+ * NULL it describes what was re-checked. Returns false, leaving the
+ * session unchanged, if the range lies outside the text or memory runs
+ * out.
+ */
+bool spell_session_edit(SpellSession* session, size_t offset, size_t removed,
+                        const char* inserted, size_t inserted_length, SpellSessionEdit* edit);
+
+/**
+ * Get the session's current text, NUL-terminated, and its length. The
+ * pointer stays valid until the next edit.
+ */
+const char* spell_session_text(SpellSession* session, size_t* length);
+
+/**
+ * Get the number of errors currently in the text
+ */
+int spell_session_error_count(const SpellSession* session);
+
+/**
+ * Build a SpellCheckResult holding copies of the session's current errors
+ * in text order, with up-to-date line numbers and positions. Identical to
+ * spell_check_document() on the current text, except that the word cache
+ * counters cover the whole session. Caller frees it with
+ * free_spell_check_result(). Returns NULL on memory allocation failure.
+ */
+SpellCheckResult* spell_session_result(const SpellSession* session);
+
+/**
+ * End a session and free everything it holds (can be NULL)
+ */
+void spell_session_destroy(SpellSession* session);
+
+/**
+ * Algorithms generate_suggestions() can use to find candidate words
+ */
+typedef enum SuggestionEngine {
+    SUGGESTION_ENGINE_TRIE,     // Bounded edit distance walk over the trie (default)
+    SUGGESTION_ENGINE_SYMSPELL, // Precomputed symmetric-delete index (see symspell.h)
+    SUGGESTION_ENGINE_SCAN      // Filtered scan of a length-partitioned word list (see length_index.h)
+} SuggestionEngine;
+
+/**
+ * Select the suggestion engine. SUGGESTION_ENGINE_SYMSPELL and
+ * SUGGESTION_ENGINE_SCAN build their index over dictionary, which is then
+ * used whenever suggestions are generated for that same dictionary;
+ * selecting another engine frees it. All engines return identical
+ * suggestions. Must not be called while a
+ * spell check is running. Returns false if the index cannot be built (the
+ * trie engine stays in use).
+ */
+bool set_suggestion_engine(SuggestionEngine engine, Trie* dictionary);
+
+/**
+ * Suppress the status lines printed to stdout for every word validated
+ * through the API and by the file loaders (see api_client_set_quiet() and
+ * file_io_set_quiet()), so only the report is written (off by default).
+ * Must not be called while a spell check is running.
+ */
+void set_spell_check_quiet(bool quiet);
+
+/**
+ * Check dictionary words against their context as well (NULL to stop,
+ * the default). Every word of at least three letters is compared with its
+ * one-edit neighbors that are also dictionary words: when a neighbor fits
+ * the surrounding words far better under model, the word is reported as
+ * an error with context_error set and the better neighbors as suggestions
+ * ("form" in "a letter form my aunt"). The words around each token are
+ * hashed once per chunk and the candidates of many tokens are scored in
+ * batches, and neighbors are looked up once per unique word.
+ * Whole-document and batch checks apply it; stream and session checks,
+ * which do not see the words after a token, do not. The model is only
+ * read and stays owned by the caller. Must not be called while a spell
+ * check is running.
+ */
+void set_context_model(const NgramModel* model);
+
+/**
+ * Get the suggestion engine currently in use
+ */
+SuggestionEngine get_suggestion_engine(void);
+
+/**
+ * Get the memory used by the suggestion engine's index in bytes
+ * (0 for the trie engine, which needs no index)
+ */
+size_t get_suggestion_engine_memory(void);
+
+/**
+ * Generate spelling suggestions for a misspelled word, best first.
+ * Every dictionary word within the distance bound is ranked by
+ * compute_weighted_distance() (keyboard-adjacent substitutions and
+ * transpositions are cheap) minus a small bonus that grows with the
+ * word's frequency; the best MAX_SUGGESTIONS are returned.
  */
 char** generate_suggestions(const char* misspelled_word, Trie* dictionary, int* count);
 
+/**
+ * Same as generate_suggestions(), also returning the ranking cost of each
+ * suggestion in *scores (lower is better, caller frees) when scores is not
+ * NULL. *scores is NULL when there are no suggestions.
+ */
+char** generate_ranked_suggestions(const char* misspelled_word, Trie* dictionary, int* count,
+                                   float** scores);
+
 /**
  * Check if a word is likely a proper noun
  */
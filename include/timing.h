@@ -0,0 +1,57 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stddef.h>
+
+/**
+ * @file timing.h
+ * @brief Portable wall-clock timing and memory measurement
+ *
+ * clock() measures CPU time of the whole process, which overstates
+ * multi-threaded stages and ignores time spent waiting on I/O. These
+ * helpers read a monotonic wall clock instead (clock_gettime on POSIX,
+ * QueryPerformanceCounter on Windows) and report the process's peak
+ * resident memory, so stage timings can be compared between runs and
+ * between machines.
+ *
+ * Usage Example:
+ * @code
+ * double start = timing_now_seconds();
+ * load_dictionary("words.txt", dictionary);
+ * printf("Loaded in %.3f s, peak RSS %zu bytes\n",
+ *        timing_now_seconds() - start, timing_peak_rss_bytes());
+ * @endcode
+ */
+
+/**
+ * @brief Read the monotonic clock
+ *
+ * @return Seconds since an arbitrary fixed point; only differences are meaningful
+ *
+ * @note Resolution is typically well below one microsecond
+ */
+double timing_now_seconds(void);
+
+/**
+ * @brief Get the peak resident set size of the process
+ *
+ * @return Largest amount of physical memory the process has used so far, in
+ *         bytes, or 0 if the platform does not report it
+ */
+size_t timing_peak_rss_bytes(void);
+
+/**
+ * @brief Get a percentile of a set of samples
+ *
+ * Sorts the samples in place and returns the nearest-rank percentile.
+ *
+ * @param samples Sample values (reordered by the call)
+ * @param count Number of samples
+ * @param percentile Percentile to return (0..100)
+ * @return The percentile value, or 0 if count is 0
+ *
+ * Time Complexity: O(n log n)
+ */
+double timing_percentile(double* samples, size_t count, double percentile);
+
+#endif // TIMING_H
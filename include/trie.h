@@ -13,9 +13,11 @@
  * the length of the word. Memory usage is optimized through careful node allocation
  * and the structure supports efficient prefix-based operations.
  * 
- * Algorithm: Standard Trie with 26-way branching for lowercase English letters (a-z).
- * Each node contains an array of 26 pointers to child nodes, a boolean flag indicating
- * if the node represents the end of a valid word, and statistics for performance tracking.
+ * Algorithm: Byte-wise Trie over UTF-8 words with 26-way direct branching for lowercase
+ * English letters (a-z) and a sorted list for the bytes of non-ASCII characters.
+ * Each node contains an array of 26 pointers to child nodes, the head of its list of
+ * non-ASCII children, a boolean flag indicating if the node represents the end of a
+ * valid word, and statistics for performance tracking.
  * 
  * Time Complexity:
  * - Insert: O(m) where m is word length
@@ -40,32 +42,112 @@
  * @endcode
  */
 
+/**
+ * @brief Maximum length of a word reported by trie traversal queries
+ *
+ * Fuzzy search results are returned in fixed-size buffers so that the
+ * query path does not allocate per candidate. Dictionary words are
+ * limited to 50 characters by is_valid_word(), well below this bound.
+ */
+#define TRIE_MAX_WORD_LENGTH 64
+
 /**
  * @brief TrieNode structure representing a single node in the Trie
  * 
- * Each node can have up to 26 children representing lowercase letters a-z.
+ * Words are stored as UTF-8 bytes. The 26 lowercase letters a-z, which
+ * make up nearly all children in English text, are indexed directly; the
+ * bytes of non-ASCII characters (0x80-0xFF) hang off a short sibling list
+ * sorted by byte, so other alphabets cost no extra space per node.
  * The is_end_of_word flag marks valid word endings, and word_count provides
- * statistics for performance analysis and debugging.
+ * statistics for performance analysis and debugging. frequency_bound caps
+ * the word_count of every word in the node's subtree, so completion can
+ * skip subtrees that cannot hold a better word (see trie_complete()).
  */
 typedef struct TrieNode {
     struct TrieNode* children[26];  ///< Child nodes for letters a-z (index = letter - 'a')
+    struct TrieNode* extended;      ///< First child for a byte >= 0x80, in increasing byte order
+    struct TrieNode* next;          ///< Next sibling in the parent's extended list
+    unsigned char label;           ///< Byte leading from the parent to this node
     bool is_end_of_word;           ///< True if this node represents the end of a valid word
+    unsigned char frequency_bound; ///< Encoded bound on the highest word_count in this subtree (see trie_encode_frequency_bound())
     int word_count;                ///< Statistics: number of words ending at this node
 } TrieNode;
 
+/**
+ * @brief Arena chunk from which a Trie allocates its nodes (opaque)
+ */
+typedef struct TrieNodeChunk TrieNodeChunk;
+
 /**
  * @brief Trie structure containing the root node and metadata
  * 
  * The main Trie structure maintains a pointer to the root node and tracks
  * statistics including total word count and approximate memory usage for
  * performance monitoring and optimization.
+ * 
+ * Nodes are carved out of arena chunks owned by the Trie, so building
+ * a large dictionary costs a handful of allocations and trie_destroy()
+ * releases every node with one free() per chunk.
+ * 
+ * After trie_freeze() the pointer nodes are released and all queries are
+ * answered from the compact read-only image (see compact_trie.h). After
+ * trie_minimize() they are answered from the minimal automaton instead,
+ * which also shares suffixes (see dawg.h).
+ * 
+ * After trie_build_word_set() exact lookups (trie_search() and
+ * trie_get_frequency()) are answered from a frozen hash set instead of
+ * the tree (see word_set.h); the tree is only walked by prefix and fuzzy
+ * queries.
  */
 typedef struct Trie {
-    TrieNode* root;         ///< Root node of the trie (represents empty string)
+    TrieNode* root;         ///< Root node of the trie (represents empty string), NULL once frozen
     int total_words;        ///< Total number of unique words stored in the trie
-    size_t memory_usage;    ///< Approximate memory usage in bytes (updated on insert/delete)
+    size_t memory_usage;    ///< Exact bytes allocated by the trie (structure, node chunks, compact image)
+    TrieNodeChunk* chunks;  ///< Arena chunks holding the nodes, most recent first
+    size_t node_count;      ///< Number of pointer nodes in the tree
+    struct CompactTrie* compact; ///< Frozen compact image answering queries (NULL until trie_freeze())
+    struct Dawg* dawg;           ///< Minimal automaton answering queries (NULL until trie_minimize())
+    struct WordSet* word_set;    ///< Exact lookup table (NULL until trie_build_word_set())
 } Trie;
 
+/**
+ * @brief A single result of a fuzzy (approximate) Trie search
+ *
+ * Holds a dictionary word found within the requested edit distance of the
+ * query, together with its Levenshtein distance from the query and its
+ * frequency (the word_count of its node), used to rank suggestions.
+ */
+typedef struct TrieMatch {
+    char word[TRIE_MAX_WORD_LENGTH + 1]; ///< Matching dictionary word (NUL-terminated)
+    int distance;                        ///< Levenshtein distance between query and word
+    int frequency;                       ///< Occurrence count of the word in the dictionary
+} TrieMatch;
+
+/**
+ * @brief Encode an upper bound of a frequency into one byte
+ *
+ * The code is a tiny floating point number (5-bit exponent, 3-bit
+ * mantissa), so it fits the padding of a node yet bounds a frequency
+ * within 12.5%. Codes are monotonic: the larger of two codes bounds the
+ * larger frequency, so a subtree's bound is the maximum of its nodes' codes.
+ *
+ * @param frequency Frequency to bound (values below 1 encode as 0)
+ * @return Smallest code whose trie_decode_frequency_bound() is >= frequency
+ *
+ * Time Complexity: O(1)
+ */
+unsigned char trie_encode_frequency_bound(int frequency);
+
+/**
+ * @brief Decode a frequency bound
+ *
+ * @param code Code from trie_encode_frequency_bound()
+ * @return Upper bound on the encoded frequency (0 for code 0)
+ *
+ * Time Complexity: O(1)
+ */
+unsigned int trie_decode_frequency_bound(unsigned char code);
+
 /**
  * @brief Create a new empty Trie
  * 
@@ -82,22 +164,41 @@ typedef struct Trie {
  */
 Trie* trie_create(void);
 
+/**
+ * @brief Create a new empty Trie whose first arena chunk holds node_count nodes
+ * 
+ * For a caller that knows how many nodes its words need (the root
+ * included): the nodes come from one chunk sized to fit, instead of a run
+ * of doubling chunks whose newest is left partly used. Inserting more
+ * nodes than reserved still works, in chunks growing from there.
+ * 
+ * @param node_count Expected number of nodes, root included (minimum 1)
+ * @return Pointer to newly created Trie, or NULL on memory allocation failure
+ * 
+ * @note Caller is responsible for calling trie_destroy() to free memory
+ * 
+ * Time Complexity: O(1)
+ * Space Complexity: O(node_count)
+ */
+Trie* trie_create_with_capacity(size_t node_count);
+
 /**
  * @brief Insert a word into the Trie
  * 
  * Inserts a word into the Trie by traversing from the root and creating
- * nodes as necessary. The word must contain only lowercase alphabetic
- * characters (a-z). Updates the total word count and memory usage statistics.
+ * nodes as necessary. The word must contain only letters a-z (ASCII A-Z are
+ * folded) and bytes of UTF-8 sequences (>= 0x80), as produced by
+ * normalize_word(). Updates the total word count and memory usage statistics.
  * 
  * Algorithm: Traverse the trie character by character, creating new nodes
  * when necessary. Mark the final node as end-of-word and update statistics.
  * 
  * @param trie Pointer to the Trie (must not be NULL)
  * @param word Word to insert (must be lowercase, alphabetic characters only)
- * @return true if insertion successful, false on error (NULL parameters, invalid characters, memory allocation failure)
+ * @return true if insertion successful, false on error (NULL parameters, invalid characters, frozen trie, memory allocation failure)
  * 
  * @pre trie != NULL && word != NULL
- * @pre word contains only lowercase letters a-z
+ * @pre word contains only lowercase letters a-z and UTF-8 bytes >= 0x80
  * 
  * Time Complexity: O(m) where m is the length of the word
  * Space Complexity: O(m) in worst case (all new nodes), O(1) in best case (word already exists)
@@ -112,6 +213,27 @@ Trie* trie_create(void);
  */
 bool trie_insert(Trie* trie, const char* word);
 
+/**
+ * @brief Insert a word and add to its frequency
+ * 
+ * Same as trie_insert(), but adds frequency instead of 1 to the word's
+ * word_count. Used for dictionaries that list how common each word is;
+ * the accumulated count ranks suggestions (see trie_get_frequency()).
+ * 
+ * @param trie Pointer to the Trie (must not be NULL)
+ * @param word Word to insert (must be lowercase, alphabetic characters only)
+ * @param frequency Occurrences to add (>= 1)
+ * @return true if insertion successful, false on error (same cases as trie_insert(), frequency < 1)
+ * 
+ * Time Complexity: O(m) where m is the length of the word
+ * 
+ * Example:
+ * @code
+ * trie_insert_with_frequency(trie, "the", 56271872);
+ * @endcode
+ */
+bool trie_insert_with_frequency(Trie* trie, const char* word, int frequency);
+
 /**
  * @brief Search for a word in the Trie
  * 
@@ -124,6 +246,7 @@ bool trie_insert(Trie* trie, const char* word);
  * @return true if word exists in trie, false otherwise (including NULL parameters)
  * 
  * @pre trie != NULL && word != NULL
+ * @note Answered from the exact lookup table when one is built (see trie_build_word_set())
  * 
  * Time Complexity: O(m) where m is the length of the word
  * Space Complexity: O(1)
@@ -140,20 +263,234 @@ bool trie_insert(Trie* trie, const char* word);
 bool trie_search(Trie* trie, const char* word);
 
 /**
- * @brief Get approximate memory usage of the Trie
+ * @brief Get the frequency of a word
+ * 
+ * Returns the word_count of the word's node: how many times it was
+ * inserted, or the sum of the frequencies given to
+ * trie_insert_with_frequency(). Works on frozen Tries too.
+ * 
+ * @param trie Pointer to the Trie
+ * @param word Word to look up
+ * @return Frequency of the word, or 0 if it is not stored (including NULL parameters)
+ * 
+ * Time Complexity: O(m) where m is the length of the word
+ * Space Complexity: O(1)
+ */
+int trie_get_frequency(Trie* trie, const char* word);
+
+/**
+ * @brief Check whether any word in the Trie starts with the given prefix
+ * 
+ * @param trie Pointer to the Trie
+ * @param prefix Prefix to look for
+ * @return true if at least one stored word has this prefix, false otherwise
+ * 
+ * Time Complexity: O(m) where m is the length of the prefix
+ * Space Complexity: O(1)
+ */
+bool trie_starts_with(Trie* trie, const char* prefix);
+
+/**
+ * @brief Freeze the Trie into its compact read-only layout
+ * 
+ * Builds a CompactTrie from the current nodes and releases the pointer
+ * nodes. Lookups, prefix and fuzzy queries, and trie_get_all_words() keep
+ * working unchanged but are served from one contiguous allocation.
+ * Further trie_insert() calls fail. Intended to be called once, after
+ * load_dictionary() finishes.
+ * 
+ * @param trie Pointer to the Trie (must not be NULL)
+ * @return true if the Trie is frozen (including already frozen), false on memory allocation failure
+ * 
+ * Time Complexity: O(N) where N is the number of nodes
+ * Space Complexity: O(N) for the compact image
+ * 
+ * Example:
+ * @code
+ * Trie* dict = trie_create();
+ * load_dictionary("words.txt", dict);
+ * trie_freeze(dict);   // Same queries, a fraction of the memory
+ * @endcode
+ */
+bool trie_freeze(Trie* trie);
+
+/**
+ * @brief Replace the Trie's nodes by the minimal automaton of its words
+ * 
+ * Builds a Dawg (see dawg.h) from the pointer nodes or the compact image
+ * and releases them. Every query keeps working unchanged; a DAWG merges
+ * common suffixes as well as prefixes, so it is usually several times
+ * smaller than the compact image. Further trie_insert() calls fail and
+ * the Trie can no longer be frozen or compiled.
+ * 
+ * @param trie Pointer to the Trie (must not be NULL)
+ * @return true if the Trie is minimized (including already minimized), false on memory allocation failure
+ * 
+ * Time Complexity: O(N * L) where N is the number of words, L the average length
+ * Space Complexity: O(S + E) for the automaton's states and edges
+ */
+bool trie_minimize(Trie* trie);
+
+/**
+ * @brief Make a Trie serve queries from an existing compact image
+ * 
+ * Releases the Trie's pointer nodes and takes ownership of the given
+ * CompactTrie, leaving the Trie in the same frozen state as after
+ * trie_freeze(). Used to wrap a compiled dictionary mapped from disk.
+ * 
+ * @param trie Pointer to the Trie (must not be NULL, must not be frozen)
+ * @param compact Compact image to adopt (ownership is transferred on success)
+ * @return true on success, false on error (NULL parameters, trie already frozen)
+ * 
+ * Time Complexity: O(C) where C is the number of arena chunks released
+ * Space Complexity: O(1)
+ */
+bool trie_adopt_compact(Trie* trie, struct CompactTrie* compact);
+
+/**
+ * @brief Move the words of another Trie under this Trie's root
+ * 
+ * Attaches every subtree hanging off donor's root to the same position
+ * under trie's root and takes over donor's arena chunks, so no node is
+ * copied. The two Tries must not share a first letter; this is how
+ * independently built per-letter Tries are combined into one dictionary.
+ * The exact lookup tables of both are released.
+ * 
+ * @param trie Pointer to the receiving Trie (must not be NULL or frozen)
+ * @param donor Trie whose words are moved (destroyed on success)
+ * @return true on success, false on error (NULL parameters, frozen Tries, a first letter used by both)
  * 
- * Returns the approximate memory usage of the Trie in bytes, including
- * all nodes and the main structure. This is useful for performance
- * monitoring and memory optimization.
+ * @post On success donor is freed and must not be used
+ * 
+ * Time Complexity: O(C) where C is the number of donor arena chunks
+ * Space Complexity: O(1)
+ * 
+ * Example:
+ * @code
+ * Trie* words_a = trie_create();
+ * trie_insert(words_a, "apple");
+ * trie_graft(dict, words_a);   // dict may not contain words starting with 'a'
+ * @endcode
+ */
+bool trie_graft(Trie* trie, Trie* donor);
+
+/**
+ * @brief Build the exact lookup table of the Trie
+ * 
+ * Copies every stored word and its frequency into a WordSet, after which
+ * trie_search() and trie_get_frequency() no longer walk the tree: an
+ * unknown word is usually rejected by one Bloom filter block, and a known
+ * word costs one table slot plus one read of its characters. Works on
+ * frozen and unfrozen Tries. load_dictionary() calls this once loading
+ * succeeds.
+ * 
+ * The table is a snapshot: inserting a word afterwards releases it, and
+ * lookups go back to the tree until it is built again.
+ * 
+ * @param trie Pointer to the Trie (must not be NULL)
+ * @return true if the table is built (including already built), false on error (NULL parameter, memory allocation failure)
+ * 
+ * Time Complexity: O(N * L) where N is number of words, L is average word length
+ * Space Complexity: O(N * L) for the table, its Bloom filter and a copy of the words
+ * 
+ * Example:
+ * @code
+ * load_dictionary("words.txt", dict);   // Already builds the table
+ * trie_insert(dict, "covfefe");         // Releases it
+ * trie_build_word_set(dict);            // Fast lookups again
+ * @endcode
+ */
+bool trie_build_word_set(Trie* trie);
+
+/**
+ * @brief Find dictionary words within a bounded edit distance of a query
+ * 
+ * Walks the Trie depth-first, carrying one row of the Levenshtein DP matrix
+ * per depth. Each child extends its parent's row by a single character, so
+ * shared prefixes are scored once. Any subtree whose row minimum already
+ * exceeds the distance bound is pruned, since no word below it can come
+ * back within range.
+ * 
+ * Results are ordered by ascending distance; ties keep alphabetical order.
+ * Only the best max_matches words are kept, and once the buffer is full the
+ * bound tightens to the worst distance held, pruning the walk further.
+ * 
+ * @param trie Pointer to the Trie (must not be NULL)
+ * @param word Query word (lowercase, at most TRIE_MAX_WORD_LENGTH characters)
+ * @param max_distance Maximum edit distance of reported words (>= 0)
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer
+ * @return Number of matches written, or 0 on error (NULL parameters, overlong query)
+ * 
+ * @pre trie != NULL && word != NULL && matches != NULL
+ * @note An exact match (distance 0) is reported if the query is in the Trie
+ * 
+ * Time Complexity: O(V * m) where V is the number of nodes visited and m is the query length
+ * Space Complexity: O((m + max_distance) * m) for the DP rows (one allocation per query)
+ * 
+ * Example:
+ * @code
+ * TrieMatch matches[5];
+ * int found = trie_fuzzy_search(trie, "helo", 2, matches, 5);
+ * for (int i = 0; i < found; i++) {
+ *     printf("%s (distance %d)\n", matches[i].word, matches[i].distance);
+ * }
+ * @endcode
+ */
+int trie_fuzzy_search(Trie* trie, const char* word, int max_distance, TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Find the most frequent words starting with a prefix
+ * 
+ * Descends to the prefix node, then runs a best-first search: a priority
+ * queue holds unexplored subtrees keyed by their frequency bound and
+ * found words keyed by their word_count. A word is reported once no
+ * subtree left in the queue can hold a more frequent one, so only
+ * branches that may contain one of the next best words are expanded,
+ * never the whole subtree below the prefix.
+ * 
+ * Results are ordered by descending frequency; ties are in alphabetical
+ * order. The prefix itself is reported when it is a word. In each match,
+ * distance holds the number of bytes the completion adds to the prefix.
+ * 
+ * @param trie Pointer to the Trie (must not be NULL)
+ * @param prefix Prefix to complete (ASCII letters are folded; empty completes from the root)
+ * @param matches Caller-provided buffer receiving the results
+ * @param max_matches Capacity of the matches buffer (the k of the top-k)
+ * @return Number of matches written, or 0 on error (NULL parameters, overlong prefix, memory allocation failure)
+ * 
+ * Time Complexity: O(m + E * log Q) where m is the prefix length, E the
+ * number of nodes expanded and Q the queue size; E grows with max_matches and
+ * the depth of the completions, not with the size of the subtree
+ * Space Complexity: O(Q) for the queue (one allocation per query, grown as needed)
+ * 
+ * Example:
+ * @code
+ * TrieMatch completions[5];
+ * int found = trie_complete(trie, "hel", completions, 5);
+ * for (int i = 0; i < found; i++) {
+ *     printf("%s (%d)\n", completions[i].word, completions[i].frequency);
+ * }
+ * @endcode
+ */
+int trie_complete(Trie* trie, const char* prefix, TrieMatch* matches, int max_matches);
+
+/**
+ * @brief Get memory usage of the Trie
+ * 
+ * Returns the number of bytes the Trie has allocated: the main structure,
+ * every arena chunk (including not yet used node slots), the compact
+ * image once frozen and the exact lookup table once built. This is useful for performance monitoring and
+ * memory optimization.
  * 
  * @param trie Pointer to the Trie
  * @return Memory usage in bytes, or 0 if trie is NULL
  * 
- * Time Complexity: O(1) - uses cached value updated during insert/delete
+ * Time Complexity: O(1) - uses cached value updated as chunks are allocated
  * Space Complexity: O(1)
  * 
- * @note The returned value is an approximation and may not include
- * all memory overhead from the system allocator
+ * @note The value is exact with respect to requested allocation sizes; it
+ * does not include per-allocation overhead of the system allocator
  */
 size_t trie_get_memory_usage(Trie* trie);
 
@@ -193,7 +530,8 @@ void trie_get_all_words(Trie* trie, char*** words, int* count);
 /**
  * @brief Destroy the Trie and free all allocated memory
  * 
- * Recursively frees all nodes in the Trie and the main Trie structure.
+ * Frees the arena chunks holding all nodes, the compact image and the
+ * exact lookup table if any, and the main Trie structure.
  * After calling this function, the trie pointer becomes invalid and
  * should not be used.
  * 
@@ -202,8 +540,8 @@ void trie_get_all_words(Trie* trie, char*** words, int* count);
  * @post All memory associated with the trie is freed
  * @post trie pointer becomes invalid
  * 
- * Time Complexity: O(N) where N is the total number of nodes
- * Space Complexity: O(h) where h is the height of the trie (for recursion stack)
+ * Time Complexity: O(C) where C is the number of arena chunks
+ * Space Complexity: O(1)
  * 
  * @note Safe to call with NULL pointer (no-op)
  * 
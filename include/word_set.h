@@ -0,0 +1,151 @@
+#ifndef WORD_SET_H
+#define WORD_SET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file word_set.h
+ * @brief Frozen exact-membership table for the "is this a word" hot path
+ *
+ * Most tokens of real text are spelled correctly, so exact lookup runs on
+ * nearly every word while fuzzy search runs on few. A Trie lookup takes a
+ * dependent memory access per character; a WordSet answers the same
+ * question from a couple of cache lines:
+ *
+ * - A blocked Bloom filter (one 64-byte block per word, about 10 bits per
+ *   word) small enough to stay cache resident rejects most unknown words
+ *   with a single load.
+ * - Words that pass the filter are looked up in an open-addressing table
+ *   of 16-byte slots holding a 32-bit hash tag, the word's length and
+ *   frequency, and the offset of its characters in a string pool. The
+ *   pool is only read when tag and length both match.
+ *
+ * The query is lowercased, measured and hashed in one pass, so a lookup
+ * touches each query character once.
+ *
+ * The set is filled once with word_set_add() and is read-only afterwards;
+ * concurrent word_set_find() calls need no locking. Its capacity is fixed
+ * at creation.
+ *
+ * Time Complexity:
+ * - Build: O(N * L) where N is the number of words, L is the average length
+ * - Find: O(m) where m is the query length, plus an expected O(1) probes
+ *
+ * Usage Example:
+ * @code
+ * WordSet* set = word_set_create(2);
+ * word_set_add(set, "hello", 5, 12);
+ * word_set_add(set, "world", 5, 7);
+ *
+ * int frequency;
+ * if (word_set_find(set, "Hello", &frequency)) {
+ *     printf("Found, frequency %d\n", frequency);
+ * }
+ * word_set_destroy(set);
+ * @endcode
+ */
+
+/**
+ * @brief Longest word a WordSet stores or looks up
+ */
+#define WORD_SET_MAX_WORD_LENGTH 64
+
+/**
+ * @brief Bloom filter bits spent per expected word
+ *
+ * Ten bits with six probes in a 512-bit block keep the false positive
+ * rate near 1%.
+ */
+#define WORD_SET_BLOOM_BITS_PER_WORD 10
+
+/**
+ * @brief A single slot of the open-addressing table (length 0 = empty)
+ */
+typedef struct WordSetSlot {
+    uint32_t tag;             ///< High 32 bits of the word's hash
+    uint32_t offset;          ///< Offset of the word in the string pool
+    int32_t frequency;        ///< Frequency of the word
+    uint16_t length;          ///< Length of the word, 0 for an empty slot
+    uint16_t reserved;        ///< Padding, always zero
+} WordSetSlot;
+
+/**
+ * @brief Frozen hash set of lowercase words with their frequencies
+ */
+typedef struct WordSet {
+    WordSetSlot* slots;       ///< Open-addressing table, slot_mask + 1 slots
+    uint32_t slot_mask;       ///< Table size minus one (size is a power of two)
+    uint64_t* bloom;          ///< Bloom filter, 8 words (one cache line) per block
+    uint32_t bloom_mask;      ///< Number of Bloom blocks minus one (a power of two)
+    char* pool;               ///< NUL-terminated words, back to back
+    size_t pool_size;         ///< Bytes used in the pool
+    size_t pool_capacity;     ///< Bytes allocated for the pool
+    size_t count;             ///< Number of words stored
+    size_t capacity;          ///< Maximum number of words (fixed at creation)
+} WordSet;
+
+/**
+ * @brief Create an empty WordSet sized for a number of words
+ *
+ * The table is sized for a load factor of at most 1/2 and the Bloom
+ * filter for WORD_SET_BLOOM_BITS_PER_WORD bits per word.
+ *
+ * @param capacity Maximum number of words that will be added
+ * @return Newly allocated WordSet, or NULL on error (memory allocation failure, capacity too large)
+ *
+ * @post Caller must call word_set_destroy() on the returned pointer
+ *
+ * Time Complexity: O(capacity) to clear the table
+ * Space Complexity: O(capacity)
+ */
+WordSet* word_set_create(size_t capacity);
+
+/**
+ * @brief Add a word to the set
+ *
+ * The word is stored lowercased. Adding a word that is already present
+ * replaces its frequency.
+ *
+ * @param set Pointer to the WordSet
+ * @param word Word to add (need not be NUL-terminated)
+ * @param length Length of the word (1..WORD_SET_MAX_WORD_LENGTH)
+ * @param frequency Frequency stored with the word
+ * @return true on success, false on error (NULL parameters, bad length, set full, memory allocation failure)
+ *
+ * Time Complexity: O(m) where m is the word length, expected
+ */
+bool word_set_add(WordSet* set, const char* word, size_t length, int frequency);
+
+/**
+ * @brief Look up a word
+ *
+ * ASCII letters are matched case-insensitively, like trie_search().
+ *
+ * @param set Pointer to the WordSet
+ * @param word NUL-terminated word to look up
+ * @param frequency Receives the word's frequency when found (may be NULL)
+ * @return true if the word is in the set, false otherwise (including NULL parameters, overlong words)
+ *
+ * Time Complexity: O(m) where m is the word length, expected
+ * Space Complexity: O(1)
+ */
+bool word_set_find(const WordSet* set, const char* word, int* frequency);
+
+/**
+ * @brief Get memory usage of the WordSet
+ *
+ * @param set Pointer to the WordSet
+ * @return Bytes allocated for the structure, table, Bloom filter and pool, or 0 if set is NULL
+ */
+size_t word_set_get_memory_usage(const WordSet* set);
+
+/**
+ * @brief Destroy a WordSet and free its memory
+ *
+ * @param set Pointer to the WordSet (can be NULL)
+ */
+void word_set_destroy(WordSet* set);
+
+#endif // WORD_SET_H
@@ -0,0 +1,346 @@
+#include "api_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// Log replay and compaction limits
+#define API_CACHE_LOG_LINE_LENGTH 128
+#define API_CACHE_COMPACT_MIN_RECORDS 1024
+
+/**
+ * @brief One cached word, linked into a hash bucket and the recency list
+ */
+typedef struct APICacheEntry {
+    char word[API_CACHE_MAX_WORD_LENGTH + 1];
+    bool found;                         // Cached API answer
+    time_t stored_at;                   // When the answer was obtained
+    unsigned int hash;                  // Hash of word
+    struct APICacheEntry* hash_next;    // Next entry in the same bucket (or free list)
+    struct APICacheEntry* prev;         // More recently used neighbour
+    struct APICacheEntry* next;         // Less recently used neighbour
+} APICacheEntry;
+
+struct APICache {
+    APICacheEntry* entries;         // Pool of capacity entries
+    APICacheEntry* free_list;       // Unused entries, chained through hash_next
+    APICacheEntry** buckets;        // Hash buckets
+    size_t bucket_mask;             // Bucket count - 1 (count is a power of two)
+    APICacheEntry* most_recent;     // Head of the recency list
+    APICacheEntry* least_recent;    // Tail of the recency list (next to evict)
+    int size;                       // Words currently cached
+    int capacity;                   // Maximum words kept in memory
+    FILE* log;                      // Append handle of the persistent log (or NULL)
+    pthread_mutex_t mutex;          // Guards everything above
+};
+
+/**
+ * @brief FNV-1a hash of a word
+ */
+static unsigned int hash_word(const char* word) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)word; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Check whether a cached answer has outlived its TTL
+ */
+static bool entry_expired(const APICacheEntry* entry, time_t now) {
+    long ttl = entry->found ? API_CACHE_POSITIVE_TTL : API_CACHE_NEGATIVE_TTL;
+    return difftime(now, entry->stored_at) > (double)ttl;
+}
+
+/**
+ * @brief Find the bucket link pointing at a word's entry
+ *
+ * @return Pointer to the link holding the entry, or to the terminating NULL link
+ */
+static APICacheEntry** find_link(APICache* cache, const char* word, unsigned int hash) {
+    APICacheEntry** link = &cache->buckets[hash & cache->bucket_mask];
+    while (*link && ((*link)->hash != hash || strcmp((*link)->word, word) != 0)) {
+        link = &(*link)->hash_next;
+    }
+    return link;
+}
+
+/**
+ * @brief Detach an entry from the recency list
+ */
+static void recency_unlink(APICache* cache, APICacheEntry* entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else cache->most_recent = entry->next;
+
+    if (entry->next) entry->next->prev = entry->prev;
+    else cache->least_recent = entry->prev;
+
+    entry->prev = entry->next = NULL;
+}
+
+/**
+ * @brief Make an entry the most recently used one
+ */
+static void recency_push_front(APICache* cache, APICacheEntry* entry) {
+    entry->prev = NULL;
+    entry->next = cache->most_recent;
+    if (cache->most_recent) cache->most_recent->prev = entry;
+    cache->most_recent = entry;
+    if (!cache->least_recent) cache->least_recent = entry;
+}
+
+/**
+ * @brief Remove an entry from the cache and return it to the free list
+ */
+static void remove_entry(APICache* cache, APICacheEntry* entry) {
+    APICacheEntry** link = find_link(cache, entry->word, entry->hash);
+    *link = entry->hash_next;
+    recency_unlink(cache, entry);
+
+    entry->hash_next = cache->free_list;
+    cache->free_list = entry;
+    cache->size--;
+}
+
+/**
+ * @brief Insert or update a word, evicting the least recently used one if full
+ */
+static void insert_entry(APICache* cache, const char* word, bool found, time_t stored_at) {
+    unsigned int hash = hash_word(word);
+    APICacheEntry* entry = *find_link(cache, word, hash);
+
+    if (entry) {
+        recency_unlink(cache, entry);
+    } else {
+        if (!cache->free_list) {
+            remove_entry(cache, cache->least_recent);
+        }
+        entry = cache->free_list;
+        cache->free_list = entry->hash_next;
+
+        strcpy(entry->word, word);
+        entry->hash = hash;
+        entry->hash_next = cache->buckets[hash & cache->bucket_mask];
+        cache->buckets[hash & cache->bucket_mask] = entry;
+        cache->size++;
+    }
+
+    entry->found = found;
+    entry->stored_at = stored_at;
+    recency_push_front(cache, entry);
+}
+
+/**
+ * @brief Write one log record
+ */
+static bool write_record(FILE* file, const APICacheEntry* entry) {
+    return fprintf(file, "%lld %d %s\n", (long long)entry->stored_at,
+                   entry->found ? 1 : 0, entry->word) > 0;
+}
+
+/**
+ * @brief Replay a log file into the cache
+ *
+ * @return Number of well-formed records read (0 if the file does not exist)
+ */
+static long replay_log(APICache* cache, const char* log_file) {
+    FILE* file = fopen(log_file, "r");
+    if (!file) return 0;
+
+    char line[API_CACHE_LOG_LINE_LENGTH];
+    char word[API_CACHE_MAX_WORD_LENGTH + 1];
+    time_t now = time(NULL);
+    long records = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        // A record without its newline was cut off mid-write
+        if (!strchr(line, '\n')) {
+            continue;
+        }
+
+        long long stored_at;
+        int found;
+        if (sscanf(line, "%lld %d %64s", &stored_at, &found, word) != 3 ||
+            (found != 0 && found != 1)) {
+            continue;
+        }
+        records++;
+
+        // An expired record still supersedes older ones for the same word
+        APICacheEntry probe;
+        probe.found = found == 1;
+        probe.stored_at = (time_t)stored_at;
+        if (entry_expired(&probe, now)) {
+            APICacheEntry* stale = *find_link(cache, word, hash_word(word));
+            if (stale) remove_entry(cache, stale);
+            continue;
+        }
+
+        insert_entry(cache, word, probe.found, probe.stored_at);
+    }
+
+    fclose(file);
+    return records;
+}
+
+/**
+ * @brief Rewrite the log with only the live records, oldest first
+ *
+ * Writes a temporary file next to the log and moves it into place, so a
+ * crash during compaction leaves the old log intact.
+ */
+static void compact_log(APICache* cache, const char* log_file) {
+    size_t path_len = strlen(log_file);
+    char* tmp_path = malloc(path_len + 5);
+    if (!tmp_path) return;
+    memcpy(tmp_path, log_file, path_len);
+    memcpy(tmp_path + path_len, ".tmp", 5);
+
+    FILE* tmp = fopen(tmp_path, "w");
+    if (!tmp) {
+        free(tmp_path);
+        return;
+    }
+
+    bool ok = true;
+    for (APICacheEntry* entry = cache->least_recent; entry && ok; entry = entry->prev) {
+        ok = write_record(tmp, entry);
+    }
+    if (fclose(tmp) != 0) ok = false;
+
+    // rename() does not replace an existing file on every platform
+    if (ok) {
+        remove(log_file);
+        ok = rename(tmp_path, log_file) == 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Warning: Failed to compact API cache log '%s'\n", log_file);
+        remove(tmp_path);
+    }
+
+    free(tmp_path);
+}
+
+/**
+ * @brief Create a cache, optionally backed by a log file
+ */
+APICache* api_cache_open(const char* log_file, int capacity) {
+    if (capacity <= 0) {
+        fprintf(stderr, "Error: Invalid API cache capacity %d\n", capacity);
+        return NULL;
+    }
+
+    APICache* cache = calloc(1, sizeof(APICache));
+    if (!cache) return NULL;
+
+    size_t bucket_count = 16;
+    while (bucket_count < (size_t)capacity * 2) bucket_count *= 2;
+
+    cache->entries = calloc((size_t)capacity, sizeof(APICacheEntry));
+    cache->buckets = calloc(bucket_count, sizeof(APICacheEntry*));
+    if (!cache->entries || !cache->buckets) {
+        free(cache->entries);
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+
+    cache->bucket_mask = bucket_count - 1;
+    cache->capacity = capacity;
+    for (int i = capacity - 1; i >= 0; i--) {
+        cache->entries[i].hash_next = cache->free_list;
+        cache->free_list = &cache->entries[i];
+    }
+    pthread_mutex_init(&cache->mutex, NULL);
+
+    if (log_file) {
+        long records = replay_log(cache, log_file);
+        if (records > API_CACHE_COMPACT_MIN_RECORDS && records > 2L * cache->size) {
+            compact_log(cache, log_file);
+        }
+
+        cache->log = fopen(log_file, "a");
+        if (!cache->log) {
+            fprintf(stderr, "Error: Cannot open API cache log '%s' for writing\n", log_file);
+            fprintf(stderr, "Suggestion: Check the directory exists and you have write permissions\n");
+            api_cache_close(cache);
+            return NULL;
+        }
+    }
+
+    return cache;
+}
+
+/**
+ * @brief Look up a cached answer
+ */
+bool api_cache_lookup(APICache* cache, const char* word, bool* found) {
+    if (!cache || !word || !found) return false;
+
+    pthread_mutex_lock(&cache->mutex);
+
+    bool hit = false;
+    APICacheEntry* entry = *find_link(cache, word, hash_word(word));
+    if (entry) {
+        if (entry_expired(entry, time(NULL))) {
+            remove_entry(cache, entry);
+        } else {
+            recency_unlink(cache, entry);
+            recency_push_front(cache, entry);
+            *found = entry->found;
+            hit = true;
+        }
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+    return hit;
+}
+
+/**
+ * @brief Store an answer in memory and append it to the log
+ */
+void api_cache_store(APICache* cache, const char* word, bool found) {
+    if (!cache || !word || word[0] == '\0' || strlen(word) > API_CACHE_MAX_WORD_LENGTH) {
+        return;
+    }
+
+    pthread_mutex_lock(&cache->mutex);
+
+    insert_entry(cache, word, found, time(NULL));
+    if (cache->log) {
+        // Flush every record so a crashed run keeps what it already paid for
+        write_record(cache->log, cache->most_recent);
+        fflush(cache->log);
+    }
+
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * @brief Get the number of words currently held in memory
+ */
+int api_cache_size(APICache* cache) {
+    if (!cache) return 0;
+
+    pthread_mutex_lock(&cache->mutex);
+    int size = cache->size;
+    pthread_mutex_unlock(&cache->mutex);
+    return size;
+}
+
+/**
+ * @brief Close the log and free the cache
+ */
+void api_cache_close(APICache* cache) {
+    if (!cache) return;
+
+    if (cache->log) {
+        fclose(cache->log);
+    }
+    pthread_mutex_destroy(&cache->mutex);
+    free(cache->buckets);
+    free(cache->entries);
+    free(cache);
+}
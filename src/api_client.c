@@ -1,20 +1,42 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "api_client.h"
+#include "api_cache.h"
+#include "profile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <curl/curl.h>
 #include <cjson/cJSON.h>
 #include <time.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
 
 // API configuration
 #define API_BASE_URL "https://www.dictionaryapi.com/api/v3/references/collegiate/json/"
 #define MAX_URL_LENGTH 512
 #define MAX_RESPONSE_SIZE 65536
 
+// Batch validation limits
+#define API_DEFAULT_MAX_CONCURRENT 8
+#define API_MAX_CONCURRENT 64
+#define API_BATCH_POLL_MS 100
+
 // Global API state
 static char* g_api_key = NULL;
 static bool g_initialized = false;
 static APIStats g_stats = {0};
+static PROFILE_THREAD_LOCAL APIStats g_stats_snapshot; // Per-thread buffer of get_api_stats()
+static pthread_mutex_t g_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static APICache* g_cache = NULL;
+static int g_max_concurrent = API_DEFAULT_MAX_CONCURRENT;
+static int g_max_requests_per_second = 0;
+static bool g_quiet = false;
 
 /**
  * @brief Structure to hold response data from curl
@@ -67,10 +89,37 @@ bool api_client_init(const char* api_key) {
         return false;
     }
 
+    // Results are always cached in memory; api_client_set_cache_file() adds persistence
+    g_cache = api_cache_open(NULL, API_CACHE_DEFAULT_CAPACITY);
+    if (!g_cache) {
+        fprintf(stderr, "Warning: Failed to create API cache, every lookup will hit the network\n");
+    }
+
     g_initialized = true;
-    memset(&g_stats, 0, sizeof(APIStats));
+    reset_api_stats();
+
+    if (!g_quiet) {
+        printf("✅ API Client initialized successfully\n");
+    }
+    return true;
+}
+
+/**
+ * @brief Persist API results in a cache log file
+ */
+bool api_client_set_cache_file(const char* cache_file) {
+    if (!g_initialized) {
+        fprintf(stderr, "Error: API client not initialized\n");
+        return false;
+    }
 
-    printf("✅ API Client initialized successfully\n");
+    APICache* cache = api_cache_open(cache_file, API_CACHE_DEFAULT_CAPACITY);
+    if (!cache) {
+        return false;
+    }
+
+    api_cache_close(g_cache);
+    g_cache = cache;
     return true;
 }
 
@@ -129,50 +178,35 @@ static bool parse_json_response(const char* json_str, char** definition) {
 }
 
 /**
- * @brief Make HTTP request to Merriam-Webster API
+ * @brief Point a curl handle at the API URL for a word
+ *
+ * The handle writes the response body into chunk, which must stay alive
+ * until the transfer completes.
  */
-static APIResponse* make_api_request(const char* word) {
-    if (!g_initialized || !g_api_key) {
-        fprintf(stderr, "Error: API client not initialized\n");
-        return NULL;
-    }
-
-    // Allocate response structure
-    APIResponse* response = calloc(1, sizeof(APIResponse));
-    if (!response) return NULL;
-
+static void prepare_api_request(CURL* curl, const char* word, MemoryStruct* chunk) {
     // Build API URL
     char url[MAX_URL_LENGTH];
     snprintf(url, sizeof(url), "%s%s?key=%s", API_BASE_URL, word, g_api_key);
 
-    // Initialize curl
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        response->error_message = strdup("Failed to initialize curl");
-        return response;
-    }
-
-    // Setup response buffer
-    MemoryStruct chunk = {0};
-    chunk.data = malloc(1);
-    chunk.size = 0;
-
-    // Configure curl
+    // Configure curl (the URL is copied by libcurl)
     curl_easy_setopt(curl, CURLOPT_URL, url);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)&chunk);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)chunk);
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "SpellChecker/1.0");
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L); // 10 second timeout
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+}
 
-    // Measure response time
-    clock_t start_time = clock();
-    
-    // Perform request
-    CURLcode res = curl_easy_perform(curl);
-    
-    clock_t end_time = clock();
-    response->response_time_ms = (int)(((double)(end_time - start_time)) / CLOCKS_PER_SEC * 1000);
+/**
+ * @brief Fill in an APIResponse from a finished transfer
+ */
+static void complete_api_request(CURL* curl, CURLcode res, const MemoryStruct* chunk,
+                                 APIResponse* response) {
+    // Wall-clock transfer time as measured by libcurl
+    double total_time = 0.0;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total_time);
+    response->response_time_ms = (int)(total_time * 1000);
 
     // Get HTTP status code
     long http_code = 0;
@@ -185,13 +219,45 @@ static APIResponse* make_api_request(const char* word) {
         response->word_found = false;
     } else if (http_code == 200) {
         // Parse JSON response
-        response->word_found = parse_json_response(chunk.data, &response->definition);
+        response->word_found = parse_json_response(chunk->data, &response->definition);
     } else {
         char error_buf[256];
         snprintf(error_buf, sizeof(error_buf), "HTTP error: %ld", http_code);
         response->error_message = strdup(error_buf);
         response->word_found = false;
     }
+}
+
+/**
+ * @brief Make HTTP request to Merriam-Webster API
+ */
+static APIResponse* make_api_request(const char* word) {
+    if (!g_initialized || !g_api_key) {
+        fprintf(stderr, "Error: API client not initialized\n");
+        return NULL;
+    }
+
+    // Allocate response structure
+    APIResponse* response = calloc(1, sizeof(APIResponse));
+    if (!response) return NULL;
+
+    // Initialize curl
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        response->error_message = strdup("Failed to initialize curl");
+        return response;
+    }
+
+    // Setup response buffer
+    MemoryStruct chunk = {0};
+    chunk.data = malloc(1);
+    chunk.size = 0;
+
+    prepare_api_request(curl, word, &chunk);
+    
+    // Perform request
+    CURLcode res = curl_easy_perform(curl);
+    complete_api_request(curl, res, &chunk, response);
 
     // Cleanup
     free(chunk.data);
@@ -201,50 +267,123 @@ static APIResponse* make_api_request(const char* word) {
 }
 
 /**
- * @brief Fetch word validation from Merriam-Webster API
+ * @brief Record the outcome of one API request in the global statistics
+ *
+ * @param response Response of the request, or NULL if it could not be made
  */
-int fetch_from_api(const char* word) {
-    if (!word || strlen(word) == 0) {
-        return -1;
-    }
+static void record_api_response(const APIResponse* response) {
+    pthread_mutex_lock(&g_stats_mutex);
 
-    // Update statistics
     g_stats.total_requests++;
-
-    // Make API request
-    APIResponse* response = make_api_request(word);
     if (!response) {
         g_stats.failed_requests++;
-        return -1;
+        pthread_mutex_unlock(&g_stats_mutex);
+        return;
     }
 
-    // Update statistics
     g_stats.total_response_time += response->response_time_ms;
     g_stats.avg_response_time = (double)g_stats.total_response_time / g_stats.total_requests;
 
-    int result;
     if (response->error_message) {
-        // API call failed
         g_stats.failed_requests++;
-        fprintf(stderr, "API Error for '%s': %s\n", word, response->error_message);
-        result = -1;
     } else {
-        // API call succeeded
         g_stats.successful_requests++;
-        
         if (response->word_found) {
             g_stats.words_found++;
-            printf("✓ API: Word '%s' found (response time: %dms)\n", 
-                   word, response->response_time_ms);
-            result = 1;
         } else {
             g_stats.words_not_found++;
-            printf("✗ API: Word '%s' not found (response time: %dms)\n", 
-                   word, response->response_time_ms);
-            result = 0;
         }
     }
 
+    pthread_mutex_unlock(&g_stats_mutex);
+}
+
+/**
+ * @brief Record whether a lookup was answered by the cache
+ */
+static void record_cache_lookup(bool hit) {
+    pthread_mutex_lock(&g_stats_mutex);
+    if (hit) {
+        g_stats.cache_hits++;
+    } else {
+        g_stats.cache_misses++;
+    }
+    pthread_mutex_unlock(&g_stats_mutex);
+}
+
+/**
+ * @brief Cache and print the outcome of a request for a word
+ *
+ * @return 1 if the word exists, 0 if not found, -1 if the request failed
+ */
+static int report_api_result(const char* word, const APIResponse* response) {
+    if (response->error_message) {
+        // API call failed; not cached so it is retried next time
+        fprintf(stderr, "API Error for '%s': %s\n", word, response->error_message);
+        return -1;
+    }
+
+    api_cache_store(g_cache, word, response->word_found);
+    if (g_quiet) {
+        return response->word_found ? 1 : 0;
+    }
+    if (response->word_found) {
+        printf("✓ API: Word '%s' found (response time: %dms)\n", 
+               word, response->response_time_ms);
+        return 1;
+    }
+
+    printf("✗ API: Word '%s' not found (response time: %dms)\n", 
+           word, response->response_time_ms);
+    return 0;
+}
+
+/**
+ * @brief Answer a word from the cache, recording the hit or miss
+ *
+ * @return 1 or 0 on a cache hit, -1 on a miss
+ */
+static int lookup_cached_result(const char* word) {
+    bool cached_found;
+    bool hit = api_cache_lookup(g_cache, word, &cached_found);
+    record_cache_lookup(hit);
+    if (!hit) {
+        return -1;
+    }
+
+    if (g_quiet) {
+        return cached_found ? 1 : 0;
+    }
+    if (cached_found) {
+        printf("✓ API: Word '%s' found (cached)\n", word);
+    } else {
+        printf("✗ API: Word '%s' not found (cached)\n", word);
+    }
+    return cached_found ? 1 : 0;
+}
+
+/**
+ * @brief Fetch word validation from Merriam-Webster API
+ */
+int fetch_from_api(const char* word) {
+    if (!word || strlen(word) == 0) {
+        return -1;
+    }
+
+    // Answer from the cache when possible
+    int cached = lookup_cached_result(word);
+    if (cached != -1) {
+        return cached;
+    }
+
+    // Make API request
+    APIResponse* response = make_api_request(word);
+    record_api_response(response);
+    if (!response) {
+        return -1;
+    }
+
+    int result = report_api_result(word, response);
     free_api_response(response);
     return result;
 }
@@ -257,60 +396,258 @@ APIResponse* fetch_word_details(const char* word) {
         return NULL;
     }
 
-    // Update statistics
-    g_stats.total_requests++;
-
-    // Make API request
+    // Make API request; the cache holds no definitions, but the answer is kept
     APIResponse* response = make_api_request(word);
-    if (!response) {
-        g_stats.failed_requests++;
-        return NULL;
+    record_api_response(response);
+    if (response && !response->error_message) {
+        api_cache_store(g_cache, word, response->word_found);
     }
 
-    // Update statistics
-    g_stats.total_response_time += response->response_time_ms;
-    g_stats.avg_response_time = (double)g_stats.total_response_time / g_stats.total_requests;
+    return response;
+}
 
-    if (response->error_message) {
-        g_stats.failed_requests++;
-    } else {
-        g_stats.successful_requests++;
-        if (response->word_found) {
-            g_stats.words_found++;
-        } else {
-            g_stats.words_not_found++;
+/**
+ * @brief Configure concurrency and rate limit of batch lookups
+ */
+void api_client_set_batch_limits(int max_concurrent, int max_requests_per_second) {
+    if (max_concurrent < 1) max_concurrent = 1;
+    if (max_concurrent > API_MAX_CONCURRENT) max_concurrent = API_MAX_CONCURRENT;
+    if (max_requests_per_second < 0) max_requests_per_second = 0;
+
+    g_max_concurrent = max_concurrent;
+    g_max_requests_per_second = max_requests_per_second;
+}
+
+void api_client_set_quiet(bool quiet) {
+    g_quiet = quiet;
+}
+
+/**
+ * @brief Milliseconds on a monotonic clock, for pacing batch requests
+ */
+static double monotonic_ms(void) {
+#ifdef _WIN32
+    return (double)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/**
+ * @brief One reusable transfer slot of a batch
+ *
+ * The easy handle is reused for successive words so libcurl can keep the
+ * connection to the API host alive between them.
+ */
+typedef struct {
+    CURL* curl;
+    MemoryStruct chunk;
+    int word_index;            // Index of the word in flight, -1 when idle
+} BatchTransfer;
+
+/**
+ * @brief Validate words one request at a time (fallback without curl_multi)
+ */
+static void fetch_batch_sequential(const char* const* words, const int* pending, int pending_count,
+                                   int* results) {
+    for (int i = 0; i < pending_count; i++) {
+        const char* word = words[pending[i]];
+        APIResponse* response = make_api_request(word);
+        record_api_response(response);
+        if (response) {
+            results[pending[i]] = report_api_result(word, response);
+            free_api_response(response);
         }
     }
+}
 
-    return response;
+/**
+ * @brief Store the outcome of a finished batch transfer and free its slot
+ */
+static void finish_batch_transfer(CURLM* multi, BatchTransfer* transfer, CURLcode res,
+                                  const char* const* words, int* results) {
+    APIResponse response = {0};
+    complete_api_request(transfer->curl, res, &transfer->chunk, &response);
+    record_api_response(&response);
+    results[transfer->word_index] = report_api_result(words[transfer->word_index], &response);
+
+    free(response.definition);
+    free(response.error_message);
+    curl_multi_remove_handle(multi, transfer->curl);
+    transfer->word_index = -1;
+}
+
+/**
+ * @brief Validate many words with concurrent requests
+ */
+int fetch_batch_from_api(const char* const* words, int count, int* results) {
+    if (!words || !results || count < 0) {
+        return -1;
+    }
+    if (!g_initialized || !g_api_key) {
+        fprintf(stderr, "Error: API client not initialized\n");
+        for (int i = 0; i < count; i++) results[i] = -1;
+        return -1;
+    }
+
+    // Answer what we can from the cache; the rest goes to the network
+    int* pending = malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!pending) return -1;
+
+    int pending_count = 0;
+    for (int i = 0; i < count; i++) {
+        results[i] = -1;
+        if (!words[i] || words[i][0] == '\0') continue;
+
+        results[i] = lookup_cached_result(words[i]);
+        if (results[i] == -1) {
+            pending[pending_count++] = i;
+        }
+    }
+
+    int slot_count = pending_count < g_max_concurrent ? pending_count : g_max_concurrent;
+    CURLM* multi = slot_count > 0 ? curl_multi_init() : NULL;
+    BatchTransfer* transfers = multi ? calloc(slot_count, sizeof(BatchTransfer)) : NULL;
+
+    int ready_slots = 0;
+    for (int t = 0; transfers && t < slot_count; t++) {
+        transfers[ready_slots].curl = curl_easy_init();
+        transfers[ready_slots].word_index = -1;
+        if (transfers[ready_slots].curl) ready_slots++;
+    }
+
+    if (pending_count > 0 && ready_slots == 0) {
+        // No multi interface available: still validate, one word at a time
+        fetch_batch_sequential(words, pending, pending_count, results);
+    } else if (pending_count > 0) {
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)ready_slots);
+
+        double interval_ms = g_max_requests_per_second > 0 ? 1000.0 / g_max_requests_per_second : 0.0;
+        double next_start_ms = monotonic_ms();
+        int next = 0;
+        int active = 0;
+
+        while (next < pending_count || active > 0) {
+            // Start words on idle slots, pacing them to the rate limit
+            for (int t = 0; t < ready_slots && next < pending_count; t++) {
+                if (transfers[t].word_index != -1) continue;
+                if (interval_ms > 0 && monotonic_ms() < next_start_ms) break;
+
+                BatchTransfer* transfer = &transfers[t];
+                free(transfer->chunk.data);
+                transfer->chunk.data = malloc(1);
+                transfer->chunk.size = 0;
+
+                int word_index = pending[next++];
+                next_start_ms += interval_ms;
+                if (!transfer->chunk.data) {
+                    record_api_response(NULL);
+                    continue;
+                }
+
+                prepare_api_request(transfer->curl, words[word_index], &transfer->chunk);
+                if (curl_multi_add_handle(multi, transfer->curl) != CURLM_OK) {
+                    record_api_response(NULL);
+                    continue;
+                }
+                transfer->word_index = word_index;
+                active++;
+            }
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+
+            // Collect finished transfers
+            CURLMsg* msg;
+            int queued;
+            while ((msg = curl_multi_info_read(multi, &queued)) != NULL) {
+                if (msg->msg != CURLMSG_DONE) continue;
+
+                for (int t = 0; t < ready_slots; t++) {
+                    if (transfers[t].curl == msg->easy_handle && transfers[t].word_index != -1) {
+                        finish_batch_transfer(multi, &transfers[t], msg->data.result, words, results);
+                        active--;
+                        break;
+                    }
+                }
+            }
+
+            // Sleep until there is network activity or the next start is due
+            if (active > 0 || next < pending_count) {
+                int timeout_ms = API_BATCH_POLL_MS;
+                if (interval_ms > 0 && next < pending_count && active < ready_slots) {
+                    double wait_ms = next_start_ms - monotonic_ms();
+                    timeout_ms = wait_ms <= 0 ? 0 : (wait_ms < timeout_ms ? (int)wait_ms + 1 : timeout_ms);
+                }
+                curl_multi_poll(multi, NULL, 0, timeout_ms, NULL);
+            }
+        }
+    }
+
+    for (int t = 0; t < ready_slots; t++) {
+        curl_easy_cleanup(transfers[t].curl);
+        free(transfers[t].chunk.data);
+    }
+    free(transfers);
+    if (multi) curl_multi_cleanup(multi);
+    free(pending);
+
+    int answered = 0;
+    for (int i = 0; i < count; i++) {
+        if (results[i] != -1) answered++;
+    }
+    return answered;
 }
 
 /**
  * @brief Get current API statistics
  */
 const APIStats* get_api_stats(void) {
-    return &g_stats;
+    get_api_stats_copy(&g_stats_snapshot);
+    return &g_stats_snapshot;
+}
+
+/**
+ * @brief Copy current API statistics into caller storage
+ */
+void get_api_stats_copy(APIStats* out) {
+    if (!out) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_stats_mutex);
+    *out = g_stats;
+    pthread_mutex_unlock(&g_stats_mutex);
 }
 
 /**
  * @brief Reset API statistics
  */
 void reset_api_stats(void) {
+    pthread_mutex_lock(&g_stats_mutex);
     memset(&g_stats, 0, sizeof(APIStats));
+    pthread_mutex_unlock(&g_stats_mutex);
 }
 
 /**
  * @brief Print API statistics to stdout
  */
 void print_api_stats(void) {
+    APIStats stats;
+    get_api_stats_copy(&stats);
+
     printf("\n=== API STATISTICS ===\n");
-    printf("Total Requests:      %d\n", g_stats.total_requests);
-    printf("Successful:          %d\n", g_stats.successful_requests);
-    printf("Failed:              %d\n", g_stats.failed_requests);
-    printf("Words Found:         %d\n", g_stats.words_found);
-    printf("Words Not Found:     %d\n", g_stats.words_not_found);
-    printf("Total Response Time: %ld ms\n", g_stats.total_response_time);
-    printf("Avg Response Time:   %.2f ms\n", g_stats.avg_response_time);
+    printf("Total Requests:      %d\n", stats.total_requests);
+    printf("Successful:          %d\n", stats.successful_requests);
+    printf("Failed:              %d\n", stats.failed_requests);
+    printf("Words Found:         %d\n", stats.words_found);
+    printf("Words Not Found:     %d\n", stats.words_not_found);
+    printf("Total Response Time: %ld ms\n", stats.total_response_time);
+    printf("Avg Response Time:   %.2f ms\n", stats.avg_response_time);
+    printf("Cache Hits:          %d\n", stats.cache_hits);
+    printf("Cache Misses:        %d\n", stats.cache_misses);
     printf("======================\n\n");
 }
 
@@ -337,9 +674,14 @@ void api_client_cleanup(void) {
         free(g_api_key);
         g_api_key = NULL;
     }
+
+    api_cache_close(g_cache);
+    g_cache = NULL;
     
     curl_global_cleanup();
     g_initialized = false;
     
-    printf("✅ API Client cleaned up\n");
+    if (!g_quiet) {
+        printf("✅ API Client cleaned up\n");
+    }
 }
\ No newline at end of file
@@ -0,0 +1,831 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/compact_trie.h"
+#include "../include/profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Marker written in native byte order to detect foreign-endian files
+ */
+#define COMPACT_TRIE_BYTE_ORDER 0x01020304u
+
+/**
+ * Find the child of a node carrying the given label
+ * @param ctrie Compact trie
+ * @param node Index of the parent node
+ * @param c Edge label to follow
+ * @return Index of the child, or COMPACT_TRIE_NO_NODE if absent
+ */
+static uint32_t find_child(const CompactTrie* ctrie, uint32_t node, unsigned char c) {
+    uint32_t first = ctrie->nodes[node].first_child;
+    uint32_t end = first + ctrie->nodes[node].child_count;
+    
+    // Children are stored in label order, so stop as soon as we pass c
+    for (uint32_t i = first; i < end; i++) {
+        if (ctrie->labels[i] == c) {
+            return i;
+        }
+        if (ctrie->labels[i] > c) {
+            break;
+        }
+    }
+    return COMPACT_TRIE_NO_NODE;
+}
+
+/**
+ * Follow a string from the root
+ * @param ctrie Compact trie
+ * @param str String to follow (lowercased on the fly)
+ * @return Index of the node reached, or COMPACT_TRIE_NO_NODE if the path does not exist
+ */
+static uint32_t find_node(const CompactTrie* ctrie, const char* str) {
+    uint32_t current = 0;
+    
+    for (size_t i = 0; str[i] != '\0'; i++) {
+        // Labels are a-z and the bytes of UTF-8 sequences (>= 0x80)
+        unsigned char c = (unsigned char)tolower((unsigned char)str[i]);
+        if ((c < 'a' || c > 'z') && c < 0x80) {
+            return COMPACT_TRIE_NO_NODE;
+        }
+        
+        current = find_child(ctrie, current, c);
+        if (current == COMPACT_TRIE_NO_NODE) {
+            return COMPACT_TRIE_NO_NODE;
+        }
+        PROFILE_COUNT(trie_nodes_visited, 1);
+    }
+    return current;
+}
+
+CompactTrie* compact_trie_build(const Trie* trie) {
+    if (trie == NULL || trie->root == NULL) {
+        return NULL;
+    }
+    
+    CompactTrie* ctrie = (CompactTrie*)malloc(sizeof(CompactTrie));
+    if (ctrie == NULL) {
+        return NULL;
+    }
+    
+    uint32_t node_count = (uint32_t)trie->node_count;
+    
+    // Nodes first (for alignment), labels right behind them
+    size_t nodes_size = (size_t)node_count * sizeof(CompactTrieNode);
+    ctrie->storage_size = nodes_size + node_count;
+    ctrie->storage = malloc(ctrie->storage_size);
+    
+    // BFS queue of source nodes, indexed by their compact position
+    const TrieNode** order = (const TrieNode**)malloc((size_t)node_count * sizeof(TrieNode*));
+    
+    if (ctrie->storage == NULL || order == NULL) {
+        free(ctrie->storage);
+        free(order);
+        free(ctrie);
+        return NULL;
+    }
+    
+    ctrie->nodes = (CompactTrieNode*)ctrie->storage;
+    ctrie->labels = (unsigned char*)ctrie->storage + nodes_size;
+    ctrie->node_count = node_count;
+    ctrie->total_words = trie->total_words;
+    ctrie->mapped = false;
+    ctrie->map_handle = NULL;
+    
+    order[0] = trie->root;
+    ctrie->labels[0] = '\0';
+    uint32_t tail = 1;
+    
+    // Level-order numbering: each node's children are appended together
+    for (uint32_t head = 0; head < node_count; head++) {
+        const TrieNode* source = order[head];
+        CompactTrieNode* node = &ctrie->nodes[head];
+        
+        node->first_child = tail;
+        node->child_count = 0;
+        node->word_count = (uint32_t)source->word_count;
+        node->is_end_of_word = source->is_end_of_word ? 1 : 0;
+        node->frequency_bound = source->frequency_bound;
+        
+        for (int i = 0; i < 26; i++) {
+            if (source->children[i] != NULL) {
+                order[tail] = source->children[i];
+                ctrie->labels[tail] = (unsigned char)('a' + i);
+                tail++;
+                node->child_count++;
+            }
+        }
+        
+        // Bytes >= 0x80 sort after a-z, and the extended list is already in order
+        for (const TrieNode* child = source->extended; child != NULL; child = child->next) {
+            order[tail] = child;
+            ctrie->labels[tail] = child->label;
+            tail++;
+            node->child_count++;
+        }
+    }
+    
+    free(order);
+    return ctrie;
+}
+
+bool compact_trie_search(const CompactTrie* ctrie, const char* word) {
+    if (ctrie == NULL || word == NULL || word[0] == '\0') {
+        return false;
+    }
+    
+    uint32_t node = find_node(ctrie, word);
+    return node != COMPACT_TRIE_NO_NODE && ctrie->nodes[node].is_end_of_word;
+}
+
+int compact_trie_get_frequency(const CompactTrie* ctrie, const char* word) {
+    if (ctrie == NULL || word == NULL || word[0] == '\0') {
+        return 0;
+    }
+    
+    uint32_t node = find_node(ctrie, word);
+    if (node == COMPACT_TRIE_NO_NODE || !ctrie->nodes[node].is_end_of_word) {
+        return 0;
+    }
+    uint32_t count = ctrie->nodes[node].word_count;
+    return (count > INT_MAX) ? INT_MAX : (int)count;
+}
+
+bool compact_trie_starts_with(const CompactTrie* ctrie, const char* prefix) {
+    if (ctrie == NULL || prefix == NULL || ctrie->total_words == 0) {
+        return false;
+    }
+    
+    return find_node(ctrie, prefix) != COMPACT_TRIE_NO_NODE;
+}
+
+/**
+ * State shared across the recursive fuzzy search walk
+ */
+typedef struct CompactFuzzyContext {
+    const CompactTrie* ctrie;   ///< Trie being searched
+    const char* query;          ///< Query word
+    int query_len;              ///< Length of the query word
+    int max_distance;           ///< Caller-requested distance bound
+    int* rows;                  ///< One DP row of (query_len + 1) ints per depth
+    int max_depth;              ///< Deepest level worth exploring
+    char prefix[TRIE_MAX_WORD_LENGTH + 1]; ///< Word spelled by the current path
+    TrieMatch* matches;         ///< Output buffer, kept sorted by distance
+    int match_count;            ///< Number of matches currently held
+    int max_matches;            ///< Capacity of the output buffer
+} CompactFuzzyContext;
+
+/**
+ * Current pruning bound (see trie_fuzzy_search)
+ * @param ctx Search context
+ * @return Largest distance still worth reporting
+ */
+static int compact_effective_bound(const CompactFuzzyContext* ctx) {
+    if (ctx->match_count < ctx->max_matches) {
+        return ctx->max_distance;
+    }
+    return ctx->matches[ctx->max_matches - 1].distance - 1;
+}
+
+/**
+ * Insert a word into the sorted match buffer, ties keep discovery order
+ * @param ctx Search context
+ * @param length Length of the word held in ctx->prefix
+ * @param distance Edit distance of the word from the query
+ * @param frequency Frequency of the word
+ */
+static void compact_add_match(CompactFuzzyContext* ctx, int length, int distance, uint32_t frequency) {
+    int pos = ctx->match_count;
+    while (pos > 0 && ctx->matches[pos - 1].distance > distance) {
+        pos--;
+    }
+    if (pos >= ctx->max_matches) {
+        return;
+    }
+    
+    int last = (ctx->match_count < ctx->max_matches) ? ctx->match_count : ctx->max_matches - 1;
+    for (int i = last; i > pos; i--) {
+        ctx->matches[i] = ctx->matches[i - 1];
+    }
+    
+    memcpy(ctx->matches[pos].word, ctx->prefix, (size_t)length);
+    ctx->matches[pos].word[length] = '\0';
+    ctx->matches[pos].distance = distance;
+    ctx->matches[pos].frequency = (frequency > INT_MAX) ? INT_MAX : (int)frequency;
+    
+    if (ctx->match_count < ctx->max_matches) {
+        ctx->match_count++;
+    }
+}
+
+/**
+ * Recursively score the children of a node from the parent's DP row
+ * @param ctx Search context
+ * @param node Index of the node whose children are explored
+ * @param depth Depth of node (its row is ctx->rows[depth])
+ */
+static void compact_fuzzy_walk(CompactFuzzyContext* ctx, uint32_t node, int depth) {
+    const CompactTrie* ctrie = ctx->ctrie;
+    int cols = ctx->query_len + 1;
+    const int* prev_row = ctx->rows + (size_t)depth * cols;
+    int* row = ctx->rows + (size_t)(depth + 1) * cols;
+    
+    uint32_t first = ctrie->nodes[node].first_child;
+    uint32_t end = first + ctrie->nodes[node].child_count;
+    
+    for (uint32_t child = first; child < end; child++) {
+        char c = (char)ctrie->labels[child];
+        row[0] = depth + 1;
+        int row_min = row[0];
+        PROFILE_COUNT(trie_nodes_visited, 1);
+        PROFILE_COUNT(dp_cells, cols - 1);
+        
+        for (int j = 1; j < cols; j++) {
+            int cost = (ctx->query[j - 1] == c) ? 0 : 1;
+            int substitute = prev_row[j - 1] + cost;
+            int insert = row[j - 1] + 1;
+            int delete = prev_row[j] + 1;
+            
+            int best = (substitute < insert) ? substitute : insert;
+            row[j] = (best < delete) ? best : delete;
+            if (row[j] < row_min) {
+                row_min = row[j];
+            }
+        }
+        
+        if (row_min > compact_effective_bound(ctx)) {
+            continue;
+        }
+        
+        ctx->prefix[depth] = c;
+        
+        if (ctrie->nodes[child].is_end_of_word && row[cols - 1] <= compact_effective_bound(ctx)) {
+            compact_add_match(ctx, depth + 1, row[cols - 1], ctrie->nodes[child].word_count);
+        }
+        
+        if (depth + 1 < ctx->max_depth) {
+            compact_fuzzy_walk(ctx, child, depth + 1);
+        }
+    }
+}
+
+int compact_trie_fuzzy_search(const CompactTrie* ctrie, const char* word, int max_distance,
+                              TrieMatch* matches, int max_matches) {
+    if (ctrie == NULL || word == NULL || matches == NULL || max_matches <= 0 || max_distance < 0) {
+        return 0;
+    }
+    
+    size_t word_len = strlen(word);
+    if (word_len == 0 || word_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    CompactFuzzyContext ctx;
+    ctx.ctrie = ctrie;
+    ctx.query = word;
+    ctx.query_len = (int)word_len;
+    ctx.max_distance = max_distance;
+    ctx.matches = matches;
+    ctx.match_count = 0;
+    ctx.max_matches = max_matches;
+    
+    ctx.max_depth = ctx.query_len + max_distance;
+    if (ctx.max_depth > TRIE_MAX_WORD_LENGTH) {
+        ctx.max_depth = TRIE_MAX_WORD_LENGTH;
+    }
+    
+    int cols = ctx.query_len + 1;
+    ctx.rows = (int*)malloc((size_t)(ctx.max_depth + 1) * cols * sizeof(int));
+    if (ctx.rows == NULL) {
+        return 0;
+    }
+    
+    for (int j = 0; j < cols; j++) {
+        ctx.rows[j] = j;
+    }
+    
+    compact_fuzzy_walk(&ctx, 0, 0);
+    
+    free(ctx.rows);
+    return ctx.match_count;
+}
+
+/**
+ * Entry of the completion queue: a subtree still to explore, or a word
+ */
+typedef struct CompactCompletionEntry {
+    uint32_t node;              ///< Root of the subtree, or the node ending the word
+    uint32_t key;               ///< Frequency bound of the subtree, or frequency of the word
+    bool is_word;               ///< Whether the entry is a finished word
+    int length;                 ///< Length of the path spelled by word
+    char word[TRIE_MAX_WORD_LENGTH + 1]; ///< Path from the root to node (NUL-terminated)
+} CompactCompletionEntry;
+
+/**
+ * Completion queue: a binary max-heap of entries
+ */
+typedef struct CompactCompletionQueue {
+    CompactCompletionEntry* entries; ///< Heap array
+    int count;                       ///< Number of entries
+    int capacity;                    ///< Allocated entries
+} CompactCompletionQueue;
+
+/**
+ * Order of completion entries (see trie_complete): higher key first, then alphabetical
+ * @param a First entry
+ * @param b Second entry
+ * @return true if a leaves the queue before b
+ */
+static bool compact_completion_before(const CompactCompletionEntry* a, const CompactCompletionEntry* b) {
+    if (a->key != b->key) {
+        return a->key > b->key;
+    }
+    return strcmp(a->word, b->word) < 0;
+}
+
+/**
+ * Add an entry to the completion queue
+ * @param queue Completion queue
+ * @param node Subtree root or word node
+ * @param key Frequency bound or word frequency
+ * @param is_word Whether the entry is a finished word
+ * @param word Path to node
+ * @param length Length of the path
+ * @return true on success, false on memory allocation failure
+ */
+static bool compact_completion_push(CompactCompletionQueue* queue, uint32_t node, uint32_t key, bool is_word,
+                                    const char* word, int length) {
+    if (queue->count == queue->capacity) {
+        int capacity = (queue->capacity == 0) ? 64 : queue->capacity * 2;
+        CompactCompletionEntry* entries = (CompactCompletionEntry*)realloc(queue->entries,
+                                                                           capacity * sizeof(CompactCompletionEntry));
+        if (entries == NULL) {
+            return false;
+        }
+        queue->entries = entries;
+        queue->capacity = capacity;
+    }
+    
+    CompactCompletionEntry entry;
+    entry.node = node;
+    entry.key = key;
+    entry.is_word = is_word;
+    entry.length = length;
+    memcpy(entry.word, word, (size_t)length);
+    entry.word[length] = '\0';
+    
+    // Sift up
+    int index = queue->count++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!compact_completion_before(&entry, &queue->entries[parent])) {
+            break;
+        }
+        queue->entries[index] = queue->entries[parent];
+        index = parent;
+    }
+    queue->entries[index] = entry;
+    return true;
+}
+
+/**
+ * Remove the first entry of the completion queue
+ * @param queue Non-empty completion queue
+ * @param out Receives the removed entry
+ */
+static void compact_completion_pop(CompactCompletionQueue* queue, CompactCompletionEntry* out) {
+    *out = queue->entries[0];
+    CompactCompletionEntry last = queue->entries[--queue->count];
+    
+    // Sift the last entry down from the root
+    int index = 0;
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= queue->count) {
+            break;
+        }
+        if (child + 1 < queue->count &&
+            compact_completion_before(&queue->entries[child + 1], &queue->entries[child])) {
+            child++;
+        }
+        if (!compact_completion_before(&queue->entries[child], &last)) {
+            break;
+        }
+        queue->entries[index] = queue->entries[child];
+        index = child;
+    }
+    if (queue->count > 0) {
+        queue->entries[index] = last;
+    }
+}
+
+int compact_trie_complete(const CompactTrie* ctrie, const char* prefix, TrieMatch* matches, int max_matches) {
+    if (ctrie == NULL || prefix == NULL || matches == NULL || max_matches <= 0 || ctrie->total_words == 0) {
+        return 0;
+    }
+    
+    size_t prefix_len = strlen(prefix);
+    if (prefix_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    uint32_t start = find_node(ctrie, prefix);
+    if (start == COMPACT_TRIE_NO_NODE || ctrie->nodes[start].frequency_bound == 0) {
+        return 0;
+    }
+    
+    // Spell the path as stored
+    char path[TRIE_MAX_WORD_LENGTH + 1];
+    for (size_t i = 0; i < prefix_len; i++) {
+        path[i] = (char)tolower((unsigned char)prefix[i]);
+    }
+    
+    CompactCompletionQueue queue = { NULL, 0, 0 };
+    int found = 0;
+    bool ok = compact_completion_push(&queue, start, trie_decode_frequency_bound(ctrie->nodes[start].frequency_bound),
+                                      false, path, (int)prefix_len);
+    
+    while (ok && found < max_matches && queue.count > 0) {
+        CompactCompletionEntry entry;
+        compact_completion_pop(&queue, &entry);
+        const CompactTrieNode* node = &ctrie->nodes[entry.node];
+        
+        if (entry.is_word) {
+            TrieMatch* match = &matches[found++];
+            memcpy(match->word, entry.word, (size_t)entry.length + 1);
+            match->distance = entry.length - (int)prefix_len;
+            match->frequency = (node->word_count > INT_MAX) ? INT_MAX : (int)node->word_count;
+            continue;
+        }
+        
+        // Expand the subtree: its own word and one entry per child
+        PROFILE_COUNT(trie_nodes_visited, 1);
+        if (node->is_end_of_word) {
+            ok = compact_completion_push(&queue, entry.node, node->word_count, true, entry.word, entry.length);
+        }
+        if (entry.length == TRIE_MAX_WORD_LENGTH) {
+            continue;
+        }
+        uint32_t end = node->first_child + node->child_count;
+        for (uint32_t child = node->first_child; ok && child < end; child++) {
+            entry.word[entry.length] = (char)ctrie->labels[child];
+            ok = compact_completion_push(&queue, child, trie_decode_frequency_bound(ctrie->nodes[child].frequency_bound),
+                                         false, entry.word, entry.length + 1);
+        }
+    }
+    
+    free(queue.entries);
+    return ok ? found : 0;
+}
+
+/**
+ * Recursively collect all words below a node in alphabetical order
+ * @param ctrie Compact trie
+ * @param node Current node index
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @param words Array to store words
+ * @param count Current count of words found
+ * @param capacity Current capacity of words array
+ */
+static void compact_collect_words(const CompactTrie* ctrie, uint32_t node, char* prefix, int depth,
+                                  char*** words, int* count, int* capacity) {
+    if (ctrie->nodes[node].is_end_of_word) {
+        if (*count >= *capacity) {
+            int new_capacity = *capacity * 2;
+            char** resized = (char**)realloc(*words, new_capacity * sizeof(char*));
+            if (resized == NULL) {
+                return; // Memory allocation failed, keep what we have
+            }
+            *words = resized;
+            *capacity = new_capacity;
+        }
+        
+        (*words)[*count] = (char*)malloc((size_t)depth + 1);
+        if ((*words)[*count] != NULL) {
+            memcpy((*words)[*count], prefix, (size_t)depth);
+            (*words)[*count][depth] = '\0';
+            (*count)++;
+        }
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return;
+    }
+    
+    uint32_t first = ctrie->nodes[node].first_child;
+    uint32_t end = first + ctrie->nodes[node].child_count;
+    for (uint32_t child = first; child < end; child++) {
+        prefix[depth] = (char)ctrie->labels[child];
+        compact_collect_words(ctrie, child, prefix, depth + 1, words, count, capacity);
+    }
+}
+
+void compact_trie_get_all_words(const CompactTrie* ctrie, char*** words, int* count) {
+    if (ctrie == NULL || words == NULL || count == NULL) {
+        if (words != NULL) *words = NULL;
+        if (count != NULL) *count = 0;
+        return;
+    }
+    
+    *count = 0;
+    int capacity = 100;
+    *words = (char**)malloc(capacity * sizeof(char*));
+    if (*words == NULL) {
+        return;
+    }
+    
+    char prefix[TRIE_MAX_WORD_LENGTH + 1];
+    compact_collect_words(ctrie, 0, prefix, 0, words, count, &capacity);
+    
+    if (*count == 0) {
+        free(*words);
+        *words = NULL;
+    }
+}
+
+/**
+ * Compute the FNV-1a 64-bit hash of a memory block
+ * @param data Block to hash
+ * @param size Size of the block in bytes
+ * @return 64-bit hash value
+ */
+static uint64_t fnv1a64(const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = 14695981039346656037ULL;
+    
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool compact_trie_save(const CompactTrie* ctrie, const char* filename) {
+    if (ctrie == NULL || filename == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - compact trie or filename is NULL\n");
+        return false;
+    }
+    
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Cannot create compiled dictionary '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check that the directory exists and you have write permissions\n");
+        return false;
+    }
+    
+    size_t nodes_size = (size_t)ctrie->node_count * sizeof(CompactTrieNode);
+    size_t labels_size = ctrie->node_count;
+    
+    CompactTrieFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COMPACT_TRIE_MAGIC, sizeof(header.magic));
+    header.version = COMPACT_TRIE_FORMAT_VERSION;
+    header.byte_order = COMPACT_TRIE_BYTE_ORDER;
+    header.header_size = (uint32_t)sizeof(CompactTrieFileHeader);
+    header.node_size = (uint32_t)sizeof(CompactTrieNode);
+    header.node_count = ctrie->node_count;
+    header.total_words = ctrie->total_words;
+    header.payload_size = nodes_size + labels_size;
+    
+    // Labels directly follow the nodes in the storage block, so the payload is contiguous
+    header.checksum = fnv1a64(ctrie->nodes, nodes_size + labels_size);
+    
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(ctrie->nodes, 1, nodes_size, file) == nodes_size &&
+              fwrite(ctrie->labels, 1, labels_size, file) == labels_size;
+    
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to write compiled dictionary '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check available disk space\n");
+        remove(filename);
+    }
+    return ok;
+}
+
+/**
+ * Map a whole file read-only
+ * @param filename File to map
+ * @param size Receives the file size
+ * @param handle Receives the platform mapping handle (Windows only)
+ * @return Base address of the mapping, or NULL on error
+ */
+static void* map_file(const char* filename, size_t* size, void** handle) {
+    *handle = NULL;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+    
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // The mapping keeps the file open
+    if (mapping == NULL) {
+        return NULL;
+    }
+    
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (base == NULL) {
+        CloseHandle(mapping);
+        return NULL;
+    }
+    
+    *size = (size_t)file_size.QuadPart;
+    *handle = mapping;
+    return base;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    
+    *size = (size_t)st.st_size;
+    return base;
+#endif
+}
+
+/**
+ * Release a mapping created by map_file()
+ * @param base Base address of the mapping
+ * @param size Size of the mapping
+ * @param handle Platform mapping handle (Windows only)
+ */
+static void unmap_file(void* base, size_t size, void* handle) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+    CloseHandle((HANDLE)handle);
+#else
+    (void)handle;
+    munmap(base, size);
+#endif
+}
+
+/**
+ * Validate a mapped compiled dictionary
+ * @param base Start of the mapping
+ * @param size Size of the mapping
+ * @param filename File name for error reporting
+ * @return true if header, structure and checksum are all valid
+ */
+static bool validate_compiled_file(const void* base, size_t size, const char* filename) {
+    const CompactTrieFileHeader* header = (const CompactTrieFileHeader*)base;
+    
+    if (size < sizeof(CompactTrieFileHeader) ||
+        memcmp(header->magic, COMPACT_TRIE_MAGIC, sizeof(header->magic)) != 0) {
+        fprintf(stderr, "Error: '%s' is not a compiled dictionary\n", filename);
+        return false;
+    }
+    
+    if (header->version != COMPACT_TRIE_FORMAT_VERSION ||
+        header->byte_order != COMPACT_TRIE_BYTE_ORDER ||
+        header->header_size != sizeof(CompactTrieFileHeader) ||
+        header->node_size != sizeof(CompactTrieNode)) {
+        fprintf(stderr, "Error: Compiled dictionary '%s' has an incompatible format (version %u)\n",
+                filename, (unsigned)header->version);
+        fprintf(stderr, "Suggestion: Recompile it with --compile-dict on this machine\n");
+        return false;
+    }
+    
+    uint64_t expected = (uint64_t)header->node_count * (sizeof(CompactTrieNode) + 1);
+    if (header->node_count == 0 || header->payload_size != expected ||
+        size - sizeof(CompactTrieFileHeader) < header->payload_size) {
+        fprintf(stderr, "Error: Compiled dictionary '%s' is truncated or corrupted\n", filename);
+        return false;
+    }
+    
+    const unsigned char* payload = (const unsigned char*)base + header->header_size;
+    if (fnv1a64(payload, (size_t)header->payload_size) != header->checksum) {
+        fprintf(stderr, "Error: Checksum mismatch in compiled dictionary '%s'\n", filename);
+        fprintf(stderr, "Suggestion: The file is corrupted, recompile it with --compile-dict\n");
+        return false;
+    }
+    
+    // Every child range must stay inside the node array for queries to be safe
+    const CompactTrieNode* nodes = (const CompactTrieNode*)payload;
+    for (uint32_t i = 0; i < header->node_count; i++) {
+        if ((uint64_t)nodes[i].first_child + nodes[i].child_count > header->node_count) {
+            fprintf(stderr, "Error: Compiled dictionary '%s' has invalid node links\n", filename);
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+CompactTrie* compact_trie_map(const char* filename) {
+    if (filename == NULL) {
+        return NULL;
+    }
+    
+    size_t size = 0;
+    void* handle = NULL;
+    void* base = map_file(filename, &size, &handle);
+    if (base == NULL) {
+        fprintf(stderr, "Error: Cannot map compiled dictionary '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check that the file exists and you have read permissions\n");
+        return NULL;
+    }
+    
+    if (!validate_compiled_file(base, size, filename)) {
+        unmap_file(base, size, handle);
+        return NULL;
+    }
+    
+    CompactTrie* ctrie = (CompactTrie*)malloc(sizeof(CompactTrie));
+    if (ctrie == NULL) {
+        unmap_file(base, size, handle);
+        return NULL;
+    }
+    
+    const CompactTrieFileHeader* header = (const CompactTrieFileHeader*)base;
+    unsigned char* payload = (unsigned char*)base + header->header_size;
+    
+    ctrie->nodes = (CompactTrieNode*)payload;
+    ctrie->labels = payload + (size_t)header->node_count * sizeof(CompactTrieNode);
+    ctrie->node_count = header->node_count;
+    ctrie->total_words = header->total_words;
+    ctrie->storage = base;
+    ctrie->storage_size = size;
+    ctrie->mapped = true;
+    ctrie->map_handle = handle;
+    
+    return ctrie;
+}
+
+bool compact_trie_is_compiled_file(const char* filename) {
+    if (filename == NULL) {
+        return false;
+    }
+    
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    
+    char magic[8];
+    bool matches = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                   memcmp(magic, COMPACT_TRIE_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+    
+    return matches;
+}
+
+size_t compact_trie_get_memory_usage(const CompactTrie* ctrie) {
+    if (ctrie == NULL) {
+        return 0;
+    }
+    
+    return sizeof(CompactTrie) + ctrie->storage_size;
+}
+
+void compact_trie_destroy(CompactTrie* ctrie) {
+    if (ctrie == NULL) {
+        return;
+    }
+    
+    if (ctrie->mapped) {
+        unmap_file(ctrie->storage, ctrie->storage_size, ctrie->map_handle);
+    } else {
+        free(ctrie->storage);
+    }
+    free(ctrie);
+}
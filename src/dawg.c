@@ -0,0 +1,1016 @@
+#include "../include/dawg.h"
+#include "../include/compact_trie.h"
+#include "../include/profile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+/**
+ * Marker for a state that does not exist
+ */
+#define DAWG_NO_STATE UINT32_MAX
+
+/**
+ * Most outgoing edges of a state, one per non-NUL byte value
+ */
+#define DAWG_MAX_EDGES 255
+
+/**
+ * A state on the path of the last added word, still open for new edges
+ */
+typedef struct DawgPendingState {
+    unsigned char labels[DAWG_MAX_EDGES];  ///< Edge labels in increasing order
+    uint32_t targets[DAWG_MAX_EDGES];      ///< Registered targets (the last one is set when its state is finished)
+    int edge_count;                        ///< Number of edges
+    bool is_final;                         ///< Whether a word ends here
+    unsigned char frequency_bound;         ///< Encoded bound over the words added through this state
+} DawgPendingState;
+
+struct DawgBuilder {
+    DawgPendingState path[TRIE_MAX_WORD_LENGTH + 1]; ///< path[d] is reached by the first d bytes of the last word
+    char last_word[TRIE_MAX_WORD_LENGTH];  ///< Last word added
+    size_t last_length;                    ///< Length of the last word, 0 before the first one
+    DawgState* states;                     ///< Registered states, children before parents
+    uint32_t state_count;                  ///< Number of registered states
+    uint32_t state_capacity;               ///< Allocated states
+    uint32_t* targets;                     ///< Edge targets of the registered states
+    unsigned char* labels;                 ///< Edge labels of the registered states
+    uint32_t edge_count;                   ///< Number of registered edges
+    uint32_t edge_capacity;                ///< Allocated edges
+    uint32_t* frequencies;                 ///< Frequency of each word, in arrival (rank) order
+    uint32_t word_count;                   ///< Number of words added
+    uint32_t frequency_capacity;           ///< Allocated frequencies
+    bool all_ones;                         ///< Whether every frequency so far is 1
+    uint32_t* table;                       ///< Register of states: state index + 1, 0 for an empty slot
+    uint32_t table_mask;                   ///< Register size minus one (a power of two)
+    bool failed;                           ///< Whether an earlier add ran out of memory
+};
+
+/**
+ * Grow a builder array to hold at least the needed number of elements
+ * @param array Current array (never NULL, the builder allocates every array up front)
+ * @param capacity Current capacity, updated on success
+ * @param needed Number of elements that must fit
+ * @param element_size Size of one element
+ * @return The (possibly moved) array, or NULL on memory allocation failure or overflow
+ */
+static void* grow_array(void* array, uint32_t* capacity, uint64_t needed, size_t element_size) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    if (needed >= UINT32_MAX) {
+        return NULL;
+    }
+    
+    uint64_t new_capacity = (uint64_t)*capacity * 2;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    if (new_capacity >= UINT32_MAX) {
+        new_capacity = UINT32_MAX - 1;
+    }
+    
+    void* resized = realloc(array, (size_t)new_capacity * element_size);
+    if (resized == NULL) {
+        return NULL;
+    }
+    *capacity = (uint32_t)new_capacity;
+    return resized;
+}
+
+/**
+ * Hash the right language signature of a state: its final flag and edges
+ * @param is_final Whether the state is final
+ * @param labels Edge labels
+ * @param targets Edge targets
+ * @param count Number of edges
+ * @return Mixed 32-bit hash
+ */
+static uint32_t hash_state(bool is_final, const unsigned char* labels, const uint32_t* targets, uint32_t count) {
+    uint64_t hash = is_final ? 0x9e3779b97f4a7c15ULL : 14695981039346656037ULL;
+    for (uint32_t i = 0; i < count; i++) {
+        hash ^= ((uint64_t)labels[i] << 32) | targets[i];
+        hash *= 1099511628211ULL;
+    }
+    
+    // MurmurHash3 finalizer, so the low bits used as the slot index are well mixed
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return (uint32_t)hash;
+}
+
+/**
+ * Check whether a registered state has the same final flag and edges as a pending one
+ * @param builder Builder
+ * @param state Registered state index
+ * @param pending Pending state
+ * @return true if both accept the same endings
+ */
+static bool state_equals(const DawgBuilder* builder, uint32_t state, const DawgPendingState* pending) {
+    const DawgState* registered = &builder->states[state];
+    if ((registered->is_final != 0) != pending->is_final || registered->edge_count != pending->edge_count) {
+        return false;
+    }
+    
+    size_t count = (size_t)pending->edge_count;
+    return memcmp(builder->labels + registered->first_edge, pending->labels, count) == 0 &&
+           memcmp(builder->targets + registered->first_edge, pending->targets, count * sizeof(uint32_t)) == 0;
+}
+
+/**
+ * Double the register and reinsert every state
+ * @param builder Builder
+ * @return true on success, false on memory allocation failure
+ */
+static bool grow_table(DawgBuilder* builder) {
+    uint64_t size = ((uint64_t)builder->table_mask + 1) * 2;
+    if (size > ((uint64_t)1 << 31)) {
+        return false;
+    }
+    
+    uint32_t* table = (uint32_t*)calloc((size_t)size, sizeof(uint32_t));
+    if (table == NULL) {
+        return false;
+    }
+    
+    uint32_t mask = (uint32_t)(size - 1);
+    for (uint32_t state = 0; state < builder->state_count; state++) {
+        const DawgState* registered = &builder->states[state];
+        uint32_t index = hash_state(registered->is_final != 0, builder->labels + registered->first_edge,
+                                    builder->targets + registered->first_edge, registered->edge_count) & mask;
+        while (table[index] != 0) {
+            index = (index + 1) & mask;
+        }
+        table[index] = state + 1;
+    }
+    
+    free(builder->table);
+    builder->table = table;
+    builder->table_mask = mask;
+    return true;
+}
+
+/**
+ * Replace a finished pending state by its registered equivalent, registering it if there is none
+ * @param builder Builder
+ * @param pending Finished state (all edge targets set)
+ * @return Index of the registered state, or DAWG_NO_STATE on memory allocation failure
+ */
+static uint32_t register_state(DawgBuilder* builder, const DawgPendingState* pending) {
+    // Keep the register at most half full, so every probe chain ends at an empty slot
+    if ((uint64_t)(builder->state_count + 1) * 2 > (uint64_t)builder->table_mask + 1 && !grow_table(builder)) {
+        return DAWG_NO_STATE;
+    }
+    
+    uint32_t count = (uint32_t)pending->edge_count;
+    uint32_t index = hash_state(pending->is_final, pending->labels, pending->targets, count) & builder->table_mask;
+    while (builder->table[index] != 0) {
+        uint32_t state = builder->table[index] - 1;
+        if (state_equals(builder, state, pending)) {
+            // The merged state now also carries the pending state's words
+            if (pending->frequency_bound > builder->states[state].frequency_bound) {
+                builder->states[state].frequency_bound = pending->frequency_bound;
+            }
+            return state;
+        }
+        index = (index + 1) & builder->table_mask;
+    }
+    
+    DawgState* states = (DawgState*)grow_array(builder->states, &builder->state_capacity,
+                                               (uint64_t)builder->state_count + 1, sizeof(DawgState));
+    if (states == NULL) {
+        return DAWG_NO_STATE;
+    }
+    builder->states = states;
+    
+    uint64_t edges_needed = (uint64_t)builder->edge_count + count;
+    uint32_t label_capacity = builder->edge_capacity;
+    uint32_t* targets = (uint32_t*)grow_array(builder->targets, &builder->edge_capacity, edges_needed, sizeof(uint32_t));
+    if (targets == NULL) {
+        return DAWG_NO_STATE;
+    }
+    builder->targets = targets;
+    unsigned char* labels = (unsigned char*)grow_array(builder->labels, &label_capacity, edges_needed, 1);
+    if (labels == NULL) {
+        return DAWG_NO_STATE;
+    }
+    builder->labels = labels;
+    
+    uint64_t word_count = pending->is_final ? 1 : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        word_count += builder->states[pending->targets[i]].word_count;
+    }
+    
+    uint32_t state = builder->state_count++;
+    DawgState* added = &builder->states[state];
+    added->first_edge = builder->edge_count;
+    added->word_count = (uint32_t)word_count;
+    added->edge_count = (uint16_t)count;
+    added->is_final = pending->is_final ? 1 : 0;
+    added->frequency_bound = pending->frequency_bound;
+    
+    memcpy(builder->labels + builder->edge_count, pending->labels, count);
+    memcpy(builder->targets + builder->edge_count, pending->targets, count * sizeof(uint32_t));
+    builder->edge_count += count;
+    
+    builder->table[index] = state + 1;
+    return state;
+}
+
+/**
+ * Register the states of the last word's path below a depth
+ * @param builder Builder
+ * @param keep Depth of the deepest state that stays pending
+ * @return true on success, false on memory allocation failure
+ */
+static bool finish_path(DawgBuilder* builder, size_t keep) {
+    for (size_t depth = builder->last_length; depth > keep; depth--) {
+        uint32_t state = register_state(builder, &builder->path[depth]);
+        if (state == DAWG_NO_STATE) {
+            return false;
+        }
+        DawgPendingState* parent = &builder->path[depth - 1];
+        parent->targets[parent->edge_count - 1] = state;
+    }
+    builder->last_length = keep;
+    return true;
+}
+
+/**
+ * Reset a pending state to an empty, non-final state
+ * @param pending State to reset
+ */
+static void clear_pending(DawgPendingState* pending) {
+    pending->edge_count = 0;
+    pending->is_final = false;
+    pending->frequency_bound = 0;
+}
+
+DawgBuilder* dawg_builder_create(void) {
+    DawgBuilder* builder = (DawgBuilder*)calloc(1, sizeof(DawgBuilder));
+    if (builder == NULL) {
+        return NULL;
+    }
+    
+    builder->table_mask = 1023;
+    builder->table = (uint32_t*)calloc((size_t)builder->table_mask + 1, sizeof(uint32_t));
+    builder->state_capacity = 256;
+    builder->states = (DawgState*)malloc(builder->state_capacity * sizeof(DawgState));
+    builder->edge_capacity = 256;
+    builder->targets = (uint32_t*)malloc(builder->edge_capacity * sizeof(uint32_t));
+    builder->labels = (unsigned char*)malloc(builder->edge_capacity);
+    builder->frequency_capacity = 256;
+    builder->frequencies = (uint32_t*)malloc(builder->frequency_capacity * sizeof(uint32_t));
+    if (builder->table == NULL || builder->states == NULL || builder->targets == NULL ||
+        builder->labels == NULL || builder->frequencies == NULL) {
+        dawg_builder_destroy(builder);
+        return NULL;
+    }
+    
+    builder->all_ones = true;
+    clear_pending(&builder->path[0]);
+    return builder;
+}
+
+bool dawg_builder_add(DawgBuilder* builder, const char* word, size_t length, int frequency) {
+    if (builder == NULL || word == NULL || builder->failed || length == 0 || length > TRIE_MAX_WORD_LENGTH ||
+        frequency < 1 || builder->word_count >= INT_MAX) {
+        return false;
+    }
+    
+    size_t limit = (length < builder->last_length) ? length : builder->last_length;
+    size_t common = 0;
+    while (common < limit && word[common] == builder->last_word[common]) {
+        common++;
+    }
+    
+    // Strictly increasing order: not a prefix of the last word, and larger at the first difference
+    if (common == length || (common < builder->last_length &&
+                             (unsigned char)word[common] < (unsigned char)builder->last_word[common])) {
+        return false;
+    }
+    for (size_t i = common; i < length; i++) {
+        if (word[i] == '\0') {
+            return false;
+        }
+    }
+    
+    uint32_t* frequencies = (uint32_t*)grow_array(builder->frequencies, &builder->frequency_capacity,
+                                                  (uint64_t)builder->word_count + 1, sizeof(uint32_t));
+    if (frequencies == NULL) {
+        return false;
+    }
+    builder->frequencies = frequencies;
+    
+    // The part of the last word's path that the new word leaves behind is final now
+    if (!finish_path(builder, common)) {
+        builder->failed = true;
+        return false;
+    }
+    
+    for (size_t depth = common; depth < length; depth++) {
+        DawgPendingState* pending = &builder->path[depth];
+        pending->labels[pending->edge_count] = (unsigned char)word[depth];
+        pending->targets[pending->edge_count] = DAWG_NO_STATE;
+        pending->edge_count++;
+        clear_pending(&builder->path[depth + 1]);
+    }
+    builder->path[length].is_final = true;
+    
+    unsigned char bound = trie_encode_frequency_bound(frequency);
+    for (size_t depth = 0; depth <= length; depth++) {
+        if (builder->path[depth].frequency_bound < bound) {
+            builder->path[depth].frequency_bound = bound;
+        }
+    }
+    
+    builder->frequencies[builder->word_count++] = (uint32_t)frequency;
+    if (frequency != 1) {
+        builder->all_ones = false;
+    }
+    
+    memcpy(builder->last_word + common, word + common, length - common);
+    builder->last_length = length;
+    return true;
+}
+
+/**
+ * Copy the registered states into the final single-block layout
+ * @param builder Builder whose root was registered last
+ * @return The Dawg, or NULL on memory allocation failure
+ */
+static Dawg* dawg_assemble(const DawgBuilder* builder) {
+    Dawg* dawg = (Dawg*)malloc(sizeof(Dawg));
+    if (dawg == NULL) {
+        return NULL;
+    }
+    
+    uint32_t state_count = builder->state_count;
+    uint32_t edge_count = builder->edge_count;
+    size_t states_size = (size_t)state_count * sizeof(DawgState);
+    size_t targets_size = (size_t)edge_count * sizeof(uint32_t);
+    size_t frequencies_size = builder->all_ones ? 0 : (size_t)builder->word_count * sizeof(uint32_t);
+    
+    // 4-byte arrays first (for alignment), labels at the end
+    dawg->storage_size = states_size + targets_size + frequencies_size + edge_count;
+    dawg->storage = malloc(dawg->storage_size);
+    if (dawg->storage == NULL) {
+        free(dawg);
+        return NULL;
+    }
+    
+    unsigned char* base = (unsigned char*)dawg->storage;
+    dawg->states = (DawgState*)base;
+    dawg->targets = (uint32_t*)(base + states_size);
+    dawg->frequencies = builder->all_ones ? NULL : (uint32_t*)(base + states_size + targets_size);
+    dawg->labels = base + states_size + targets_size + frequencies_size;
+    dawg->state_count = state_count;
+    dawg->edge_count = edge_count;
+    dawg->total_words = (int)builder->word_count;
+    
+    // States were registered children first, ending with the root: reverse
+    // them so the root is state 0 and a walk moves forward through memory
+    for (uint32_t i = 0; i < state_count; i++) {
+        dawg->states[i] = builder->states[state_count - 1 - i];
+    }
+    for (uint32_t e = 0; e < edge_count; e++) {
+        dawg->targets[e] = state_count - 1 - builder->targets[e];
+    }
+    memcpy(dawg->labels, builder->labels, edge_count);
+    if (dawg->frequencies != NULL) {
+        memcpy(dawg->frequencies, builder->frequencies, frequencies_size);
+    }
+    
+    return dawg;
+}
+
+Dawg* dawg_builder_finish(DawgBuilder* builder) {
+    if (builder == NULL) {
+        return NULL;
+    }
+    
+    // A finite language is never the right language of a non-root state, so the root is always new
+    Dawg* dawg = NULL;
+    if (!builder->failed && finish_path(builder, 0) &&
+        register_state(builder, &builder->path[0]) != DAWG_NO_STATE) {
+        dawg = dawg_assemble(builder);
+    }
+    
+    dawg_builder_destroy(builder);
+    return dawg;
+}
+
+void dawg_builder_destroy(DawgBuilder* builder) {
+    if (builder == NULL) {
+        return;
+    }
+    
+    free(builder->states);
+    free(builder->targets);
+    free(builder->labels);
+    free(builder->frequencies);
+    free(builder->table);
+    free(builder);
+}
+
+/**
+ * Feed the words below a pointer node to a builder in sorted order
+ * @param builder Builder
+ * @param node Current node
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @return true on success, false if a word could not be added
+ */
+static bool add_trie_words(DawgBuilder* builder, const TrieNode* node, char* prefix, int depth) {
+    if (node->is_end_of_word && depth > 0 &&
+        !dawg_builder_add(builder, prefix, (size_t)depth, node->word_count)) {
+        return false;
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return true;
+    }
+    
+    for (int i = 0; i < 26; i++) {
+        if (node->children[i] != NULL) {
+            prefix[depth] = (char)('a' + i);
+            if (!add_trie_words(builder, node->children[i], prefix, depth + 1)) {
+                return false;
+            }
+        }
+    }
+    
+    // Bytes >= 0x80 sort after a-z, and the extended list is already in order
+    for (const TrieNode* child = node->extended; child != NULL; child = child->next) {
+        prefix[depth] = (char)child->label;
+        if (!add_trie_words(builder, child, prefix, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Feed the words below a compact node to a builder in sorted order
+ * @param builder Builder
+ * @param ctrie Compact trie
+ * @param node Current node index
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @return true on success, false if a word could not be added
+ */
+static bool add_compact_words(DawgBuilder* builder, const CompactTrie* ctrie, uint32_t node, char* prefix, int depth) {
+    const CompactTrieNode* current = &ctrie->nodes[node];
+    int frequency = current->word_count > INT_MAX ? INT_MAX : (int)current->word_count;
+    if (current->is_end_of_word && depth > 0 && !dawg_builder_add(builder, prefix, (size_t)depth, frequency)) {
+        return false;
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return true;
+    }
+    
+    uint32_t end = current->first_child + current->child_count;
+    for (uint32_t child = current->first_child; child < end; child++) {
+        prefix[depth] = (char)ctrie->labels[child];
+        if (!add_compact_words(builder, ctrie, child, prefix, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Dawg* dawg_build(const Trie* trie) {
+    if (trie == NULL || (trie->root == NULL && trie->compact == NULL)) {
+        return NULL;
+    }
+    
+    DawgBuilder* builder = dawg_builder_create();
+    if (builder == NULL) {
+        return NULL;
+    }
+    
+    char prefix[TRIE_MAX_WORD_LENGTH + 1];
+    bool added = (trie->compact != NULL) ? add_compact_words(builder, trie->compact, 0, prefix, 0)
+                                         : add_trie_words(builder, trie->root, prefix, 0);
+    if (!added) {
+        dawg_builder_destroy(builder);
+        return NULL;
+    }
+    
+    return dawg_builder_finish(builder);
+}
+
+/**
+ * Follow a string from the root
+ * @param dawg Dawg
+ * @param str String to follow (lowercased on the fly)
+ * @param rank Receives the number of accepted words sorting before str (may be NULL)
+ * @return State reached, or DAWG_NO_STATE if the path does not exist
+ */
+static uint32_t find_state(const Dawg* dawg, const char* str, uint32_t* rank) {
+    uint32_t current = 0;
+    uint32_t before = 0;
+    
+    for (size_t i = 0; str[i] != '\0'; i++) {
+        // Labels are a-z and the bytes of UTF-8 sequences (>= 0x80)
+        unsigned char c = (unsigned char)tolower((unsigned char)str[i]);
+        if ((c < 'a' || c > 'z') && c < 0x80) {
+            return DAWG_NO_STATE;
+        }
+        
+        const DawgState* state = &dawg->states[current];
+        uint32_t end = state->first_edge + state->edge_count;
+        uint32_t next = DAWG_NO_STATE;
+        before += state->is_final;
+        
+        // Edges are stored in label order; every word behind an earlier edge sorts before str
+        for (uint32_t e = state->first_edge; e < end; e++) {
+            if (dawg->labels[e] == c) {
+                next = dawg->targets[e];
+                break;
+            }
+            if (dawg->labels[e] > c) {
+                break;
+            }
+            if (rank != NULL) {
+                before += dawg->states[dawg->targets[e]].word_count;
+            }
+        }
+        if (next == DAWG_NO_STATE) {
+            return DAWG_NO_STATE;
+        }
+        current = next;
+        PROFILE_COUNT(trie_nodes_visited, 1);
+    }
+    
+    if (rank != NULL) {
+        *rank = before;
+    }
+    return current;
+}
+
+/**
+ * Look up the frequency of the word with a given rank
+ * @param dawg Dawg
+ * @param rank Rank of the word in sorted order
+ * @return Its frequency
+ */
+static int frequency_at(const Dawg* dawg, uint32_t rank) {
+    if (dawg->frequencies == NULL) {
+        return 1;
+    }
+    uint32_t frequency = dawg->frequencies[rank];
+    return (frequency > INT_MAX) ? INT_MAX : (int)frequency;
+}
+
+bool dawg_search(const Dawg* dawg, const char* word) {
+    if (dawg == NULL || word == NULL || word[0] == '\0') {
+        return false;
+    }
+    
+    uint32_t state = find_state(dawg, word, NULL);
+    return state != DAWG_NO_STATE && dawg->states[state].is_final;
+}
+
+int dawg_get_frequency(const Dawg* dawg, const char* word) {
+    if (dawg == NULL || word == NULL || word[0] == '\0') {
+        return 0;
+    }
+    
+    uint32_t rank = 0;
+    uint32_t state = find_state(dawg, word, &rank);
+    if (state == DAWG_NO_STATE || !dawg->states[state].is_final) {
+        return 0;
+    }
+    return frequency_at(dawg, rank);
+}
+
+bool dawg_starts_with(const Dawg* dawg, const char* prefix) {
+    if (dawg == NULL || prefix == NULL || dawg->total_words == 0) {
+        return false;
+    }
+    
+    return find_state(dawg, prefix, NULL) != DAWG_NO_STATE;
+}
+
+/**
+ * State shared across the recursive fuzzy search walk
+ */
+typedef struct DawgFuzzyContext {
+    const Dawg* dawg;           ///< Automaton being searched
+    const char* query;          ///< Query word
+    int query_len;              ///< Length of the query word
+    int max_distance;           ///< Caller-requested distance bound
+    int* rows;                  ///< One DP row of (query_len + 1) ints per depth
+    int max_depth;              ///< Deepest level worth exploring
+    char prefix[TRIE_MAX_WORD_LENGTH + 1]; ///< Word spelled by the current path
+    TrieMatch* matches;         ///< Output buffer, kept sorted by distance
+    int match_count;            ///< Number of matches currently held
+    int max_matches;            ///< Capacity of the output buffer
+} DawgFuzzyContext;
+
+/**
+ * Current pruning bound (see trie_fuzzy_search)
+ * @param ctx Search context
+ * @return Largest distance still worth reporting
+ */
+static int dawg_effective_bound(const DawgFuzzyContext* ctx) {
+    if (ctx->match_count < ctx->max_matches) {
+        return ctx->max_distance;
+    }
+    return ctx->matches[ctx->max_matches - 1].distance - 1;
+}
+
+/**
+ * Insert a word into the sorted match buffer, ties keep discovery order
+ * @param ctx Search context
+ * @param length Length of the word held in ctx->prefix
+ * @param distance Edit distance of the word from the query
+ * @param frequency Frequency of the word
+ */
+static void dawg_add_match(DawgFuzzyContext* ctx, int length, int distance, int frequency) {
+    int pos = ctx->match_count;
+    while (pos > 0 && ctx->matches[pos - 1].distance > distance) {
+        pos--;
+    }
+    if (pos >= ctx->max_matches) {
+        return;
+    }
+    
+    int last = (ctx->match_count < ctx->max_matches) ? ctx->match_count : ctx->max_matches - 1;
+    for (int i = last; i > pos; i--) {
+        ctx->matches[i] = ctx->matches[i - 1];
+    }
+    
+    memcpy(ctx->matches[pos].word, ctx->prefix, (size_t)length);
+    ctx->matches[pos].word[length] = '\0';
+    ctx->matches[pos].distance = distance;
+    ctx->matches[pos].frequency = frequency;
+    
+    if (ctx->match_count < ctx->max_matches) {
+        ctx->match_count++;
+    }
+}
+
+/**
+ * Recursively score the edges of a state from the parent's DP row
+ * @param ctx Search context
+ * @param state State whose edges are explored
+ * @param depth Length of the path to state (its row is ctx->rows[depth])
+ * @param rank Number of words sorting before the path to state
+ */
+static void dawg_fuzzy_walk(DawgFuzzyContext* ctx, uint32_t state, int depth, uint32_t rank) {
+    const Dawg* dawg = ctx->dawg;
+    int cols = ctx->query_len + 1;
+    const int* prev_row = ctx->rows + (size_t)depth * cols;
+    int* row = ctx->rows + (size_t)(depth + 1) * cols;
+    
+    const DawgState* current = &dawg->states[state];
+    uint32_t end = current->first_edge + current->edge_count;
+    uint32_t child_rank = rank + current->is_final;
+    
+    for (uint32_t e = current->first_edge; e < end; e++) {
+        uint32_t child = dawg->targets[e];
+        uint32_t rank_here = child_rank;
+        child_rank += dawg->states[child].word_count;
+        
+        char c = (char)dawg->labels[e];
+        row[0] = depth + 1;
+        int row_min = row[0];
+        PROFILE_COUNT(trie_nodes_visited, 1);
+        PROFILE_COUNT(dp_cells, cols - 1);
+        
+        for (int j = 1; j < cols; j++) {
+            int cost = (ctx->query[j - 1] == c) ? 0 : 1;
+            int substitute = prev_row[j - 1] + cost;
+            int insert = row[j - 1] + 1;
+            int delete = prev_row[j] + 1;
+            
+            int best = (substitute < insert) ? substitute : insert;
+            row[j] = (best < delete) ? best : delete;
+            if (row[j] < row_min) {
+                row_min = row[j];
+            }
+        }
+        
+        if (row_min > dawg_effective_bound(ctx)) {
+            continue;
+        }
+        
+        ctx->prefix[depth] = c;
+        
+        if (dawg->states[child].is_final && row[cols - 1] <= dawg_effective_bound(ctx)) {
+            dawg_add_match(ctx, depth + 1, row[cols - 1], frequency_at(dawg, rank_here));
+        }
+        
+        if (depth + 1 < ctx->max_depth) {
+            dawg_fuzzy_walk(ctx, child, depth + 1, rank_here);
+        }
+    }
+}
+
+int dawg_fuzzy_search(const Dawg* dawg, const char* word, int max_distance, TrieMatch* matches, int max_matches) {
+    if (dawg == NULL || word == NULL || matches == NULL || max_matches <= 0 || max_distance < 0) {
+        return 0;
+    }
+    
+    size_t word_len = strlen(word);
+    if (word_len == 0 || word_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    DawgFuzzyContext ctx;
+    ctx.dawg = dawg;
+    ctx.query = word;
+    ctx.query_len = (int)word_len;
+    ctx.max_distance = max_distance;
+    ctx.matches = matches;
+    ctx.match_count = 0;
+    ctx.max_matches = max_matches;
+    
+    ctx.max_depth = ctx.query_len + max_distance;
+    if (ctx.max_depth > TRIE_MAX_WORD_LENGTH) {
+        ctx.max_depth = TRIE_MAX_WORD_LENGTH;
+    }
+    
+    int cols = ctx.query_len + 1;
+    ctx.rows = (int*)malloc((size_t)(ctx.max_depth + 1) * cols * sizeof(int));
+    if (ctx.rows == NULL) {
+        return 0;
+    }
+    
+    for (int j = 0; j < cols; j++) {
+        ctx.rows[j] = j;
+    }
+    
+    dawg_fuzzy_walk(&ctx, 0, 0, 0);
+    
+    free(ctx.rows);
+    return ctx.match_count;
+}
+
+/**
+ * Entry of the completion queue: a sub-automaton still to explore, or a word
+ */
+typedef struct DawgCompletionEntry {
+    uint32_t state;             ///< State the path leads to
+    uint32_t rank;              ///< Number of words sorting before the path
+    uint32_t key;               ///< Frequency bound of the state, or frequency of the word
+    bool is_word;               ///< Whether the entry is a finished word
+    int length;                 ///< Length of the path spelled by word
+    char word[TRIE_MAX_WORD_LENGTH + 1]; ///< Path from the root to state (NUL-terminated)
+} DawgCompletionEntry;
+
+/**
+ * Completion queue: a binary max-heap of entries
+ */
+typedef struct DawgCompletionQueue {
+    DawgCompletionEntry* entries; ///< Heap array
+    int count;                    ///< Number of entries
+    int capacity;                 ///< Allocated entries
+} DawgCompletionQueue;
+
+/**
+ * Order of completion entries (see trie_complete): higher key first, then alphabetical
+ * @param a First entry
+ * @param b Second entry
+ * @return true if a leaves the queue before b
+ */
+static bool dawg_completion_before(const DawgCompletionEntry* a, const DawgCompletionEntry* b) {
+    if (a->key != b->key) {
+        return a->key > b->key;
+    }
+    return strcmp(a->word, b->word) < 0;
+}
+
+/**
+ * Add an entry to the completion queue
+ * @param queue Completion queue
+ * @param state State the path leads to
+ * @param rank Number of words sorting before the path
+ * @param key Frequency bound or word frequency
+ * @param is_word Whether the entry is a finished word
+ * @param word Path to state
+ * @param length Length of the path
+ * @return true on success, false on memory allocation failure
+ */
+static bool dawg_completion_push(DawgCompletionQueue* queue, uint32_t state, uint32_t rank, uint32_t key,
+                                 bool is_word, const char* word, int length) {
+    if (queue->count == queue->capacity) {
+        int capacity = (queue->capacity == 0) ? 64 : queue->capacity * 2;
+        DawgCompletionEntry* entries = (DawgCompletionEntry*)realloc(queue->entries,
+                                                                     capacity * sizeof(DawgCompletionEntry));
+        if (entries == NULL) {
+            return false;
+        }
+        queue->entries = entries;
+        queue->capacity = capacity;
+    }
+    
+    DawgCompletionEntry entry;
+    entry.state = state;
+    entry.rank = rank;
+    entry.key = key;
+    entry.is_word = is_word;
+    entry.length = length;
+    memcpy(entry.word, word, (size_t)length);
+    entry.word[length] = '\0';
+    
+    // Sift up
+    int index = queue->count++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!dawg_completion_before(&entry, &queue->entries[parent])) {
+            break;
+        }
+        queue->entries[index] = queue->entries[parent];
+        index = parent;
+    }
+    queue->entries[index] = entry;
+    return true;
+}
+
+/**
+ * Remove the first entry of the completion queue
+ * @param queue Non-empty completion queue
+ * @param out Receives the removed entry
+ */
+static void dawg_completion_pop(DawgCompletionQueue* queue, DawgCompletionEntry* out) {
+    *out = queue->entries[0];
+    DawgCompletionEntry last = queue->entries[--queue->count];
+    
+    // Sift the last entry down from the root
+    int index = 0;
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= queue->count) {
+            break;
+        }
+        if (child + 1 < queue->count &&
+            dawg_completion_before(&queue->entries[child + 1], &queue->entries[child])) {
+            child++;
+        }
+        if (!dawg_completion_before(&queue->entries[child], &last)) {
+            break;
+        }
+        queue->entries[index] = queue->entries[child];
+        index = child;
+    }
+    if (queue->count > 0) {
+        queue->entries[index] = last;
+    }
+}
+
+int dawg_complete(const Dawg* dawg, const char* prefix, TrieMatch* matches, int max_matches) {
+    if (dawg == NULL || prefix == NULL || matches == NULL || max_matches <= 0 || dawg->total_words == 0) {
+        return 0;
+    }
+    
+    size_t prefix_len = strlen(prefix);
+    if (prefix_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    uint32_t rank = 0;
+    uint32_t start = find_state(dawg, prefix, &rank);
+    if (start == DAWG_NO_STATE || dawg->states[start].frequency_bound == 0) {
+        return 0;
+    }
+    
+    // Spell the path as stored
+    char path[TRIE_MAX_WORD_LENGTH + 1];
+    for (size_t i = 0; i < prefix_len; i++) {
+        path[i] = (char)tolower((unsigned char)prefix[i]);
+    }
+    
+    DawgCompletionQueue queue = { NULL, 0, 0 };
+    int found = 0;
+    bool ok = dawg_completion_push(&queue, start, rank, trie_decode_frequency_bound(dawg->states[start].frequency_bound),
+                                   false, path, (int)prefix_len);
+    
+    while (ok && found < max_matches && queue.count > 0) {
+        DawgCompletionEntry entry;
+        dawg_completion_pop(&queue, &entry);
+        const DawgState* state = &dawg->states[entry.state];
+        
+        if (entry.is_word) {
+            TrieMatch* match = &matches[found++];
+            memcpy(match->word, entry.word, (size_t)entry.length + 1);
+            match->distance = entry.length - (int)prefix_len;
+            match->frequency = (entry.key > INT_MAX) ? INT_MAX : (int)entry.key;
+            continue;
+        }
+        
+        // Expand the state: its own word and one entry per edge
+        PROFILE_COUNT(trie_nodes_visited, 1);
+        uint32_t child_rank = entry.rank;
+        if (state->is_final) {
+            ok = dawg_completion_push(&queue, entry.state, entry.rank, (uint32_t)frequency_at(dawg, entry.rank),
+                                      true, entry.word, entry.length);
+            child_rank++;
+        }
+        if (entry.length == TRIE_MAX_WORD_LENGTH) {
+            continue;
+        }
+        uint32_t end = state->first_edge + state->edge_count;
+        for (uint32_t e = state->first_edge; ok && e < end; e++) {
+            const DawgState* child = &dawg->states[dawg->targets[e]];
+            entry.word[entry.length] = (char)dawg->labels[e];
+            ok = dawg_completion_push(&queue, dawg->targets[e], child_rank,
+                                      trie_decode_frequency_bound(child->frequency_bound),
+                                      false, entry.word, entry.length + 1);
+            child_rank += child->word_count;
+        }
+    }
+    
+    free(queue.entries);
+    return ok ? found : 0;
+}
+
+/**
+ * Recursively collect all words accepted from a state in alphabetical order
+ * @param dawg Dawg
+ * @param state Current state
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @param words Array to store words
+ * @param count Current count of words found
+ * @param capacity Current capacity of words array
+ */
+static void dawg_collect_words(const Dawg* dawg, uint32_t state, char* prefix, int depth,
+                               char*** words, int* count, int* capacity) {
+    const DawgState* current = &dawg->states[state];
+    if (current->is_final) {
+        if (*count >= *capacity) {
+            int new_capacity = *capacity * 2;
+            char** resized = (char**)realloc(*words, new_capacity * sizeof(char*));
+            if (resized == NULL) {
+                return; // Memory allocation failed, keep what we have
+            }
+            *words = resized;
+            *capacity = new_capacity;
+        }
+        
+        (*words)[*count] = (char*)malloc((size_t)depth + 1);
+        if ((*words)[*count] != NULL) {
+            memcpy((*words)[*count], prefix, (size_t)depth);
+            (*words)[*count][depth] = '\0';
+            (*count)++;
+        }
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return;
+    }
+    
+    uint32_t end = current->first_edge + current->edge_count;
+    for (uint32_t e = current->first_edge; e < end; e++) {
+        prefix[depth] = (char)dawg->labels[e];
+        dawg_collect_words(dawg, dawg->targets[e], prefix, depth + 1, words, count, capacity);
+    }
+}
+
+void dawg_get_all_words(const Dawg* dawg, char*** words, int* count) {
+    if (dawg == NULL || words == NULL || count == NULL) {
+        if (words != NULL) *words = NULL;
+        if (count != NULL) *count = 0;
+        return;
+    }
+    
+    *count = 0;
+    int capacity = 100;
+    *words = (char**)malloc(capacity * sizeof(char*));
+    if (*words == NULL) {
+        return;
+    }
+    
+    char prefix[TRIE_MAX_WORD_LENGTH + 1];
+    dawg_collect_words(dawg, 0, prefix, 0, words, count, &capacity);
+    
+    if (*count == 0) {
+        free(*words);
+        *words = NULL;
+    }
+}
+
+size_t dawg_get_memory_usage(const Dawg* dawg) {
+    if (dawg == NULL) {
+        return 0;
+    }
+    
+    return sizeof(Dawg) + dawg->storage_size;
+}
+
+void dawg_destroy(Dawg* dawg) {
+    if (dawg == NULL) {
+        return;
+    }
+    
+    free(dawg->storage);
+    free(dawg);
+}
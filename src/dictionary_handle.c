@@ -0,0 +1,362 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/dictionary_handle.h"
+#include "../include/file_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+/**
+ * Size of a cache line; reader slots are padded so that one reader's
+ * stores never invalidate another reader's line
+ */
+#define DICTIONARY_CACHE_LINE 64
+
+/**
+ * One published dictionary and its reclamation bookkeeping
+ */
+typedef struct DictionaryVersion {
+    Trie* trie;                             // Frozen dictionary
+    unsigned long generation;               // 1 for the first version, +1 per reload
+    time_t modified;                        // Modification time of the file it was loaded from
+    unsigned long retired_epoch;            // Epoch at which it was replaced
+    struct DictionaryVersion* next_retired; // Next version waiting to be freed
+} DictionaryVersion;
+
+struct DictionaryReader {
+    DictionaryHandle* handle;               // Owning handle
+    DictionaryVersion* version;             // Version of the open read section (reader thread only)
+    unsigned long epoch;                    // Epoch of the open read section, 0 when idle (atomic)
+    int in_use;                             // Whether the slot is registered (atomic)
+    char padding[DICTIONARY_CACHE_LINE];    // Keeps neighbouring slots off this cache line
+};
+
+struct DictionaryHandle {
+    char* filename;                         // Dictionary file reloaded from
+    DictionaryVersion* current;             // Published version (atomic)
+    unsigned long epoch;                    // Global epoch, starts at 1 (atomic)
+    DictionaryReader readers[DICTIONARY_MAX_READERS];
+    
+    pthread_mutex_t reload_mutex;           // Serializes reloads, guards retired
+    DictionaryVersion* retired;             // Replaced versions not yet freed
+    
+    pthread_mutex_t watcher_mutex;          // Guards the watcher fields below
+    pthread_cond_t watcher_cond;            // Wakes the watcher early
+    pthread_t watcher;                      // Background reload thread
+    bool watcher_running;                   // Whether watcher was started
+    bool stop_requested;                    // Tells the watcher to exit
+    bool reload_requested;                  // Set by dictionary_handle_request_reload()
+    int interval_ms;                        // Watcher polling interval
+};
+
+/**
+ * Get a file's modification time, or 0 if it cannot be read
+ */
+static time_t file_modified_time(const char* filename) {
+    struct stat info;
+    if (stat(filename, &info) != 0) {
+        return 0;
+    }
+    return info.st_mtime;
+}
+
+/**
+ * Load and freeze a new dictionary version
+ * @return New version with generation 0, or NULL on error
+ */
+static DictionaryVersion* load_version(const char* filename) {
+    DictionaryVersion* version = (DictionaryVersion*)calloc(1, sizeof(DictionaryVersion));
+    if (version == NULL) {
+        return NULL;
+    }
+    
+    // Take the time first so a change during loading triggers another reload
+    version->modified = file_modified_time(filename);
+    version->trie = trie_create();
+    if (version->trie == NULL || !load_dictionary(filename, version->trie) || !trie_freeze(version->trie)) {
+        trie_destroy(version->trie);
+        free(version);
+        return NULL;
+    }
+    
+    return version;
+}
+
+/**
+ * Free a version and its dictionary
+ */
+static void free_version(DictionaryVersion* version) {
+    trie_destroy(version->trie);
+    free(version);
+}
+
+/**
+ * Free every retired version that no open read section can still see.
+ * A version retired at epoch R is visible only to sections that began at
+ * an epoch below R; sections announcing R or later loaded the pointer
+ * after it was replaced.
+ * @pre reload_mutex is held
+ */
+static void reclaim_retired(DictionaryHandle* handle) {
+    if (handle->retired == NULL) {
+        return;
+    }
+    
+    // Oldest epoch any open read section announced
+    unsigned long oldest = 0;
+    for (int i = 0; i < DICTIONARY_MAX_READERS; i++) {
+        unsigned long epoch = __atomic_load_n(&handle->readers[i].epoch, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && (oldest == 0 || epoch < oldest)) {
+            oldest = epoch;
+        }
+    }
+    
+    DictionaryVersion** link = &handle->retired;
+    while (*link != NULL) {
+        DictionaryVersion* version = *link;
+        if (oldest == 0 || oldest >= version->retired_epoch) {
+            *link = version->next_retired;
+            free_version(version);
+        } else {
+            link = &version->next_retired;
+        }
+    }
+}
+
+DictionaryHandle* dictionary_handle_open(const char* filename) {
+    if (filename == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - dictionary filename is NULL\n");
+        return NULL;
+    }
+    
+    DictionaryHandle* handle = (DictionaryHandle*)calloc(1, sizeof(DictionaryHandle));
+    if (handle == NULL) {
+        return NULL;
+    }
+    
+    size_t len = strlen(filename) + 1;
+    handle->filename = (char*)malloc(len);
+    if (handle->filename == NULL) {
+        free(handle);
+        return NULL;
+    }
+    memcpy(handle->filename, filename, len);
+    
+    handle->current = load_version(filename);
+    if (handle->current == NULL) {
+        free(handle->filename);
+        free(handle);
+        return NULL;
+    }
+    handle->current->generation = 1;
+    handle->epoch = 1;
+    
+    for (int i = 0; i < DICTIONARY_MAX_READERS; i++) {
+        handle->readers[i].handle = handle;
+    }
+    
+    pthread_mutex_init(&handle->reload_mutex, NULL);
+    pthread_mutex_init(&handle->watcher_mutex, NULL);
+    pthread_cond_init(&handle->watcher_cond, NULL);
+    return handle;
+}
+
+bool dictionary_handle_reload(DictionaryHandle* handle) {
+    if (handle == NULL) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&handle->reload_mutex);
+    
+    // Build the new version while readers keep using the current one
+    DictionaryVersion* version = load_version(handle->filename);
+    if (version == NULL) {
+        fprintf(stderr, "Warning: Failed to reload dictionary '%s', keeping generation %lu\n",
+                handle->filename, handle->current->generation);
+        pthread_mutex_unlock(&handle->reload_mutex);
+        return false;
+    }
+    version->generation = handle->current->generation + 1;
+    
+    // Publish, then open a new epoch: sections announcing it see the new version
+    DictionaryVersion* old = __atomic_exchange_n(&handle->current, version, __ATOMIC_SEQ_CST);
+    old->retired_epoch = __atomic_add_fetch(&handle->epoch, 1, __ATOMIC_SEQ_CST);
+    old->next_retired = handle->retired;
+    handle->retired = old;
+    
+    reclaim_retired(handle);
+    
+    pthread_mutex_unlock(&handle->reload_mutex);
+    return true;
+}
+
+/**
+ * Watcher thread: on every tick (or request) free retired versions and
+ * reload if asked to or if the file changed
+ */
+static void* dictionary_watcher(void* arg) {
+    DictionaryHandle* handle = (DictionaryHandle*)arg;
+    
+    pthread_mutex_lock(&handle->watcher_mutex);
+    while (!handle->stop_requested) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += handle->interval_ms / 1000;
+        deadline.tv_nsec += (long)(handle->interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        
+        int wait_result = 0;
+        while (!handle->stop_requested && !handle->reload_requested && wait_result != ETIMEDOUT) {
+            wait_result = pthread_cond_timedwait(&handle->watcher_cond, &handle->watcher_mutex, &deadline);
+        }
+        if (handle->stop_requested) {
+            break;
+        }
+        
+        bool requested = handle->reload_requested;
+        handle->reload_requested = false;
+        pthread_mutex_unlock(&handle->watcher_mutex);
+        
+        pthread_mutex_lock(&handle->reload_mutex);
+        reclaim_retired(handle);
+        time_t loaded = handle->current->modified;
+        pthread_mutex_unlock(&handle->reload_mutex);
+        
+        time_t modified = file_modified_time(handle->filename);
+        if (requested || (modified != 0 && modified != loaded)) {
+            if (dictionary_handle_reload(handle)) {
+                printf("Dictionary '%s' reloaded (generation %lu)\n",
+                       handle->filename, dictionary_handle_generation(handle));
+            }
+        }
+        
+        pthread_mutex_lock(&handle->watcher_mutex);
+    }
+    pthread_mutex_unlock(&handle->watcher_mutex);
+    
+    return NULL;
+}
+
+bool dictionary_handle_start_watcher(DictionaryHandle* handle, int interval_ms) {
+    if (handle == NULL || interval_ms <= 0) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&handle->watcher_mutex);
+    bool ok = true;
+    if (!handle->watcher_running) {
+        handle->interval_ms = interval_ms;
+        handle->stop_requested = false;
+        ok = pthread_create(&handle->watcher, NULL, dictionary_watcher, handle) == 0;
+        handle->watcher_running = ok;
+        if (!ok) {
+            fprintf(stderr, "Error: Failed to start dictionary watcher thread\n");
+        }
+    }
+    pthread_mutex_unlock(&handle->watcher_mutex);
+    
+    return ok;
+}
+
+void dictionary_handle_request_reload(DictionaryHandle* handle) {
+    if (handle == NULL) {
+        return;
+    }
+    
+    pthread_mutex_lock(&handle->watcher_mutex);
+    handle->reload_requested = true;
+    pthread_cond_signal(&handle->watcher_cond);
+    pthread_mutex_unlock(&handle->watcher_mutex);
+}
+
+unsigned long dictionary_handle_generation(DictionaryHandle* handle) {
+    if (handle == NULL) {
+        return 0;
+    }
+    
+    DictionaryVersion* version = __atomic_load_n(&handle->current, __ATOMIC_SEQ_CST);
+    return version->generation;
+}
+
+DictionaryReader* dictionary_reader_register(DictionaryHandle* handle) {
+    if (handle == NULL) {
+        return NULL;
+    }
+    
+    for (int i = 0; i < DICTIONARY_MAX_READERS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&handle->readers[i].in_use, &expected, 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            return &handle->readers[i];
+        }
+    }
+    
+    fprintf(stderr, "Error: All %d dictionary reader slots are in use\n", DICTIONARY_MAX_READERS);
+    return NULL;
+}
+
+void dictionary_reader_unregister(DictionaryReader* reader) {
+    if (reader == NULL) {
+        return;
+    }
+    
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&reader->in_use, 0, __ATOMIC_RELEASE);
+}
+
+Trie* dictionary_read_begin(DictionaryReader* reader) {
+    DictionaryHandle* handle = reader->handle;
+    
+    // Announce the epoch before loading the pointer (see reclaim_retired)
+    unsigned long epoch = __atomic_load_n(&handle->epoch, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&reader->epoch, epoch, __ATOMIC_SEQ_CST);
+    DictionaryVersion* version = __atomic_load_n(&handle->current, __ATOMIC_SEQ_CST);
+    reader->version = version;
+    
+    return version->trie;
+}
+
+unsigned long dictionary_read_generation(const DictionaryReader* reader) {
+    return reader->version->generation;
+}
+
+void dictionary_read_end(DictionaryReader* reader) {
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+void dictionary_handle_close(DictionaryHandle* handle) {
+    if (handle == NULL) {
+        return;
+    }
+    
+    pthread_mutex_lock(&handle->watcher_mutex);
+    bool running = handle->watcher_running;
+    handle->stop_requested = true;
+    pthread_cond_signal(&handle->watcher_cond);
+    pthread_mutex_unlock(&handle->watcher_mutex);
+    if (running) {
+        pthread_join(handle->watcher, NULL);
+    }
+    
+    while (handle->retired != NULL) {
+        DictionaryVersion* next = handle->retired->next_retired;
+        free_version(handle->retired);
+        handle->retired = next;
+    }
+    free_version(handle->current);
+    
+    pthread_cond_destroy(&handle->watcher_cond);
+    pthread_mutex_destroy(&handle->watcher_mutex);
+    pthread_mutex_destroy(&handle->reload_mutex);
+    free(handle->filename);
+    free(handle);
+}
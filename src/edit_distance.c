@@ -1,7 +1,16 @@
 #include "edit_distance.h"
+#include "profile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
+
+// AVX2 batch kernel: GCC/Clang on x86, enabled per function and chosen at runtime
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EDIT_DISTANCE_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
 
 /**
  * Helper function to get minimum of three integers
@@ -12,42 +21,29 @@ static int min3(int a, int b, int c) {
 }
 
 /**
- * Compute the minimum edit distance between two strings using dynamic programming
- * Uses space-optimized approach with only two rows instead of full matrix
+ * Fill DP rows for word against target[0..target_len), keeping only two rows.
+ * Stops after the first row whose every cell exceeds max_distance, since
+ * later rows can only be larger.
+ * @param prev_row Buffer of target_len + 1 ints
+ * @param curr_row Buffer of target_len + 1 ints
+ * @param last_row Receives whichever buffer holds the last computed row
+ * @return Minimum of the last computed row
  */
-int compute_edit_distance(const char* word1, const char* word2) {
-    if (!word1 || !word2) {
-        return -1; // Invalid input
-    }
-    
-    int len1 = strlen(word1);
-    int len2 = strlen(word2);
-    
-    // Handle edge cases
-    if (len1 == 0) return len2;
-    if (len2 == 0) return len1;
-    
-    // Allocate two rows for space optimization
-    int* prev_row = (int*)malloc((len2 + 1) * sizeof(int));
-    int* curr_row = (int*)malloc((len2 + 1) * sizeof(int));
-    
-    if (!prev_row || !curr_row) {
-        free(prev_row);
-        free(curr_row);
-        return -1; // Memory allocation failed
-    }
-    
-    // Initialize first row (transforming empty string to word2[0..j])
-    for (int j = 0; j <= len2; j++) {
+static int fill_distance_rows(const char* word, int word_len, const char* target, int target_len,
+                              int max_distance, int* prev_row, int* curr_row, int** last_row) {
+    // Initialize first row (transforming empty string to target[0..j])
+    for (int j = 0; j <= target_len; j++) {
         prev_row[j] = j;
     }
+    int row_min = 0;
     
     // Fill the matrix row by row
-    for (int i = 1; i <= len1; i++) {
-        curr_row[0] = i; // Transforming word1[0..i] to empty string
+    for (int i = 1; i <= word_len && row_min <= max_distance; i++) {
+        curr_row[0] = i; // Transforming word[0..i] to empty string
+        row_min = i;
         
-        for (int j = 1; j <= len2; j++) {
-            if (word1[i-1] == word2[j-1]) {
+        for (int j = 1; j <= target_len; j++) {
+            if (word[i-1] == target[j-1]) {
                 // Characters match, no operation needed
                 curr_row[j] = prev_row[j-1];
             } else {
@@ -58,25 +54,241 @@ int compute_edit_distance(const char* word1, const char* word2) {
                 
                 curr_row[j] = min3(substitute, insert, delete);
             }
+            if (curr_row[j] < row_min) {
+                row_min = curr_row[j];
+            }
         }
         
         // Swap rows for next iteration
         int* temp = prev_row;
         prev_row = curr_row;
         curr_row = temp;
+        PROFILE_COUNT(dp_cells, target_len);
+    }
+    
+    *last_row = prev_row;
+    return row_min;
+}
+
+/**
+ * Build the Myers match masks of a pattern: bit i of peq[c] is set when
+ * pattern[i] == c
+ */
+static void myers_build_peq(const char* pattern, int m, uint64_t peq[256]) {
+    memset(peq, 0, 256 * sizeof(uint64_t));
+    for (int i = 0; i < m; i++) {
+        peq[(unsigned char)pattern[i]] |= (uint64_t)1 << i;
+    }
+}
+
+/**
+ * Bit-parallel Levenshtein distance (Myers 1999, Hyyro's global variant)
+ * between a pattern of 1..64 characters, given by its match masks, and a text.
+ * Each text character updates a whole DP column in a few word operations;
+ * the score tracks the bottom cell D[m][j].
+ * @return Exact distance if it is <= max_distance, otherwise max_distance + 1
+ */
+static int myers_distance(const uint64_t peq[256], int m, const char* text, int n, int max_distance) {
+    uint64_t pv = ~(uint64_t)0;
+    uint64_t mv = 0;
+    uint64_t last = (uint64_t)1 << (m - 1);
+    int score = m;
+    
+    for (int j = 0; j < n; j++) {
+        uint64_t eq = peq[(unsigned char)text[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        
+        if (ph & last) score++;
+        else if (mh & last) score--;
+        
+        // Each remaining column lowers the score by at most one
+        if (score - (n - j - 1) > max_distance) {
+            PROFILE_COUNT(dp_cells, (size_t)m * (j + 1));
+            return max_distance + 1;
+        }
+        
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    
+    PROFILE_COUNT(dp_cells, (size_t)m * n);
+    return (score <= max_distance) ? score : max_distance + 1;
+}
+
+/**
+ * Value of band cells outside the DP matrix; adding a few edits cannot overflow it
+ */
+#define EDIT_DISTANCE_BAND_INF (INT_MAX / 2)
+
+/**
+ * Banded Levenshtein kernel for a fixed bound K, one instance per K.
+ * A cell (i, j) with |i - j| > K costs more than K edits, so only the
+ * diagonal band of width 2K + 1 is evaluated. Row i lives in slots 1..2K+1
+ * (slot d + 1 holds column j = i + d - K), and slots 0 and 2K+2 stay at
+ * EDIT_DISTANCE_BAND_INF as the left and upper-right neighbours outside the
+ * band, so the fixed-length inner loop needs no bounds checks on the rows.
+ * Requires |m - n| <= K.
+ * @return Exact distance if it is <= K, otherwise K + 1
+ */
+#define DEFINE_BANDED_DISTANCE(K)                                                       \
+static int banded_distance_##K(const char* a, int m, const char* b, int n) {            \
+    int rows[2][2 * (K) + 3];                                                           \
+    int* prev = rows[0];                                                                \
+    int* curr = rows[1];                                                                \
+    for (int s = 0; s < 2 * (K) + 3; s++) {                                             \
+        prev[s] = EDIT_DISTANCE_BAND_INF;                                               \
+        curr[s] = EDIT_DISTANCE_BAND_INF;                                               \
+    }                                                                                   \
+    for (int j = 0; j <= (K) && j <= n; j++) {                                          \
+        prev[j + (K) + 1] = j;                                                          \
+    }                                                                                   \
+                                                                                        \
+    for (int i = 1; i <= m; i++) {                                                      \
+        int row_min = EDIT_DISTANCE_BAND_INF;                                           \
+        for (int d = 0; d <= 2 * (K); d++) {                                            \
+            int j = i + d - (K);                                                        \
+            int value;                                                                  \
+            if (j < 0 || j > n) {                                                       \
+                value = EDIT_DISTANCE_BAND_INF;                                         \
+            } else if (j == 0) {                                                        \
+                value = i;                                                              \
+            } else {                                                                    \
+                int substitute = prev[d + 1] + (a[i - 1] != b[j - 1]);                  \
+                int delete = prev[d + 2] + 1;                                           \
+                int insert = curr[d] + 1;                                               \
+                value = min3(substitute, insert, delete);                               \
+            }                                                                           \
+            curr[d + 1] = value;                                                        \
+            if (value < row_min) {                                                      \
+                row_min = value;                                                        \
+            }                                                                           \
+        }                                                                               \
+        PROFILE_COUNT(dp_cells, 2 * (K) + 1);                                           \
+        if (row_min > (K)) {                                                            \
+            return (K) + 1;                                                             \
+        }                                                                               \
+        int* temp = prev;                                                               \
+        prev = curr;                                                                    \
+        curr = temp;                                                                    \
+    }                                                                                   \
+                                                                                        \
+    int result = prev[n - m + (K) + 1];                                                 \
+    return (result <= (K)) ? result : (K) + 1;                                          \
+}
+
+DEFINE_BANDED_DISTANCE(1)
+DEFINE_BANDED_DISTANCE(2)
+DEFINE_BANDED_DISTANCE(3)
+
+/**
+ * Pick the banded kernel of a bound
+ * @param max_distance Bound, 0..EDIT_DISTANCE_MAX_BANDED
+ * @return Exact distance if it is <= max_distance, otherwise max_distance + 1
+ */
+static int banded_distance(const char* a, int m, const char* b, int n, int max_distance) {
+    switch (max_distance) {
+        case 0: return (m == n && memcmp(a, b, (size_t)m) == 0) ? 0 : 1;
+        case 1: return banded_distance_1(a, m, b, n);
+        case 2: return banded_distance_2(a, m, b, n);
+        default: return banded_distance_3(a, m, b, n);
+    }
+}
+
+/**
+ * Bounded edit distance using caller-provided rows
+ * Bails out as soon as a whole row exceeds max_distance
+ */
+int compute_edit_distance_bounded(const char* word1, const char* word2, int max_distance,
+                                  int* scratch, size_t scratch_size) {
+    if (!word1 || !word2 || max_distance < 0) {
+        return -1; // Invalid input
+    }
+    
+    int len1 = strlen(word1);
+    int len2 = strlen(word2);
+    if (!scratch || scratch_size < EDIT_DISTANCE_SCRATCH_SIZE(len2)) {
+        return -1; // Scratch too small for word2
+    }
+    
+    // The distance is at least the length difference
+    int gap = (len1 > len2) ? len1 - len2 : len2 - len1;
+    if (gap > max_distance) {
+        return max_distance + 1;
+    }
+    
+    // Small bounds only need the diagonal band
+    if (max_distance <= EDIT_DISTANCE_MAX_BANDED) {
+        return banded_distance(word1, len1, word2, len2, max_distance);
+    }
+    
+    int* last_row;
+    int row_min = fill_distance_rows(word1, len1, word2, len2, max_distance,
+                                     scratch, scratch + len2 + 1, &last_row);
+    if (row_min > max_distance || last_row[len2] > max_distance) {
+        return max_distance + 1;
+    }
+    return last_row[len2];
+}
+
+/**
+ * Compute the minimum edit distance between two strings
+ * Uses the bit-parallel kernel when the shorter string fits in 64 bits, and
+ * two DP rows (on the stack for short words) otherwise
+ */
+int compute_edit_distance(const char* word1, const char* word2) {
+    if (!word1 || !word2) {
+        return -1; // Invalid input
+    }
+    
+    int len1 = strlen(word1);
+    int len2 = strlen(word2);
+    
+    // Handle edge cases
+    if (len1 == 0) return len2;
+    if (len2 == 0) return len1;
+    
+    // The shorter string becomes the bit-parallel pattern
+    int longest = (len1 > len2) ? len1 : len2;
+    if (len1 <= 64 || len2 <= 64) {
+        uint64_t peq[256];
+        if (len1 <= len2) {
+            myers_build_peq(word1, len1, peq);
+            return myers_distance(peq, len1, word2, len2, longest);
+        }
+        myers_build_peq(word2, len2, peq);
+        return myers_distance(peq, len2, word1, len1, longest);
     }
     
-    int result = prev_row[len2];
+    int stack_rows[EDIT_DISTANCE_SCRATCH_SIZE(256)];
+    int* scratch = stack_rows;
+    size_t scratch_size = sizeof(stack_rows) / sizeof(stack_rows[0]);
+    if (scratch_size < EDIT_DISTANCE_SCRATCH_SIZE(len2)) {
+        scratch_size = EDIT_DISTANCE_SCRATCH_SIZE(len2);
+        scratch = (int*)malloc(scratch_size * sizeof(int));
+        if (!scratch) {
+            return -1; // Memory allocation failed
+        }
+    }
     
-    free(prev_row);
-    free(curr_row);
+    int result = compute_edit_distance_bounded(word1, word2, longest, scratch, scratch_size);
     
+    if (scratch != stack_rows) {
+        free(scratch);
+    }
     return result;
-}/**
- * C
-ompute edit distance and track the sequence of operations
- * Uses full matrix to enable backtracking for operation sequence
+}
+
+/**
+ * Compute edit distance and track the sequence of operations
+ * Uses one flat full matrix to enable backtracking for operation sequence
  */
+#define DP(i, j) dp[(size_t)(i) * stride + (j)]
+
 EditResult* compute_edit_operations(const char* word1, const char* word2) {
     if (!word1 || !word2) {
         return NULL;
@@ -91,64 +303,49 @@ EditResult* compute_edit_operations(const char* word1, const char* word2) {
         return NULL;
     }
     
-    // Allocate full DP matrix for backtracking
-    int** dp = (int**)malloc((len1 + 1) * sizeof(int*));
+    // Allocate the full DP matrix for backtracking as one flat block
+    size_t stride = (size_t)len2 + 1;
+    int* dp = (int*)malloc(((size_t)len1 + 1) * stride * sizeof(int));
     if (!dp) {
         free(result);
         return NULL;
     }
     
-    for (int i = 0; i <= len1; i++) {
-        dp[i] = (int*)malloc((len2 + 1) * sizeof(int));
-        if (!dp[i]) {
-            // Clean up on allocation failure
-            for (int k = 0; k < i; k++) {
-                free(dp[k]);
-            }
-            free(dp);
-            free(result);
-            return NULL;
-        }
-    }
-    
     // Initialize base cases
     for (int i = 0; i <= len1; i++) {
-        dp[i][0] = i;
+        DP(i, 0) = i;
     }
     for (int j = 0; j <= len2; j++) {
-        dp[0][j] = j;
+        DP(0, j) = j;
     }
     
     // Fill the DP matrix
+    PROFILE_COUNT(dp_cells, (size_t)len1 * len2);
     for (int i = 1; i <= len1; i++) {
         for (int j = 1; j <= len2; j++) {
             if (word1[i-1] == word2[j-1]) {
-                dp[i][j] = dp[i-1][j-1]; // Match
+                DP(i, j) = DP(i-1, j-1); // Match
             } else {
-                int substitute = dp[i-1][j-1] + 1;
-                int insert = dp[i][j-1] + 1;
-                int delete = dp[i-1][j] + 1;
-                dp[i][j] = min3(substitute, insert, delete);
+                int substitute = DP(i-1, j-1) + 1;
+                int insert = DP(i, j-1) + 1;
+                int delete = DP(i-1, j) + 1;
+                DP(i, j) = min3(substitute, insert, delete);
             }
         }
     }
     
-    result->distance = dp[len1][len2];
+    result->distance = DP(len1, len2);
     
     // Backtrack to find operations
     int max_ops = len1 + len2; // Upper bound on operations
-    result->operations = (EditOperation*)malloc(max_ops * sizeof(EditOperation));
+    result->operations = (EditOperation*)malloc((max_ops > 0 ? max_ops : 1) * sizeof(EditOperation));
     if (!result->operations) {
-        // Clean up on allocation failure
-        for (int i = 0; i <= len1; i++) {
-            free(dp[i]);
-        }
         free(dp);
         free(result);
         return NULL;
     }
     
-    // Backtrack from dp[len1][len2] to dp[0][0]
+    // Backtrack from DP(len1, len2) to DP(0, 0)
     int i = len1, j = len2;
     int op_count = 0;
     
@@ -162,7 +359,7 @@ EditResult* compute_edit_operations(const char* word1, const char* word2) {
             op_count++;
             i--;
             j--;
-        } else if (i > 0 && j > 0 && dp[i][j] == dp[i-1][j-1] + 1) {
+        } else if (i > 0 && j > 0 && DP(i, j) == DP(i-1, j-1) + 1) {
             // Substitution
             result->operations[op_count].type = EDIT_SUBSTITUTE;
             result->operations[op_count].from_char = word1[i-1];
@@ -171,7 +368,7 @@ EditResult* compute_edit_operations(const char* word1, const char* word2) {
             op_count++;
             i--;
             j--;
-        } else if (j > 0 && dp[i][j] == dp[i][j-1] + 1) {
+        } else if (j > 0 && DP(i, j) == DP(i, j-1) + 1) {
             // Insertion
             result->operations[op_count].type = EDIT_INSERT;
             result->operations[op_count].from_char = '\0';
@@ -179,7 +376,7 @@ EditResult* compute_edit_operations(const char* word1, const char* word2) {
             result->operations[op_count].position = i;
             op_count++;
             j--;
-        } else if (i > 0 && dp[i][j] == dp[i-1][j] + 1) {
+        } else if (i > 0 && DP(i, j) == DP(i-1, j) + 1) {
             // Deletion
             result->operations[op_count].type = EDIT_DELETE;
             result->operations[op_count].from_char = word1[i-1];
@@ -199,15 +396,36 @@ EditResult* compute_edit_operations(const char* word1, const char* word2) {
         result->operations[op_count - 1 - k] = temp;
     }
     
-    // Clean up DP matrix
-    for (int i = 0; i <= len1; i++) {
-        free(dp[i]);
-    }
     free(dp);
     
     return result;
 }
 
+#undef DP
+
+/**
+ * Compute the final DP row into caller-provided buffers
+ * Bails out as soon as a whole row exceeds max_distance
+ */
+int get_distance_row_bounded(const char* word, const char* target, int target_len, int max_distance,
+                             int* row, int* scratch) {
+    if (!word || !target || target_len < 0 || max_distance < 0 || !row || !scratch) {
+        return -1;
+    }
+    
+    int* last_row;
+    int row_min = fill_distance_rows(word, strlen(word), target, target_len, max_distance,
+                                     row, scratch, &last_row);
+    if (row_min > max_distance) {
+        return max_distance + 1;
+    }
+    
+    if (last_row != row) {
+        memcpy(row, last_row, (target_len + 1) * sizeof(int));
+    }
+    return row_min;
+}
+
 /**
  * Get a single row of the edit distance matrix for partial computations
  * Useful for generating suggestions within a specific edit distance threshold
@@ -217,58 +435,230 @@ int* get_distance_row(const char* word, const char* target, int target_len) {
         return NULL;
     }
     
-    int word_len = strlen(word);
-    
-    // Allocate row array
-    int* row = (int*)malloc((target_len + 1) * sizeof(int));
+    // One block: the returned row followed by the scratch row
+    int* row = (int*)malloc(2 * ((size_t)target_len + 1) * sizeof(int));
     if (!row) {
         return NULL;
     }
     
-    // Initialize first row
-    for (int j = 0; j <= target_len; j++) {
-        row[j] = j;
+    get_distance_row_bounded(word, target, target_len, INT_MAX - 1, row, row + target_len + 1);
+    return row;
+}
+
+/**
+ * Bit of a letter in a neighbour mask
+ */
+#define KEY(c) (1u << ((c) - 'a'))
+
+/**
+ * Neighbouring keys of each letter on a QWERTY keyboard, including the
+ * diagonal neighbours in the rows above and below, as masks of KEY() bits
+ */
+static const uint32_t qwerty_neighbours[26] = {
+    KEY('q') | KEY('w') | KEY('s') | KEY('z'),                       /* a */
+    KEY('v') | KEY('g') | KEY('h') | KEY('n'),                       /* b */
+    KEY('x') | KEY('d') | KEY('f') | KEY('v'),                       /* c */
+    KEY('e') | KEY('r') | KEY('f') | KEY('c') | KEY('x') | KEY('s'), /* d */
+    KEY('w') | KEY('s') | KEY('d') | KEY('r'),                       /* e */
+    KEY('r') | KEY('t') | KEY('g') | KEY('v') | KEY('c') | KEY('d'), /* f */
+    KEY('t') | KEY('y') | KEY('h') | KEY('b') | KEY('v') | KEY('f'), /* g */
+    KEY('y') | KEY('u') | KEY('j') | KEY('n') | KEY('b') | KEY('g'), /* h */
+    KEY('u') | KEY('j') | KEY('k') | KEY('o'),                       /* i */
+    KEY('u') | KEY('i') | KEY('k') | KEY('m') | KEY('n') | KEY('h'), /* j */
+    KEY('i') | KEY('o') | KEY('l') | KEY('m') | KEY('j'),            /* k */
+    KEY('o') | KEY('p') | KEY('k'),                                  /* l */
+    KEY('n') | KEY('j') | KEY('k'),                                  /* m */
+    KEY('b') | KEY('h') | KEY('j') | KEY('m'),                       /* n */
+    KEY('i') | KEY('k') | KEY('l') | KEY('p'),                       /* o */
+    KEY('o') | KEY('l'),                                             /* p */
+    KEY('w') | KEY('a'),                                             /* q */
+    KEY('e') | KEY('d') | KEY('f') | KEY('t'),                       /* r */
+    KEY('w') | KEY('e') | KEY('d') | KEY('x') | KEY('z') | KEY('a'), /* s */
+    KEY('r') | KEY('f') | KEY('g') | KEY('y'),                       /* t */
+    KEY('y') | KEY('h') | KEY('j') | KEY('i'),                       /* u */
+    KEY('c') | KEY('f') | KEY('g') | KEY('b'),                       /* v */
+    KEY('q') | KEY('a') | KEY('s') | KEY('e'),                       /* w */
+    KEY('z') | KEY('s') | KEY('d') | KEY('c'),                       /* x */
+    KEY('t') | KEY('g') | KEY('h') | KEY('u'),                       /* y */
+    KEY('a') | KEY('s') | KEY('x')                                   /* z */
+};
+
+#undef KEY
+
+/**
+ * Cost of substituting one character by another (0 when equal)
+ */
+static inline float substitution_cost(char from, char to) {
+    if (from == to) {
+        return 0.0f;
     }
     
-    // If word is empty, return initialized row
-    if (word_len == 0) {
-        return row;
+    // ASCII case folding: tolower() in the C locale leaves other bytes alone
+    unsigned a = (unsigned char)from;
+    unsigned b = (unsigned char)to;
+    a = (a >= 'A' && a <= 'Z') ? (a | 0x20) : a;
+    b = (b >= 'A' && b <= 'Z') ? (b | 0x20) : b;
+    if (a == b) {
+        return 0.0f;
+    }
+    if (a - 'a' < 26 && b - 'a' < 26 && (qwerty_neighbours[a - 'a'] & (1u << (b - 'a')))) {
+        return EDIT_COST_ADJACENT_KEY;
+    }
+    return EDIT_COST_DEFAULT;
+}
+
+/**
+ * Weighted optimal string alignment distance over three rolling rows
+ */
+float compute_weighted_distance(const char* typed, const char* candidate) {
+    if (!typed || !candidate) {
+        return -1.0f;
     }
     
-    // Allocate previous row for computation
-    int* prev_row = (int*)malloc((target_len + 1) * sizeof(int));
-    if (!prev_row) {
-        free(row);
-        return NULL;
+    int len1 = strlen(typed);
+    int len2 = strlen(candidate);
+    
+    // Rows i-2, i-1 and i of the DP matrix
+    float stack_rows[3 * 65];
+    float* rows = stack_rows;
+    if (len2 + 1 > 65) {
+        rows = (float*)malloc(3 * ((size_t)len2 + 1) * sizeof(float));
+        if (!rows) {
+            return -1.0f;
+        }
     }
+    float* before_prev = rows;
+    float* prev_row = rows + len2 + 1;
+    float* curr_row = rows + 2 * (len2 + 1);
     
-    // Copy initial row to prev_row
-    memcpy(prev_row, row, (target_len + 1) * sizeof(int));
+    for (int j = 0; j <= len2; j++) {
+        prev_row[j] = j * EDIT_COST_DEFAULT;
+    }
     
-    // Compute each row
-    for (int i = 1; i <= word_len; i++) {
-        row[0] = i;
+    for (int i = 1; i <= len1; i++) {
+        curr_row[0] = i * EDIT_COST_DEFAULT;
         
-        for (int j = 1; j <= target_len; j++) {
-            if (word[i-1] == target[j-1]) {
-                row[j] = prev_row[j-1];
-            } else {
-                int substitute = prev_row[j-1] + 1;
-                int insert = row[j-1] + 1;
-                int delete = prev_row[j] + 1;
-                row[j] = min3(substitute, insert, delete);
+        for (int j = 1; j <= len2; j++) {
+            float substitute = prev_row[j-1] + substitution_cost(typed[i-1], candidate[j-1]);
+            float insert = curr_row[j-1] + EDIT_COST_DEFAULT;
+            float delete = prev_row[j] + EDIT_COST_DEFAULT;
+            
+            float best = (substitute < insert) ? substitute : insert;
+            best = (best < delete) ? best : delete;
+            
+            // Two swapped letters count as a single cheaper edit
+            if (i > 1 && j > 1 && typed[i-1] == candidate[j-2] && typed[i-2] == candidate[j-1] &&
+                typed[i-1] != typed[i-2]) {
+                float transpose = before_prev[j-2] + EDIT_COST_TRANSPOSE;
+                best = (transpose < best) ? transpose : best;
             }
+            
+            curr_row[j] = best;
         }
         
-        // Swap rows
-        int* temp = prev_row;
-        prev_row = row;
-        row = temp;
+        // Rotate rows for next iteration
+        float* temp = before_prev;
+        before_prev = prev_row;
+        prev_row = curr_row;
+        curr_row = temp;
     }
     
-    // prev_row now contains the final result
-    free(row);
-    return prev_row;
+    float result = prev_row[len2];
+    PROFILE_COUNT(dp_cells, (size_t)len1 * len2);
+    
+    if (rows != stack_rows) {
+        free(rows);
+    }
+    return result;
+}
+
+/**
+ * Value of weighted band cells outside the DP matrix
+ */
+#define EDIT_DISTANCE_BAND_INF_COST 1e30f
+
+/**
+ * Banded weighted OSA kernel for a fixed bound K, one instance per K.
+ * Same rows and slot layout as DEFINE_BANDED_DISTANCE, plus the row before
+ * the previous one for transpositions: cell (i - 2, j - 2) sits in the same
+ * slot as (i, j). Only insertions and deletions move off the diagonal and
+ * each costs EDIT_COST_DEFAULT, so every alignment leaving the band costs
+ * more than K and the band result is exact when the distance is <= K.
+ * Requires |m - n| <= K.
+ * @return Weighted distance if it is <= K, otherwise some value above K
+ */
+#define DEFINE_BANDED_WEIGHTED(K)                                                       \
+static float banded_weighted_##K(const char* a, int m, const char* b, int n) {          \
+    float rows[3][2 * (K) + 3];                                                         \
+    float* before_prev = rows[0];                                                       \
+    float* prev = rows[1];                                                              \
+    float* curr = rows[2];                                                              \
+    for (int s = 0; s < 2 * (K) + 3; s++) {                                             \
+        before_prev[s] = EDIT_DISTANCE_BAND_INF_COST;                                   \
+        prev[s] = EDIT_DISTANCE_BAND_INF_COST;                                          \
+        curr[s] = EDIT_DISTANCE_BAND_INF_COST;                                          \
+    }                                                                                   \
+    for (int j = 0; j <= (K) && j <= n; j++) {                                          \
+        prev[j + (K) + 1] = j * EDIT_COST_DEFAULT;                                      \
+    }                                                                                   \
+                                                                                        \
+    for (int i = 1; i <= m; i++) {                                                      \
+        for (int d = 0; d <= 2 * (K); d++) {                                            \
+            int j = i + d - (K);                                                        \
+            float value;                                                                \
+            if (j < 0 || j > n) {                                                       \
+                value = EDIT_DISTANCE_BAND_INF_COST;                                    \
+            } else if (j == 0) {                                                        \
+                value = i * EDIT_COST_DEFAULT;                                          \
+            } else {                                                                    \
+                float substitute = prev[d + 1] + substitution_cost(a[i - 1], b[j - 1]); \
+                float insert = curr[d] + EDIT_COST_DEFAULT;                             \
+                float delete = prev[d + 2] + EDIT_COST_DEFAULT;                         \
+                value = (substitute < insert) ? substitute : insert;                    \
+                value = (value < delete) ? value : delete;                              \
+                if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1] &&   \
+                    a[i - 1] != a[i - 2]) {                                             \
+                    float transpose = before_prev[d + 1] + EDIT_COST_TRANSPOSE;         \
+                    value = (transpose < value) ? transpose : value;                    \
+                }                                                                       \
+            }                                                                           \
+            curr[d + 1] = value;                                                        \
+        }                                                                               \
+        PROFILE_COUNT(dp_cells, 2 * (K) + 1);                                           \
+        float* temp = before_prev;                                                      \
+        before_prev = prev;                                                             \
+        prev = curr;                                                                    \
+        curr = temp;                                                                    \
+    }                                                                                   \
+                                                                                        \
+    return prev[n - m + (K) + 1];                                                       \
+}
+
+DEFINE_BANDED_WEIGHTED(1)
+DEFINE_BANDED_WEIGHTED(2)
+DEFINE_BANDED_WEIGHTED(3)
+
+/**
+ * Weighted distance restricted to the band of a known Levenshtein bound
+ */
+float compute_weighted_distance_bounded(const char* typed, const char* candidate, int max_distance) {
+    if (!typed || !candidate || max_distance < 0) {
+        return -1.0f;
+    }
+    
+    int len1 = strlen(typed);
+    int len2 = strlen(candidate);
+    int gap = (len1 > len2) ? len1 - len2 : len2 - len1;
+    if (gap > max_distance || max_distance > EDIT_DISTANCE_MAX_BANDED) {
+        return compute_weighted_distance(typed, candidate);
+    }
+    
+    switch (max_distance) {
+        case 0:
+        case 1: return banded_weighted_1(typed, len1, candidate, len2);
+        case 2: return banded_weighted_2(typed, len1, candidate, len2);
+        default: return banded_weighted_3(typed, len1, candidate, len2);
+    }
 }
 
 /**
@@ -279,4 +669,221 @@ void free_edit_result(EditResult* result) {
         free(result->operations);
         free(result);
     }
-}
\ No newline at end of file
+}
+
+
+/**
+ * Check whether two strings are within a maximum edit distance
+ * Uses the allocation-free bit-parallel kernel when the shorter string fits in 64 bits
+ */
+bool edit_distance_within(const char* word1, const char* word2, int max_distance, int* distance) {
+    if (!word1 || !word2 || max_distance < 0) {
+        return false;
+    }
+    
+    int len1 = strlen(word1);
+    int len2 = strlen(word2);
+    int gap = (len1 > len2) ? len1 - len2 : len2 - len1;
+    if (gap > max_distance) {
+        return false;
+    }
+    
+    // The shorter string becomes the bit-parallel pattern
+    const char* pattern = (len1 <= len2) ? word1 : word2;
+    const char* text = (len1 <= len2) ? word2 : word1;
+    int m = (len1 <= len2) ? len1 : len2;
+    int n = (len1 <= len2) ? len2 : len1;
+    
+    int result;
+    if (m == 0) {
+        result = n;
+    } else if (m <= 64) {
+        uint64_t peq[256];
+        myers_build_peq(pattern, m, peq);
+        result = myers_distance(peq, m, text, n, max_distance);
+    } else {
+        int* scratch = (int*)malloc(EDIT_DISTANCE_SCRATCH_SIZE(len2) * sizeof(int));
+        result = compute_edit_distance_bounded(word1, word2, max_distance, scratch,
+                                               EDIT_DISTANCE_SCRATCH_SIZE(len2));
+        free(scratch);
+        if (result < 0) {
+            return false;
+        }
+    }
+    
+    if (result > max_distance) {
+        return false;
+    }
+    if (distance) {
+        *distance = result;
+    }
+    return true;
+}
+
+#ifdef EDIT_DISTANCE_HAVE_AVX2
+/**
+ * Score four candidates against one pattern at once, one candidate per
+ * 64-bit lane, with the same recurrence as myers_distance()
+ */
+__attribute__((target("avx2")))
+static void myers_distance_x4(const uint64_t peq[256], int m, const char* const texts[4],
+                              const int lengths[4], int max_distance, int scores[4]) {
+    const __m256i ones = _mm256_set1_epi64x(1);
+    const __m256i last = _mm256_set1_epi64x((long long)((uint64_t)1 << (m - 1)));
+    const __m256i all = _mm256_set1_epi64x(-1);
+    const __m256i lens = _mm256_set_epi64x(lengths[3], lengths[2], lengths[1], lengths[0]);
+    const __m256i limit = _mm256_set1_epi64x(max_distance);
+    
+    __m256i pv = all;
+    __m256i mv = _mm256_setzero_si256();
+    __m256i score = _mm256_set1_epi64x(m);
+    
+    int longest = lengths[0];
+    for (int i = 1; i < 4; i++) {
+        if (lengths[i] > longest) longest = lengths[i];
+    }
+    
+    for (int j = 0; j < longest; j++) {
+        // Finished lanes feed a harmless zero mask and stop scoring
+        __m256i eq = _mm256_set_epi64x(
+            (long long)(j < lengths[3] ? peq[(unsigned char)texts[3][j]] : 0),
+            (long long)(j < lengths[2] ? peq[(unsigned char)texts[2][j]] : 0),
+            (long long)(j < lengths[1] ? peq[(unsigned char)texts[1][j]] : 0),
+            (long long)(j < lengths[0] ? peq[(unsigned char)texts[0][j]] : 0));
+        __m256i column = _mm256_set1_epi64x(j);
+        __m256i active = _mm256_cmpgt_epi64(lens, column);
+        
+        __m256i xv = _mm256_or_si256(eq, mv);
+        __m256i xh = _mm256_or_si256(_mm256_xor_si256(_mm256_add_epi64(_mm256_and_si256(eq, pv), pv), pv), eq);
+        __m256i ph = _mm256_or_si256(mv, _mm256_xor_si256(_mm256_or_si256(xh, pv), all));
+        __m256i mh = _mm256_and_si256(pv, xh);
+        
+        // Compare results are -1 where the bottom bit is set
+        __m256i ph_last = _mm256_cmpeq_epi64(_mm256_and_si256(ph, last), last);
+        __m256i mh_last = _mm256_cmpeq_epi64(_mm256_and_si256(mh, last), last);
+        score = _mm256_sub_epi64(score, _mm256_and_si256(ph_last, active));
+        score = _mm256_add_epi64(score, _mm256_and_si256(mh_last, active));
+        
+        // Stop once every lane has either finished or can no longer get within the bound
+        __m256i remaining = _mm256_sub_epi64(_mm256_sub_epi64(lens, column), ones);
+        __m256i lower_bound = _mm256_sub_epi64(score, _mm256_and_si256(remaining, active));
+        __m256i done = _mm256_or_si256(_mm256_cmpgt_epi64(lower_bound, limit),
+                                       _mm256_xor_si256(_mm256_cmpgt_epi64(lens, _mm256_add_epi64(column, ones)), all));
+        if (_mm256_movemask_pd(_mm256_castsi256_pd(done)) == 0xF) {
+            break;
+        }
+        
+        ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), ones);
+        mh = _mm256_slli_epi64(mh, 1);
+        pv = _mm256_or_si256(mh, _mm256_xor_si256(_mm256_or_si256(xv, ph), all));
+        mv = _mm256_and_si256(ph, xv);
+        PROFILE_COUNT(dp_cells, (size_t)m * __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(active))));
+    }
+    
+    long long lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, score);
+    for (int i = 0; i < 4; i++) {
+        scores[i] = (lanes[i] <= max_distance) ? (int)lanes[i] : max_distance + 1;
+    }
+}
+#endif
+
+/**
+ * Detect once whether the AVX2 batch kernel can run on this CPU
+ */
+static bool edit_distance_use_avx2(void) {
+#ifdef EDIT_DISTANCE_HAVE_AVX2
+    static int supported = -1; // Benign race: every thread computes the same value
+    if (supported < 0) {
+        __builtin_cpu_init();
+        supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return supported == 1;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Name of the kernel edit_distance_batch_within() uses on this CPU
+ */
+const char* edit_distance_kernel_name(void) {
+    return edit_distance_use_avx2() ? "avx2" : "bit-parallel";
+}
+
+/**
+ * Score many candidates against one word, four at a time with AVX2 when available
+ */
+int edit_distance_batch_within(const char* word, const char* const* candidates, int count,
+                               int max_distance, int* distances) {
+    if (!word || !candidates || !distances || count < 0 || max_distance < 0) {
+        return 0;
+    }
+    
+    int m = strlen(word);
+    if (m == 0 || m > 64) {
+        // Outside the bit-parallel range: score one by one
+        int within = 0;
+        for (int i = 0; i < count; i++) {
+            distances[i] = -1;
+            if (candidates[i] && edit_distance_within(word, candidates[i], max_distance, &distances[i])) {
+                within++;
+            }
+        }
+        return within;
+    }
+    
+    uint64_t peq[256];
+    myers_build_peq(word, m, peq);
+    bool use_avx2 = edit_distance_use_avx2();
+    
+    int within = 0;
+    int i = 0;
+    while (i < count) {
+        // Gather the next candidates that pass the length filter
+        const char* texts[4];
+        int lengths[4];
+        int slots[4];
+        int lanes = 0;
+        for (; i < count && lanes < (use_avx2 ? 4 : 1); i++) {
+            distances[i] = -1;
+            if (!candidates[i]) {
+                continue;
+            }
+            int n = strlen(candidates[i]);
+            int gap = (n > m) ? n - m : m - n;
+            if (gap > max_distance) {
+                continue;
+            }
+            texts[lanes] = candidates[i];
+            lengths[lanes] = n;
+            slots[lanes] = i;
+            lanes++;
+        }
+        
+        int scores[4];
+#ifdef EDIT_DISTANCE_HAVE_AVX2
+        if (use_avx2 && lanes > 1) {
+            for (int lane = lanes; lane < 4; lane++) {
+                texts[lane] = "";
+                lengths[lane] = 0;
+            }
+            myers_distance_x4(peq, m, texts, lengths, max_distance, scores);
+        } else
+#endif
+        {
+            for (int lane = 0; lane < lanes; lane++) {
+                scores[lane] = myers_distance(peq, m, texts[lane], lengths[lane], max_distance);
+            }
+        }
+        
+        for (int lane = 0; lane < lanes; lane++) {
+            if (scores[lane] <= max_distance) {
+                distances[slots[lane]] = scores[lane];
+                within++;
+            }
+        }
+    }
+    
+    return within;
+}
@@ -1,20 +1,146 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "../include/file_io.h"
+#include "../include/compact_trie.h"
+#include "../include/timing.h"
+#include "../include/utf8.h"
+#include "../include/memory_budget.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 /**
  * Maximum line length for dictionary and text files
  */
 #define MAX_LINE_LENGTH 1024
 
+/**
+ * Upper bound on the threads load_dictionary_parallel() starts
+ */
+#define LOAD_MAX_THREADS 64
+
+// Progress lines are skipped and warnings sent to stderr when quiet
+static bool g_quiet = false;
+
+/**
+ * Split an optional trailing frequency column ("word 1234") off a
+ * dictionary line, shortening the line to the word part
+ * @param line Dictionary line without its newline
+ * @param len Length of line, updated when a count is removed
+ * @return The count, or 1 if the line has none
+ */
+static int split_frequency(char* line, size_t* len) {
+    size_t end = *len;
+    while (end > 0 && isspace((unsigned char)line[end - 1])) {
+        end--;
+    }
+    
+    size_t start = end;
+    while (start > 0 && isdigit((unsigned char)line[start - 1])) {
+        start--;
+    }
+    
+    // Needs digits, separated by whitespace from a non-empty word
+    if (start == end || start == 0 || !isspace((unsigned char)line[start - 1])) {
+        return 1;
+    }
+    
+    // Saturate at INT_MAX, checking before the multiply so it cannot overflow
+    int frequency = 0;
+    for (size_t i = start; i < end; i++) {
+        int digit = line[i] - '0';
+        if (frequency > (INT_MAX - digit) / 10) {
+            frequency = INT_MAX;
+            break;
+        }
+        frequency = frequency * 10 + digit;
+    }
+    
+    while (start > 0 && isspace((unsigned char)line[start - 1])) {
+        start--;
+    }
+    line[start] = '\0';
+    *len = start;
+    return (frequency > 0) ? frequency : 1;
+}
+
+/**
+ * What a dictionary line turned out to hold
+ */
+typedef enum {
+    DICTIONARY_LINE_SKIP,       ///< Empty line or a word rejected by the validation rules
+    DICTIONARY_LINE_INVALID,    ///< Control characters or malformed UTF-8 (corrupted file indicator)
+    DICTIONARY_LINE_WORD        ///< A valid word to insert
+} DictionaryLineKind;
+
+/**
+ * Parse one line of a text dictionary the way load_dictionary() reads it
+ * @param line Line as returned by fgets() (modified in place)
+ * @param len Length of line
+ * @param word Receives the normalized word (MAX_WORD_INPUT_LENGTH + 1 bytes)
+ * @param frequency Receives the word's frequency
+ * @return Kind of line; word and frequency are set for DICTIONARY_LINE_WORD
+ */
+static DictionaryLineKind parse_dictionary_line(char* line, size_t len, char* word, int* frequency) {
+    // Remove newline character if present
+    if (len > 0 && line[len - 1] == '\n') {
+        line[len - 1] = '\0';
+        len--;
+    }
+    
+    // Skip empty lines
+    if (len == 0) {
+        return DICTIONARY_LINE_SKIP;
+    }
+    
+    // Check for control characters and malformed UTF-8 (corrupted file indicator)
+    if (utf8_find_invalid(line, len) < len) {
+        return DICTIONARY_LINE_INVALID;
+    }
+    
+    *frequency = split_frequency(line, &len);
+    
+    // Normalize the word (convert to lowercase, validate characters)
+    if (len == 0 || len > MAX_WORD_INPUT_LENGTH ||
+        normalize_word_into(line, len, word, MAX_WORD_INPUT_LENGTH + 1) == 0 || !is_valid_word(word)) {
+        return DICTIONARY_LINE_SKIP; // Skip invalid words but don't treat as error
+    }
+    return DICTIONARY_LINE_WORD;
+}
+
+/**
+ * Build the exact lookup table of a freshly loaded dictionary; without
+ * it lookups still work, only slower, so a failure is just a warning
+ * @param trie Loaded dictionary
+ */
+static void build_lookup_table(Trie* trie) {
+    if (!trie_build_word_set(trie)) {
+        fprintf(stderr, "Warning: Not enough memory for the exact lookup table, lookups will walk the trie\n");
+    }
+}
+
+void file_io_set_quiet(bool quiet) {
+    g_quiet = quiet;
+}
+
 bool load_dictionary(const char* filename, Trie* trie) {
     if (filename == NULL || trie == NULL) {
         fprintf(stderr, "Error: Invalid parameters - filename or trie is NULL\n");
         return false;
     }
     
+    // Precompiled dictionaries are mapped instead of parsed
+    if (compact_trie_is_compiled_file(filename)) {
+        return load_compiled_dictionary(filename, trie);
+    }
+    
     FILE* file = fopen(filename, "r");
     if (file == NULL) {
         fprintf(stderr, "Error: Cannot open dictionary file '%s'\n", filename);
@@ -23,6 +149,7 @@ bool load_dictionary(const char* filename, Trie* trie) {
     }
     
     char line[MAX_LINE_LENGTH];
+    char word[MAX_WORD_INPUT_LENGTH + 1];
     int words_loaded = 0;
     int line_number = 0;
     int corrupted_lines = 0;
@@ -40,46 +167,17 @@ bool load_dictionary(const char* filename, Trie* trie) {
             while ((c = fgetc(file)) != EOF && c != '\n');
         }
         
-        // Remove newline character if present
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-            len--;
-        }
-        
-        // Skip empty lines
-        if (len == 0) {
-            continue;
-        }
-        
-        // Check for non-printable characters (corrupted file indicator)
-        bool has_invalid_chars = false;
-        for (size_t i = 0; i < len; i++) {
-            if (!isprint(line[i]) && !isspace(line[i])) {
-                has_invalid_chars = true;
-                break;
-            }
-        }
-        
-        if (has_invalid_chars) {
+        int frequency;
+        DictionaryLineKind kind = parse_dictionary_line(line, len, word, &frequency);
+        if (kind == DICTIONARY_LINE_INVALID) {
             fprintf(stderr, "Warning: Line %d contains invalid characters, skipping\n", line_number);
             corrupted_lines++;
-            continue;
-        }
-        
-        // Normalize the word (convert to lowercase, validate characters)
-        char* normalized = normalize_word(line);
-        if (normalized != NULL && is_valid_word(normalized)) {
-            if (trie_insert(trie, normalized)) {
+        } else if (kind == DICTIONARY_LINE_WORD) {
+            if (trie_insert_with_frequency(trie, word, frequency)) {
                 words_loaded++;
             } else {
                 fprintf(stderr, "Warning: Failed to insert word '%s' at line %d (possible memory issue)\n", 
-                       normalized, line_number);
-            }
-            free(normalized);
-        } else {
-            // Skip invalid words but don't treat as error
-            if (normalized != NULL) {
-                free(normalized);
+                       word, line_number);
             }
         }
     }
@@ -95,8 +193,8 @@ bool load_dictionary(const char* filename, Trie* trie) {
     fclose(file);
     
     if (corrupted_lines > 0) {
-        printf("Warning: Skipped %d corrupted/invalid lines in dictionary '%s'\n", 
-               corrupted_lines, filename);
+        fprintf(g_quiet ? stderr : stdout, "Warning: Skipped %d corrupted/invalid lines in dictionary '%s'\n", 
+                corrupted_lines, filename);
     }
     
     if (words_loaded == 0) {
@@ -105,49 +203,138 @@ bool load_dictionary(const char* filename, Trie* trie) {
         return false;
     }
     
-    printf("Successfully loaded %d words from dictionary '%s'\n", words_loaded, filename);
+    if (!g_quiet) {
+        printf("Successfully loaded %d words from dictionary '%s'\n", words_loaded, filename);
+    }
+    build_lookup_table(trie);
     return true;
 }
 
-char* normalize_word(const char* word) {
-    if (word == NULL) {
-        return NULL;
+bool compile_dictionary(Trie* trie, const char* output_filename) {
+    if (trie == NULL || output_filename == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - trie or output filename is NULL\n");
+        return false;
     }
     
-    size_t len = strlen(word);
-    if (len == 0) {
-        return NULL;
+    if (trie->dawg != NULL) {
+        fprintf(stderr, "Error: A minimized dictionary cannot be compiled\n");
+        return false;
     }
     
-    // Check for extremely long words (potential corruption)
-    if (len > 100) {
-        return NULL;
+    if (!trie_freeze(trie)) {
+        fprintf(stderr, "Error: Not enough memory to build compact dictionary\n");
+        return false;
     }
     
-    // Allocate memory for normalized word (worst case: same length)
-    char* normalized = (char*)malloc((len + 1) * sizeof(char));
-    if (normalized == NULL) {
-        return NULL;
+    if (!compact_trie_save(trie->compact, output_filename)) {
+        return false;
+    }
+    
+    if (!g_quiet) {
+        printf("Compiled %d words (%u nodes) into '%s'\n",
+               trie->total_words, (unsigned)trie->compact->node_count, output_filename);
+    }
+    return true;
+}
+
+bool load_compiled_dictionary(const char* filename, Trie* trie) {
+    if (filename == NULL || trie == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - filename or trie is NULL\n");
+        return false;
+    }
+    
+    if (trie->compact != NULL || trie->total_words > 0) {
+        fprintf(stderr, "Error: Compiled dictionary '%s' must be loaded into an empty trie\n", filename);
+        return false;
+    }
+    
+    CompactTrie* compact = compact_trie_map(filename);
+    if (compact == NULL) {
+        return false;
+    }
+    
+    if (!trie_adopt_compact(trie, compact)) {
+        compact_trie_destroy(compact);
+        return false;
+    }
+    
+    if (!g_quiet) {
+        printf("Successfully mapped %d words from compiled dictionary '%s'\n", trie->total_words, filename);
+    }
+    build_lookup_table(trie);
+    return true;
+}
+
+size_t normalize_word_into(const char* word, size_t len, char* out, size_t out_size) {
+    if (word == NULL || out == NULL || out_size == 0 || len == 0) {
+        return 0;
+    }
+    
+    // Check for extremely long words (potential corruption)
+    if (len > MAX_WORD_INPUT_LENGTH) {
+        return 0;
     }
     
     size_t write_pos = 0;
     
     // Process each character
-    for (size_t i = 0; i < len; i++) {
-        char c = word[i];
+    size_t i = 0;
+    while (i < len && write_pos + 1 < out_size) {
+        unsigned char c = (unsigned char)word[i];
+        
+        // Convert to lowercase if alphabetic (bit 0x20 folds ASCII case)
+        if (c < 0x80) {
+            if ((unsigned char)((c | 0x20) - 'a') < 26) {
+                out[write_pos++] = (char)(c | 0x20);
+            }
+            i++;
+            continue;
+        }
         
-        // Convert to lowercase if alphabetic
-        if (isalpha(c)) {
-            normalized[write_pos++] = tolower(c);
+        // Non-ASCII letters are lowercased and re-encoded; bytes that are not UTF-8 are dropped
+        uint32_t code_point;
+        size_t sequence = utf8_decode(word + i, len - i, &code_point);
+        if (sequence == 0) {
+            i++;
+            continue;
+        }
+        if (utf8_is_letter(code_point)) {
+            char encoded[UTF8_MAX_SEQUENCE_LENGTH];
+            size_t encoded_len = utf8_encode(utf8_to_lower(code_point), encoded);
+            if (write_pos + encoded_len >= out_size) {
+                break;
+            }
+            memcpy(out + write_pos, encoded, encoded_len);
+            write_pos += encoded_len;
         }
         // Skip punctuation and other non-alphabetic characters
+        i += sequence;
     }
     
     // Null terminate
-    normalized[write_pos] = '\0';
+    out[write_pos] = '\0';
+    
+    return write_pos;
+}
+
+char* normalize_word(const char* word) {
+    if (word == NULL) {
+        return NULL;
+    }
+    
+    size_t len = strlen(word);
+    if (len == 0 || len > MAX_WORD_INPUT_LENGTH) {
+        return NULL;
+    }
+    
+    // Allocate memory for normalized word (worst case: same length)
+    char* normalized = (char*)malloc((len + 1) * sizeof(char));
+    if (normalized == NULL) {
+        return NULL;
+    }
     
     // If no valid characters found, return NULL
-    if (write_pos == 0) {
+    if (normalize_word_into(word, len, normalized, len + 1) == 0) {
         free(normalized);
         return NULL;
     }
@@ -165,248 +352,1062 @@ bool is_valid_word(const char* word) {
         return false;
     }
     
-    // Check if word contains only alphabetic characters
-    for (size_t i = 0; i < len; i++) {
-        if (!isalpha((unsigned char)word[i])) {
-            return false;
+    // Check if word contains only letters, counting characters and
+    // rejecting repeated ones (potential corruption) on the way
+    size_t characters = 0;
+    int consecutive_count = 0;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < len; ) {
+        // ASCII needs no decoding
+        uint32_t code_point = (unsigned char)word[i];
+        size_t sequence = 1;
+        if (code_point < 0x80) {
+            if ((uint32_t)((code_point | 0x20) - 'a') >= 26) {
+                return false;
+            }
+        } else {
+            sequence = utf8_decode(word + i, len - i, &code_point);
+            if (sequence == 0 || !utf8_is_letter(code_point)) {
+                return false;
+            }
+        }
+        
+        consecutive_count = (characters > 0 && code_point == previous) ? consecutive_count + 1 : 1;
+        if (consecutive_count > 3) {
+            return false; // Reject words like "aaaaaaa"
         }
+        previous = code_point;
+        characters++;
+        i += sequence;
     }
     
     // Reject very short words (single characters) and very long words
-    if (len < 2 || len > 50) {
+    if (characters < 2 || characters > 50 || len > TRIE_MAX_WORD_LENGTH) {
         return false;
     }
     
-    // Additional validation: reject words with repeated characters (potential corruption)
-    int consecutive_count = 1;
-    for (size_t i = 1; i < len; i++) {
-        if (word[i] == word[i-1]) {
-            consecutive_count++;
-            if (consecutive_count > 3) {
-                return false; // Reject words like "aaaaaaa"
-            }
-        } else {
-            consecutive_count = 1;
-        }
-    }
-    
     return true;
 }
 
-TextDocument* load_text_file(const char* filename) {
-    if (filename == NULL) {
-        fprintf(stderr, "Error: Invalid parameter - filename is NULL\n");
+/**
+ * Read the rest of a file into one NUL-terminated buffer
+ * @return Heap buffer holding *size bytes plus a terminator, or NULL on error
+ */
+static char* read_whole_file(FILE* file, size_t* size) {
+    size_t capacity = STREAM_CHUNK_SIZE;
+    size_t used = 0;
+    char* buffer = (char*)malloc(capacity + 1);
+    if (buffer == NULL) {
         return NULL;
     }
     
-    FILE* file = fopen(filename, "r");
-    if (file == NULL) {
-        fprintf(stderr, "Error: Cannot open text file '%s'\n", filename);
-        fprintf(stderr, "Suggestion: Check that the file exists and you have read permissions\n");
-        return NULL;
+    size_t bytes_read;
+    while ((bytes_read = fread(buffer + used, 1, capacity - used, file)) > 0) {
+        used += bytes_read;
+        if (used == capacity) {
+            char* grown = (char*)realloc(buffer, capacity * 2 + 1);
+            if (grown == NULL) {
+                free(buffer);
+                return NULL;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
     }
     
-    // Allocate TextDocument structure
-    TextDocument* doc = (TextDocument*)malloc(sizeof(TextDocument));
-    if (doc == NULL) {
-        fclose(file);
+    if (ferror(file)) {
+        free(buffer);
         return NULL;
     }
     
-    // Initialize document
-    doc->tokens = NULL;
-    doc->token_count = 0;
-    doc->total_words = 0;
-    doc->filename = (char*)malloc((strlen(filename) + 1) * sizeof(char));
-    if (doc->filename == NULL) {
-        free(doc);
-        fclose(file);
-        return NULL;
+    // Give back the doubling slack; the document keeps this buffer for its lifetime
+    char* fitted = (char*)realloc(buffer, used + 1);
+    if (fitted != NULL) {
+        buffer = fitted;
     }
-    strcpy(doc->filename, filename);
     
-    // Initial capacity for tokens array
-    int capacity = 1000;
-    doc->tokens = (TextToken*)malloc(capacity * sizeof(TextToken));
-    if (doc->tokens == NULL) {
-        free(doc->filename);
-        free(doc);
-        fclose(file);
-        return NULL;
+    buffer[used] = '\0';
+    *size = used;
+    return buffer;
+}
+
+/**
+ * Smallest share of a dictionary file worth a parse thread of its own
+ */
+#define PARALLEL_LOAD_MIN_CHUNK 65536
+
+/**
+ * First bytes that get a Trie of their own: a-z, and every byte >= 0x80
+ * (the lead byte of a non-ASCII character)
+ */
+#define LOAD_LETTERS (26 + 128)
+
+/**
+ * Number of first-letter buckets: the letters, plus one for any other first byte
+ */
+#define LOAD_BUCKETS (LOAD_LETTERS + 1)
+
+/**
+ * A word accepted by a parse worker, held in its chunk's word pool
+ */
+typedef struct LoadedWord {
+    size_t offset;    ///< Offset of the NUL-terminated word in the chunk pool
+    int frequency;    ///< Frequency column of the line (1 if absent)
+    int line;         ///< Line number within the chunk
+} LoadedWord;
+
+/**
+ * Growable list of accepted words sharing a first letter
+ */
+typedef struct LoadedWordList {
+    LoadedWord* items;
+    size_t count;
+    size_t capacity;
+} LoadedWordList;
+
+/**
+ * A per-line warning found by a parse worker, printed later in file order
+ */
+typedef struct LoadNotice {
+    int line;         ///< Line number within the chunk
+    bool overlong;    ///< true for "exceeds maximum length", false for "invalid characters"
+} LoadNotice;
+
+/**
+ * A slice of the dictionary file parsed by one worker thread
+ */
+typedef struct DictionaryChunk {
+    const char* start;                     ///< First byte (the start of a line)
+    const char* end;                       ///< One past the last byte (just after a newline, or end of file)
+    char* pool;                            ///< Normalized words, NUL-terminated, back to back
+    size_t pool_size;                      ///< Bytes used in pool
+    LoadedWordList buckets[LOAD_BUCKETS];  ///< Accepted words by first letter, in file order
+    LoadNotice* notices;                   ///< Warnings in file order
+    size_t notice_count;
+    size_t notice_capacity;
+    int lines;                             ///< Lines read, counted the way fgets() splits them
+    int first_line;                        ///< Number of lines in the chunks before this one
+    bool failed;                           ///< Memory allocation failure
+} DictionaryChunk;
+
+/**
+ * A word the builders could not insert, reported like the serial loader does
+ */
+typedef struct LoadFailure {
+    const char* word;
+    int line;
+} LoadFailure;
+
+/**
+ * The first letters one builder thread turns into Tries
+ */
+typedef struct LetterBuild {
+    DictionaryChunk* chunks;     ///< All parsed chunks
+    int chunk_count;
+    int letters[LOAD_LETTERS];   ///< Letters assigned to this builder
+    int letter_count;
+    Trie** subtries;             ///< Shared result array, one Trie per letter
+    int words_loaded;            ///< Successful insertions (duplicates included)
+    LoadFailure* failures;       ///< Words that could not be inserted
+    size_t failure_count;
+    size_t failure_capacity;
+    bool failed;                 ///< A Trie could not be created
+} LetterBuild;
+
+/**
+ * Append an item to a growable array
+ * @param items Array pointer (reallocated as needed)
+ * @param count Current number of items
+ * @param capacity Current capacity, updated when the array grows
+ * @param item_size Size of one item
+ * @return Pointer to the new (uninitialized) slot, or NULL on memory allocation failure
+ */
+static void* append_item(void** items, size_t* count, size_t* capacity, size_t item_size) {
+    if (*count == *capacity) {
+        size_t new_capacity = (*capacity == 0) ? 256 : *capacity * 2;
+        void* grown = realloc(*items, new_capacity * item_size);
+        if (grown == NULL) {
+            return NULL;
+        }
+        *items = grown;
+        *capacity = new_capacity;
     }
-    
+    return (char*)*items + (*count)++ * item_size;
+}
+
+/**
+ * Record a per-line warning of a chunk
+ * @param chunk Chunk being parsed
+ * @param overlong Kind of warning
+ */
+static void chunk_add_notice(DictionaryChunk* chunk, bool overlong) {
+    LoadNotice* notice = (LoadNotice*)append_item((void**)&chunk->notices, &chunk->notice_count,
+                                                  &chunk->notice_capacity, sizeof(LoadNotice));
+    if (notice == NULL) {
+        chunk->failed = true;
+        return;
+    }
+    notice->line = chunk->lines;
+    notice->overlong = overlong;
+}
+
+/**
+ * Worker: split a chunk into lines exactly as fgets() would and keep the
+ * valid words, bucketed by first letter
+ * @param arg DictionaryChunk to parse
+ * @return NULL
+ */
+static void* parse_dictionary_chunk(void* arg) {
+    DictionaryChunk* chunk = (DictionaryChunk*)arg;
     char line[MAX_LINE_LENGTH];
-    int line_number = 0;
-    int corrupted_lines = 0;
-    int memory_failures = 0;
+    char word[MAX_WORD_INPUT_LENGTH + 1];
+    const char* cursor = chunk->start;
     
-    while (fgets(line, sizeof(line), file) != NULL) {
-        line_number++;
+    // Normalized words never outgrow their line, and each line
+    // (except possibly the last) gives up a newline to hold the terminator
+    chunk->pool = (char*)malloc((size_t)(chunk->end - chunk->start) + 1);
+    if (chunk->pool == NULL) {
+        chunk->failed = true;
+        return NULL;
+    }
+    
+    while (cursor < chunk->end && !chunk->failed) {
+        // fgets() stops after a newline or MAX_LINE_LENGTH - 1 bytes
+        size_t available = (size_t)(chunk->end - cursor);
+        size_t limit = (available < MAX_LINE_LENGTH - 1) ? available : MAX_LINE_LENGTH - 1;
+        const char* newline = (const char*)memchr(cursor, '\n', limit);
+        size_t piece = (newline != NULL) ? (size_t)(newline - cursor) + 1 : limit;
+        
+        memcpy(line, cursor, piece);
+        line[piece] = '\0';
+        cursor += piece;
+        chunk->lines++;
         
-        // Check for line length overflow (corrupted file indicator)
         size_t len = strlen(line);
         if (len == MAX_LINE_LENGTH - 1 && line[len - 1] != '\n') {
-            fprintf(stderr, "Warning: Line %d exceeds maximum length, truncating\n", line_number);
-            corrupted_lines++;
+            chunk_add_notice(chunk, true);
             // Skip rest of this line
-            int c;
-            while ((c = fgetc(file)) != EOF && c != '\n');
+            const char* rest = (const char*)memchr(cursor, '\n', (size_t)(chunk->end - cursor));
+            cursor = (rest != NULL) ? rest + 1 : chunk->end;
         }
         
-        // Remove newline character if present
-        if (len > 0 && line[len - 1] == '\n') {
-            line[len - 1] = '\0';
-            len--;
-        }
-        
-        // Check for non-printable characters (corrupted file indicator)
-        bool has_invalid_chars = false;
-        for (size_t i = 0; i < len; i++) {
-            if (!isprint(line[i]) && !isspace(line[i])) {
-                has_invalid_chars = true;
+        int frequency;
+        DictionaryLineKind kind = parse_dictionary_line(line, len, word, &frequency);
+        if (kind == DICTIONARY_LINE_INVALID) {
+            chunk_add_notice(chunk, false);
+        } else if (kind == DICTIONARY_LINE_WORD) {
+            unsigned char first = (unsigned char)word[0];
+            int bucket = LOAD_BUCKETS - 1;
+            if (first >= 'a' && first <= 'z') {
+                bucket = first - 'a';
+            } else if (first >= 0x80) {
+                bucket = 26 + (first - 0x80);
+            }
+            LoadedWordList* list = &chunk->buckets[bucket];
+            LoadedWord* entry = (LoadedWord*)append_item((void**)&list->items, &list->count,
+                                                         &list->capacity, sizeof(LoadedWord));
+            if (entry == NULL) {
+                chunk->failed = true;
                 break;
             }
+            
+            size_t word_len = strlen(word);
+            memcpy(chunk->pool + chunk->pool_size, word, word_len + 1);
+            entry->offset = chunk->pool_size;
+            entry->frequency = frequency;
+            entry->line = chunk->lines;
+            chunk->pool_size += word_len + 1;
         }
+    }
+    
+    return NULL;
+}
+
+/**
+ * Insert one bucket of every chunk, in file order, into a Trie
+ * @param build Builder receiving the counts and failures
+ * @param trie Trie to insert into
+ * @param bucket Bucket index
+ */
+static void insert_bucket(LetterBuild* build, Trie* trie, int bucket) {
+    for (int c = 0; c < build->chunk_count; c++) {
+        const DictionaryChunk* chunk = &build->chunks[c];
+        const LoadedWordList* list = &chunk->buckets[bucket];
         
-        if (has_invalid_chars) {
-            fprintf(stderr, "Warning: Line %d contains invalid characters, skipping\n", line_number);
-            corrupted_lines++;
-            continue;
-        }
-        
-        // Tokenize the line
-        char* line_copy = (char*)malloc((len + 1) * sizeof(char));
-        if (line_copy == NULL) {
-            fprintf(stderr, "Warning: Memory allocation failed for line %d, skipping\n", line_number);
-            memory_failures++;
-            continue; // Skip this line on memory allocation failure
-        }
-        strcpy(line_copy, line);
-        
-        // Simple tokenization by whitespace and punctuation
-        char* token_start = line_copy;
-        int position = 0;
-        
-        for (size_t i = 0; i <= len; i++) {
-            char c = (i < len) ? line_copy[i] : '\0';
+        for (size_t i = 0; i < list->count; i++) {
+            const char* word = chunk->pool + list->items[i].offset;
+            if (trie_insert_with_frequency(trie, word, list->items[i].frequency)) {
+                build->words_loaded++;
+                continue;
+            }
             
-            // Check if we've reached end of a token
-            if (isspace(c) || ispunct(c) || c == '\0') {
-                if (token_start < line_copy + i) {
-                    // Extract token
-                    char original_char = line_copy[i];
-                    line_copy[i] = '\0'; // Temporarily null-terminate
-                    
-                    // Create normalized version
-                    char* normalized = normalize_word(token_start);
-                    
-                    if (normalized != NULL && is_valid_word(normalized)) {
-                        // Resize tokens array if needed
-                        if (doc->token_count >= capacity) {
-                            capacity *= 2;
-                            TextToken* new_tokens = (TextToken*)realloc(doc->tokens, 
-                                                                      capacity * sizeof(TextToken));
-                            if (new_tokens == NULL) {
-                                fprintf(stderr, "Warning: Memory allocation failed, stopping at line %d\n", line_number);
-                                memory_failures++;
-                                free(normalized);
-                                break; // Stop processing on memory allocation failure
-                            }
-                            doc->tokens = new_tokens;
-                        }
-                        
-                        // Store token
-                        TextToken* token = &doc->tokens[doc->token_count];
-                        token->word = normalized;
-                        
-                        // Store original word
-                        size_t orig_len = strlen(token_start);
-                        token->original_word = (char*)malloc((orig_len + 1) * sizeof(char));
-                        if (token->original_word != NULL) {
-                            strcpy(token->original_word, token_start);
-                        }
-                        
-                        token->line_number = line_number;
-                        token->position = position;
-                        
-                        doc->token_count++;
-                        doc->total_words++;
-                    } else {
-                        if (normalized != NULL) {
-                            free(normalized);
-                        }
-                    }
-                    
-                    line_copy[i] = original_char; // Restore character
-                }
-                
-                // Move to next potential token start
-                if (i < len) {
-                    while (i < len && (isspace(line_copy[i]) || ispunct(line_copy[i]))) {
-                        i++;
-                        position++;
-                    }
-                    if (i < len) {
-                        token_start = line_copy + i;
-                        position = i;
-                        i--; // Adjust for loop increment
-                    }
-                }
+            LoadFailure* failure = (LoadFailure*)append_item((void**)&build->failures, &build->failure_count,
+                                                             &build->failure_capacity, sizeof(LoadFailure));
+            if (failure != NULL) {
+                failure->word = word;
+                failure->line = chunk->first_line + list->items[i].line;
             }
         }
-        
-        free(line_copy);
-    }
-    
-    // Check for file read errors
-    if (ferror(file)) {
-        fprintf(stderr, "Error: File read error occurred while processing '%s'\n", filename);
-        fprintf(stderr, "Suggestion: Check file integrity and disk space\n");
-        // Continue with partial results rather than failing completely
     }
-    
+}
+
+/**
+ * Order two word pointers alphabetically (bytewise)
+ */
+static int compare_word_pointers(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+/**
+ * Length of the common prefix of two words
+ */
+static size_t common_prefix_length(const char* a, const char* b) {
+    size_t length = 0;
+    while (a[length] != '\0' && a[length] == b[length]) {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * Count the Trie nodes one bucket's words need, root included: over the
+ * words in sorted order, each adds one node per byte past its common
+ * prefix with the word before. Dictionaries are usually sorted already;
+ * otherwise a sorted copy of the word pointers is counted instead.
+ * @return Node count, or 0 if unknown (memory allocation failure)
+ */
+static size_t count_bucket_nodes(const LetterBuild* build, int bucket) {
+    size_t nodes = 1;
+    const char* previous = "";
+    bool sorted = true;
+    for (int c = 0; c < build->chunk_count && sorted; c++) {
+        const DictionaryChunk* chunk = &build->chunks[c];
+        const LoadedWordList* list = &chunk->buckets[bucket];
+        for (size_t i = 0; i < list->count; i++) {
+            const char* word = chunk->pool + list->items[i].offset;
+            if (strcmp(previous, word) > 0) {
+                sorted = false;
+                break;
+            }
+            nodes += strlen(word) - common_prefix_length(previous, word);
+            previous = word;
+        }
+    }
+    if (sorted) {
+        return nodes;
+    }
+    
+    size_t words = 0;
+    for (int c = 0; c < build->chunk_count; c++) {
+        words += build->chunks[c].buckets[bucket].count;
+    }
+    const char** sorted_words = (const char**)malloc(words * sizeof(const char*));
+    if (sorted_words == NULL) {
+        return 0;
+    }
+    size_t count = 0;
+    for (int c = 0; c < build->chunk_count; c++) {
+        const DictionaryChunk* chunk = &build->chunks[c];
+        const LoadedWordList* list = &chunk->buckets[bucket];
+        for (size_t i = 0; i < list->count; i++) {
+            sorted_words[count++] = chunk->pool + list->items[i].offset;
+        }
+    }
+    qsort(sorted_words, count, sizeof(const char*), compare_word_pointers);
+    
+    nodes = 1;
+    previous = "";
+    for (size_t i = 0; i < count; i++) {
+        nodes += strlen(sorted_words[i]) - common_prefix_length(previous, sorted_words[i]);
+        previous = sorted_words[i];
+    }
+    free(sorted_words);
+    return nodes;
+}
+
+/**
+ * Worker: build one Trie per assigned first letter, each sized to its
+ * words so grafting leaves no partly used arena chunks behind
+ * @param arg LetterBuild to run
+ * @return NULL
+ */
+static void* build_letter_tries(void* arg) {
+    LetterBuild* build = (LetterBuild*)arg;
+    
+    for (int i = 0; i < build->letter_count; i++) {
+        int letter = build->letters[i];
+        Trie* subtrie = trie_create_with_capacity(count_bucket_nodes(build, letter));
+        if (subtrie == NULL) {
+            build->failed = true;
+            return NULL;
+        }
+        build->subtries[letter] = subtrie;
+        insert_bucket(build, subtrie, letter);
+    }
+    
+    return NULL;
+}
+
+/**
+ * Run a worker function over an array of tasks, one thread per task;
+ * a task whose thread cannot be started runs on the calling thread
+ * @param worker Worker function
+ * @param tasks Task array
+ * @param task_size Size of one task
+ * @param task_count Number of tasks
+ */
+static void run_parallel(void* (*worker)(void*), void* tasks, size_t task_size, int task_count) {
+    pthread_t threads[LOAD_MAX_THREADS];
+    bool started[LOAD_MAX_THREADS];
+    
+    // The calling thread takes the first task itself
+    for (int t = 1; t < task_count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, worker, (char*)tasks + (size_t)t * task_size) == 0;
+    }
+    worker(tasks);
+    for (int t = 1; t < task_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        } else {
+            worker((char*)tasks + (size_t)t * task_size); // Thread creation failed, run inline
+        }
+    }
+}
+
+/**
+ * Hand out the letters to builders, largest bucket first to the least
+ * loaded builder, so one long letter does not hold up the rest
+ * @param chunks Parsed chunks
+ * @param chunk_count Number of chunks
+ * @param builds Builders to fill
+ * @param build_count Number of builders
+ */
+static void assign_letters(const DictionaryChunk* chunks, int chunk_count, LetterBuild* builds, int build_count) {
+    size_t sizes[LOAD_LETTERS] = { 0 };
+    int order[LOAD_LETTERS];
+    for (int letter = 0; letter < LOAD_LETTERS; letter++) {
+        for (int c = 0; c < chunk_count; c++) {
+            sizes[letter] += chunks[c].buckets[letter].count;
+        }
+        order[letter] = letter;
+    }
+    
+    // Insertion sort, largest first (ties keep alphabetical order)
+    for (int i = 1; i < LOAD_LETTERS; i++) {
+        int letter = order[i];
+        int j = i;
+        while (j > 0 && sizes[order[j - 1]] < sizes[letter]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = letter;
+    }
+    
+    size_t loads[LOAD_MAX_THREADS] = { 0 };
+    for (int i = 0; i < LOAD_LETTERS && sizes[order[i]] > 0; i++) {
+        int target = 0;
+        for (int b = 1; b < build_count; b++) {
+            if (loads[b] < loads[target]) {
+                target = b;
+            }
+        }
+        builds[target].letters[builds[target].letter_count++] = order[i];
+        loads[target] += sizes[order[i]];
+    }
+}
+
+/**
+ * Split a file buffer into line-aligned chunks of roughly equal size
+ * @param buffer File contents
+ * @param size Size of buffer
+ * @param chunks Chunks to fill
+ * @param chunk_count Number of chunks
+ */
+static void split_into_chunks(const char* buffer, size_t size, DictionaryChunk* chunks, int chunk_count) {
+    const char* end = buffer + size;
+    const char* cursor = buffer;
+    
+    for (int c = 0; c < chunk_count; c++) {
+        chunks[c].start = cursor;
+        if (c == chunk_count - 1) {
+            cursor = end;
+        } else {
+            const char* split = buffer + size / (size_t)chunk_count * (size_t)(c + 1);
+            if (split < cursor) {
+                split = cursor;
+            }
+            // Every byte after a newline starts an fgets() line, so chunks can be parsed independently
+            const char* newline = (const char*)memchr(split, '\n', (size_t)(end - split));
+            cursor = (newline != NULL) ? newline + 1 : end;
+        }
+        chunks[c].end = cursor;
+    }
+}
+
+/**
+ * Release everything the parallel loader allocated, including Tries not grafted
+ */
+static void free_parallel_load(DictionaryChunk* chunks, int chunk_count, LetterBuild* builds, int build_count,
+                               Trie** subtries) {
+    for (int c = 0; c < chunk_count; c++) {
+        free(chunks[c].pool);
+        free(chunks[c].notices);
+        for (int b = 0; b < LOAD_BUCKETS; b++) {
+            free(chunks[c].buckets[b].items);
+        }
+    }
+    for (int b = 0; b < build_count; b++) {
+        free(builds[b].failures);
+    }
+    for (int letter = 0; letter < LOAD_LETTERS; letter++) {
+        trie_destroy(subtries[letter]);
+    }
+}
+
+bool load_dictionary_parallel(const char* filename, Trie* trie, int thread_count) {
+    if (filename == NULL || trie == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - filename or trie is NULL\n");
+        return false;
+    }
+    
+    // Grafting needs an empty, unfrozen trie; everything else is the serial loader's job
+    if (thread_count <= 1 || trie->root == NULL || trie->total_words > 0 ||
+        compact_trie_is_compiled_file(filename)) {
+        return load_dictionary(filename, trie);
+    }
+    if (thread_count > LOAD_MAX_THREADS) {
+        thread_count = LOAD_MAX_THREADS;
+    }
+    
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        return load_dictionary(filename, trie); // Reports the error
+    }
+    size_t size = 0;
+    char* buffer = read_whole_file(file, &size);
     fclose(file);
+    if (buffer == NULL) {
+        return load_dictionary(filename, trie); // Read error or out of memory: stream it instead
+    }
+    
+    int chunk_count = (int)(size / PARALLEL_LOAD_MIN_CHUNK) + 1;
+    if (chunk_count > thread_count) {
+        chunk_count = thread_count;
+    }
+    int build_count = thread_count < LOAD_LETTERS ? thread_count : LOAD_LETTERS;
+    
+    DictionaryChunk chunks[LOAD_MAX_THREADS];
+    LetterBuild builds[LOAD_MAX_THREADS];
+    Trie* subtries[LOAD_LETTERS] = { NULL };
+    memset(chunks, 0, sizeof(chunks));
+    memset(builds, 0, sizeof(builds));
+    
+    // Phase 1: read lines, normalize and validate words in parallel
+    split_into_chunks(buffer, size, chunks, chunk_count);
+    run_parallel(parse_dictionary_chunk, chunks, sizeof(DictionaryChunk), chunk_count);
+    
+    bool failed = false;
+    for (int c = 0; c < chunk_count; c++) {
+        failed |= chunks[c].failed;
+        if (c > 0) {
+            chunks[c].first_line = chunks[c - 1].first_line + chunks[c - 1].lines;
+        }
+    }
+    
+    // Phase 2: build one Trie per first letter in parallel
+    if (!failed) {
+        for (int b = 0; b < build_count; b++) {
+            builds[b].chunks = chunks;
+            builds[b].chunk_count = chunk_count;
+            builds[b].subtries = subtries;
+        }
+        assign_letters(chunks, chunk_count, builds, build_count);
+        run_parallel(build_letter_tries, builds, sizeof(LetterBuild), build_count);
+        for (int b = 0; b < build_count; b++) {
+            failed |= builds[b].failed;
+        }
+    }
+    
+    if (failed) {
+        free_parallel_load(chunks, chunk_count, builds, build_count, subtries);
+        free(buffer);
+        return load_dictionary(filename, trie); // Out of memory: fall back to the streaming loader
+    }
+    
+    // Phase 3: graft the letters under the root; words starting with
+    // anything else go straight in (and are reported the same way)
+    int words_loaded = 0;
+    for (int letter = 0; letter < LOAD_LETTERS; letter++) {
+        if (subtries[letter] != NULL && trie_graft(trie, subtries[letter])) {
+            subtries[letter] = NULL;
+        }
+    }
+    LetterBuild* others = &builds[0];
+    insert_bucket(others, trie, LOAD_BUCKETS - 1);
+    
+    // Same warnings as the serial loader, in file order
+    int corrupted_lines = 0;
+    for (int c = 0; c < chunk_count; c++) {
+        for (size_t i = 0; i < chunks[c].notice_count; i++) {
+            const LoadNotice* notice = &chunks[c].notices[i];
+            fprintf(stderr, notice->overlong ? "Warning: Line %d exceeds maximum length, truncating\n"
+                                             : "Warning: Line %d contains invalid characters, skipping\n",
+                    chunks[c].first_line + notice->line);
+            corrupted_lines++;
+        }
+    }
+    for (int b = 0; b < build_count; b++) {
+        words_loaded += builds[b].words_loaded;
+        for (size_t i = 0; i < builds[b].failure_count; i++) {
+            fprintf(stderr, "Warning: Failed to insert word '%s' at line %d (possible memory issue)\n",
+                    builds[b].failures[i].word, builds[b].failures[i].line);
+        }
+    }
+    
+    free_parallel_load(chunks, chunk_count, builds, build_count, subtries);
+    free(buffer);
+    
+    if (corrupted_lines > 0) {
+        fprintf(g_quiet ? stderr : stdout, "Warning: Skipped %d corrupted/invalid lines in dictionary '%s'\n",
+                corrupted_lines, filename);
+    }
+    
+    if (words_loaded == 0) {
+        fprintf(stderr, "Error: No valid words loaded from dictionary '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check file format - dictionary should contain one word per line\n");
+        return false;
+    }
+    
+    if (!g_quiet) {
+        printf("Successfully loaded %d words from dictionary '%s'\n", words_loaded, filename);
+    }
+    build_lookup_table(trie);
+    return true;
+}
+
+/**
+ * Split doc->text into tokens, terminating originals in place and copying
+ * normalized words into doc->words
+ * @param doc Document whose text and text_size are set
+ * @param report Whether to print per-line warnings and a summary
+ * @return false if the token or word storage cannot be allocated
+ */
+static bool tokenize_document(TextDocument* doc, bool report) {
+    double started = timing_now_seconds();
+    
+    // Every token is followed by a boundary byte (or the terminator), and
+    // normalizing never lengthens a word, so text_size + 1 bytes always hold
+    // all normalized words and their terminators
+    doc->words = (char*)malloc(doc->text_size + 1);
+    
+    // Initial capacity for tokens array
+    int capacity = 1000;
+    doc->tokens = (TextToken*)malloc(capacity * sizeof(TextToken));
+    if (doc->words == NULL || doc->tokens == NULL) {
+        return false;
+    }
+    
+    char* text = doc->text;
+    size_t text_size = doc->text_size;
+    size_t words_used = 0;
+    char normalized[MAX_WORD_INPUT_LENGTH + 1];
+    
+    size_t line_start = 0;
+    int line_number = 0;
+    int corrupted_lines = 0;
+    int memory_failures = 0;
+    
+    while (line_start < text_size && memory_failures == 0) {
+        line_number++;
+        
+        const char* newline = (const char*)memchr(text + line_start, '\n', text_size - line_start);
+        size_t line_end = newline ? (size_t)(newline - text) : text_size;
+        
+        // Check for control characters and malformed UTF-8 (corrupted file indicator)
+        size_t line_len = line_end - line_start;
+        if (utf8_find_invalid(text + line_start, line_len) < line_len) {
+            if (report) {
+                fprintf(stderr, "Warning: Line %d contains invalid characters, skipping\n", line_number);
+            }
+            corrupted_lines++;
+            line_start = line_end + 1;
+            continue;
+        }
+        
+        // Tokenization by whitespace, punctuation and symbols
+        size_t i = line_start;
+        while (i < line_end) {
+            i += utf8_token_start(text + i, line_end - i);
+            if (i >= line_end) {
+                break;
+            }
+            
+            size_t token_start = i;
+            i += utf8_token_end(text + i, line_end - i);
+            size_t length = i - token_start;
+            
+            // Normalize into scratch space; only valid words are kept
+            size_t normalized_len = normalize_word_into(text + token_start, length,
+                                                        normalized, sizeof(normalized));
+            if (normalized_len == 0 || !is_valid_word(normalized)) {
+                continue;
+            }
+            
+            // Resize tokens array if needed
+            if (doc->token_count >= capacity) {
+                TextToken* new_tokens = (TextToken*)realloc(doc->tokens, 
+                                                          capacity * 2 * sizeof(TextToken));
+                if (new_tokens == NULL) {
+                    if (report) {
+                        fprintf(stderr, "Warning: Memory allocation failed, stopping at line %d\n", line_number);
+                    }
+                    memory_failures++;
+                    break; // Stop processing on memory allocation failure
+                }
+                doc->tokens = new_tokens;
+                capacity *= 2;
+            }
+            
+            // Store token: normalized word in the words block, original
+            // terminated in place by overwriting the first byte of the
+            // separator after it (scanning resumes behind the separator)
+            TextToken* token = &doc->tokens[doc->token_count];
+            token->word = memcpy(doc->words + words_used, normalized, normalized_len + 1);
+            words_used += normalized_len + 1;
+            
+            size_t separator = utf8_separator_length(text + i, line_end - i);
+            text[i] = '\0';
+            token->original_word = text + token_start;
+            token->offset = token_start;
+            token->length = length;
+            token->line_number = line_number;
+            token->position = (int)(token_start - line_start);
+            
+            doc->token_count++;
+            doc->total_words++;
+            i += separator;
+        }
+        
+        line_start = line_end + 1;
+    }
+    doc->tokenize_seconds = timing_now_seconds() - started;
+    
+    // Text and words blocks, token array and name, for the memory budget
+    doc->memory_used = sizeof(TextDocument) + 2 * (doc->text_size + 1) + (size_t)capacity * sizeof(TextToken) +
+                       (doc->filename != NULL ? strlen(doc->filename) + 1 : 0);
+    memory_charge(MEMORY_COMPONENT_DOCUMENTS, doc->memory_used);
+    
+    if (!report) {
+        return true;
+    }
     
     // Report processing summary
     if (corrupted_lines > 0) {
-        printf("Warning: Skipped %d corrupted/invalid lines in text file '%s'\n", 
-               corrupted_lines, filename);
+        fprintf(g_quiet ? stderr : stdout, "Warning: Skipped %d corrupted/invalid lines in text file '%s'\n", 
+                corrupted_lines, doc->filename);
     }
     
     if (memory_failures > 0) {
-        printf("Warning: %d memory allocation failures occurred during processing\n", 
-               memory_failures);
+        fprintf(g_quiet ? stderr : stdout, "Warning: %d memory allocation failures occurred during processing\n", 
+                memory_failures);
     }
     
     if (doc->token_count == 0) {
-        fprintf(stderr, "Warning: No valid tokens found in file '%s'\n", filename);
+        fprintf(stderr, "Warning: No valid tokens found in file '%s'\n", doc->filename);
         fprintf(stderr, "Suggestion: Check file format and content\n");
-    } else {
+    } else if (!g_quiet) {
         printf("Successfully loaded %d tokens from text file '%s'\n", 
-               doc->token_count, filename);
+               doc->token_count, doc->filename);
+    }
+    
+    return true;
+}
+
+/**
+ * Load and tokenize a text file
+ * @param filename Path to text file
+ * @param report Whether to print errors, per-line warnings and a summary
+ * @return Pointer to TextDocument structure, or NULL on error
+ */
+static TextDocument* read_text_document(const char* filename, bool report) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        if (report) {
+            fprintf(stderr, "Error: Cannot open text file '%s'\n", filename);
+            fprintf(stderr, "Suggestion: Check that the file exists and you have read permissions\n");
+        }
+        return NULL;
+    }
+    
+    // Allocate TextDocument structure
+    TextDocument* doc = (TextDocument*)calloc(1, sizeof(TextDocument));
+    if (doc == NULL) {
+        fclose(file);
+        return NULL;
+    }
+    
+    doc->filename = (char*)malloc((strlen(filename) + 1) * sizeof(char));
+    if (doc->filename == NULL) {
+        free(doc);
+        fclose(file);
+        return NULL;
+    }
+    strcpy(doc->filename, filename);
+    
+    // Read the whole file once; tokens are spans into this buffer
+    doc->text = read_whole_file(file, &doc->text_size);
+    fclose(file);
+    if (doc->text == NULL) {
+        if (report) {
+            fprintf(stderr, "Error: File read error occurred while processing '%s'\n", filename);
+            fprintf(stderr, "Suggestion: Check file integrity and disk space\n");
+        }
+        free_text_document(doc);
+        return NULL;
+    }
+    
+    if (!tokenize_document(doc, report)) {
+        free_text_document(doc);
+        return NULL;
     }
     
     return doc;
 }
 
-void free_text_document(TextDocument* doc) {
+size_t estimate_text_file_memory(const char* filename) {
+    struct stat info;
+    if (filename == NULL || stat(filename, &info) != 0 || info.st_size < 0) {
+        return 0;
+    }
+    
+    // Text and words blocks exactly; one token slot per 4 bytes covers prose
+    // (a word every 6 bytes or so) plus the slack of the doubling token array
+    size_t size = (size_t)info.st_size;
+    return sizeof(TextDocument) + 2 * (size + 1) + (size / 4 + 1000) * sizeof(TextToken) + strlen(filename) + 1;
+}
+
+TextDocument* load_text_file(const char* filename) {
+    if (filename == NULL) {
+        fprintf(stderr, "Error: Invalid parameter - filename is NULL\n");
+        return NULL;
+    }
+    
+    return read_text_document(filename, true);
+}
+
+TextDocument* load_text_file_quiet(const char* filename) {
+    if (filename == NULL) {
+        return NULL;
+    }
+    
+    return read_text_document(filename, false);
+}
+
+TextDocument* load_text_buffer(const char* text, size_t size) {
+    if (text == NULL) {
+        return NULL;
+    }
+    
+    TextDocument* doc = (TextDocument*)calloc(1, sizeof(TextDocument));
     if (doc == NULL) {
-        return;
+        return NULL;
     }
     
-    // Free all tokens
-    if (doc->tokens != NULL) {
-        for (int i = 0; i < doc->token_count; i++) {
-            if (doc->tokens[i].word != NULL) {
-                free(doc->tokens[i].word);
+    // Tokens terminate originals in place, so work on a private copy
+    doc->text = (char*)malloc(size + 1);
+    if (doc->text == NULL) {
+        free(doc);
+        return NULL;
+    }
+    memcpy(doc->text, text, size);
+    doc->text[size] = '\0';
+    doc->text_size = size;
+    
+    if (!tokenize_document(doc, false)) {
+        free_text_document(doc);
+        return NULL;
+    }
+    
+    return doc;
+}
+
+/**
+ * State of the chunked tokenizer between buffer refills
+ */
+typedef struct StreamTokenizer {
+    char token[MAX_WORD_INPUT_LENGTH + 1];          ///< Original bytes of the current token
+    char normalized[MAX_WORD_INPUT_LENGTH + 1];     ///< Scratch buffer for normalization
+    size_t token_len;       ///< Bytes of the current token seen so far
+    size_t token_offset;    ///< Byte offset of the current token in the file
+    bool has_invalid_chars; ///< Current token contains control characters or malformed UTF-8
+    int token_line;         ///< Line where the current token started
+    int token_position;     ///< Position within that line where it started
+} StreamTokenizer;
+
+/**
+ * Finish the current token and hand it to the callback if it is a valid word
+ * @return false if the callback asked to stop
+ */
+static bool stream_flush_token(StreamTokenizer* tz, TokenCallback callback, void* user_data) {
+    size_t len = tz->token_len;
+    bool invalid = tz->has_invalid_chars;
+    tz->token_len = 0;
+    tz->has_invalid_chars = false;
+    
+    // Overlong tokens are rejected just like normalize_word() rejects them
+    if (len == 0 || invalid || len > MAX_WORD_INPUT_LENGTH) {
+        return true;
+    }
+    
+    tz->token[len] = '\0';
+    if (normalize_word_into(tz->token, len, tz->normalized, sizeof(tz->normalized)) == 0 ||
+        !is_valid_word(tz->normalized)) {
+        return true;
+    }
+    
+    TextToken token;
+    token.word = tz->normalized;
+    token.original_word = tz->token;
+    token.offset = tz->token_offset;
+    token.length = len;
+    token.line_number = tz->token_line;
+    token.position = tz->token_position;
+    
+    return callback(&token, user_data);
+}
+
+bool stream_text_file(const char* filename, TokenCallback callback, void* user_data) {
+    if (filename == NULL || callback == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - filename or callback is NULL\n");
+        return false;
+    }
+    
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Cannot open text file '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check that the file exists and you have read permissions\n");
+        return false;
+    }
+    
+    // Room for a sequence carried over from the end of the previous read
+    char* buffer = (char*)malloc(STREAM_CHUNK_SIZE + UTF8_MAX_SEQUENCE_LENGTH);
+    if (buffer == NULL) {
+        fclose(file);
+        return false;
+    }
+    
+    StreamTokenizer tz;
+    tz.token_len = 0;
+    tz.token_offset = 0;
+    tz.has_invalid_chars = false;
+    tz.token_line = 0;
+    tz.token_position = 0;
+    
+    int line_number = 1;
+    int position = 0;
+    size_t chunk_offset = 0;
+    size_t carry = 0;
+    bool at_eof = false;
+    bool keep_going = true;
+    
+    while (keep_going && !at_eof) {
+        size_t bytes_read = fread(buffer + carry, 1, STREAM_CHUNK_SIZE, file);
+        if (bytes_read == 0) {
+            // A sequence still carried over was cut short by the end of the file
+            at_eof = true;
+            if (carry == 0) {
+                break;
+            }
+        }
+        
+        size_t available = carry + bytes_read;
+        size_t i = 0;
+        while (i < available && keep_going) {
+            unsigned char c = (unsigned char)buffer[i];
+            uint32_t code_point = c;
+            size_t sequence = 1;
+            if (c >= 0x80) {
+                // Wait for the rest of a sequence split by the end of the buffer
+                if (!at_eof && utf8_sequence_length(c) > available - i) {
+                    break;
+                }
+                sequence = utf8_decode(buffer + i, available - i, &code_point);
+            }
+            
+            // Word boundaries: whitespace (including line breaks), punctuation and symbols
+            if (sequence > 0 && utf8_is_separator(code_point)) {
+                if (tz.token_len > 0) {
+                    keep_going = stream_flush_token(&tz, callback, user_data);
+                }
+                
+                if (c == '\n') {
+                    line_number++;
+                    position = 0;
+                } else {
+                    position += (int)sequence;
+                }
+                i += sequence;
+                continue;
+            }
+            
+            // Malformed bytes stay inside the word and mark it as corrupted
+            if (sequence == 0 || utf8_is_control(code_point)) {
+                tz.has_invalid_chars = true;
             }
-            if (doc->tokens[i].original_word != NULL) {
-                free(doc->tokens[i].original_word);
+            if (sequence == 0) {
+                sequence = 1;
             }
+            
+            if (tz.token_len == 0) {
+                tz.token_line = line_number;
+                tz.token_position = position;
+                tz.token_offset = chunk_offset + i;
+            }
+            
+            // Keep counting past the buffer so overlong tokens are recognized
+            for (size_t k = 0; k < sequence; k++) {
+                if (tz.token_len < MAX_WORD_INPUT_LENGTH) {
+                    tz.token[tz.token_len] = buffer[i + k];
+                }
+                tz.token_len++;
+            }
+            position += (int)sequence;
+            i += sequence;
         }
-        free(doc->tokens);
+        
+        chunk_offset += i;
+        carry = available - i;
+        memmove(buffer, buffer + i, carry);
     }
     
+    if (keep_going && tz.token_len > 0) {
+        stream_flush_token(&tz, callback, user_data);
+    }
+    
+    bool ok = true;
+    if (ferror(file)) {
+        fprintf(stderr, "Error: File read error occurred while processing '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check file integrity and disk space\n");
+        ok = false;
+    }
+    
+    free(buffer);
+    fclose(file);
+    return ok;
+}
+
+void free_text_document(TextDocument* doc) {
+    if (doc == NULL) {
+        return;
+    }
+    
+    memory_release(MEMORY_COMPONENT_DOCUMENTS, doc->memory_used);
+    
+    // Tokens only point into the text and words blocks
+    free(doc->tokens);
+    free(doc->words);
+    free(doc->text);
+    
     // Free filename
     if (doc->filename != NULL) {
         free(doc->filename);
@@ -414,4 +1415,145 @@ void free_text_document(TextDocument* doc) {
     
     // Free document structure
     free(doc);
-}
\ No newline at end of file
+}
+
+/**
+ * Append a copy of a path to a growing file list
+ * @return false on memory allocation failure
+ */
+static bool file_list_append(char*** files, int* count, int* capacity, const char* path) {
+    if (*count >= *capacity) {
+        int new_capacity = (*capacity == 0) ? 64 : *capacity * 2;
+        char** grown = (char**)realloc(*files, (size_t)new_capacity * sizeof(char*));
+        if (grown == NULL) {
+            return false;
+        }
+        *files = grown;
+        *capacity = new_capacity;
+    }
+    
+    char* copy = (char*)malloc(strlen(path) + 1);
+    if (copy == NULL) {
+        return false;
+    }
+    strcpy(copy, path);
+    (*files)[(*count)++] = copy;
+    return true;
+}
+
+/**
+ * Recursively append the regular files below a directory
+ * @return false if the directory cannot be read or memory runs out
+ */
+static bool list_directory(const char* directory, char*** files, int* count, int* capacity) {
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        return false;
+    }
+    
+    bool ok = true;
+    struct dirent* entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        
+        size_t length = strlen(directory) + strlen(entry->d_name) + 2;
+        char* path = (char*)malloc(length);
+        if (path == NULL) {
+            ok = false;
+            break;
+        }
+        snprintf(path, length, "%s/%s", directory, entry->d_name);
+        
+        struct stat info;
+        if (stat(path, &info) == 0) {
+            if (S_ISDIR(info.st_mode)) {
+                ok = list_directory(path, files, count, capacity);
+            } else if (S_ISREG(info.st_mode)) {
+                ok = file_list_append(files, count, capacity, path);
+            }
+        }
+        free(path);
+    }
+    
+    closedir(dir);
+    return ok;
+}
+
+/**
+ * qsort() comparator for an array of paths
+ */
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+char** list_batch_files(const char* path, int* count) {
+    if (path == NULL || count == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - path or count is NULL\n");
+        return NULL;
+    }
+    *count = 0;
+    
+    char** files = NULL;
+    int capacity = 0;
+    bool ok = true;
+    
+    struct stat info;
+    if (stat(path, &info) == 0 && S_ISDIR(info.st_mode)) {
+        ok = list_directory(path, &files, count, &capacity);
+        if (ok && *count > 1) {
+            qsort(files, (size_t)*count, sizeof(char*), compare_paths);
+        }
+    } else {
+        FILE* list = fopen(path, "r");
+        if (list == NULL) {
+            fprintf(stderr, "Error: Cannot open batch list '%s'\n", path);
+            fprintf(stderr, "Suggestion: Pass a directory or a file listing one document per line\n");
+            return NULL;
+        }
+        
+        char line[MAX_LINE_LENGTH];
+        while (ok && fgets(line, sizeof(line), list) != NULL) {
+            size_t start = 0;
+            size_t end = strlen(line);
+            while (start < end && isspace((unsigned char)line[start])) {
+                start++;
+            }
+            while (end > start && isspace((unsigned char)line[end - 1])) {
+                end--;
+            }
+            if (start == end) {
+                continue;
+            }
+            
+            line[end] = '\0';
+            ok = file_list_append(&files, count, &capacity, line + start);
+        }
+        fclose(list);
+    }
+    
+    if (!ok || *count == 0) {
+        if (!ok) {
+            fprintf(stderr, "Error: Failed to list the files of batch '%s'\n", path);
+        } else {
+            fprintf(stderr, "Error: No files to check in batch '%s'\n", path);
+        }
+        free_file_list(files, *count);
+        *count = 0;
+        return NULL;
+    }
+    
+    return files;
+}
+
+void free_file_list(char** files, int count) {
+    if (files == NULL) {
+        return;
+    }
+    
+    for (int i = 0; i < count; i++) {
+        free(files[i]);
+    }
+    free(files);
+}
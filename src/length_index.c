@@ -0,0 +1,234 @@
+#include "../include/length_index.h"
+#include "../include/edit_distance.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Candidates verified per call to edit_distance_batch_within()
+ */
+#define LENGTH_INDEX_VERIFY_BATCH 64
+
+struct LengthIndex {
+    char* word_storage;         // All words, NUL-terminated, shortest first and alphabetical within a length
+    uint32_t* word_offsets;     // Start of entry i in word_storage
+    int* word_frequencies;      // Frequency of entry i in the source Trie
+    uint32_t* signatures;       // Letter-presence signature of entry i
+    uint32_t bucket_start[TRIE_MAX_WORD_LENGTH + 2]; // Entries of length L are [bucket_start[L], bucket_start[L + 1])
+    int word_count;             // Number of indexed words
+    size_t memory_usage;        // Bytes allocated by the index
+};
+
+/**
+ * Number of set bits of a signature
+ */
+static inline int popcount32(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(value);
+#else
+    int count = 0;
+    while (value != 0) {
+        value &= value - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+uint32_t length_index_signature(const char* word, size_t length) {
+    uint32_t signature = 0;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)word[i];
+        if (c >= 'A' && c <= 'Z') {
+            c |= 0x20;
+        }
+        if (c >= 'a' && c <= 'z') {
+            signature |= 1u << (c - 'a');
+        } else if (c >= 0x80) {
+            signature |= 1u << (26 + (c & 0x3F) % 6);
+        }
+    }
+    return signature;
+}
+
+LengthIndex* length_index_build(Trie* trie) {
+    if (trie == NULL) {
+        return NULL;
+    }
+    
+    LengthIndex* index = (LengthIndex*)calloc(1, sizeof(LengthIndex));
+    if (index == NULL) {
+        return NULL;
+    }
+    index->memory_usage = sizeof(LengthIndex);
+    
+    char** words = NULL;
+    int count = 0;
+    trie_get_all_words(trie, &words, &count);
+    
+    // Count the words of each length; longer ones are out of reach of any query
+    uint32_t bucket_size[TRIE_MAX_WORD_LENGTH + 1] = { 0 };
+    size_t total = 0;
+    int indexed = 0;
+    for (int i = 0; i < count; i++) {
+        size_t len = strlen(words[i]);
+        if (len <= TRIE_MAX_WORD_LENGTH) {
+            bucket_size[len]++;
+            total += len + 1;
+            indexed++;
+        }
+    }
+    
+    index->word_storage = (char*)malloc(total > 0 ? total : 1);
+    index->word_offsets = (uint32_t*)malloc((indexed > 0 ? indexed : 1) * sizeof(uint32_t));
+    index->word_frequencies = (int*)malloc((indexed > 0 ? indexed : 1) * sizeof(int));
+    index->signatures = (uint32_t*)malloc((indexed > 0 ? indexed : 1) * sizeof(uint32_t));
+    bool ok = index->word_storage != NULL && index->word_offsets != NULL &&
+              index->word_frequencies != NULL && index->signatures != NULL && total <= UINT32_MAX;
+    
+    // Buckets in length order, with storage in the same order so a bucket scan reads it forward
+    uint32_t next[TRIE_MAX_WORD_LENGTH + 1];
+    size_t next_offset[TRIE_MAX_WORD_LENGTH + 1];
+    uint32_t start = 0;
+    size_t storage_start = 0;
+    for (int len = 0; len <= TRIE_MAX_WORD_LENGTH; len++) {
+        index->bucket_start[len] = start;
+        next[len] = start;
+        next_offset[len] = storage_start;
+        start += bucket_size[len];
+        storage_start += (size_t)bucket_size[len] * (size_t)(len + 1);
+    }
+    index->bucket_start[TRIE_MAX_WORD_LENGTH + 1] = start;
+    
+    // A stable placement keeps each bucket alphabetical
+    for (int i = 0; ok && i < count; i++) {
+        size_t len = strlen(words[i]);
+        if (len > TRIE_MAX_WORD_LENGTH) {
+            continue;
+        }
+        uint32_t entry = next[len]++;
+        size_t offset = next_offset[len];
+        next_offset[len] += len + 1;
+        memcpy(index->word_storage + offset, words[i], len + 1);
+        index->word_offsets[entry] = (uint32_t)offset;
+        index->word_frequencies[entry] = trie_get_frequency(trie, words[i]);
+        index->signatures[entry] = length_index_signature(words[i], len);
+    }
+    
+    for (int i = 0; i < count; i++) {
+        free(words[i]);
+    }
+    free(words);
+    
+    if (!ok) {
+        length_index_destroy(index);
+        return NULL;
+    }
+    
+    index->word_count = indexed;
+    index->memory_usage += total + (size_t)indexed * (2 * sizeof(uint32_t) + sizeof(int));
+    return index;
+}
+
+/**
+ * Insert a verified candidate into the sorted match buffer
+ * @param matches Match buffer, sorted by distance and then alphabetically
+ * @param match_count Number of matches held
+ * @param max_matches Capacity of the buffer
+ * @param candidate Candidate word
+ * @param distance Its edit distance from the query
+ * @param frequency Its frequency
+ * @return New number of matches held
+ */
+static int add_match(TrieMatch* matches, int match_count, int max_matches, const char* candidate,
+                     int distance, int frequency) {
+    // Buckets are scanned by length, so ties are ordered here rather than by discovery
+    int pos = match_count;
+    while (pos > 0 && (matches[pos - 1].distance > distance ||
+                       (matches[pos - 1].distance == distance && strcmp(matches[pos - 1].word, candidate) > 0))) {
+        pos--;
+    }
+    if (pos >= max_matches) {
+        return match_count;
+    }
+    
+    int last = (match_count < max_matches) ? match_count : max_matches - 1;
+    for (int k = last; k > pos; k--) {
+        matches[k] = matches[k - 1];
+    }
+    memcpy(matches[pos].word, candidate, strlen(candidate) + 1);
+    matches[pos].distance = distance;
+    matches[pos].frequency = frequency;
+    
+    return (match_count < max_matches) ? match_count + 1 : match_count;
+}
+
+int length_index_lookup(const LengthIndex* index, const char* word, int max_distance,
+                        TrieMatch* matches, int max_matches) {
+    if (index == NULL || word == NULL || matches == NULL || max_matches <= 0 || max_distance < 0) {
+        return 0;
+    }
+    
+    size_t query_len = strlen(word);
+    if (query_len == 0 || query_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    // Buckets are consecutive, so the lengths within reach form one range of entries
+    size_t shortest = (query_len > (size_t)max_distance) ? query_len - (size_t)max_distance : 0;
+    size_t longest = query_len + (size_t)max_distance;
+    if (longest > TRIE_MAX_WORD_LENGTH) {
+        longest = TRIE_MAX_WORD_LENGTH;
+    }
+    uint32_t first = index->bucket_start[shortest];
+    uint32_t end = index->bucket_start[longest + 1];
+    
+    uint32_t query_signature = length_index_signature(word, query_len);
+    int match_count = 0;
+    const char* batch[LENGTH_INDEX_VERIFY_BATCH];
+    uint32_t batch_entries[LENGTH_INDEX_VERIFY_BATCH];
+    int distances[LENGTH_INDEX_VERIFY_BATCH];
+    uint32_t entry = first;
+    
+    while (entry < end) {
+        // Gather the next candidates whose signatures are close enough
+        int batch_count = 0;
+        for (; entry < end && batch_count < LENGTH_INDEX_VERIFY_BATCH; entry++) {
+            uint32_t signature = index->signatures[entry];
+            if (popcount32(signature & ~query_signature) > max_distance ||
+                popcount32(query_signature & ~signature) > max_distance) {
+                continue;
+            }
+            batch[batch_count] = index->word_storage + index->word_offsets[entry];
+            batch_entries[batch_count] = entry;
+            batch_count++;
+        }
+        
+        edit_distance_batch_within(word, batch, batch_count, max_distance, distances);
+        
+        for (int i = 0; i < batch_count; i++) {
+            if (distances[i] >= 0) {
+                match_count = add_match(matches, match_count, max_matches, batch[i], distances[i],
+                                        index->word_frequencies[batch_entries[i]]);
+            }
+        }
+    }
+    
+    return match_count;
+}
+
+size_t length_index_get_memory_usage(const LengthIndex* index) {
+    return (index != NULL) ? index->memory_usage : 0;
+}
+
+void length_index_destroy(LengthIndex* index) {
+    if (index == NULL) {
+        return;
+    }
+    
+    free(index->word_storage);
+    free(index->word_offsets);
+    free(index->word_frequencies);
+    free(index->signatures);
+    free(index);
+}
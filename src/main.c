@@ -1,11 +1,38 @@
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <time.h>
 #include "../include/trie.h"
+#include "../include/dawg.h"
 #include "../include/file_io.h"
 #include "../include/spell_check.h"
 #include "../include/api_client.h"
+#include "../include/dictionary_handle.h"
+#include "../include/server.h"
+#include "../include/profile.h"
+#include "../include/timing.h"
+#include "../include/output_writer.h"
+#include "../include/memory_budget.h"
+#include "../include/ngram_model.h"
+
+// Progress and status lines are left out when only the report is wanted
+static bool g_quiet = false;
+
+/**
+ * Print a progress or status line unless quiet
+ */
+static void print_status(const char* format, ...) {
+    if (g_quiet) {
+        return;
+    }
+    
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
 
 /**
  * Display usage information
@@ -13,24 +40,56 @@
 void print_usage(const char* program_name) {
     printf("Advanced Spell Checker with API Integration\n");
     printf("Usage: %s [OPTIONS] <dictionary_file> <input_file>\n", program_name);
+    printf("       %s --compile-dict <output_file> <dictionary_file>\n", program_name);
+    printf("       %s --serve <port> [options] <dictionary_file>\n", program_name);
+    printf("       %s --batch <list_or_dir> [options] <dictionary_file>\n", program_name);
     printf("\nArguments:\n");
-    printf("  dictionary_file  Path to dictionary file (one word per line)\n");
+    printf("  dictionary_file  Path to dictionary file (one word per line, or compiled)\n");
     printf("  input_file       Path to text file to spell check\n");
     printf("\nOptions:\n");
     printf("  --api-key KEY    Enable Merriam-Webster API with your API key\n");
     printf("  --api-stats      Show API statistics after spell checking\n");
+    printf("  --api-cache FILE Remember API answers across runs in FILE\n");
+    printf("  --api-concurrency N  Send up to N API requests at once (default 8)\n");
+    printf("  --api-rate N     Start at most N API requests per second (default unlimited)\n");
+    printf("  --compact        Freeze the dictionary into the compact read-only layout\n");
+    printf("  --dawg           Minimize the dictionary into an automaton sharing prefixes and suffixes\n");
+    printf("  --compile-dict FILE  Compile the dictionary into a binary file and exit\n");
+    printf("  --threads N      Load the dictionary and check the documents with N threads (default 1)\n");
+    printf("  --stream         Check the input incrementally and print errors as found\n");
+    printf("  --batch PATH     Check every file of a directory, or listed in a file, in one run\n");
+    printf("  --engine NAME    Suggestion engine: trie (default), symspell or scan\n");
+    printf("  --profile        Report per-stage timings and work counters\n");
+    printf("  --format NAME    Report format: text (default), jsonl, csv or binary\n");
+    printf("  --output FILE    Write the report to FILE instead of standard output\n");
+    printf("  --quiet          Print only the report, without progress or per-word API lines\n");
+    printf("  --memory-limit COMPONENT=SIZE  Budget documents, results or caches, e.g. documents=64M (repeatable)\n");
+    printf("  --memory-report  Report live and peak memory of each component\n");
+    printf("  --context MODEL  Also flag dictionary words unlikely in their context (compiled model or training text);\n");
+    printf("                   not with --stream\n");
+    printf("  --compile-context FILE  Count the n-grams of a training text into FILE and exit\n");
+    printf("  --serve PORT     Keep the dictionary loaded and serve JSON checks over HTTP\n");
+    printf("  --bind ADDR      Address to serve on (default 127.0.0.1)\n");
+    printf("  --reload-interval N  Reload the served dictionary when it changes, checking every N seconds (default 5)\n");
     printf("  -h, --help       Show this help message\n");
     printf("\nExamples:\n");
     printf("  %s dict.txt input.txt\n", program_name);
     printf("  %s --api-key YOUR_KEY dict.txt input.txt\n", program_name);
+    printf("  %s --compile-dict dict.bin dict.txt && %s dict.bin input.txt\n", program_name, program_name);
+    printf("  %s --serve 8080 --threads 8 dict.txt\n", program_name);
+    printf("  %s --batch docs/ --threads 4 dict.txt\n", program_name);
+    printf("  %s --format jsonl --output report.jsonl dict.txt input.txt\n", program_name);
+    printf("  %s --memory-limit documents=64M --memory-report dict.txt big.txt\n", program_name);
+    printf("  %s --compile-context news.ngm news.txt && %s --context news.ngm dict.txt input.txt\n",
+           program_name, program_name);
 }
 
 /**
- * Load dictionary and show progress
+ * Load dictionary (in parallel for thread_count > 1) and show progress
  */
-bool load_dictionary_with_progress(const char* filename, Trie* trie) {
-    if (load_dictionary(filename, trie)) {
-        printf("Dictionary loaded: %d words\n", trie->total_words);
+bool load_dictionary_with_progress(const char* filename, Trie* trie, int thread_count) {
+    if (load_dictionary_parallel(filename, trie, thread_count)) {
+        print_status("Dictionary loaded: %d words\n", trie->total_words);
         return true;
     } else {
         printf("Error: Cannot open dictionary file '%s'\n", filename);
@@ -38,6 +97,26 @@ bool load_dictionary_with_progress(const char* filename, Trie* trie) {
     }
 }
 
+/**
+ * Print one numbered error with its suggestions
+ */
+void print_error(int number, const SpellError* error) {
+    printf("%d. Line %d: '%s' (original: '%s')%s\n", 
+           number, error->line_number, error->misspelled_word, error->original_word,
+           error->context_error ? " - unlikely in this context" : "");
+    
+    if (error->suggestion_count > 0) {
+        printf("   Suggestions: ");
+        for (int j = 0; j < error->suggestion_count; j++) {
+            printf("%s", error->suggestions[j]);
+            if (j < error->suggestion_count - 1) printf(", ");
+        }
+        printf("\n");
+    } else {
+        printf("   No suggestions available\n");
+    }
+}
+
 /**
  * Print spell check results
  */
@@ -58,20 +137,7 @@ void print_results(SpellCheckResult* result) {
     
     printf("\nErrors:\n");
     for (int i = 0; i < result->error_count; i++) {
-        SpellError* error = &result->errors[i];
-        printf("%d. Line %d: '%s' (original: '%s')\n", 
-               i + 1, error->line_number, error->misspelled_word, error->original_word);
-        
-        if (error->suggestion_count > 0) {
-            printf("   Suggestions: ");
-            for (int j = 0; j < error->suggestion_count; j++) {
-                printf("%s", error->suggestions[j]);
-                if (j < error->suggestion_count - 1) printf(", ");
-            }
-            printf("\n");
-        } else {
-            printf("   No suggestions available\n");
-        }
+        print_error(i + 1, &result->errors[i]);
     }
     
     // Calculate accuracy
@@ -82,6 +148,177 @@ void print_results(SpellCheckResult* result) {
     printf("\nAccuracy: %.1f%%\n", accuracy);
 }
 
+/**
+ * Print one error as soon as the streaming checker reports it
+ */
+bool print_stream_error(const SpellError* error, void* user_data) {
+    int* error_number = (int*)user_data;
+    (*error_number)++;
+    print_error(*error_number, error);
+    return true;
+}
+
+/**
+ * Print the counts of a spell check without its errors
+ */
+void print_check_summary(const SpellCheckResult* summary) {
+    printf("\n=== SPELL CHECK SUMMARY ===\n");
+    printf("Total words checked: %d\n", summary->total_words_checked);
+    printf("Errors found: %d\n", summary->error_count);
+    
+    if (summary->error_count == 0) {
+        printf("No spelling errors found!\n");
+        return;
+    }
+    
+    double accuracy = 100.0;
+    if (summary->total_words_checked > 0) {
+        accuracy = 100.0 - ((double)summary->error_count / summary->total_words_checked * 100.0);
+    }
+    printf("\nAccuracy: %.1f%%\n", accuracy);
+}
+
+/**
+ * Print one document of a batch, in input order
+ */
+bool print_batch_document(const SpellCheckBatchItem* item, void* user_data) {
+    (void)user_data;
+    
+    printf("\n=== %s ===\n", item->filename);
+    if (!item->result) {
+        printf("Error: Failed to process input file '%s'\n", item->filename);
+        return true;
+    }
+    
+    const SpellCheckResult* result = item->result;
+    printf("Words checked: %d, errors: %d (%d tokens, %zu bytes, loaded in %.1f ms, checked in %.1f ms)\n",
+           result->total_words_checked, result->error_count, item->token_count, item->bytes,
+           item->load_seconds * 1000.0, result->processing_time * 1000.0);
+    for (int i = 0; i < result->error_count; i++) {
+        print_error(i + 1, &result->errors[i]);
+    }
+    return true;
+}
+
+/**
+ * Print the totals of a batch spell check
+ */
+void print_batch_summary(const SpellCheckBatchSummary* summary) {
+    printf("\n=== BATCH SUMMARY ===\n");
+    printf("Documents checked: %d\n", summary->documents_checked);
+    if (summary->documents_failed > 0) {
+        printf("Documents failed: %d\n", summary->documents_failed);
+    }
+    printf("Total words checked: %d\n", summary->total_words_checked);
+    printf("Errors found: %d\n", summary->total_errors);
+    printf("Elapsed: %.1f ms", summary->elapsed_seconds * 1000.0);
+    if (summary->elapsed_seconds > 0) {
+        printf(" (%.1f documents/s)", summary->documents_checked / summary->elapsed_seconds);
+    }
+    printf("\n");
+    printf("Tasks: %d run, %d stolen\n", summary->tasks_run, summary->tasks_stolen);
+}
+
+/**
+ * Destination of the errors of a streaming check in a structured format
+ */
+typedef struct StreamReport {
+    OutputWriter* writer;       // Report writer
+    const char* document;       // Name of the checked file
+} StreamReport;
+
+/**
+ * Write one error as soon as the streaming checker reports it
+ */
+bool write_stream_error(const SpellError* error, void* user_data) {
+    StreamReport* report = (StreamReport*)user_data;
+    return output_writer_write_error(report->writer, report->document, error);
+}
+
+/**
+ * Write one document of a batch, in input order
+ */
+bool write_batch_document(const SpellCheckBatchItem* item, void* user_data) {
+    return output_writer_write_result((OutputWriter*)user_data, item->filename, item->result);
+}
+
+/**
+ * Print the per-stage profile of a spell check (--profile)
+ */
+void print_profile(const SpellCheckResult* result, double load_seconds) {
+    const SpellCheckProfile* profile = &result->profile;
+    
+    printf("\n=== PROFILE ===\n");
+    printf("Dictionary load:    %10.3f ms\n", load_seconds * 1000.0);
+    printf("Tokenization:       %10.3f ms\n", profile->tokenize_seconds * 1000.0);
+    printf("Dictionary lookup:  %10.3f ms\n", profile->lookup_seconds * 1000.0);
+    printf("Suggestions:        %10.3f ms", profile->suggestion_seconds * 1000.0);
+    if (profile->suggestion_calls > 0) {
+        printf(" (%d misspellings, %.1f us each)", profile->suggestion_calls,
+               profile->suggestion_seconds * 1e6 / profile->suggestion_calls);
+    }
+    printf("\n");
+    printf("API validation:     %10.3f ms\n", profile->api_seconds * 1000.0);
+    printf("Context check:      %10.3f ms\n", profile->context_seconds * 1000.0);
+    printf("Spell check total:  %10.3f ms (wall clock)\n", result->processing_time * 1000.0);
+    printf("Trie nodes visited: %10llu\n", profile->trie_nodes_visited);
+    printf("DP cells computed:  %10llu\n", profile->dp_cells);
+    printf("Allocations:        %10llu (%llu bytes)\n", profile->allocations, profile->allocated_bytes);
+    printf("Word cache:         %10d hits, %d misses\n", result->cache_hits, result->cache_misses);
+    printf("Result memory:      %10zu bytes\n", result->memory_used);
+}
+
+/**
+ * Print the live and peak bytes of each component (--memory-report)
+ */
+void print_memory_report(void) {
+    printf("\n=== MEMORY ===\n");
+    printf("%-12s %14s %14s %14s\n", "Component", "Live bytes", "Peak bytes", "Limit");
+    for (int c = 0; c < MEMORY_COMPONENT_COUNT; c++) {
+        MemoryComponent component = (MemoryComponent)c;
+        printf("%-12s %14zu %14zu ", memory_component_name(component), memory_get_live(component),
+               memory_get_peak(component));
+        if (memory_get_limit(component) > 0) {
+            printf("%14zu\n", memory_get_limit(component));
+        } else {
+            printf("%14s\n", "none");
+        }
+    }
+    printf("%-12s %14zu %14zu\n", "total", memory_get_total_live(), memory_get_total_peak());
+}
+
+/**
+ * Parse a --memory-limit COMPONENT=SIZE argument and set the budget
+ */
+bool parse_memory_limit(const char* argument) {
+    const char* equals = strchr(argument, '=');
+    size_t bytes = 0;
+    if (!equals || !memory_parse_size(equals + 1, &bytes)) {
+        return false;
+    }
+    
+    size_t name_length = (size_t)(equals - argument);
+    for (int c = 0; c < MEMORY_COMPONENT_COUNT; c++) {
+        const char* name = memory_component_name((MemoryComponent)c);
+        if (strlen(name) == name_length && strncmp(argument, name, name_length) == 0) {
+            return memory_set_limit((MemoryComponent)c, bytes);
+        }
+    }
+    return false;
+}
+
+/**
+ * Map a compiled context model, or count one from a training text (--context)
+ */
+NgramModel* load_context_model(const char* path) {
+    if (ngram_model_is_compiled(path)) {
+        return ngram_model_load(path);
+    }
+    
+    print_status("Counting n-grams of '%s'...\n", path);
+    return ngram_model_build(path);
+}
+
 /**
  * Main function
  */
@@ -89,6 +326,26 @@ int main(int argc, char* argv[]) {
     // Parse command line arguments
     const char* api_key = NULL;
     bool show_api_stats = false;
+    const char* api_cache_file = NULL;
+    int api_concurrency = 8;
+    int api_rate = 0;
+    bool use_compact = false;
+    bool use_dawg = false;
+    const char* compile_output = NULL;
+    const char* context_path = NULL;
+    const char* compile_context_output = NULL;
+    int thread_count = 1;
+    bool threads_given = false;
+    bool use_stream = false;
+    const char* batch_path = NULL;
+    bool show_profile = false;
+    bool show_memory = false;
+    SuggestionEngine engine = SUGGESTION_ENGINE_TRIE;
+    OutputFormat output_format = OUTPUT_FORMAT_TEXT;
+    const char* output_file = NULL;
+    int serve_port = 0;
+    const char* bind_address = "127.0.0.1";
+    int reload_interval = 5;
     const char* dictionary_file = NULL;
     const char* input_file = NULL;
     
@@ -97,6 +354,86 @@ int main(int argc, char* argv[]) {
             api_key = argv[++i];
         } else if (strcmp(argv[i], "--api-stats") == 0) {
             show_api_stats = true;
+        } else if (strcmp(argv[i], "--api-cache") == 0 && i + 1 < argc) {
+            api_cache_file = argv[++i];
+        } else if (strcmp(argv[i], "--api-concurrency") == 0 && i + 1 < argc) {
+            api_concurrency = atoi(argv[++i]);
+            if (api_concurrency < 1) {
+                fprintf(stderr, "Error: --api-concurrency expects a positive number\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--api-rate") == 0 && i + 1 < argc) {
+            api_rate = atoi(argv[++i]);
+            if (api_rate < 0) {
+                fprintf(stderr, "Error: --api-rate expects a non-negative number\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            use_compact = true;
+        } else if (strcmp(argv[i], "--dawg") == 0) {
+            use_dawg = true;
+        } else if (strcmp(argv[i], "--compile-dict") == 0 && i + 1 < argc) {
+            compile_output = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = atoi(argv[++i]);
+            if (thread_count < 1) {
+                fprintf(stderr, "Error: --threads expects a positive number\n");
+                return 1;
+            }
+            threads_given = true;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            use_stream = true;
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_path = argv[++i];
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            show_profile = true;
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcmp(name, "trie") == 0) {
+                engine = SUGGESTION_ENGINE_TRIE;
+            } else if (strcmp(name, "symspell") == 0) {
+                engine = SUGGESTION_ENGINE_SYMSPELL;
+            } else if (strcmp(name, "scan") == 0) {
+                engine = SUGGESTION_ENGINE_SCAN;
+            } else {
+                fprintf(stderr, "Error: Unknown suggestion engine '%s' (use trie, symspell or scan)\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!output_format_parse(name, &output_format)) {
+                fprintf(stderr, "Error: Unknown report format '%s' (use text, jsonl, csv or binary)\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            g_quiet = true;
+        } else if (strcmp(argv[i], "--memory-limit") == 0 && i + 1 < argc) {
+            if (!parse_memory_limit(argv[++i])) {
+                fprintf(stderr, "Error: --memory-limit expects COMPONENT=SIZE with COMPONENT documents, results or caches, e.g. documents=64M\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--memory-report") == 0) {
+            show_memory = true;
+        } else if (strcmp(argv[i], "--context") == 0 && i + 1 < argc) {
+            context_path = argv[++i];
+        } else if (strcmp(argv[i], "--compile-context") == 0 && i + 1 < argc) {
+            compile_context_output = argv[++i];
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            serve_port = atoi(argv[++i]);
+            if (serve_port < 1 || serve_port > 65535) {
+                fprintf(stderr, "Error: --serve expects a port number (1-65535)\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--bind") == 0 && i + 1 < argc) {
+            bind_address = argv[++i];
+        } else if (strcmp(argv[i], "--reload-interval") == 0 && i + 1 < argc) {
+            reload_interval = atoi(argv[++i]);
+            if (reload_interval < 1) {
+                fprintf(stderr, "Error: --reload-interval expects a positive number of seconds\n");
+                return 1;
+            }
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -107,82 +444,396 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    // Validate required arguments
-    if (!dictionary_file || !input_file) {
+    // Compile mode only needs the dictionary
+    if (compile_output) {
+        if (!dictionary_file) {
+            fprintf(stderr, "Error: Missing dictionary file to compile\n\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+        
+        Trie* dictionary = trie_create();
+        if (!dictionary) {
+            printf("Error: Failed to create dictionary\n");
+            return 1;
+        }
+        
+        bool compiled = load_dictionary_with_progress(dictionary_file, dictionary, thread_count) &&
+                        compile_dictionary(dictionary, compile_output);
+        trie_destroy(dictionary);
+        return compiled ? 0 : 1;
+    }
+    
+    // Compiling a context model only needs the training text
+    if (compile_context_output) {
+        if (!dictionary_file) {
+            fprintf(stderr, "Error: Missing training text to compile\n\n");
+            print_usage(argv[0]);
+            return 1;
+        }
+        
+        NgramModel* model = ngram_model_build(dictionary_file);
+        bool compiled = model && ngram_model_save(model, compile_context_output);
+        if (compiled) {
+            printf("Compiled %zu n-grams into '%s' (%zu bytes)\n", ngram_model_get_entry_count(model),
+                   compile_context_output, ngram_model_get_file_size(model));
+        }
+        ngram_model_destroy(model);
+        return compiled ? 0 : 1;
+    }
+    
+    // Validate required arguments (serve and batch modes take no input file)
+    if (!dictionary_file || (!input_file && !serve_port && !batch_path)) {
         fprintf(stderr, "Error: Missing required arguments\n\n");
         print_usage(argv[0]);
         return 1;
     }
+    if (batch_path && (use_stream || serve_port || input_file)) {
+        fprintf(stderr, "Error: --batch takes only a dictionary file and cannot be combined with --stream or --serve\n\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (context_path && use_stream) {
+        fprintf(stderr, "Error: --context cannot be combined with --stream, which does not see the words after a token\n\n");
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (output_file && output_format == OUTPUT_FORMAT_TEXT) {
+        fprintf(stderr, "Error: --output needs --format jsonl, csv or binary\n\n");
+        print_usage(argv[0]);
+        return 1;
+    }
     
-    printf("🔍 Advanced Spell Checker Starting...\n");
-    printf("Dictionary: %s\n", dictionary_file);
-    printf("Input file: %s\n", input_file);
+    // A structured report on standard output must be the only thing written there
+    bool report_to_stdout = output_format != OUTPUT_FORMAT_TEXT && (!output_file || strcmp(output_file, "-") == 0);
+    if (report_to_stdout && !serve_port) {
+        g_quiet = true;
+    }
+    set_spell_check_quiet(g_quiet);
+    if (report_to_stdout && (show_profile || show_api_stats || show_memory)) {
+        fprintf(stderr, "⚠️  --profile, --api-stats and --memory-report are not printed with a report on standard output\n");
+        show_profile = false;
+        show_api_stats = false;
+        show_memory = false;
+    }
+    
+    print_status("🔍 Advanced Spell Checker Starting...\n");
+    print_status("Dictionary: %s\n", dictionary_file);
+    if (input_file) {
+        print_status("Input file: %s\n", input_file);
+    }
+    if (batch_path) {
+        print_status("Batch: %s\n", batch_path);
+    }
     
     // Initialize API if key provided
     if (api_key) {
-        printf("API Key: %s\n", api_key);
+        print_status("API Key: %s\n", api_key);
         if (api_client_init(api_key)) {
-            printf("✅ Merriam-Webster API enabled\n");
+            print_status("✅ Merriam-Webster API enabled\n");
+            api_client_set_batch_limits(api_concurrency, api_rate);
+            if (api_cache_file && !api_client_set_cache_file(api_cache_file)) {
+                fprintf(stderr, "⚠️  Failed to open API cache '%s', caching in memory only\n", api_cache_file);
+            }
         } else {
             fprintf(stderr, "⚠️  Failed to initialize API, continuing with local dictionary only\n");
         }
     } else {
-        printf("ℹ️  API not enabled (use --api-key to enable)\n");
+        print_status("ℹ️  API not enabled (use --api-key to enable)\n");
+    }
+    print_status("\n");
+    
+    // Counters and stage timers only record when asked for
+    profile_set_enabled(show_profile);
+    
+    // The context model is independent of the dictionary, so serve mode uses it too
+    NgramModel* context_model = NULL;
+    if (context_path) {
+        context_model = load_context_model(context_path);
+        if (!context_model) {
+            fprintf(stderr, "Error: Failed to load context model '%s'\n", context_path);
+            if (is_api_initialized()) {
+                api_client_cleanup();
+            }
+            return 1;
+        }
+        print_status("Context model: %zu n-grams, %zu bytes\n", ngram_model_get_entry_count(context_model),
+                     ngram_model_get_memory_usage(context_model));
+        set_context_model(context_model);
+    }
+    
+    // Serve mode loads the dictionary once and keeps it for every request
+    if (serve_port) {
+        if (engine != SUGGESTION_ENGINE_TRIE) {
+            fprintf(stderr, "⚠️  The %s index does not follow dictionary reloads, serving with trie search\n",
+                    engine == SUGGESTION_ENGINE_SYMSPELL ? "symspell" : "scan");
+        }
+        
+        DictionaryHandle* handle = dictionary_handle_open(dictionary_file);
+        if (!handle) {
+            printf("Error: Cannot open dictionary file '%s'\n", dictionary_file);
+            ngram_model_destroy(context_model);
+            if (is_api_initialized()) {
+                api_client_cleanup();
+            }
+            return 1;
+        }
+        dictionary_handle_start_watcher(handle, reload_interval * 1000);
+        
+        ServerConfig config;
+        config.bind_address = bind_address;
+        config.port = serve_port;
+        config.thread_count = threads_given ? thread_count : 4;
+        config.dictionary = handle;
+        bool served = server_run(&config);
+        
+        dictionary_handle_close(handle);
+        ngram_model_destroy(context_model);
+        if (is_api_initialized()) {
+            api_client_cleanup();
+        }
+        return served ? 0 : 1;
     }
-    printf("\n");
     
     // Create and load dictionary
     Trie* dictionary = trie_create();
     if (!dictionary) {
         printf("Error: Failed to create dictionary\n");
+        ngram_model_destroy(context_model);
         return 1;
     }
     
-    if (!load_dictionary_with_progress(dictionary_file, dictionary)) {
+    double load_started = timing_now_seconds();
+    if (!load_dictionary_with_progress(dictionary_file, dictionary, thread_count)) {
         trie_destroy(dictionary);
+        ngram_model_destroy(context_model);
         return 1;
     }
+    double load_seconds = timing_now_seconds() - load_started;
+    
+    // Optionally switch to the compact read-only layout
+    if (use_compact) {
+        size_t pointer_bytes = trie_get_memory_usage(dictionary);
+        if (trie_freeze(dictionary)) {
+            print_status("Dictionary frozen: %zu bytes -> %zu bytes\n",
+                         pointer_bytes, trie_get_memory_usage(dictionary));
+        } else {
+            fprintf(stderr, "⚠️  Failed to build compact dictionary, using pointer trie\n");
+        }
+    }
+    
+    // Optionally merge common suffixes too
+    if (use_dawg) {
+        size_t tree_bytes = trie_get_memory_usage(dictionary);
+        if (trie_minimize(dictionary)) {
+            print_status("Dictionary minimized: %zu bytes -> %zu bytes (%u states, %u edges)\n",
+                         tree_bytes, trie_get_memory_usage(dictionary),
+                         (unsigned)dictionary->dawg->state_count, (unsigned)dictionary->dawg->edge_count);
+        } else {
+            fprintf(stderr, "⚠️  Failed to build minimized dictionary, keeping the trie\n");
+        }
+    }
+    
+    // Build the suggestion index once the dictionary is final
+    if (engine != SUGGESTION_ENGINE_TRIE) {
+        clock_t start = clock();
+        if (set_suggestion_engine(engine, dictionary)) {
+            print_status("Suggestion index built: %zu bytes in %.0f ms\n", get_suggestion_engine_memory(),
+                         (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+        } else {
+            fprintf(stderr, "⚠️  Failed to build suggestion index, using trie search\n");
+        }
+    }
+    
+    // Structured reports are written as the documents are checked
+    OutputWriter* writer = NULL;
+    if (output_format != OUTPUT_FORMAT_TEXT && !serve_port) {
+        writer = output_writer_open(output_file, output_format);
+        if (!writer) {
+            set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+            trie_destroy(dictionary);
+            ngram_model_destroy(context_model);
+            return 1;
+        }
+    }
+    
+    // Batch mode checks every document against the dictionary loaded once
+    if (batch_path) {
+        int file_count = 0;
+        char** files = list_batch_files(batch_path, &file_count);
+        SpellCheckBatchSummary summary;
+        SpellBatchCallback callback = writer ? write_batch_document : print_batch_document;
+        bool checked = files && spell_check_batch((const char* const*)files, file_count, dictionary, thread_count,
+                                                  callback, writer, &summary);
+        if (!output_writer_close(writer)) {
+            fprintf(stderr, "Error: Failed to write the report\n");
+            checked = false;
+        }
+        if (checked) {
+            if (!writer || !g_quiet) {
+                print_batch_summary(&summary);
+            }
+            if (show_api_stats && is_api_initialized()) {
+                print_api_stats();
+            }
+            if (show_memory) {
+                print_memory_report();
+            }
+        } else if (files) {
+            printf("Error: Batch spell check failed\n");
+        }
+        
+        free_file_list(files, file_count);
+        set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+        trie_destroy(dictionary);
+        ngram_model_destroy(context_model);
+        if (is_api_initialized()) {
+            api_client_cleanup();
+        }
+        
+        if (!checked || summary.documents_failed > 0) {
+            return 1;
+        }
+        print_status("\n✅ Spell check complete!\n");
+        return 0;
+    }
+    
+    // A document too large for its budget is checked in streaming mode instead
+    if (!use_stream && memory_would_exceed(MEMORY_COMPONENT_DOCUMENTS, estimate_text_file_memory(input_file))) {
+        fprintf(stderr, "⚠️  '%s' would exceed the documents memory budget, checking it in streaming mode\n",
+                input_file);
+        if (context_model) {
+            fprintf(stderr, "⚠️  Streaming mode has no context check, only spelling errors will be reported\n");
+        }
+        use_stream = true;
+    }
+    
+    // Streaming mode never holds the whole document in memory
+    if (use_stream) {
+        print_status("Streaming spell check...\n");
+        if (!writer) {
+            printf("\nErrors:\n");
+        }
+        
+        int error_number = 0;
+        StreamReport report = { writer, input_file };
+        SpellCheckResult summary;
+        bool checked = writer ? spell_check_stream(input_file, dictionary, write_stream_error, &report, &summary)
+                              : spell_check_stream(input_file, dictionary, print_stream_error, &error_number, &summary);
+        if (checked && writer) {
+            output_writer_write_summary(writer, input_file, &summary);
+        }
+        if (!output_writer_close(writer)) {
+            fprintf(stderr, "Error: Failed to write the report\n");
+            set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+            trie_destroy(dictionary);
+            ngram_model_destroy(context_model);
+            return 1;
+        }
+        if (!checked) {
+            printf("Error: Failed to process input file '%s'\n", input_file);
+            set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+            trie_destroy(dictionary);
+            ngram_model_destroy(context_model);
+            return 1;
+        }
+        
+        if (!writer || !g_quiet) {
+            print_check_summary(&summary);
+        }
+        if (show_profile) {
+            print_profile(&summary, load_seconds);
+        }
+        
+        if (show_api_stats && is_api_initialized()) {
+            print_api_stats();
+        }
+        if (show_memory) {
+            print_memory_report();
+        }
+        
+        set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
+        trie_destroy(dictionary);
+        ngram_model_destroy(context_model);
+        if (is_api_initialized()) {
+            api_client_cleanup();
+        }
+        
+        print_status("\n✅ Spell check complete!\n");
+        return 0;
+    }
     
     // Load and process input file
-    printf("Loading input file...\n");
+    print_status("Loading input file...\n");
     TextDocument* document = load_text_file(input_file);
     if (!document) {
         printf("Error: Failed to load input file '%s'\n", input_file);
+        output_writer_write_summary(writer, input_file, NULL);
+        output_writer_close(writer);
+        set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
         trie_destroy(dictionary);
+        ngram_model_destroy(context_model);
         return 1;
     }
     
-    printf("Input file loaded: %d tokens, %d words\n", 
-           document->token_count, document->total_words);
+    print_status("Input file loaded: %d tokens, %d words\n", 
+                 document->token_count, document->total_words);
     
     // Perform spell checking
-    printf("Performing spell check...\n");
-    SpellCheckResult* result = spell_check_document(document, dictionary);
+    print_status("Performing spell check...\n");
+    SpellCheckResult* result = spell_check_document_parallel(document, dictionary, thread_count);
     if (!result) {
         printf("Error: Spell checking failed\n");
+        output_writer_write_summary(writer, input_file, NULL);
+        output_writer_close(writer);
         free_text_document(document);
+        set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
         trie_destroy(dictionary);
+        ngram_model_destroy(context_model);
         return 1;
     }
     
     // Display results
-    print_results(result);
+    bool reported = true;
+    if (writer) {
+        output_writer_write_result(writer, input_file, result);
+        reported = output_writer_close(writer);
+        if (!reported) {
+            fprintf(stderr, "Error: Failed to write the report\n");
+        } else if (!g_quiet) {
+            print_check_summary(result);
+        }
+    } else {
+        print_results(result);
+    }
+    if (show_profile) {
+        print_profile(result, load_seconds);
+    }
     
     // Show API statistics if requested
     if (show_api_stats && is_api_initialized()) {
         print_api_stats();
     }
+    if (show_memory) {
+        print_memory_report();
+    }
     
     // Cleanup
     free_spell_check_result(result);
     free_text_document(document);
+    set_suggestion_engine(SUGGESTION_ENGINE_TRIE, NULL);
     trie_destroy(dictionary);
+    ngram_model_destroy(context_model);
     
     // Cleanup API if initialized
     if (is_api_initialized()) {
         api_client_cleanup();
     }
     
-    printf("\n✅ Spell check complete!\n");
+    if (!reported) {
+        return 1;
+    }
+    print_status("\n✅ Spell check complete!\n");
     return 0;
 }
\ No newline at end of file
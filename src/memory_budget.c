@@ -0,0 +1,129 @@
+#include "../include/memory_budget.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Counters of one component
+ */
+typedef struct MemoryCounter {
+    size_t live;                // Bytes held now
+    size_t peak;                // Most bytes held at once
+    size_t limit;               // Budget (0 = unlimited)
+} MemoryCounter;
+
+// Per-component counters and the total over all components
+static MemoryCounter g_counters[MEMORY_COMPONENT_COUNT];
+static MemoryCounter g_total;
+
+static const char* const g_component_names[MEMORY_COMPONENT_COUNT] = {
+    "dictionary", "index", "documents", "results", "caches"
+};
+
+/**
+ * Add bytes to a counter and raise its peak if needed
+ */
+static void counter_add(MemoryCounter* counter, size_t bytes) {
+    size_t live = __atomic_add_fetch(&counter->live, bytes, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&counter->peak, __ATOMIC_RELAXED);
+    while (live > peak &&
+           !__atomic_compare_exchange_n(&counter->peak, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // peak was reloaded by the failed exchange
+    }
+}
+
+void memory_charge(MemoryComponent component, size_t bytes) {
+    if ((unsigned)component >= MEMORY_COMPONENT_COUNT || bytes == 0) {
+        return;
+    }
+    
+    counter_add(&g_counters[component], bytes);
+    counter_add(&g_total, bytes);
+}
+
+void memory_release(MemoryComponent component, size_t bytes) {
+    if ((unsigned)component >= MEMORY_COMPONENT_COUNT || bytes == 0) {
+        return;
+    }
+    
+    __atomic_sub_fetch(&g_counters[component].live, bytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&g_total.live, bytes, __ATOMIC_RELAXED);
+}
+
+size_t memory_get_live(MemoryComponent component) {
+    if ((unsigned)component >= MEMORY_COMPONENT_COUNT) {
+        return 0;
+    }
+    return __atomic_load_n(&g_counters[component].live, __ATOMIC_RELAXED);
+}
+
+size_t memory_get_peak(MemoryComponent component) {
+    if ((unsigned)component >= MEMORY_COMPONENT_COUNT) {
+        return 0;
+    }
+    return __atomic_load_n(&g_counters[component].peak, __ATOMIC_RELAXED);
+}
+
+size_t memory_get_total_live(void) {
+    return __atomic_load_n(&g_total.live, __ATOMIC_RELAXED);
+}
+
+size_t memory_get_total_peak(void) {
+    return __atomic_load_n(&g_total.peak, __ATOMIC_RELAXED);
+}
+
+bool memory_component_has_budget(MemoryComponent component) {
+    return component == MEMORY_COMPONENT_DOCUMENTS || component == MEMORY_COMPONENT_RESULTS ||
+           component == MEMORY_COMPONENT_CACHES;
+}
+
+bool memory_set_limit(MemoryComponent component, size_t bytes) {
+    if (!memory_component_has_budget(component)) {
+        return false;
+    }
+    
+    g_counters[component].limit = bytes;
+    return true;
+}
+
+size_t memory_get_limit(MemoryComponent component) {
+    return ((unsigned)component < MEMORY_COMPONENT_COUNT) ? g_counters[component].limit : 0;
+}
+
+bool memory_would_exceed(MemoryComponent component, size_t bytes) {
+    if ((unsigned)component >= MEMORY_COMPONENT_COUNT) {
+        return false;
+    }
+    
+    size_t limit = g_counters[component].limit;
+    if (limit == 0) {
+        return false;
+    }
+    size_t live = __atomic_load_n(&g_counters[component].live, __ATOMIC_RELAXED);
+    return bytes > limit || live > limit - bytes;
+}
+
+const char* memory_component_name(MemoryComponent component) {
+    return ((unsigned)component < MEMORY_COMPONENT_COUNT) ? g_component_names[component] : "unknown";
+}
+
+bool memory_parse_size(const char* text, size_t* bytes) {
+    if (!text || !bytes || *text < '0' || *text > '9') {
+        return false;
+    }
+    
+    char* end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    unsigned long long scale = 1;
+    switch (*end) {
+        case 'k': case 'K': scale = 1ULL << 10; end++; break;
+        case 'm': case 'M': scale = 1ULL << 20; end++; break;
+        case 'g': case 'G': scale = 1ULL << 30; end++; break;
+        default: break;
+    }
+    if (*end != '\0' || value > SIZE_MAX / scale) {
+        return false;
+    }
+    
+    *bytes = (size_t)(value * scale);
+    return true;
+}
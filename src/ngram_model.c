@@ -0,0 +1,915 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/ngram_model.h"
+#include "../include/memory_budget.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Compiled model layout: an NgramFileHeader, then slot_count uint32
+ * fingerprints, then slot_count quantized counts (one byte each)
+ */
+#define NGRAM_MAGIC "SPNG"
+#define NGRAM_FORMAT_VERSION 1
+
+/**
+ * Marker written in native byte order to detect foreign-endian files
+ */
+#define NGRAM_BYTE_ORDER 0x01020304u
+
+/**
+ * Quantization steps per doubling of a count: a stored byte q > 0 stands
+ * for a log2 count of (q - 1) / NGRAM_QUANT_STEPS
+ */
+#define NGRAM_QUANT_STEPS 8.0f
+
+/**
+ * Stupid backoff penalty for each order dropped, as its log2 (log2 0.4)
+ */
+#define NGRAM_BACKOFF_LOG2 (-1.321928f)
+
+/**
+ * Windows scored per round of batched lookups
+ */
+#define NGRAM_SCORE_BATCH 16
+
+/**
+ * Distinct n-grams a window's score needs (see score_window())
+ */
+#define NGRAM_KEYS_PER_WINDOW 11
+
+/**
+ * Trigrams of a window, the first of its n-grams (see g_window_ngrams)
+ */
+#define NGRAM_WINDOW_TRIGRAMS 3
+
+/**
+ * Positions of a sequence whose n-grams are looked up per round (up to
+ * NGRAM_MAX_ORDER each)
+ */
+#define NGRAM_SEQUENCE_BATCH 64
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NGRAM_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define NGRAM_PREFETCH(address) ((void)(address))
+#endif
+
+// SSE2 is part of the x86-64 baseline, so no runtime check is needed
+#if defined(__SSE2__) || defined(_M_X64)
+#define NGRAM_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * Header of a compiled model
+ */
+typedef struct NgramFileHeader {
+    char magic[4];              // NGRAM_MAGIC (not NUL-terminated)
+    uint32_t version;           // NGRAM_FORMAT_VERSION
+    uint32_t byte_order;        // NGRAM_BYTE_ORDER in the writer's native byte order
+    uint32_t header_size;       // sizeof(NgramFileHeader) at write time
+    uint64_t slot_count;        // Table slots (a power of two)
+    uint64_t entry_count;       // Distinct n-grams stored
+    uint64_t total_tokens;      // Words and boundaries counted, the unigram denominator
+    uint64_t payload_size;      // slot_count * 5
+    uint64_t checksum;          // FNV-1a 64-bit hash of the payload
+} NgramFileHeader;
+
+struct NgramModel {
+    const uint32_t* fingerprints; // Slot fingerprints (0 marks an empty slot)
+    const uint8_t* counts;      // Quantized count of each slot
+    uint64_t mask;              // slot_count - 1
+    uint64_t slot_count;        // Table slots
+    uint64_t entry_count;       // Distinct n-grams stored
+    uint64_t total_tokens;      // Words and boundaries counted
+    float log2_total;           // log2(total_tokens)
+    void* storage;              // Heap table or file mapping
+    size_t storage_size;        // Bytes of storage
+    bool mapped;                // storage is a file mapping
+    void* map_handle;           // Platform mapping handle (Windows only)
+};
+
+/**
+ * Exact counts gathered while reading a corpus
+ */
+typedef struct NgramCounter {
+    uint64_t* keys;             // N-gram keys (0 marks an empty slot)
+    uint32_t* counts;           // Count of each key
+    size_t capacity;            // Slots (a power of two)
+    size_t count;               // Occupied slots
+} NgramCounter;
+
+/**
+ * Continue an FNV-1a 64-bit hash over a memory block
+ */
+static uint64_t fnv1a64_extend(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Compute the FNV-1a 64-bit hash of a memory block
+ */
+static uint64_t fnv1a64(const void* data, size_t size) {
+    return fnv1a64_extend(NGRAM_WORD_HASH_SEED, data, size);
+}
+
+uint64_t ngram_word_hash(const char* word, size_t length) {
+    return fnv1a64(word, length);
+}
+
+uint64_t ngram_word_hash_extend(uint64_t hash, const char* bytes, size_t length) {
+    return fnv1a64_extend(hash, bytes, length);
+}
+
+uint64_t ngram_key(const uint64_t* word_hashes, int order) {
+    uint64_t key = 0x9E3779B97F4A7C15ULL * (uint64_t)order;
+    for (int i = 0; i < order; i++) {
+        key = (key ^ word_hashes[i]) * 0xFF51AFD7ED558CCDULL;
+        key ^= key >> 32;
+    }
+
+    // Slots come from the low bits and fingerprints from the high ones, so mix both
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * Fingerprint stored for a key; never 0, which marks an empty slot
+ */
+static inline uint32_t key_fingerprint(uint64_t key) {
+    uint32_t fingerprint = (uint32_t)(key >> 32);
+    return (fingerprint != 0) ? fingerprint : 1;
+}
+
+bool ngram_is_sentence_start(const TextDocument* doc, int index) {
+    if (index <= 0) {
+        return true;
+    }
+
+    const TextToken* previous = &doc->tokens[index - 1];
+    const TextToken* token = &doc->tokens[index];
+    if (token->line_number > previous->line_number + 1) {
+        return true;
+    }
+
+    for (size_t i = previous->offset + previous->length; i < token->offset; i++) {
+        char c = doc->text[i];
+        if (c == '.' || c == '!' || c == '?') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Double the capacity of a counter and rehash its keys
+ */
+static bool counter_grow(NgramCounter* counter) {
+    size_t capacity = (counter->capacity == 0) ? 1024 : counter->capacity * 2;
+    uint64_t* keys = (uint64_t*)calloc(capacity, sizeof(uint64_t));
+    uint32_t* counts = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+    if (keys == NULL || counts == NULL) {
+        free(keys);
+        free(counts);
+        return false;
+    }
+
+    for (size_t i = 0; i < counter->capacity; i++) {
+        uint64_t key = counter->keys[i];
+        if (key == 0) {
+            continue;
+        }
+        size_t slot = (size_t)key & (capacity - 1);
+        while (keys[slot] != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        keys[slot] = key;
+        counts[slot] = counter->counts[i];
+    }
+
+    free(counter->keys);
+    free(counter->counts);
+    counter->keys = keys;
+    counter->counts = counts;
+    counter->capacity = capacity;
+    return true;
+}
+
+/**
+ * Count one occurrence of an n-gram
+ */
+static bool counter_add(NgramCounter* counter, const uint64_t* word_hashes, int order) {
+    // Keep the load factor at or below 1/2
+    if ((counter->count + 1) * 2 > counter->capacity && !counter_grow(counter)) {
+        return false;
+    }
+
+    uint64_t key = ngram_key(word_hashes, order);
+    if (key == 0) {
+        key = 1;
+    }
+    size_t slot = (size_t)key & (counter->capacity - 1);
+    while (counter->keys[slot] != 0 && counter->keys[slot] != key) {
+        slot = (slot + 1) & (counter->capacity - 1);
+    }
+
+    if (counter->keys[slot] == 0) {
+        counter->keys[slot] = key;
+        counter->counts[slot] = 0;
+        counter->count++;
+    }
+    if (counter->counts[slot] < UINT32_MAX) {
+        counter->counts[slot]++;
+    }
+    return true;
+}
+
+/**
+ * Count the n-grams ending at the latest word of a sentence history
+ * @param history Hashes of the sentence so far, latest last
+ * @param length Number of hashes in history
+ */
+static bool count_ngrams_ending(NgramCounter* counter, const uint64_t* history, int length) {
+    bool ok = true;
+    for (int order = 1; order <= NGRAM_MAX_ORDER && order <= length; order++) {
+        ok = ok && counter_add(counter, history + length - order, order);
+    }
+    return ok;
+}
+
+/**
+ * Quantize an exact count to one byte
+ */
+static uint8_t quantize_count(uint32_t count) {
+    float q = 1.0f + roundf(log2f((float)count) * NGRAM_QUANT_STEPS);
+    return (q > 255.0f) ? 255 : (uint8_t)q;
+}
+
+/**
+ * Allocate an empty heap model with room for entry_count n-grams
+ */
+static NgramModel* model_create(uint64_t entry_count) {
+    // Keep the load factor at or below 0.7 so probe chains stay short
+    uint64_t slot_count = 16;
+    while (slot_count * 7 < entry_count * 10) {
+        slot_count *= 2;
+    }
+
+    NgramModel* model = (NgramModel*)calloc(1, sizeof(NgramModel));
+    if (model == NULL) {
+        return NULL;
+    }
+    model->storage_size = (size_t)slot_count * (sizeof(uint32_t) + sizeof(uint8_t));
+    model->storage = calloc(1, model->storage_size);
+    if (model->storage == NULL) {
+        free(model);
+        return NULL;
+    }
+
+    model->fingerprints = (const uint32_t*)model->storage;
+    model->counts = (const uint8_t*)model->storage + slot_count * sizeof(uint32_t);
+    model->slot_count = slot_count;
+    model->mask = slot_count - 1;
+    model->entry_count = entry_count;
+    memory_charge(MEMORY_COMPONENT_INDEX, sizeof(NgramModel) + model->storage_size);
+    return model;
+}
+
+NgramModel* ngram_model_build(const char* corpus_filename) {
+    if (corpus_filename == NULL) {
+        return NULL;
+    }
+
+    TextDocument* corpus = load_text_file(corpus_filename);
+    if (corpus == NULL) {
+        return NULL;
+    }
+
+    NgramCounter counter = { NULL, NULL, 0, 0 };
+    uint64_t boundary = ngram_word_hash(NGRAM_BOUNDARY, strlen(NGRAM_BOUNDARY));
+    uint64_t history[NGRAM_MAX_ORDER];
+    int length = 0;
+    uint64_t total_tokens = 0;
+    bool ok = true;
+
+    // Each sentence is counted as <s> w1 ... wn <s>; the closing boundary opens the next sentence
+    for (int i = 0; ok && i <= corpus->token_count; i++) {
+        bool sentence_start = (i == corpus->token_count) || ngram_is_sentence_start(corpus, i);
+        if (sentence_start) {
+            if (length == NGRAM_MAX_ORDER) {
+                memmove(history, history + 1, (NGRAM_MAX_ORDER - 1) * sizeof(uint64_t));
+                length--;
+            }
+            history[length++] = boundary;
+            ok = (i == 0) ? counter_add(&counter, &boundary, 1) : count_ngrams_ending(&counter, history, length);
+            total_tokens++;
+
+            // Nothing spans a boundary
+            history[0] = boundary;
+            length = 1;
+        }
+        if (i == corpus->token_count) {
+            break;
+        }
+
+        const char* word = corpus->tokens[i].word;
+        if (length == NGRAM_MAX_ORDER) {
+            memmove(history, history + 1, (NGRAM_MAX_ORDER - 1) * sizeof(uint64_t));
+            length--;
+        }
+        history[length++] = ngram_word_hash(word, strlen(word));
+        ok = ok && count_ngrams_ending(&counter, history, length);
+        total_tokens++;
+    }
+    free_text_document(corpus);
+
+    NgramModel* model = ok ? model_create(counter.count) : NULL;
+    if (model != NULL) {
+        uint32_t* fingerprints = (uint32_t*)model->storage;
+        uint8_t* counts = (uint8_t*)model->storage + model->slot_count * sizeof(uint32_t);
+        for (size_t i = 0; i < counter.capacity; i++) {
+            uint64_t key = counter.keys[i];
+            if (key == 0) {
+                continue;
+            }
+            uint64_t slot = key & model->mask;
+            while (fingerprints[slot] != 0) {
+                slot = (slot + 1) & model->mask;
+            }
+            fingerprints[slot] = key_fingerprint(key);
+            counts[slot] = quantize_count(counter.counts[i]);
+        }
+        model->total_tokens = total_tokens;
+        model->log2_total = log2f((float)(total_tokens > 0 ? total_tokens : 1));
+    } else {
+        fprintf(stderr, "Error: Memory allocation failed while counting n-grams of '%s'\n", corpus_filename);
+    }
+
+    free(counter.keys);
+    free(counter.counts);
+    return model;
+}
+
+bool ngram_model_save(const NgramModel* model, const char* filename) {
+    if (model == NULL || filename == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - n-gram model or filename is NULL\n");
+        return false;
+    }
+
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Cannot create n-gram model '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check that the directory exists and you have write permissions\n");
+        return false;
+    }
+
+    size_t payload_size = (size_t)model->slot_count * (sizeof(uint32_t) + sizeof(uint8_t));
+    const unsigned char* payload = (const unsigned char*)model->fingerprints;
+
+    NgramFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, NGRAM_MAGIC, sizeof(header.magic));
+    header.version = NGRAM_FORMAT_VERSION;
+    header.byte_order = NGRAM_BYTE_ORDER;
+    header.header_size = (uint32_t)sizeof(NgramFileHeader);
+    header.slot_count = model->slot_count;
+    header.entry_count = model->entry_count;
+    header.total_tokens = model->total_tokens;
+    header.payload_size = payload_size;
+
+    // Counts directly follow the fingerprints in storage, so the payload is contiguous
+    header.checksum = fnv1a64(payload, payload_size);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(payload, 1, payload_size, file) == payload_size;
+
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+
+    if (!ok) {
+        fprintf(stderr, "Error: Failed to write n-gram model '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check available disk space\n");
+        remove(filename);
+    }
+    return ok;
+}
+
+/**
+ * Map a whole file read-only
+ * @param filename File to map
+ * @param size Receives the file size
+ * @param handle Receives the platform mapping handle (Windows only)
+ * @return Base address of the mapping, or NULL on error
+ */
+static void* map_file(const char* filename, size_t* size, void** handle) {
+    *handle = NULL;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // The mapping keeps the file open
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (base == NULL) {
+        CloseHandle(mapping);
+        return NULL;
+    }
+
+    *size = (size_t)file_size.QuadPart;
+    *handle = mapping;
+    return base;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    *size = (size_t)st.st_size;
+    return base;
+#endif
+}
+
+/**
+ * Release a mapping created by map_file()
+ */
+static void unmap_file(void* base, size_t size, void* handle) {
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(base);
+    CloseHandle((HANDLE)handle);
+#else
+    (void)handle;
+    munmap(base, size);
+#endif
+}
+
+/**
+ * Validate a mapped model
+ * @param base Start of the mapping
+ * @param size Size of the mapping
+ * @param filename File name for error reporting
+ * @return true if header, table size, checksum and occupancy are all valid
+ */
+static bool validate_model_file(const void* base, size_t size, const char* filename) {
+    const NgramFileHeader* header = (const NgramFileHeader*)base;
+
+    if (size < sizeof(NgramFileHeader) || memcmp(header->magic, NGRAM_MAGIC, sizeof(header->magic)) != 0) {
+        fprintf(stderr, "Error: '%s' is not a compiled n-gram model\n", filename);
+        return false;
+    }
+
+    if (header->version != NGRAM_FORMAT_VERSION ||
+        header->byte_order != NGRAM_BYTE_ORDER ||
+        header->header_size != sizeof(NgramFileHeader)) {
+        fprintf(stderr, "Error: N-gram model '%s' has an incompatible format (version %u)\n",
+                filename, (unsigned)header->version);
+        fprintf(stderr, "Suggestion: Recompile it with --compile-context on this machine\n");
+        return false;
+    }
+
+    uint64_t slots = header->slot_count;
+    if (slots < 16 || (slots & (slots - 1)) != 0 || slots > SIZE_MAX / 8 ||
+        header->payload_size != slots * (sizeof(uint32_t) + sizeof(uint8_t)) ||
+        size - sizeof(NgramFileHeader) < header->payload_size) {
+        fprintf(stderr, "Error: N-gram model '%s' is truncated or corrupted\n", filename);
+        return false;
+    }
+
+    const unsigned char* payload = (const unsigned char*)base + header->header_size;
+    if (fnv1a64(payload, (size_t)header->payload_size) != header->checksum) {
+        fprintf(stderr, "Error: Checksum mismatch in n-gram model '%s'\n", filename);
+        fprintf(stderr, "Suggestion: The file is corrupted, recompile it with --compile-context\n");
+        return false;
+    }
+
+    // Probes stop at an empty slot, so a full table would never end a miss
+    const uint32_t* fingerprints = (const uint32_t*)payload;
+    uint64_t occupied = 0;
+    for (uint64_t slot = 0; slot < slots; slot++) {
+        occupied += (fingerprints[slot] != 0);
+    }
+    if (occupied != header->entry_count || occupied >= slots) {
+        fprintf(stderr, "Error: N-gram model '%s' is corrupted (%llu of %llu slots used, %llu n-grams declared)\n",
+                filename, (unsigned long long)occupied, (unsigned long long)slots,
+                (unsigned long long)header->entry_count);
+        return false;
+    }
+
+    return true;
+}
+
+NgramModel* ngram_model_load(const char* filename) {
+    if (filename == NULL) {
+        return NULL;
+    }
+
+    size_t size = 0;
+    void* handle = NULL;
+    void* base = map_file(filename, &size, &handle);
+    if (base == NULL) {
+        fprintf(stderr, "Error: Cannot map n-gram model '%s'\n", filename);
+        fprintf(stderr, "Suggestion: Check that the file exists and you have read permissions\n");
+        return NULL;
+    }
+
+    if (!validate_model_file(base, size, filename)) {
+        unmap_file(base, size, handle);
+        return NULL;
+    }
+
+    NgramModel* model = (NgramModel*)calloc(1, sizeof(NgramModel));
+    if (model == NULL) {
+        unmap_file(base, size, handle);
+        return NULL;
+    }
+
+    const NgramFileHeader* header = (const NgramFileHeader*)base;
+    const unsigned char* payload = (const unsigned char*)base + header->header_size;
+
+    model->fingerprints = (const uint32_t*)payload;
+    model->counts = payload + header->slot_count * sizeof(uint32_t);
+    model->slot_count = header->slot_count;
+    model->mask = header->slot_count - 1;
+    model->entry_count = header->entry_count;
+    model->total_tokens = header->total_tokens;
+    model->log2_total = log2f((float)(header->total_tokens > 0 ? header->total_tokens : 1));
+    model->storage = base;
+    model->storage_size = size;
+    model->mapped = true;
+    model->map_handle = handle;
+    memory_charge(MEMORY_COMPONENT_INDEX, sizeof(NgramModel) + size);
+
+    return model;
+}
+
+bool ngram_model_is_compiled(const char* filename) {
+    if (filename == NULL) {
+        return false;
+    }
+
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    char magic[4];
+    bool matches = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                   memcmp(magic, NGRAM_MAGIC, sizeof(magic)) == 0;
+    fclose(file);
+
+    return matches;
+}
+
+#ifdef NGRAM_HAVE_SSE2
+/**
+ * Index of the lowest set bit of a non-zero mask
+ */
+static inline unsigned lowest_bit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctz(mask);
+#else
+    unsigned index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+#endif
+
+/**
+ * Probe the table from slot for a fingerprint
+ * @return Slot holding it, or slot_count if an empty slot comes first
+ */
+static inline uint64_t find_fingerprint(const NgramModel* model, uint32_t fingerprint, uint64_t slot) {
+    uint64_t probes = 0;
+#ifdef NGRAM_HAVE_SSE2
+    // Four slots per step, so most probes end in one step whatever their length
+    const __m128i wanted = _mm_set1_epi32((int)fingerprint);
+    for (; probes < model->slot_count && slot + 4 <= model->slot_count; probes += 4, slot += 4) {
+        __m128i group = _mm_loadu_si128((const __m128i*)(model->fingerprints + slot));
+        unsigned matches = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(group, wanted)));
+        unsigned empty = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(group, _mm_setzero_si128())));
+        if ((matches | empty) != 0) {
+            unsigned first = lowest_bit(matches | empty);
+            return ((matches >> first) & 1u) ? slot + first : model->slot_count;
+        }
+    }
+    slot &= model->mask;
+#endif
+
+    // Slot by slot near the end of the table, where probes wrap around
+    for (; probes < model->slot_count && model->fingerprints[slot] != 0; probes++) {
+        if (model->fingerprints[slot] == fingerprint) {
+            return slot;
+        }
+        slot = (slot + 1) & model->mask;
+    }
+    return model->slot_count;
+}
+
+void ngram_model_lookup_batch(const NgramModel* model, const uint64_t* keys, int count, float* log2_counts) {
+    // Start loading every home slot before probing any of them
+    for (int i = 0; i < count; i++) {
+        uint64_t slot = keys[i] & model->mask;
+        NGRAM_PREFETCH(&model->fingerprints[slot]);
+        NGRAM_PREFETCH(&model->counts[slot]);
+    }
+
+    for (int i = 0; i < count; i++) {
+        uint64_t slot = find_fingerprint(model, key_fingerprint(keys[i]), keys[i] & model->mask);
+        log2_counts[i] = (slot < model->slot_count) ? (float)(model->counts[slot] - 1) / NGRAM_QUANT_STEPS
+                                                    : NGRAM_ABSENT;
+    }
+}
+
+/**
+ * Log2 stupid-backoff probability of c following a b
+ * @param abc Log2 count of the trigram a b c
+ * @param ab Log2 count of the bigram a b
+ * @param bc Log2 count of the bigram b c
+ * @param b Log2 count of b
+ * @param c Log2 count of c
+ * @param log2_total Log2 of the unigram total
+ */
+static float backoff_log2(float abc, float ab, float bc, float b, float c, float log2_total) {
+    // Quantization can round a count above its prefix's, so probabilities are capped at 1
+    if (abc != NGRAM_ABSENT && ab != NGRAM_ABSENT) {
+        return (abc < ab) ? abc - ab : 0.0f;
+    }
+    if (bc != NGRAM_ABSENT && b != NGRAM_ABSENT) {
+        return NGRAM_BACKOFF_LOG2 + ((bc < b) ? bc - b : 0.0f);
+    }
+
+    // A word never seen counts as half an occurrence
+    float unigram = (c != NGRAM_ABSENT) ? c : -1.0f;
+    return 2.0f * NGRAM_BACKOFF_LOG2 + unigram - log2_total;
+}
+
+/**
+ * Log2 bound on backoff_log2() when the trigram a b c was not looked up:
+ * no trigram occurs more often than its last two words, so its count is
+ * taken to be that of b c
+ */
+static float backoff_bound_log2(float ab, float bc, float b, float c, float log2_total) {
+    float bound = backoff_log2(NGRAM_ABSENT, ab, bc, b, c, log2_total);
+    if (ab != NGRAM_ABSENT && bc != NGRAM_ABSENT) {
+        float trigram = (bc < ab) ? bc - ab : 0.0f;
+        bound = (trigram > bound) ? trigram : bound;
+    }
+    return bound;
+}
+
+/**
+ * N-grams of a window as (first word, order): trigrams (l2 l1 x),
+ * (l1 x r1), (x r1 r2); bigrams (l2 l1), (l1 x), (x r1), (r1 r2);
+ * unigrams l1, x, r1, r2. Counts are kept in this order, and bounds
+ * need those from NGRAM_WINDOW_TRIGRAMS on.
+ */
+static const int g_window_ngrams[NGRAM_KEYS_PER_WINDOW][2] = {
+    { 0, 3 }, { 1, 3 }, { 2, 3 },
+    { 0, 2 }, { 1, 2 }, { 2, 2 }, { 3, 2 },
+    { 1, 1 }, { 2, 1 }, { 3, 1 }, { 4, 1 }
+};
+
+/**
+ * Look up n-grams first_ngram on of up to NGRAM_SCORE_BATCH windows into
+ * counts, NGRAM_KEYS_PER_WINDOW per window
+ */
+static void lookup_windows(const NgramModel* model, const uint64_t* windows, int count, int first_ngram,
+                           float* counts) {
+    uint64_t keys[NGRAM_SCORE_BATCH * NGRAM_KEYS_PER_WINDOW];
+    float found[NGRAM_SCORE_BATCH * NGRAM_KEYS_PER_WINDOW];
+    int per_window = NGRAM_KEYS_PER_WINDOW - first_ngram;
+    int key_count = 0;
+    for (int w = 0; w < count; w++) {
+        const uint64_t* window = windows + (size_t)w * NGRAM_WINDOW;
+        for (int n = first_ngram; n < NGRAM_KEYS_PER_WINDOW; n++) {
+            keys[key_count++] = ngram_key(window + g_window_ngrams[n][0], g_window_ngrams[n][1]);
+        }
+    }
+
+    ngram_model_lookup_batch(model, keys, key_count, found);
+    for (int w = 0; w < count; w++) {
+        memcpy(counts + w * NGRAM_KEYS_PER_WINDOW + first_ngram, found + w * per_window, per_window * sizeof(float));
+    }
+}
+
+/**
+ * Score a window from its counts (see g_window_ngrams)
+ */
+static float score_window(const float* n, float log2_total) {
+    return backoff_log2(n[0], n[3], n[4], n[7], n[8], log2_total) +
+           backoff_log2(n[1], n[4], n[5], n[8], n[9], log2_total) +
+           backoff_log2(n[2], n[5], n[6], n[9], n[10], log2_total);
+}
+
+void ngram_model_score_batch(const NgramModel* model, const uint64_t* windows, int count, float* scores) {
+    float counts[NGRAM_SCORE_BATCH * NGRAM_KEYS_PER_WINDOW];
+
+    for (int start = 0; start < count; start += NGRAM_SCORE_BATCH) {
+        int batch = (count - start < NGRAM_SCORE_BATCH) ? count - start : NGRAM_SCORE_BATCH;
+        lookup_windows(model, windows + (size_t)start * NGRAM_WINDOW, batch, 0, counts);
+        for (int w = 0; w < batch; w++) {
+            scores[start + w] = score_window(counts + w * NGRAM_KEYS_PER_WINDOW, model->log2_total);
+        }
+    }
+}
+
+void ngram_model_bound_batch(const NgramModel* model, const uint64_t* windows, int count, float* bounds) {
+    float counts[NGRAM_SCORE_BATCH * NGRAM_KEYS_PER_WINDOW];
+
+    for (int start = 0; start < count; start += NGRAM_SCORE_BATCH) {
+        int batch = (count - start < NGRAM_SCORE_BATCH) ? count - start : NGRAM_SCORE_BATCH;
+        lookup_windows(model, windows + (size_t)start * NGRAM_WINDOW, batch, NGRAM_WINDOW_TRIGRAMS, counts);
+
+        // The terms of score_window(), each trigram taken at its bound
+        for (int w = 0; w < batch; w++) {
+            const float* n = counts + w * NGRAM_KEYS_PER_WINDOW;
+            bounds[start + w] = backoff_bound_log2(n[3], n[4], n[7], n[8], model->log2_total) +
+                                backoff_bound_log2(n[4], n[5], n[8], n[9], model->log2_total) +
+                                backoff_bound_log2(n[5], n[6], n[9], n[10], model->log2_total);
+        }
+    }
+}
+
+/**
+ * Look up the n-grams flagged in needed into counts, in batches: bit
+ * order - 1 of needed[j] flags the n-gram of that order ending at word j,
+ * whose count goes to counts[(order - 1) * count + j]. Each flag then
+ * moves up NGRAM_MAX_ORDER bits, marking the n-gram as looked up.
+ */
+static void lookup_sequence(const NgramModel* model, const uint64_t* words, int count, uint8_t* needed,
+                            float* counts) {
+    uint64_t keys[NGRAM_SEQUENCE_BATCH * NGRAM_MAX_ORDER];
+    float found[NGRAM_SEQUENCE_BATCH * NGRAM_MAX_ORDER];
+    float* targets[NGRAM_SEQUENCE_BATCH * NGRAM_MAX_ORDER];
+    const unsigned orders = (1u << NGRAM_MAX_ORDER) - 1;
+    int key_count = 0;
+    for (int j = 0; j < count; j++) {
+        for (int order = 1; order <= NGRAM_MAX_ORDER; order++) {
+            if (needed[j] & (1u << (order - 1))) {
+                keys[key_count] = ngram_key(words + j - (order - 1), order);
+                targets[key_count++] = &counts[(size_t)(order - 1) * count + j];
+            }
+        }
+        needed[j] = (uint8_t)((needed[j] & ~orders) | ((needed[j] & orders) << NGRAM_MAX_ORDER));
+        if (key_count > 0 && (key_count + NGRAM_MAX_ORDER > NGRAM_SEQUENCE_BATCH * NGRAM_MAX_ORDER || j + 1 == count)) {
+            ngram_model_lookup_batch(model, keys, key_count, found);
+            for (int k = 0; k < key_count; k++) {
+                *targets[k] = found[k];
+            }
+            key_count = 0;
+        }
+    }
+}
+
+bool ngram_model_score_sequence(const NgramModel* model, const uint64_t* words, int count, float screen_log2_count,
+                                bool* wanted, float* scores) {
+    // unigrams[j], bigrams[j] and trigrams[j] are the n-grams ending at word j,
+    // looked up only where a wanted window needs them
+    float* counts = (float*)malloc((size_t)count * NGRAM_MAX_ORDER * sizeof(float));
+    uint8_t* needed = (uint8_t*)calloc((size_t)count, 1);
+    if (counts == NULL || needed == NULL) {
+        free(counts);
+        free(needed);
+        return false;
+    }
+    float* unigrams = counts;
+    float* bigrams = counts + count;
+    float* trigrams = counts + 2 * (size_t)count;
+
+    // The two bigrams with the middle word first, as most words are dropped on them
+    for (int j = 2; j + 2 < count; j++) {
+        if (wanted[j]) {
+            needed[j] |= 2;
+            needed[j + 1] |= 2;
+        }
+    }
+    lookup_sequence(model, words, count, needed, counts);
+    for (int j = 2; j + 2 < count; j++) {
+        if (wanted[j] && bigrams[j] > screen_log2_count && bigrams[j + 1] > screen_log2_count) {
+            wanted[j] = false;
+        }
+    }
+
+    // Then the rest of the windows left (see score_window()), skipping the
+    // n-grams already looked up
+    for (int j = 2; j + 2 < count; j++) {
+        if (wanted[j]) {
+            needed[j - 1] |= 3;
+            needed[j] |= 7;
+            needed[j + 1] |= 7;
+            needed[j + 2] |= 7;
+        }
+    }
+    for (int j = 0; j < count; j++) {
+        needed[j] &= (uint8_t)~(needed[j] >> NGRAM_MAX_ORDER);
+    }
+    lookup_sequence(model, words, count, needed, counts);
+
+    // The three terms of score_window() for the window centered on word j
+    float total = model->log2_total;
+    for (int j = 2; j + 2 < count; j++) {
+        if (!wanted[j]) {
+            continue;
+        }
+        scores[j] = backoff_log2(trigrams[j], bigrams[j - 1], bigrams[j], unigrams[j - 1], unigrams[j], total) +
+                    backoff_log2(trigrams[j + 1], bigrams[j], bigrams[j + 1], unigrams[j], unigrams[j + 1], total) +
+                    backoff_log2(trigrams[j + 2], bigrams[j + 1], bigrams[j + 2], unigrams[j + 1], unigrams[j + 2],
+                                 total);
+    }
+
+    free(counts);
+    free(needed);
+    return true;
+}
+
+bool ngram_model_has_word(const NgramModel* model, uint64_t word_hash) {
+    if (model == NULL) {
+        return false;
+    }
+
+    uint64_t key = ngram_key(&word_hash, 1);
+    float count;
+    ngram_model_lookup_batch(model, &key, 1, &count);
+    return count != NGRAM_ABSENT;
+}
+
+size_t ngram_model_get_entry_count(const NgramModel* model) {
+    return (model != NULL) ? (size_t)model->entry_count : 0;
+}
+
+size_t ngram_model_get_memory_usage(const NgramModel* model) {
+    return (model != NULL) ? sizeof(NgramModel) + model->storage_size : 0;
+}
+
+size_t ngram_model_get_file_size(const NgramModel* model) {
+    if (model == NULL) {
+        return 0;
+    }
+    return sizeof(NgramFileHeader) + (size_t)model->slot_count * (sizeof(uint32_t) + sizeof(uint8_t));
+}
+
+void ngram_model_destroy(NgramModel* model) {
+    if (model == NULL) {
+        return;
+    }
+
+    memory_release(MEMORY_COMPONENT_INDEX, sizeof(NgramModel) + model->storage_size);
+    if (model->mapped) {
+        unmap_file(model->storage, model->storage_size, model->map_handle);
+    } else {
+        free(model->storage);
+    }
+    free(model);
+}
@@ -0,0 +1,405 @@
+#include "../include/output_writer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+/**
+ * Bytes buffered before a write to the file
+ */
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+/**
+ * Binary report layout: magic, version byte, then records introduced by a tag
+ * byte. Integers are little-endian; strings are a uint16 length and their bytes.
+ *
+ * error:   tag, uint32 line, uint32 position, string word, string original,
+ *          uint8 suggestion count, that many strings (the context error tag
+ *          marks a dictionary word unlikely in its context)
+ * summary: tag, string document, uint32 words checked, uint32 errors,
+ *          uint8 failed (1 if the document could not be checked)
+ */
+#define OUTPUT_BINARY_MAGIC "SPCB"
+#define OUTPUT_BINARY_VERSION 1
+#define OUTPUT_BINARY_TAG_ERROR 0x01
+#define OUTPUT_BINARY_TAG_SUMMARY 0x02
+#define OUTPUT_BINARY_TAG_CONTEXT_ERROR 0x03
+
+struct OutputWriter {
+    FILE* file;                 // Destination
+    bool owns_file;             // Close the file with the writer (not for stdout)
+    bool failed;                // A write failed; further records are dropped
+    OutputFormat format;        // Encoding of the records
+    size_t length;              // Bytes held in buffer
+    char buffer[OUTPUT_BUFFER_SIZE];
+};
+
+bool output_format_parse(const char* name, OutputFormat* format) {
+    if (!name || !format) {
+        return false;
+    }
+    
+    if (strcmp(name, "text") == 0) {
+        *format = OUTPUT_FORMAT_TEXT;
+    } else if (strcmp(name, "jsonl") == 0) {
+        *format = OUTPUT_FORMAT_JSONL;
+    } else if (strcmp(name, "csv") == 0) {
+        *format = OUTPUT_FORMAT_CSV;
+    } else if (strcmp(name, "binary") == 0) {
+        *format = OUTPUT_FORMAT_BINARY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool output_writer_flush(OutputWriter* writer) {
+    if (!writer) {
+        return false;
+    }
+    
+    if (!writer->failed && writer->length > 0 &&
+        fwrite(writer->buffer, 1, writer->length, writer->file) != writer->length) {
+        writer->failed = true;
+    }
+    writer->length = 0;
+    if (!writer->failed && fflush(writer->file) != 0) {
+        writer->failed = true;
+    }
+    return !writer->failed;
+}
+
+/**
+ * Append bytes to the buffer, writing it out whenever it fills
+ */
+static void append_bytes(OutputWriter* writer, const void* data, size_t size) {
+    const char* bytes = (const char*)data;
+    while (size > 0 && !writer->failed) {
+        size_t room = OUTPUT_BUFFER_SIZE - writer->length;
+        if (room == 0) {
+            if (fwrite(writer->buffer, 1, writer->length, writer->file) != writer->length) {
+                writer->failed = true;
+            }
+            writer->length = 0;
+            continue;
+        }
+        
+        size_t chunk = (size < room) ? size : room;
+        memcpy(writer->buffer + writer->length, bytes, chunk);
+        writer->length += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+/**
+ * Append one byte
+ */
+static inline void append_char(OutputWriter* writer, char c) {
+    if (writer->length == OUTPUT_BUFFER_SIZE) {
+        append_bytes(writer, &c, 1);
+    } else {
+        writer->buffer[writer->length++] = c;
+    }
+}
+
+/**
+ * Append a NUL-terminated string unchanged
+ */
+static void append_text(OutputWriter* writer, const char* text) {
+    append_bytes(writer, text, strlen(text));
+}
+
+/**
+ * Append a decimal integer without going through printf
+ */
+static void append_int(OutputWriter* writer, long long value) {
+    char digits[24];
+    int count = 0;
+    unsigned long long magnitude = (value < 0) ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0) {
+        digits[count++] = '-';
+    }
+    while (count > 0) {
+        append_char(writer, digits[--count]);
+    }
+}
+
+/**
+ * Append a JSON string literal; UTF-8 bytes pass through unchanged
+ */
+static void append_json_string(OutputWriter* writer, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    append_char(writer, '"');
+    for (const unsigned char* p = (const unsigned char*)(text ? text : ""); *p; p++) {
+        // Copy runs that need no escaping in one go
+        const unsigned char* run = p;
+        while (*p >= 0x20 && *p != '"' && *p != '\\') {
+            p++;
+        }
+        append_bytes(writer, run, (size_t)(p - run));
+        if (*p == '\0') {
+            break;
+        }
+        
+        if (*p == '"' || *p == '\\') {
+            append_char(writer, '\\');
+            append_char(writer, (char)*p);
+        } else if (*p == '\n') {
+            append_bytes(writer, "\\n", 2);
+        } else if (*p == '\r') {
+            append_bytes(writer, "\\r", 2);
+        } else if (*p == '\t') {
+            append_bytes(writer, "\\t", 2);
+        } else {
+            char escape[6] = { '\\', 'u', '0', '0', hex[*p >> 4], hex[*p & 0x0F] };
+            append_bytes(writer, escape, sizeof(escape));
+        }
+    }
+    append_char(writer, '"');
+}
+
+/**
+ * Append one CSV field made of parts joined by ';', quoted only when it
+ * holds a separator, quote or line break
+ */
+static void append_csv_joined(OutputWriter* writer, char* const* parts, int count) {
+    bool quoted = false;
+    for (int i = 0; i < count && !quoted; i++) {
+        quoted = parts[i] && strpbrk(parts[i], ",\"\r\n") != NULL;
+    }
+    
+    if (quoted) {
+        append_char(writer, '"');
+    }
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            append_char(writer, ';');
+        }
+        if (!quoted) {
+            append_text(writer, parts[i] ? parts[i] : "");
+            continue;
+        }
+        for (const char* p = parts[i] ? parts[i] : ""; *p; p++) {
+            if (*p == '"') {
+                append_char(writer, '"');
+            }
+            append_char(writer, *p);
+        }
+    }
+    if (quoted) {
+        append_char(writer, '"');
+    }
+}
+
+/**
+ * Append a single CSV field
+ */
+static void append_csv_field(OutputWriter* writer, const char* text) {
+    char* parts[1] = { (char*)text };
+    append_csv_joined(writer, parts, 1);
+}
+
+/**
+ * Append a little-endian uint16
+ */
+static void append_u16(OutputWriter* writer, uint16_t value) {
+    unsigned char bytes[2] = { (unsigned char)value, (unsigned char)(value >> 8) };
+    append_bytes(writer, bytes, sizeof(bytes));
+}
+
+/**
+ * Append a little-endian uint32
+ */
+static void append_u32(OutputWriter* writer, uint32_t value) {
+    unsigned char bytes[4] = { (unsigned char)value, (unsigned char)(value >> 8),
+                               (unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+    append_bytes(writer, bytes, sizeof(bytes));
+}
+
+/**
+ * Append a length-prefixed string (truncated to 65535 bytes)
+ */
+static void append_binary_string(OutputWriter* writer, const char* text) {
+    size_t length = text ? strlen(text) : 0;
+    if (length > UINT16_MAX) {
+        length = UINT16_MAX;
+    }
+    append_u16(writer, (uint16_t)length);
+    append_bytes(writer, text, length);
+}
+
+OutputWriter* output_writer_open(const char* path, OutputFormat format) {
+    if (format != OUTPUT_FORMAT_JSONL && format != OUTPUT_FORMAT_CSV && format != OUTPUT_FORMAT_BINARY) {
+        return NULL;
+    }
+    
+    OutputWriter* writer = (OutputWriter*)malloc(sizeof(OutputWriter));
+    if (!writer) {
+        fprintf(stderr, "Error: Not enough memory for the output writer\n");
+        return NULL;
+    }
+    
+    bool to_stdout = (path == NULL || strcmp(path, "-") == 0);
+    if (to_stdout) {
+        writer->file = stdout;
+#ifdef _WIN32
+        // Line endings are written explicitly, so no text-mode translation
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    } else {
+        writer->file = fopen(path, "wb");
+        if (!writer->file) {
+            fprintf(stderr, "Error: Cannot create output file '%s'\n", path);
+            free(writer);
+            return NULL;
+        }
+    }
+    writer->owns_file = !to_stdout;
+    writer->failed = false;
+    writer->format = format;
+    writer->length = 0;
+    
+    if (format == OUTPUT_FORMAT_CSV) {
+        append_text(writer, "document,line,position,word,original,suggestions\r\n");
+    } else if (format == OUTPUT_FORMAT_BINARY) {
+        append_bytes(writer, OUTPUT_BINARY_MAGIC, 4);
+        append_char(writer, (char)OUTPUT_BINARY_VERSION);
+    }
+    return writer;
+}
+
+bool output_writer_write_error(OutputWriter* writer, const char* document, const SpellError* error) {
+    if (!writer || !error) {
+        return false;
+    }
+    
+    switch (writer->format) {
+        case OUTPUT_FORMAT_JSONL:
+            append_text(writer, "{\"type\":\"error\",\"document\":");
+            append_json_string(writer, document);
+            append_text(writer, ",\"line\":");
+            append_int(writer, error->line_number);
+            append_text(writer, ",\"position\":");
+            append_int(writer, error->position);
+            append_text(writer, ",\"word\":");
+            append_json_string(writer, error->misspelled_word);
+            append_text(writer, ",\"original\":");
+            append_json_string(writer, error->original_word);
+            if (error->context_error) {
+                append_text(writer, ",\"context\":true");
+            }
+            append_text(writer, ",\"suggestions\":[");
+            for (int i = 0; i < error->suggestion_count; i++) {
+                if (i > 0) {
+                    append_char(writer, ',');
+                }
+                append_json_string(writer, error->suggestions[i]);
+            }
+            append_text(writer, "]}\n");
+            break;
+        
+        case OUTPUT_FORMAT_CSV:
+            append_csv_field(writer, document);
+            append_char(writer, ',');
+            append_int(writer, error->line_number);
+            append_char(writer, ',');
+            append_int(writer, error->position);
+            append_char(writer, ',');
+            append_csv_field(writer, error->misspelled_word);
+            append_char(writer, ',');
+            append_csv_field(writer, error->original_word);
+            append_char(writer, ',');
+            append_csv_joined(writer, error->suggestions, error->suggestion_count);
+            append_text(writer, "\r\n");
+            break;
+        
+        case OUTPUT_FORMAT_BINARY: {
+            int suggestion_count = (error->suggestion_count < UINT8_MAX) ? error->suggestion_count : UINT8_MAX;
+            append_char(writer, (char)(error->context_error ? OUTPUT_BINARY_TAG_CONTEXT_ERROR : OUTPUT_BINARY_TAG_ERROR));
+            append_u32(writer, (uint32_t)error->line_number);
+            append_u32(writer, (uint32_t)error->position);
+            append_binary_string(writer, error->misspelled_word);
+            append_binary_string(writer, error->original_word);
+            append_char(writer, (char)suggestion_count);
+            for (int i = 0; i < suggestion_count; i++) {
+                append_binary_string(writer, error->suggestions[i]);
+            }
+            break;
+        }
+        
+        default:
+            return false;
+    }
+    return !writer->failed;
+}
+
+bool output_writer_write_summary(OutputWriter* writer, const char* document, const SpellCheckResult* result) {
+    if (!writer) {
+        return false;
+    }
+    
+    int words_checked = result ? result->total_words_checked : 0;
+    int error_count = result ? result->error_count : 0;
+    switch (writer->format) {
+        case OUTPUT_FORMAT_JSONL:
+            append_text(writer, "{\"type\":\"summary\",\"document\":");
+            append_json_string(writer, document);
+            append_text(writer, ",\"words_checked\":");
+            append_int(writer, words_checked);
+            append_text(writer, ",\"errors\":");
+            append_int(writer, error_count);
+            append_text(writer, result ? ",\"failed\":false}\n" : ",\"failed\":true}\n");
+            break;
+        
+        case OUTPUT_FORMAT_CSV:
+            break;
+        
+        case OUTPUT_FORMAT_BINARY:
+            append_char(writer, (char)OUTPUT_BINARY_TAG_SUMMARY);
+            append_binary_string(writer, document);
+            append_u32(writer, (uint32_t)words_checked);
+            append_u32(writer, (uint32_t)error_count);
+            append_char(writer, result ? 0 : 1);
+            break;
+        
+        default:
+            return false;
+    }
+    return !writer->failed;
+}
+
+bool output_writer_write_result(OutputWriter* writer, const char* document, const SpellCheckResult* result) {
+    if (!writer) {
+        return false;
+    }
+    
+    if (result) {
+        for (int i = 0; i < result->error_count; i++) {
+            output_writer_write_error(writer, document, &result->errors[i]);
+        }
+    }
+    return output_writer_write_summary(writer, document, result);
+}
+
+bool output_writer_close(OutputWriter* writer) {
+    if (!writer) {
+        return true;
+    }
+    
+    bool ok = output_writer_flush(writer);
+    if (writer->owns_file && fclose(writer->file) != 0) {
+        ok = false;
+    }
+    free(writer);
+    return ok;
+}
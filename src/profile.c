@@ -0,0 +1,25 @@
+#include "../include/profile.h"
+#include "../include/timing.h"
+
+bool g_profile_enabled = false;
+PROFILE_THREAD_LOCAL ProfileCounters g_profile_counters;
+
+void profile_set_enabled(bool enabled) {
+#ifdef SPELL_CHECK_NO_PROFILE
+    (void)enabled;
+#else
+    g_profile_enabled = enabled;
+#endif
+}
+
+bool profile_is_enabled(void) {
+    return PROFILE_ENABLED();
+}
+
+ProfileCounters profile_read_counters(void) {
+    return g_profile_counters;
+}
+
+double profile_clock(void) {
+    return PROFILE_ENABLED() ? timing_now_seconds() : 0.0;
+}
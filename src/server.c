@@ -0,0 +1,1175 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/server.h"
+#include "../include/file_io.h"
+#include "../include/spell_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <errno.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET server_socket_t;
+#define SERVER_INVALID_SOCKET INVALID_SOCKET
+#define server_close_socket closesocket
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int server_socket_t;
+#define SERVER_INVALID_SOCKET (-1)
+#define server_close_socket close
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/**
+ * Largest request line plus headers accepted; larger requests get 431
+ */
+#define SERVER_MAX_HEADER_BYTES (16 * 1024)
+
+/**
+ * Seconds an idle keep-alive connection may hold a worker
+ */
+#define SERVER_IDLE_TIMEOUT_SECONDS 5
+
+/**
+ * Largest number of worker threads server_run() accepts
+ */
+#define SERVER_MAX_THREADS 64
+
+/**
+ * Deepest JSON nesting skipped inside a request before it is rejected
+ */
+#define SERVER_MAX_JSON_DEPTH 32
+
+/**
+ * Bytes read from a socket per recv() call
+ */
+#define SERVER_READ_CHUNK 8192
+
+/**
+ * Growable byte buffer used for request data and response bodies
+ */
+typedef struct ServerBuffer {
+    char* data;         // Bytes, NUL-terminated when non-empty
+    size_t length;      // Bytes in use, excluding the terminator
+    size_t capacity;    // Bytes allocated
+} ServerBuffer;
+
+/**
+ * Parsed request line and the headers the server acts on
+ */
+typedef struct HttpRequest {
+    char method[8];             // "GET", "POST", ...
+    char path[256];             // Request target without the query string
+    size_t header_length;       // Bytes up to and including the blank line
+    size_t content_length;      // Body size in bytes (0 without a Content-Length header)
+    bool keep_alive;            // Whether the connection stays open afterwards
+    bool expect_continue;       // Client waits for "100 Continue" before sending the body
+} HttpRequest;
+
+/**
+ * Cursor over a JSON request body
+ */
+typedef struct JsonReader {
+    const char* pos;            // Next unread byte
+    const char* end;            // One past the last byte
+} JsonReader;
+
+/**
+ * Documents decoded from one /check request
+ */
+typedef struct TextBatch {
+    TextDocument** documents;   // One tokenized document per text
+    int count;                  // Documents in use
+    int capacity;               // Documents allocated
+} TextBatch;
+
+/**
+ * State of one worker thread
+ */
+typedef struct ServerWorker {
+    pthread_t thread;           // Worker thread
+    DictionaryReader* reader;   // Registration with the dictionary handle
+} ServerWorker;
+
+// Global server state (one server per process)
+static server_socket_t g_server_socket = SERVER_INVALID_SOCKET;
+static volatile sig_atomic_t g_server_stopping = 0;
+static DictionaryHandle* g_server_dictionary = NULL;
+
+/**
+ * Make room for at least extra more bytes plus a terminator
+ */
+static bool buffer_reserve(ServerBuffer* buffer, size_t extra) {
+    size_t needed = buffer->length + extra + 1;
+    if (needed <= buffer->capacity) {
+        return true;
+    }
+    
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : 1024;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    char* data = (char*)realloc(buffer->data, capacity);
+    if (data == NULL) {
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+/**
+ * Append bytes to a buffer
+ */
+static bool buffer_append(ServerBuffer* buffer, const char* data, size_t length) {
+    if (!buffer_reserve(buffer, length)) {
+        return false;
+    }
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+    return true;
+}
+
+/**
+ * Append a NUL-terminated string to a buffer
+ */
+static bool buffer_append_string(ServerBuffer* buffer, const char* text) {
+    return buffer_append(buffer, text, strlen(text));
+}
+
+/**
+ * Append printf-style formatted text to a buffer
+ */
+static bool buffer_append_format(ServerBuffer* buffer, const char* format, ...) {
+    char text[128];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0 || (size_t)length >= sizeof(text)) {
+        return false;
+    }
+    return buffer_append(buffer, text, (size_t)length);
+}
+
+/**
+ * Drop the first count bytes of a buffer, keeping the rest (pipelined data)
+ */
+static void buffer_consume(ServerBuffer* buffer, size_t count) {
+    if (count >= buffer->length) {
+        buffer->length = 0;
+    } else {
+        memmove(buffer->data, buffer->data + count, buffer->length - count);
+        buffer->length -= count;
+    }
+    if (buffer->data != NULL) {
+        buffer->data[buffer->length] = '\0';
+    }
+}
+
+/**
+ * Append a string as a quoted JSON string
+ */
+static bool json_append_string(ServerBuffer* buffer, const char* text) {
+    if (!buffer_append(buffer, "\"", 1)) {
+        return false;
+    }
+    
+    const char* run = text;
+    for (const char* p = text; ; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '\0' && c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        
+        // Flush the unescaped run before this character
+        if (!buffer_append(buffer, run, (size_t)(p - run))) {
+            return false;
+        }
+        if (c == '\0') {
+            break;
+        }
+        
+        bool ok;
+        if (c == '"') {
+            ok = buffer_append(buffer, "\\\"", 2);
+        } else if (c == '\\') {
+            ok = buffer_append(buffer, "\\\\", 2);
+        } else if (c == '\n') {
+            ok = buffer_append(buffer, "\\n", 2);
+        } else if (c == '\r') {
+            ok = buffer_append(buffer, "\\r", 2);
+        } else if (c == '\t') {
+            ok = buffer_append(buffer, "\\t", 2);
+        } else {
+            ok = buffer_append_format(buffer, "\\u%04x", c);
+        }
+        if (!ok) {
+            return false;
+        }
+        run = p + 1;
+    }
+    
+    return buffer_append(buffer, "\"", 1);
+}
+
+/**
+ * Skip JSON whitespace
+ */
+static void json_skip_space(JsonReader* reader) {
+    while (reader->pos < reader->end &&
+           (*reader->pos == ' ' || *reader->pos == '\t' || *reader->pos == '\n' || *reader->pos == '\r')) {
+        reader->pos++;
+    }
+}
+
+/**
+ * Consume one expected character after optional whitespace
+ */
+static bool json_expect(JsonReader* reader, char expected) {
+    json_skip_space(reader);
+    if (reader->pos < reader->end && *reader->pos == expected) {
+        reader->pos++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Read four hex digits of a \u escape
+ */
+static bool json_read_hex4(JsonReader* reader, unsigned int* value) {
+    if (reader->end - reader->pos < 4) {
+        return false;
+    }
+    
+    unsigned int result = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = *reader->pos++;
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= (unsigned int)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            result |= (unsigned int)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            result |= (unsigned int)(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    *value = result;
+    return true;
+}
+
+/**
+ * Append a Unicode code point encoded as UTF-8
+ */
+static bool append_utf8(ServerBuffer* buffer, unsigned int code_point) {
+    char bytes[4];
+    size_t length;
+    if (code_point < 0x80) {
+        // A NUL would end the text early; it separates words like a space
+        bytes[0] = code_point == 0 ? ' ' : (char)code_point;
+        length = 1;
+    } else if (code_point < 0x800) {
+        bytes[0] = (char)(0xC0 | (code_point >> 6));
+        bytes[1] = (char)(0x80 | (code_point & 0x3F));
+        length = 2;
+    } else if (code_point < 0x10000) {
+        bytes[0] = (char)(0xE0 | (code_point >> 12));
+        bytes[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+        bytes[2] = (char)(0x80 | (code_point & 0x3F));
+        length = 3;
+    } else {
+        bytes[0] = (char)(0xF0 | (code_point >> 18));
+        bytes[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+        bytes[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+        bytes[3] = (char)(0x80 | (code_point & 0x3F));
+        length = 4;
+    }
+    return buffer_append(buffer, bytes, length);
+}
+
+/**
+ * Read a JSON string, decoding escapes into out (NULL to skip it)
+ */
+static bool json_read_string(JsonReader* reader, ServerBuffer* out) {
+    if (!json_expect(reader, '"')) {
+        return false;
+    }
+    
+    while (reader->pos < reader->end) {
+        // Copy the run of plain characters in one step
+        const char* run = reader->pos;
+        while (reader->pos < reader->end && *reader->pos != '"' && *reader->pos != '\\' &&
+               (unsigned char)*reader->pos >= 0x20) {
+            reader->pos++;
+        }
+        if (out != NULL && !buffer_append(out, run, (size_t)(reader->pos - run))) {
+            return false;
+        }
+        if (reader->pos >= reader->end) {
+            break;
+        }
+        
+        char c = *reader->pos++;
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\' || reader->pos >= reader->end) {
+            return false;               // Raw control character or truncated escape
+        }
+        
+        char escape = *reader->pos++;
+        unsigned int code_point;
+        switch (escape) {
+            case '"':  code_point = '"'; break;
+            case '\\': code_point = '\\'; break;
+            case '/':  code_point = '/'; break;
+            case 'b':  code_point = '\b'; break;
+            case 'f':  code_point = '\f'; break;
+            case 'n':  code_point = '\n'; break;
+            case 'r':  code_point = '\r'; break;
+            case 't':  code_point = '\t'; break;
+            case 'u':
+                if (!json_read_hex4(reader, &code_point)) {
+                    return false;
+                }
+                // Combine a UTF-16 surrogate pair; lone surrogates become U+FFFD
+                if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                    unsigned int low;
+                    if (reader->end - reader->pos >= 6 && reader->pos[0] == '\\' && reader->pos[1] == 'u') {
+                        reader->pos += 2;
+                        if (!json_read_hex4(reader, &low)) {
+                            return false;
+                        }
+                        if (low >= 0xDC00 && low <= 0xDFFF) {
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        } else {
+                            code_point = 0xFFFD;
+                            reader->pos -= 6;   // Decode the second escape on its own
+                        }
+                    } else {
+                        code_point = 0xFFFD;
+                    }
+                } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+                    code_point = 0xFFFD;
+                }
+                break;
+            default:
+                return false;
+        }
+        if (out != NULL && !append_utf8(out, code_point)) {
+            return false;
+        }
+    }
+    
+    return false;                       // Unterminated string
+}
+
+/**
+ * Skip an exact literal (true, false or null)
+ */
+static bool json_skip_literal(JsonReader* reader, const char* literal) {
+    size_t length = strlen(literal);
+    if ((size_t)(reader->end - reader->pos) < length || memcmp(reader->pos, literal, length) != 0) {
+        return false;
+    }
+    reader->pos += length;
+    return true;
+}
+
+/**
+ * Skip a run of decimal digits, returning how many there were
+ */
+static size_t json_skip_digits(JsonReader* reader) {
+    const char* start = reader->pos;
+    while (reader->pos < reader->end && *reader->pos >= '0' && *reader->pos <= '9') {
+        reader->pos++;
+    }
+    return (size_t)(reader->pos - start);
+}
+
+/**
+ * Skip a number following the JSON grammar:
+ * -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+static bool json_skip_number(JsonReader* reader) {
+    if (reader->pos < reader->end && *reader->pos == '-') {
+        reader->pos++;
+    }
+    
+    // No leading zeros: "0" stands alone
+    if (reader->pos < reader->end && *reader->pos == '0') {
+        reader->pos++;
+    } else if (json_skip_digits(reader) == 0) {
+        return false;
+    }
+    
+    if (reader->pos < reader->end && *reader->pos == '.') {
+        reader->pos++;
+        if (json_skip_digits(reader) == 0) {
+            return false;
+        }
+    }
+    
+    if (reader->pos < reader->end && (*reader->pos == 'e' || *reader->pos == 'E')) {
+        reader->pos++;
+        if (reader->pos < reader->end && (*reader->pos == '+' || *reader->pos == '-')) {
+            reader->pos++;
+        }
+        if (json_skip_digits(reader) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Skip one JSON value of any type
+ */
+static bool json_skip_value(JsonReader* reader, int depth) {
+    if (depth > SERVER_MAX_JSON_DEPTH) {
+        return false;
+    }
+    
+    json_skip_space(reader);
+    if (reader->pos >= reader->end) {
+        return false;
+    }
+    
+    char c = *reader->pos;
+    if (c == '"') {
+        return json_read_string(reader, NULL);
+    }
+    
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        reader->pos++;
+        if (json_expect(reader, close)) {
+            return true;
+        }
+        do {
+            if (c == '{' && (!json_read_string(reader, NULL) || !json_expect(reader, ':'))) {
+                return false;
+            }
+            if (!json_skip_value(reader, depth + 1)) {
+                return false;
+            }
+        } while (json_expect(reader, ','));
+        return json_expect(reader, close);
+    }
+    
+    if (c == 't') {
+        return json_skip_literal(reader, "true");
+    }
+    if (c == 'f') {
+        return json_skip_literal(reader, "false");
+    }
+    if (c == 'n') {
+        return json_skip_literal(reader, "null");
+    }
+    return json_skip_number(reader);
+}
+
+/**
+ * Tokenize one decoded text and add it to a batch
+ */
+static bool batch_add_text(TextBatch* batch, const ServerBuffer* text) {
+    if (batch->count == batch->capacity) {
+        int capacity = batch->capacity > 0 ? batch->capacity * 2 : 4;
+        TextDocument** documents = (TextDocument**)realloc(batch->documents,
+                                                           (size_t)capacity * sizeof(TextDocument*));
+        if (documents == NULL) {
+            return false;
+        }
+        batch->documents = documents;
+        batch->capacity = capacity;
+    }
+    
+    TextDocument* doc = load_text_buffer(text->length > 0 ? text->data : "", text->length);
+    if (doc == NULL) {
+        return false;
+    }
+    batch->documents[batch->count++] = doc;
+    return true;
+}
+
+/**
+ * Free every document of a batch
+ */
+static void batch_free(TextBatch* batch) {
+    for (int i = 0; i < batch->count; i++) {
+        free_text_document(batch->documents[i]);
+    }
+    free(batch->documents);
+    batch->documents = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+/**
+ * Parse a /check body: an object with "texts" (array of strings) and/or
+ * "text" (string); other members are ignored
+ */
+static bool parse_check_request(const char* body, size_t length, TextBatch* batch) {
+    JsonReader reader = { body, body + length };
+    ServerBuffer key = { NULL, 0, 0 };
+    ServerBuffer text = { NULL, 0, 0 };
+    bool ok = json_expect(&reader, '{');
+    
+    if (ok && !json_expect(&reader, '}')) {
+        do {
+            key.length = 0;
+            ok = json_read_string(&reader, &key) && json_expect(&reader, ':');
+            if (!ok) {
+                break;
+            }
+            
+            json_skip_space(&reader);
+            bool is_text = key.length == 4 && memcmp(key.data, "text", 4) == 0;
+            bool is_texts = key.length == 5 && memcmp(key.data, "texts", 5) == 0;
+            if (is_text) {
+                text.length = 0;
+                ok = json_read_string(&reader, &text) && batch_add_text(batch, &text);
+            } else if (is_texts) {
+                ok = json_expect(&reader, '[');
+                if (ok && !json_expect(&reader, ']')) {
+                    do {
+                        text.length = 0;
+                        ok = json_read_string(&reader, &text) && batch_add_text(batch, &text);
+                    } while (ok && json_expect(&reader, ','));
+                    ok = ok && json_expect(&reader, ']');
+                }
+            } else {
+                ok = json_skip_value(&reader, 1);
+            }
+        } while (ok && json_expect(&reader, ','));
+        ok = ok && json_expect(&reader, '}');
+    }
+    
+    json_skip_space(&reader);
+    ok = ok && reader.pos == reader.end;
+    
+    free(key.data);
+    free(text.data);
+    return ok;
+}
+
+/**
+ * Append one document's spell check result as a JSON object
+ */
+static bool append_check_result(ServerBuffer* out, const SpellCheckResult* result) {
+    if (!buffer_append_format(out, "{\"words_checked\":%d,\"error_count\":%d,\"errors\":[",
+                              result->total_words_checked, result->error_count)) {
+        return false;
+    }
+    
+    for (int i = 0; i < result->error_count; i++) {
+        const SpellError* error = &result->errors[i];
+        bool ok = (i == 0 || buffer_append(out, ",", 1)) &&
+                  buffer_append_string(out, "{\"word\":") &&
+                  json_append_string(out, error->misspelled_word) &&
+                  buffer_append_string(out, ",\"original\":") &&
+                  json_append_string(out, error->original_word) &&
+                  (!error->context_error || buffer_append_string(out, ",\"context\":true")) &&
+                  buffer_append_format(out, ",\"line\":%d,\"position\":%d,\"suggestions\":[",
+                                       error->line_number, error->position);
+        for (int j = 0; ok && j < error->suggestion_count; j++) {
+            float score = error->suggestion_scores ? error->suggestion_scores[j] : 0.0f;
+            ok = (j == 0 || buffer_append(out, ",", 1)) &&
+                 buffer_append_string(out, "{\"word\":") &&
+                 json_append_string(out, error->suggestions[j]) &&
+                 buffer_append_format(out, ",\"score\":%.3f}", score);
+        }
+        if (!ok || !buffer_append(out, "]}", 2)) {
+            return false;
+        }
+    }
+    
+    return buffer_append(out, "]}", 2);
+}
+
+/**
+ * Write an {"error": message} body
+ */
+static void set_error_body(ServerBuffer* out, const char* message) {
+    out->length = 0;
+    if (!buffer_append_string(out, "{\"error\":") || !json_append_string(out, message) ||
+        !buffer_append(out, "}", 1)) {
+        out->length = 0;
+    }
+}
+
+/**
+ * Handle POST /check
+ * @return HTTP status code; out holds the response body
+ */
+static int handle_check(ServerWorker* worker, const char* body, size_t length, ServerBuffer* out) {
+    TextBatch batch = { NULL, 0, 0 };
+    if (!parse_check_request(body, length, &batch)) {
+        batch_free(&batch);
+        set_error_body(out, "Request body must be a JSON object with a \"texts\" array of strings");
+        return 400;
+    }
+    
+    // Check the whole batch against one dictionary version
+    int status = 200;
+    Trie* dictionary = dictionary_read_begin(worker->reader);
+    bool ok = buffer_append_format(out, "{\"generation\":%lu,\"results\":[",
+                                   dictionary_read_generation(worker->reader));
+    for (int i = 0; ok && i < batch.count; i++) {
+        SpellCheckResult* result = spell_check_document(batch.documents[i], dictionary);
+        ok = result != NULL && (i == 0 || buffer_append(out, ",", 1)) && append_check_result(out, result);
+        free_spell_check_result(result);
+    }
+    dictionary_read_end(worker->reader);
+    
+    if (!ok || !buffer_append(out, "]}", 2)) {
+        set_error_body(out, "Spell check failed");
+        status = 500;
+    }
+    
+    batch_free(&batch);
+    return status;
+}
+
+/**
+ * Route one complete request
+ * @return HTTP status code; out holds the response body (empty for none)
+ */
+static int handle_request(ServerWorker* worker, const HttpRequest* request, const char* body, ServerBuffer* out) {
+    bool is_get = strcmp(request->method, "GET") == 0;
+    bool is_post = strcmp(request->method, "POST") == 0;
+    
+    // CORS preflight: the allow headers are sent with every response
+    if (strcmp(request->method, "OPTIONS") == 0) {
+        return 204;
+    }
+    
+    if (strcmp(request->path, "/check") == 0) {
+        if (!is_post) {
+            set_error_body(out, "Use POST for /check");
+            return 405;
+        }
+        return handle_check(worker, body, request->content_length, out);
+    }
+    
+    if (strcmp(request->path, "/health") == 0) {
+        if (!is_get) {
+            set_error_body(out, "Use GET for /health");
+            return 405;
+        }
+        buffer_append_format(out, "{\"status\":\"ok\",\"generation\":%lu}",
+                             dictionary_handle_generation(g_server_dictionary));
+        return 200;
+    }
+    
+    if (strcmp(request->path, "/reload") == 0) {
+        if (!is_post) {
+            set_error_body(out, "Use POST for /reload");
+            return 405;
+        }
+        dictionary_handle_request_reload(g_server_dictionary);
+        buffer_append_format(out, "{\"status\":\"reload requested\",\"generation\":%lu}",
+                             dictionary_handle_generation(g_server_dictionary));
+        return 202;
+    }
+    
+    set_error_body(out, "Unknown endpoint (use /check, /health or /reload)");
+    return 404;
+}
+
+/**
+ * Get the reason phrase of a status code
+ */
+static const char* status_reason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        default:  return "Internal Server Error";
+    }
+}
+
+/**
+ * Send every byte of a buffer
+ */
+static bool send_all(server_socket_t client, const char* data, size_t length) {
+    while (length > 0) {
+        int chunk = length > 65536 ? 65536 : (int)length;
+        int sent = (int)send(client, data, chunk, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+/**
+ * Send a complete response with a JSON body
+ */
+static bool send_response(server_socket_t client, int status, const ServerBuffer* body, bool keep_alive) {
+    size_t body_length = body != NULL ? body->length : 0;
+    char head[512];
+    int head_length = snprintf(head, sizeof(head),
+                               "HTTP/1.1 %d %s\r\n"
+                               "Content-Type: application/json\r\n"
+                               "Content-Length: %lu\r\n"
+                               "Access-Control-Allow-Origin: *\r\n"
+                               "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                               "Access-Control-Allow-Headers: Content-Type\r\n"
+                               "Connection: %s\r\n"
+                               "\r\n",
+                               status, status_reason(status), (unsigned long)body_length,
+                               keep_alive ? "keep-alive" : "close");
+    
+    return send_all(client, head, (size_t)head_length) &&
+           (body_length == 0 || send_all(client, body->data, body_length));
+}
+
+/**
+ * Send an error response with an {"error": message} body
+ */
+static void send_error(server_socket_t client, int status, const char* message) {
+    ServerBuffer body = { NULL, 0, 0 };
+    set_error_body(&body, message);
+    send_response(client, status, &body, false);
+    free(body.data);
+}
+
+/**
+ * Read more bytes from a connection into a buffer
+ * @return false when the peer closed, timed out or failed
+ */
+static bool receive_more(server_socket_t client, ServerBuffer* buffer) {
+    if (!buffer_reserve(buffer, SERVER_READ_CHUNK)) {
+        return false;
+    }
+    
+    for (;;) {
+        int received = (int)recv(client, buffer->data + buffer->length, SERVER_READ_CHUNK, 0);
+        if (received > 0) {
+            buffer->length += (size_t)received;
+            buffer->data[buffer->length] = '\0';
+            return true;
+        }
+#ifndef _WIN32
+        if (received < 0 && errno == EINTR && !g_server_stopping) {
+            continue;
+        }
+#endif
+        return false;
+    }
+}
+
+/**
+ * Find the blank line ending the headers
+ * @return Offset just past it, or 0 if not received yet
+ */
+static size_t find_header_end(const ServerBuffer* buffer) {
+    for (size_t i = 0; i + 3 < buffer->length; i++) {
+        if (buffer->data[i] == '\r' && buffer->data[i + 1] == '\n' &&
+            buffer->data[i + 2] == '\r' && buffer->data[i + 3] == '\n') {
+            return i + 4;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Compare a header line's name case-insensitively
+ * @return Pointer to the value (leading spaces skipped), or NULL if the name differs
+ */
+static const char* header_value(const char* line, const char* line_end, const char* name) {
+    size_t name_length = strlen(name);
+    if ((size_t)(line_end - line) <= name_length || line[name_length] != ':') {
+        return NULL;
+    }
+    for (size_t i = 0; i < name_length; i++) {
+        char c = line[i];
+        if (c >= 'A' && c <= 'Z') {
+            c = (char)(c - 'A' + 'a');
+        }
+        if (c != name[i]) {
+            return NULL;
+        }
+    }
+    
+    const char* value = line + name_length + 1;
+    while (value < line_end && (*value == ' ' || *value == '\t')) {
+        value++;
+    }
+    return value;
+}
+
+/**
+ * Check whether a header value contains a token, ignoring case
+ */
+static bool value_has_token(const char* value, const char* value_end, const char* token) {
+    size_t token_length = strlen(token);
+    for (const char* p = value; p + token_length <= value_end; p++) {
+        size_t i = 0;
+        while (i < token_length) {
+            char c = p[i];
+            if (c >= 'A' && c <= 'Z') {
+                c = (char)(c - 'A' + 'a');
+            }
+            if (c != token[i]) {
+                break;
+            }
+            i++;
+        }
+        if (i == token_length) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Parse the request line and headers
+ * @return 0 on success, otherwise the HTTP status to reject the request with
+ */
+static int parse_request_head(const char* data, size_t header_length, HttpRequest* request) {
+    memset(request, 0, sizeof(HttpRequest));
+    request->header_length = header_length;
+    
+    // Headers are text; a NUL would also end the line searches early
+    if (memchr(data, '\0', header_length) != NULL) {
+        return 400;
+    }
+    
+    const char* end = data + header_length;
+    const char* line_end = strstr(data, "\r\n");
+    
+    // Request line: METHOD SP TARGET SP VERSION
+    const char* space = memchr(data, ' ', (size_t)(line_end - data));
+    if (space == NULL || space == data || (size_t)(space - data) >= sizeof(request->method)) {
+        return 400;
+    }
+    memcpy(request->method, data, (size_t)(space - data));
+    
+    const char* target = space + 1;
+    const char* target_end = memchr(target, ' ', (size_t)(line_end - target));
+    if (target_end == NULL) {
+        return 400;
+    }
+    const char* query = memchr(target, '?', (size_t)(target_end - target));
+    const char* path_end = query != NULL ? query : target_end;
+    if ((size_t)(path_end - target) >= sizeof(request->path)) {
+        return 404;
+    }
+    memcpy(request->path, target, (size_t)(path_end - target));
+    
+    const char* version = target_end + 1;
+    if (line_end - version != 8 || strncmp(version, "HTTP/1.", 7) != 0) {
+        return 400;
+    }
+    request->keep_alive = version[7] != '0';   // HTTP/1.1 defaults to keep-alive, 1.0 to close
+    
+    for (const char* line = line_end + 2; line < end - 2; line = line_end + 2) {
+        line_end = strstr(line, "\r\n");
+        const char* value;
+        if ((value = header_value(line, line_end, "content-length")) != NULL) {
+            char* number_end;
+            errno = 0;
+            unsigned long length = strtoul(value, &number_end, 10);
+            if (number_end == value || errno != 0) {
+                return 400;
+            }
+            request->content_length = length > SERVER_MAX_BODY_BYTES ? SERVER_MAX_BODY_BYTES + 1 : (size_t)length;
+        } else if ((value = header_value(line, line_end, "transfer-encoding")) != NULL) {
+            return 411;
+        } else if ((value = header_value(line, line_end, "connection")) != NULL) {
+            if (value_has_token(value, line_end, "close")) {
+                request->keep_alive = false;
+            } else if (value_has_token(value, line_end, "keep-alive")) {
+                request->keep_alive = true;
+            }
+        } else if ((value = header_value(line, line_end, "expect")) != NULL) {
+            request->expect_continue = value_has_token(value, line_end, "100-continue");
+        }
+    }
+    
+    if (request->content_length > SERVER_MAX_BODY_BYTES) {
+        return 413;
+    }
+    return 0;
+}
+
+/**
+ * Serve requests on one connection until it closes, errs or idles out
+ */
+static void serve_connection(ServerWorker* worker, server_socket_t client) {
+    ServerBuffer input = { NULL, 0, 0 };
+    ServerBuffer output = { NULL, 0, 0 };
+    
+    while (!g_server_stopping) {
+        // Headers
+        size_t header_length;
+        while ((header_length = find_header_end(&input)) == 0) {
+            if (input.length > SERVER_MAX_HEADER_BYTES) {
+                send_error(client, 431, "Request headers too large");
+                goto done;
+            }
+            if (!receive_more(client, &input)) {
+                goto done;
+            }
+        }
+        
+        HttpRequest request;
+        int status = parse_request_head(input.data, header_length, &request);
+        if (status != 0) {
+            send_error(client, status, status == 413 ? "Request body too large" :
+                                       status == 411 ? "Chunked bodies are not supported, send Content-Length" :
+                                       "Malformed request");
+            goto done;
+        }
+        
+        // Body
+        if (request.expect_continue && input.length < header_length + request.content_length) {
+            const char* go_ahead = "HTTP/1.1 100 Continue\r\n\r\n";
+            if (!send_all(client, go_ahead, strlen(go_ahead))) {
+                goto done;
+            }
+        }
+        while (input.length < header_length + request.content_length) {
+            if (!receive_more(client, &input)) {
+                goto done;
+            }
+        }
+        
+        output.length = 0;
+        status = handle_request(worker, &request, input.data + header_length, &output);
+        bool keep_alive = request.keep_alive && !g_server_stopping;
+        if (!send_response(client, status, &output, keep_alive) || !keep_alive) {
+            goto done;
+        }
+        
+        buffer_consume(&input, header_length + request.content_length);
+    }
+
+done:
+    free(input.data);
+    free(output.data);
+}
+
+/**
+ * Limit how long a connection may stay silent
+ */
+static void set_receive_timeout(server_socket_t client, int seconds) {
+#ifdef _WIN32
+    DWORD timeout = (DWORD)seconds * 1000;
+#else
+    struct timeval timeout;
+    timeout.tv_sec = seconds;
+    timeout.tv_usec = 0;
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+}
+
+/**
+ * Worker thread: accept and serve connections until the server stops
+ */
+static void* server_worker(void* arg) {
+    ServerWorker* worker = (ServerWorker*)arg;
+    
+    while (!g_server_stopping) {
+        server_socket_t client = accept(g_server_socket, NULL, NULL);
+        if (client == SERVER_INVALID_SOCKET) {
+            if (g_server_stopping) {
+                break;
+            }
+            continue;                   // Aborted handshake or interrupted call
+        }
+        
+        set_receive_timeout(client, SERVER_IDLE_TIMEOUT_SECONDS);
+        serve_connection(worker, client);
+        server_close_socket(client);
+    }
+    
+    return NULL;
+}
+
+/**
+ * Signal handler for SIGINT/SIGTERM
+ */
+static void server_signal_handler(int signal_number) {
+    (void)signal_number;
+    server_stop();
+}
+
+/**
+ * Create the listening socket
+ * @return Socket, or SERVER_INVALID_SOCKET on error
+ */
+static server_socket_t open_listener(const char* bind_address, int port) {
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((unsigned short)port);
+    address.sin_addr.s_addr = inet_addr(bind_address);
+    if (address.sin_addr.s_addr == INADDR_NONE && strcmp(bind_address, "255.255.255.255") != 0) {
+        fprintf(stderr, "Error: Invalid bind address '%s' (expected an IPv4 address)\n", bind_address);
+        return SERVER_INVALID_SOCKET;
+    }
+    
+    server_socket_t listener = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener == SERVER_INVALID_SOCKET) {
+        fprintf(stderr, "Error: Failed to create server socket\n");
+        return SERVER_INVALID_SOCKET;
+    }
+    
+    // Allow an immediate restart while old connections linger in TIME_WAIT
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+    
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s:%d (address in use or not permitted)\n", bind_address, port);
+        server_close_socket(listener);
+        return SERVER_INVALID_SOCKET;
+    }
+    
+    return listener;
+}
+
+bool server_run(const ServerConfig* config) {
+    if (config == NULL || config->dictionary == NULL) {
+        fprintf(stderr, "Error: Invalid parameters - server needs a dictionary\n");
+        return false;
+    }
+    if (config->port < 1 || config->port > 65535) {
+        fprintf(stderr, "Error: Invalid port %d (expected 1-65535)\n", config->port);
+        return false;
+    }
+    if (config->thread_count < 1 || config->thread_count > SERVER_MAX_THREADS) {
+        fprintf(stderr, "Error: Invalid thread count %d (expected 1-%d)\n", config->thread_count, SERVER_MAX_THREADS);
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        fprintf(stderr, "Error: Failed to initialize Winsock\n");
+        return false;
+    }
+#endif
+    
+    const char* bind_address = config->bind_address ? config->bind_address : "127.0.0.1";
+    g_server_stopping = 0;
+    g_server_dictionary = config->dictionary;
+    g_server_socket = open_listener(bind_address, config->port);
+    if (g_server_socket == SERVER_INVALID_SOCKET) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    
+    // Stop cleanly on Ctrl+C; a client hanging up must not kill the process
+#ifdef _WIN32
+    void (*previous_int)(int) = signal(SIGINT, server_signal_handler);
+    void (*previous_term)(int) = signal(SIGTERM, server_signal_handler);
+#else
+    struct sigaction action, previous_int, previous_term, previous_pipe;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = server_signal_handler;
+    sigaction(SIGINT, &action, &previous_int);
+    sigaction(SIGTERM, &action, &previous_term);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, &previous_pipe);
+#endif
+    
+    ServerWorker* workers = (ServerWorker*)calloc((size_t)config->thread_count, sizeof(ServerWorker));
+    int started = 0;
+    bool ok = workers != NULL;
+    for (int i = 0; ok && i < config->thread_count; i++) {
+        workers[i].reader = dictionary_reader_register(config->dictionary);
+        if (workers[i].reader == NULL) {
+            ok = false;
+        } else if (pthread_create(&workers[i].thread, NULL, server_worker, &workers[i]) != 0) {
+            fprintf(stderr, "Error: Failed to start server worker thread\n");
+            dictionary_reader_unregister(workers[i].reader);
+            ok = false;
+        } else {
+            started++;
+        }
+    }
+    
+    if (ok) {
+        printf("Serving spell checks on http://%s:%d (%d threads, Ctrl+C to stop)\n",
+               bind_address, config->port, config->thread_count);
+        fflush(stdout);
+    } else {
+        server_stop();
+    }
+    
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        dictionary_reader_unregister(workers[i].reader);
+    }
+    free(workers);
+    
+    if (g_server_socket != SERVER_INVALID_SOCKET) {
+        server_close_socket(g_server_socket);
+        g_server_socket = SERVER_INVALID_SOCKET;
+    }
+    g_server_dictionary = NULL;
+
+#ifdef _WIN32
+    signal(SIGINT, previous_int);
+    signal(SIGTERM, previous_term);
+    WSACleanup();
+#else
+    sigaction(SIGINT, &previous_int, NULL);
+    sigaction(SIGTERM, &previous_term, NULL);
+    sigaction(SIGPIPE, &previous_pipe, NULL);
+#endif
+    
+    if (ok) {
+        printf("Server stopped\n");
+    }
+    return ok;
+}
+
+void server_stop(void) {
+    g_server_stopping = 1;
+    
+    // Wakes every worker blocked in accept()
+    server_socket_t listener = g_server_socket;
+    if (listener != SERVER_INVALID_SOCKET) {
+#ifdef _WIN32
+        g_server_socket = SERVER_INVALID_SOCKET;
+        closesocket(listener);
+#else
+        shutdown(listener, SHUT_RDWR);
+#endif
+    }
+}
@@ -1,10 +1,100 @@
 #include "spell_check.h"
 #include "edit_distance.h"
 #include "api_client.h"
+#include "symspell.h"
+#include "length_index.h"
+#include "memory_budget.h"
+#include "profile.h"
+#include "timing.h"
+#include "utf8.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <pthread.h>
+
+/**
+ * Suggestion limits: at most MAX_SUGGESTIONS words within
+ * MAX_SUGGESTION_DISTANCE edits of the misspelling
+ */
+#define MAX_SUGGESTIONS 5
+#define MAX_SUGGESTION_DISTANCE 2
+
+/**
+ * Initial capacity of the candidate buffer, and its growth factor. Every
+ * dictionary word within MAX_SUGGESTION_DISTANCE is ranked: a lookup that
+ * fills the buffer may have dropped words, so it is repeated with a larger
+ * one. Growing steeply keeps dense neighborhoods (short words) to one retry.
+ */
+#define SUGGESTION_CANDIDATES 64
+#define SUGGESTION_CANDIDATE_GROWTH 8
+
+/**
+ * Ranking bonus per doubling of a word's frequency, and its cap. The cap
+ * stays below EDIT_COST_DEFAULT, so frequency reorders words of similar
+ * cost but never outweighs a whole extra edit.
+ */
+#define SUGGESTION_FREQUENCY_BONUS 0.05f
+#define SUGGESTION_MAX_FREQUENCY_BONUS 0.5f
+
+/**
+ * Context checking limits: words shorter than CONTEXT_MIN_WORD_LENGTH
+ * ("a", "an", "as") have neighbors that fit almost any context, and longer
+ * than CONTEXT_MAX_WORD_LENGTH rarely have a dictionary neighbor at all.
+ * At most CONTEXT_MAX_NEIGHBORS neighbors, the most frequent in the model,
+ * are scored per word.
+ */
+#define CONTEXT_MIN_WORD_LENGTH 3
+#define CONTEXT_MAX_WORD_LENGTH 24
+#define CONTEXT_MAX_NEIGHBORS 8
+
+/**
+ * Distinct one-edit changes of the longest checked word: a delete, a
+ * transpose and 25 substitutions per letter, and 26 inserts per gap
+ */
+#define CONTEXT_MAX_EDITS (CONTEXT_MAX_WORD_LENGTH * 27 + (CONTEXT_MAX_WORD_LENGTH + 1) * 26)
+
+/**
+ * How many times, as a log2, a neighbor must make its context more likely
+ * than the word itself before the word is reported: the prior odds that
+ * a dictionary word is the one the writer meant
+ */
+#define CONTEXT_MIN_LOG2_RATIO 7.0f
+
+/**
+ * Words whose bigrams with the words (or sentence boundaries) on both
+ * sides were each seen more than 2^CONTEXT_SCREEN_LOG2_COUNT times are
+ * taken as fitting their context, and neither their neighbors nor any
+ * window is scored for them. A word the writer did not mean rarely
+ * forms a common bigram on both sides, and most words of clean text do.
+ */
+#define CONTEXT_SCREEN_LOG2_COUNT 1.0f
+
+/**
+ * Windows (a neighbor in the context of a word) bounded and scored per
+ * flush of a batch, and dictionary edits of a word looked up in the model
+ * per call to ngram_model_lookup_batch()
+ */
+#define CONTEXT_SCORE_BATCH 64
+#define CONTEXT_EDIT_BATCH 256
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CONTEXT_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define CONTEXT_PREFETCH(address) ((void)(address))
+#endif
+
+// Selected suggestion engine and the dictionary its index was built from
+static SuggestionEngine g_engine = SUGGESTION_ENGINE_TRIE;
+static SymSpellIndex* g_symspell = NULL;
+static const Trie* g_symspell_dictionary = NULL;
+static LengthIndex* g_length_index = NULL;
+static const Trie* g_length_index_dictionary = NULL;
+
+// Per-word status lines of API validation are printed unless quiet
+static bool g_quiet = false;
+
+// N-gram model dictionary words are checked against, if any
+static const NgramModel* g_context_model = NULL;
 
 /**
  * Safe string duplication function
@@ -15,30 +105,29 @@ static char* safe_strdup(const char* str) {
     size_t len = strlen(str) + 1;
     char* copy = malloc(len);
     if (copy) {
+        PROFILE_ALLOCATION(len);
         memcpy(copy, str, len);
     }
     return copy;
 }
 
 /**
- * Helper function to check if a character is alphabetic
- */
-static bool is_alpha_char(char c) {
-    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
-}
-
-/**
- * Helper function to check if a word contains only alphabetic characters
+ * Helper function to check if a word contains only letters (UTF-8)
  */
 static bool is_alphabetic_word(const char* word) {
     if (!word || strlen(word) == 0) {
         return false;
     }
     
-    for (int i = 0; word[i] != '\0'; i++) {
-        if (!is_alpha_char(word[i])) {
+    size_t len = strlen(word);
+    for (size_t i = 0; i < len; ) {
+        // ASCII needs no decoding
+        uint32_t code_point = (unsigned char)word[i];
+        size_t sequence = (code_point < 0x80) ? 1 : utf8_decode(word + i, len - i, &code_point);
+        if (sequence == 0 || !utf8_is_letter(code_point)) {
             return false;
         }
+        i += sequence;
     }
     return true;
 }
@@ -52,7 +141,9 @@ bool is_likely_proper_noun(const char* word, const TextToken* token) {
     }
     
     // If original word starts with uppercase and rest is lowercase
-    if (isupper(token->original_word[0])) {
+    const char* original = token->original_word;
+    uint32_t first;
+    if (utf8_decode(original, strlen(original), &first) > 0 && utf8_to_lower(first) != first) {
         // Skip if it's at the beginning of a sentence
         if (token->position == 0) {
             return false;
@@ -64,240 +155,2704 @@ bool is_likely_proper_noun(const char* word, const TextToken* token) {
 }
 
 /**
- * Generate suggestions using edit distance
+ * Select the suggestion engine, building its index and freeing any other
+ */
+bool set_suggestion_engine(SuggestionEngine engine, Trie* dictionary) {
+    if (engine == SUGGESTION_ENGINE_SYMSPELL) {
+        if (!dictionary) {
+            return false;
+        }
+        
+        SymSpellIndex* index = symspell_build(dictionary, MAX_SUGGESTION_DISTANCE);
+        if (!index) {
+            return false;
+        }
+        
+        memory_release(MEMORY_COMPONENT_INDEX, symspell_get_memory_usage(g_symspell));
+        symspell_destroy(g_symspell);
+        memory_charge(MEMORY_COMPONENT_INDEX, symspell_get_memory_usage(index));
+        g_symspell = index;
+        g_symspell_dictionary = dictionary;
+    } else {
+        memory_release(MEMORY_COMPONENT_INDEX, symspell_get_memory_usage(g_symspell));
+        symspell_destroy(g_symspell);
+        g_symspell = NULL;
+        g_symspell_dictionary = NULL;
+    }
+    
+    if (engine == SUGGESTION_ENGINE_SCAN) {
+        if (!dictionary) {
+            return false;
+        }
+        
+        LengthIndex* index = length_index_build(dictionary);
+        if (!index) {
+            return false;
+        }
+        
+        memory_release(MEMORY_COMPONENT_INDEX, length_index_get_memory_usage(g_length_index));
+        length_index_destroy(g_length_index);
+        memory_charge(MEMORY_COMPONENT_INDEX, length_index_get_memory_usage(index));
+        g_length_index = index;
+        g_length_index_dictionary = dictionary;
+    } else {
+        memory_release(MEMORY_COMPONENT_INDEX, length_index_get_memory_usage(g_length_index));
+        length_index_destroy(g_length_index);
+        g_length_index = NULL;
+        g_length_index_dictionary = NULL;
+    }
+    
+    g_engine = engine;
+    return true;
+}
+
+/**
+ * Suppress or restore the per-word API status lines and loader progress
+ */
+void set_spell_check_quiet(bool quiet) {
+    g_quiet = quiet;
+    api_client_set_quiet(quiet);
+    file_io_set_quiet(quiet);
+}
+
+/**
+ * Check dictionary words against their context with model (NULL to stop)
+ */
+void set_context_model(const NgramModel* model) {
+    g_context_model = model;
+}
+
+/**
+ * Get the suggestion engine currently in use
+ */
+SuggestionEngine get_suggestion_engine(void) {
+    return g_engine;
+}
+
+/**
+ * Get the memory used by the suggestion engine's index
+ */
+size_t get_suggestion_engine_memory(void) {
+    return symspell_get_memory_usage(g_symspell) + length_index_get_memory_usage(g_length_index);
+}
+
+/**
+ * A candidate being ranked: lower score wins, then lower order (the
+ * engine's closest-first, alphabetical order)
+ */
+typedef struct RankedCandidate {
+    const TrieMatch* match;     // Candidate word
+    float score;                // Ranking cost
+    int order;                  // Position in the engine's result list
+} RankedCandidate;
+
+/**
+ * Whether candidate a ranks below (is worse than) candidate b
+ */
+static bool ranks_below(const RankedCandidate* a, const RankedCandidate* b) {
+    if (a->score != b->score) {
+        return a->score > b->score;
+    }
+    return a->order > b->order;
+}
+
+/**
+ * Restore the heap order below slot index of a heap whose root is its
+ * worst candidate
+ */
+static void heap_sift_down(RankedCandidate* heap, int size, int index) {
+    for (;;) {
+        int worst = index;
+        int left = 2 * index + 1;
+        int right = left + 1;
+        if (left < size && ranks_below(&heap[left], &heap[worst])) worst = left;
+        if (right < size && ranks_below(&heap[right], &heap[worst])) worst = right;
+        if (worst == index) {
+            return;
+        }
+        
+        RankedCandidate temp = heap[index];
+        heap[index] = heap[worst];
+        heap[worst] = temp;
+        index = worst;
+    }
+}
+
+/**
+ * Ranking cost of a candidate: weighted edit cost (banded by the candidate's
+ * edit distance) minus a frequency bonus of SUGGESTION_FREQUENCY_BONUS per
+ * doubling beyond frequency 1
+ */
+static float suggestion_score(const char* misspelled_word, const TrieMatch* match) {
+    float bonus = 0.0f;
+    for (unsigned int frequency = (unsigned int)match->frequency; frequency > 1; frequency >>= 1) {
+        bonus += SUGGESTION_FREQUENCY_BONUS;
+    }
+    if (bonus > SUGGESTION_MAX_FREQUENCY_BONUS) {
+        bonus = SUGGESTION_MAX_FREQUENCY_BONUS;
+    }
+    return compute_weighted_distance_bounded(misspelled_word, match->word, match->distance) - bonus;
+}
+
+/**
+ * Look up the dictionary words within MAX_SUGGESTION_DISTANCE of a word with
+ * the selected engine
+ */
+static int lookup_candidates(const char* misspelled_word, Trie* dictionary, TrieMatch* matches, int capacity) {
+    if (g_symspell && g_symspell_dictionary == dictionary) {
+        return symspell_lookup(g_symspell, misspelled_word, MAX_SUGGESTION_DISTANCE, matches, capacity);
+    }
+    if (g_length_index && g_length_index_dictionary == dictionary) {
+        return length_index_lookup(g_length_index, misspelled_word, MAX_SUGGESTION_DISTANCE, matches, capacity);
+    }
+    return trie_fuzzy_search(dictionary, misspelled_word, MAX_SUGGESTION_DISTANCE, matches, capacity);
+}
+
+/**
+ * Generate suggestions within a bounded edit distance, using the selected engine
  */
 char** generate_suggestions(const char* misspelled_word, Trie* dictionary, int* count) {
+    return generate_ranked_suggestions(misspelled_word, dictionary, count, NULL);
+}
+
+char** generate_ranked_suggestions(const char* misspelled_word, Trie* dictionary, int* count,
+                                   float** scores) {
+    if (scores) {
+        *scores = NULL;
+    }
     if (!misspelled_word || !dictionary || !count) {
         return NULL;
     }
     
     *count = 0;
     
-    // Get all words from dictionary
-    char** all_words;
-    int total_words;
-    trie_get_all_words(dictionary, &all_words, &total_words);
+    // Engines keep only the closest words once their buffer is full, which
+    // would cut the pool by Levenshtein distance before the weighted ranking
+    // sees it, so grow the buffer until every word within the bound fits
+    TrieMatch local_matches[SUGGESTION_CANDIDATES];
+    TrieMatch* matches = local_matches;
+    int capacity = SUGGESTION_CANDIDATES;
+    int match_count = lookup_candidates(misspelled_word, dictionary, matches, capacity);
+    while (match_count == capacity) {
+        TrieMatch* larger = malloc((size_t)capacity * SUGGESTION_CANDIDATE_GROWTH * sizeof(TrieMatch));
+        if (!larger) {
+            break; // Rank the closest words already found
+        }
+        PROFILE_ALLOCATION((size_t)capacity * SUGGESTION_CANDIDATE_GROWTH * sizeof(TrieMatch));
+        if (matches != local_matches) {
+            free(matches);
+        }
+        matches = larger;
+        capacity *= SUGGESTION_CANDIDATE_GROWTH;
+        match_count = lookup_candidates(misspelled_word, dictionary, matches, capacity);
+    }
     
-    if (!all_words || total_words == 0) {
-        return NULL;
+    // Keep the best MAX_SUGGESTIONS in a bounded heap rooted at the worst
+    RankedCandidate heap[MAX_SUGGESTIONS];
+    int heap_size = 0;
+    for (int i = 0; i < match_count; i++) {
+        if (matches[i].distance == 0) {
+            continue; // Exclude exact matches
+        }
+        
+        RankedCandidate candidate = { &matches[i], suggestion_score(misspelled_word, &matches[i]), i };
+        if (heap_size < MAX_SUGGESTIONS) {
+            // Sift up
+            int index = heap_size++;
+            heap[index] = candidate;
+            while (index > 0 && ranks_below(&heap[index], &heap[(index - 1) / 2])) {
+                RankedCandidate temp = heap[index];
+                heap[index] = heap[(index - 1) / 2];
+                heap[(index - 1) / 2] = temp;
+                index = (index - 1) / 2;
+            }
+        } else if (ranks_below(&heap[0], &candidate)) {
+            heap[0] = candidate;
+            heap_sift_down(heap, heap_size, 0);
+        }
     }
     
-    // Structure to hold word-distance pairs for sorting
-    typedef struct {
-        char* word;
-        int distance;
-    } WordDistance;
+    if (heap_size == 0) {
+        if (matches != local_matches) {
+            free(matches);
+        }
+        return NULL;
+    }
     
-    WordDistance* candidates = malloc(total_words * sizeof(WordDistance));
-    if (!candidates) {
-        // Free all_words
-        for (int i = 0; i < total_words; i++) {
-            free(all_words[i]);
+    char** suggestions = malloc(heap_size * sizeof(char*));
+    float* ranked_scores = malloc(heap_size * sizeof(float));
+    if (!suggestions || !ranked_scores) {
+        free(suggestions);
+        free(ranked_scores);
+        if (matches != local_matches) {
+            free(matches);
         }
-        free(all_words);
         return NULL;
     }
+    PROFILE_ALLOCATION(heap_size * sizeof(char*));
+    PROFILE_ALLOCATION(heap_size * sizeof(float));
     
-    int candidate_count = 0;
+    // Popping the worst candidate first fills the arrays from the back
+    int suggestion_count = heap_size;
+    for (int slot = heap_size - 1; slot >= 0; slot--) {
+        suggestions[slot] = safe_strdup(heap[0].match->word);
+        ranked_scores[slot] = heap[0].score;
+        heap[0] = heap[--heap_size];
+        heap_sift_down(heap, heap_size, 0);
+    }
+    if (matches != local_matches) {
+        free(matches);
+    }
     
-    // Find words with edit distance <= 2
-    for (int i = 0; i < total_words; i++) {
-        int distance = compute_edit_distance(misspelled_word, all_words[i]);
-        if (distance <= 2 && distance > 0) { // distance > 0 to exclude exact matches
-            candidates[candidate_count].word = safe_strdup(all_words[i]);
-            candidates[candidate_count].distance = distance;
-            candidate_count++;
+    // Drop any suggestion whose copy failed, keeping the order
+    int kept = 0;
+    for (int i = 0; i < suggestion_count; i++) {
+        if (suggestions[i]) {
+            suggestions[kept] = suggestions[i];
+            ranked_scores[kept] = ranked_scores[i];
+            kept++;
         }
     }
     
-    // Free all_words as we've copied what we need
-    for (int i = 0; i < total_words; i++) {
-        free(all_words[i]);
+    if (kept == 0) {
+        free(suggestions);
+        free(ranked_scores);
+        return NULL;
     }
-    free(all_words);
     
-    if (candidate_count == 0) {
-        free(candidates);
-        return NULL;
+    *count = kept;
+    if (scores) {
+        *scores = ranked_scores;
+    } else {
+        free(ranked_scores);
+    }
+    return suggestions;
+}
+
+/**
+ * Free the strings and arrays owned by a single error (not the error itself)
+ */
+static void free_spell_error(SpellError* error) {
+    if (error->misspelled_word) {
+        free(error->misspelled_word);
     }
     
-    // Sort candidates by edit distance (bubble sort for simplicity)
-    for (int i = 0; i < candidate_count - 1; i++) {
-        for (int j = 0; j < candidate_count - i - 1; j++) {
-            if (candidates[j].distance > candidates[j + 1].distance) {
-                WordDistance temp = candidates[j];
-                candidates[j] = candidates[j + 1];
-                candidates[j + 1] = temp;
-            }
-        }
+    if (error->original_word) {
+        free(error->original_word);
     }
     
-    // Return top 5 suggestions
-    int max_suggestions = (candidate_count < 5) ? candidate_count : 5;
-    char** suggestions = malloc(max_suggestions * sizeof(char*));
-    if (!suggestions) {
-        // Free candidates
-        for (int i = 0; i < candidate_count; i++) {
-            free(candidates[i].word);
+    if (error->suggestions) {
+        for (int j = 0; j < error->suggestion_count; j++) {
+            if (error->suggestions[j]) {
+                free(error->suggestions[j]);
+            }
         }
-        free(candidates);
-        return NULL;
+        free(error->suggestions);
     }
     
-    for (int i = 0; i < max_suggestions; i++) {
-        suggestions[i] = candidates[i].word; // Transfer ownership
+    if (error->suggestion_scores) {
+        free(error->suggestion_scores);
     }
-    
-    // Free remaining candidates
-    for (int i = max_suggestions; i < candidate_count; i++) {
-        free(candidates[i].word);
+}
+
+/**
+ * Initial number of slots in a per-run word cache (power of two)
+ */
+#define WORD_CACHE_INITIAL_CAPACITY 256
+
+/**
+ * Memoized outcome for one normalized word within a spell check run
+ */
+typedef struct WordCacheEntry {
+    char* word;                 // Normalized word (NULL marks an empty slot)
+    unsigned int hash;          // Cached hash of word
+    bool found;                 // Lookup outcome (dictionary or API)
+    bool has_suggestions;       // Whether suggestions have been generated yet
+    char** suggestions;         // Suggestions for a misspelled word
+    float* suggestion_scores;   // Ranking cost of each suggestion
+    int suggestion_count;       // Number of suggestions
+    bool has_neighbors;         // Whether context neighbors have been looked up yet
+    char** neighbors;           // One-edit dictionary neighbors seen in the context model
+    uint64_t* neighbor_hashes;  // ngram_word_hash() of each neighbor
+    int neighbor_count;         // Number of neighbors
+} WordCacheEntry;
+
+/**
+ * Open-addressing hash table from normalized word to lookup outcome.
+ * Each worker thread owns one, so no locking is needed.
+ */
+typedef struct WordCache {
+    WordCacheEntry* entries;    // Slot array (capacity is a power of two)
+    int capacity;               // Number of slots
+    int count;                  // Number of occupied slots
+    size_t bytes;               // Slots, keys and suggestions held (charged to MEMORY_COMPONENT_CACHES)
+} WordCache;
+
+/**
+ * FNV-1a hash of a NUL-terminated string
+ */
+static unsigned int hash_word(const char* word) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)word; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
     }
-    free(candidates);
+    return hash;
+}
+
+/**
+ * Record bytes allocated by a cache in it and in the caches budget
+ */
+static void word_cache_charge(WordCache* cache, size_t bytes) {
+    cache->bytes += bytes;
+    memory_charge(MEMORY_COMPONENT_CACHES, bytes);
+}
+
+/**
+ * Find the slot for a word: either the entry holding it or the empty slot
+ * where it would be inserted
+ */
+static WordCacheEntry* word_cache_slot(WordCache* cache, const char* word, unsigned int hash) {
+    unsigned int mask = (unsigned int)cache->capacity - 1;
+    unsigned int index = hash & mask;
     
-    *count = max_suggestions;
-    return suggestions;
+    while (cache->entries[index].word != NULL) {
+        WordCacheEntry* entry = &cache->entries[index];
+        if (entry->hash == hash && strcmp(entry->word, word) == 0) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+    return &cache->entries[index];
 }
 
 /**
- * Simple spell checking function
+ * Double the capacity of the cache and rehash all entries
  */
-SpellCheckResult* spell_check_document(TextDocument* doc, Trie* dictionary) {
-    if (!doc || !dictionary) {
-        return NULL;
+static bool word_cache_grow(WordCache* cache) {
+    int new_capacity = (cache->capacity == 0) ? WORD_CACHE_INITIAL_CAPACITY : cache->capacity * 2;
+    WordCacheEntry* new_entries = calloc(new_capacity, sizeof(WordCacheEntry));
+    if (!new_entries) {
+        return false;
     }
+    PROFILE_ALLOCATION(new_capacity * sizeof(WordCacheEntry));
     
-    // Allocate result structure
-    SpellCheckResult* result = malloc(sizeof(SpellCheckResult));
-    if (!result) {
-        return NULL;
+    WordCache grown = { new_entries, new_capacity, cache->count, cache->bytes };
+    for (int i = 0; i < cache->capacity; i++) {
+        WordCacheEntry* entry = &cache->entries[i];
+        if (entry->word != NULL) {
+            *word_cache_slot(&grown, entry->word, entry->hash) = *entry;
+        }
     }
     
-    // Initialize result
-    result->errors = NULL;
-    result->error_count = 0;
-    result->total_words_checked = 0;
-    result->processing_time = 0.0;
-    result->memory_used = 0;
+    word_cache_charge(&grown, (size_t)(new_capacity - cache->capacity) * sizeof(WordCacheEntry));
     
-    // Allocate initial error array
-    int max_errors = 100;
-    result->errors = malloc(max_errors * sizeof(SpellError));
-    if (!result->errors) {
-        free(result);
+    free(cache->entries);
+    *cache = grown;
+    return true;
+}
+
+/**
+ * Insert a word, returning its entry (or NULL on memory allocation failure)
+ */
+static WordCacheEntry* word_cache_insert(WordCache* cache, const char* word, unsigned int hash, bool found) {
+    // Keep the load factor below 3/4
+    if ((cache->count + 1) * 4 > cache->capacity * 3) {
+        if (!word_cache_grow(cache)) {
+            return NULL;
+        }
+    }
+    
+    char* key = safe_strdup(word);
+    if (!key) {
         return NULL;
     }
+    word_cache_charge(cache, strlen(key) + 1);
     
-    // Process each token in the document
-    for (int i = 0; i < doc->token_count; i++) {
-        TextToken* token = &doc->tokens[i];
-        
-        // Skip invalid words
-        if (!is_valid_word(token->word) || !is_alphabetic_word(token->word)) {
+    WordCacheEntry* entry = word_cache_slot(cache, word, hash);
+    entry->word = key;
+    entry->hash = hash;
+    entry->found = found;
+    entry->has_suggestions = false;
+    entry->suggestions = NULL;
+    entry->suggestion_scores = NULL;
+    entry->suggestion_count = 0;
+    entry->has_neighbors = false;
+    entry->neighbors = NULL;
+    entry->neighbor_hashes = NULL;
+    entry->neighbor_count = 0;
+    cache->count++;
+    
+    return entry;
+}
+
+/**
+ * Free every key and suggestion list held by the cache
+ */
+static void word_cache_free(WordCache* cache) {
+    for (int i = 0; i < cache->capacity; i++) {
+        WordCacheEntry* entry = &cache->entries[i];
+        if (entry->word == NULL) {
             continue;
         }
         
-        result->total_words_checked++;
-        
-        // Check if word is in local dictionary
-        bool word_found = trie_search(dictionary, token->word);
-        
-        // If not found in local dictionary, try API (if initialized)
-        if (!word_found && is_api_initialized()) {
-            printf("🔍 Checking '%s' via API...\n", token->word);
-            int api_result = fetch_from_api(token->word);
-            
-            if (api_result == 1) {
-                // Word found in API, mark as correct
-                word_found = true;
-                printf("✅ Word '%s' validated by API\n", token->word);
-            } else if (api_result == -1) {
-                // API error, fall back to local checking
-                printf("⚠️  API error for '%s', using local dictionary only\n", token->word);
-            }
+        for (int j = 0; j < entry->suggestion_count; j++) {
+            free(entry->suggestions[j]);
         }
-        
-        // If word still not found, it's misspelled
-        if (!word_found) {
-            // Check if it's likely a proper noun (skip if so)
-            if (is_likely_proper_noun(token->word, token)) {
-                continue;
-            }
-            
-            // Expand error array if needed
-            if (result->error_count >= max_errors) {
-                max_errors *= 2;
-                SpellError* new_errors = realloc(result->errors, max_errors * sizeof(SpellError));
-                if (!new_errors) {
-                    break; // Memory allocation failed, return partial results
-                }
-                result->errors = new_errors;
-            }
-            
-            // Create new error entry
-            SpellError* error = &result->errors[result->error_count];
-            
-            // Copy word information
-            error->misspelled_word = safe_strdup(token->word);
-            error->original_word = safe_strdup(token->original_word);
-            error->line_number = token->line_number;
-            error->position = token->position;
-            
-            // Generate suggestions
-            error->suggestions = generate_suggestions(token->word, dictionary, &error->suggestion_count);
-            
-            // Simple scoring (if suggestions exist)
-            if (error->suggestion_count > 0) {
-                error->suggestion_scores = malloc(error->suggestion_count * sizeof(float));
-                if (error->suggestion_scores) {
-                    for (int j = 0; j < error->suggestion_count; j++) {
-                        error->suggestion_scores[j] = (float)j; // Simple scoring
-                    }
-                }
-            } else {
-                error->suggestion_scores = NULL;
-            }
-            
-            result->error_count++;
+        free(entry->suggestions);
+        free(entry->suggestion_scores);
+        for (int j = 0; j < entry->neighbor_count; j++) {
+            free(entry->neighbors[j]);
         }
+        free(entry->neighbors);
+        free(entry->neighbor_hashes);
+        free(entry->word);
     }
     
-    return result;
+    memory_release(MEMORY_COMPONENT_CACHES, cache->bytes);
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->capacity = 0;
+    cache->count = 0;
+    cache->bytes = 0;
 }
 
 /**
- * Free all memory associated with a SpellCheckResult
+ * Duplicate a suggestion list and its scores so each SpellError owns its
+ * own copy
  */
-void free_spell_check_result(SpellCheckResult* result) {
-    if (!result) {
-        return;
+static char** copy_suggestions(char** suggestions, const float* scores, int count, int* copied,
+                               float** copied_scores) {
+    *copied = 0;
+    *copied_scores = NULL;
+    if (!suggestions || !scores || count == 0) {
+        return NULL;
     }
     
-    // Free each error and its associated data
-    for (int i = 0; i < result->error_count; i++) {
-        SpellError* error = &result->errors[i];
-        
-        if (error->misspelled_word) {
-            free(error->misspelled_word);
+    char** copy = malloc(count * sizeof(char*));
+    float* score_copy = malloc(count * sizeof(float));
+    if (!copy || !score_copy) {
+        free(copy);
+        free(score_copy);
+        return NULL;
+    }
+    PROFILE_ALLOCATION(count * sizeof(char*));
+    PROFILE_ALLOCATION(count * sizeof(float));
+    
+    for (int i = 0; i < count; i++) {
+        copy[*copied] = safe_strdup(suggestions[i]);
+        if (copy[*copied]) {
+            score_copy[*copied] = scores[i];
+            (*copied)++;
+        }
+    }
+    
+    if (*copied == 0) {
+        free(copy);
+        free(score_copy);
+        return NULL;
+    }
+    *copied_scores = score_copy;
+    return copy;
+}
+
+/**
+ * Upper bound on worker threads for parallel checking
+ */
+#define MAX_CHECK_THREADS 256
+
+/**
+ * Unique words a streaming run remembers before its cache is reset,
+ * keeping memory bounded on arbitrarily large inputs
+ */
+#define STREAM_CACHE_MAX_WORDS 65536
+
+/**
+ * Per-thread checking state: dictionary, word cache and counters
+ */
+typedef struct TokenChecker {
+    Trie* dictionary;           // Dictionary (read-only)
+    WordCache* api_answers;     // Words already validated via the API (read-only, may be NULL)
+    WordCache cache;            // Memo of lookup outcomes and suggestions
+    int cache_limit;            // Reset the cache past this many words (0 = unbounded)
+    int words_checked;          // Words checked so far
+    int cache_hits;             // Tokens answered from the cache
+    int cache_misses;           // Tokens that needed a full lookup
+    SpellCheckProfile profile;  // Stage timers (profiling only)
+} TokenChecker;
+
+/**
+ * Add the time since started (a profile_clock() reading) to a stage timer
+ */
+static void profile_stop(double* stage_seconds, double started) {
+    if (PROFILE_ENABLED()) {
+        *stage_seconds += profile_clock() - started;
+    }
+}
+
+/**
+ * Add the counter growth between two snapshots of one thread to a profile
+ */
+static void profile_add_counters(SpellCheckProfile* profile, const ProfileCounters* before,
+                                 const ProfileCounters* after) {
+    profile->trie_nodes_visited += after->trie_nodes_visited - before->trie_nodes_visited;
+    profile->dp_cells += after->dp_cells - before->dp_cells;
+    profile->allocations += after->allocations - before->allocations;
+    profile->allocated_bytes += after->allocated_bytes - before->allocated_bytes;
+}
+
+/**
+ * Add one profile's timers and counters to another
+ */
+static void profile_merge(SpellCheckProfile* into, const SpellCheckProfile* from) {
+    into->tokenize_seconds += from->tokenize_seconds;
+    into->lookup_seconds += from->lookup_seconds;
+    into->suggestion_seconds += from->suggestion_seconds;
+    into->api_seconds += from->api_seconds;
+    into->context_seconds += from->context_seconds;
+    into->suggestion_calls += from->suggestion_calls;
+    into->trie_nodes_visited += from->trie_nodes_visited;
+    into->dp_cells += from->dp_cells;
+    into->allocations += from->allocations;
+    into->allocated_bytes += from->allocated_bytes;
+}
+
+/**
+ * Check one token. Returns true if it is misspelled, in which case *error
+ * is filled in and owns its strings.
+ */
+static bool check_token(TokenChecker* checker, const TextToken* token, SpellError* error) {
+    Trie* dictionary = checker->dictionary;
+    
+    // Skip invalid words
+    if (!is_valid_word(token->word) || !is_alphabetic_word(token->word)) {
+        return false;
+    }
+    
+    checker->words_checked++;
+    
+    // Repeated words cost one hash probe
+    unsigned int hash = hash_word(token->word);
+    WordCacheEntry* cached = NULL;
+    if (checker->cache.capacity > 0) {
+        cached = word_cache_slot(&checker->cache, token->word, hash);
+        if (cached->word == NULL) {
+            cached = NULL;
         }
+    }
+    
+    bool word_found;
+    if (cached) {
+        checker->cache_hits++;
+        word_found = cached->found;
+    } else {
+        checker->cache_misses++;
         
-        if (error->original_word) {
-            free(error->original_word);
+        // Check if word is in local dictionary
+        double started = profile_clock();
+        word_found = trie_search(dictionary, token->word);
+        profile_stop(&checker->profile.lookup_seconds, started);
+    }
+    
+    // Use the answer of a batch validation when one ran
+    WordCacheEntry* answer = NULL;
+    if (!cached && !word_found && checker->api_answers && checker->api_answers->capacity > 0) {
+        answer = word_cache_slot(checker->api_answers, token->word, hash);
+        if (answer->word != NULL) {
+            word_found = answer->found;
+        } else {
+            answer = NULL;
+        }
+    }
+    
+    // If not found in local dictionary, try API (if initialized)
+    if (!cached && !word_found && !answer && is_api_initialized()) {
+        if (!g_quiet) {
+            printf("🔍 Checking '%s' via API...\n", token->word);
         }
+        double started = profile_clock();
+        int api_result = fetch_from_api(token->word);
+        profile_stop(&checker->profile.api_seconds, started);
         
-        if (error->suggestions) {
-            for (int j = 0; j < error->suggestion_count; j++) {
-                if (error->suggestions[j]) {
-                    free(error->suggestions[j]);
-                }
+        if (api_result == 1) {
+            // Word found in API, mark as correct
+            word_found = true;
+            if (!g_quiet) {
+                printf("✅ Word '%s' validated by API\n", token->word);
             }
-            free(error->suggestions);
+        } else if (api_result == -1 && !g_quiet) {
+            // API error, fall back to local checking
+            printf("⚠️  API error for '%s', using local dictionary only\n", token->word);
+        }
+    }
+    
+    if (!cached) {
+        // A full cache, or one the caches budget can no longer afford, starts over
+        if ((checker->cache_limit > 0 && checker->cache.count >= checker->cache_limit) ||
+            (checker->cache.count > 0 && memory_would_exceed(MEMORY_COMPONENT_CACHES, 0))) {
+            word_cache_free(&checker->cache);
+        }
+        cached = word_cache_insert(&checker->cache, token->word, hash, word_found);
+    }
+    
+    // A word found in the dictionary or API is correct
+    if (word_found) {
+        return false;
+    }
+    
+    // Check if it's likely a proper noun (skip if so)
+    if (is_likely_proper_noun(token->word, token)) {
+        return false;
+    }
+    
+    // Copy word information
+    error->misspelled_word = safe_strdup(token->word);
+    error->original_word = safe_strdup(token->original_word);
+    error->line_number = token->line_number;
+    error->position = token->position;
+    error->context_error = false;
+    
+    // Generate suggestions once per unique misspelling, then reuse them
+    double started = profile_clock();
+    if (cached && !cached->has_suggestions) {
+        cached->suggestions = generate_ranked_suggestions(token->word, dictionary, &cached->suggestion_count,
+                                                          &cached->suggestion_scores);
+        cached->has_suggestions = true;
+        checker->profile.suggestion_calls++;
+        
+        size_t bytes = cached->suggestion_count * (sizeof(char*) + sizeof(float));
+        for (int i = 0; i < cached->suggestion_count; i++) {
+            bytes += strlen(cached->suggestions[i]) + 1;
+        }
+        word_cache_charge(&checker->cache, bytes);
+    }
+    
+    if (cached) {
+        error->suggestions = copy_suggestions(cached->suggestions, cached->suggestion_scores,
+                                              cached->suggestion_count, &error->suggestion_count,
+                                              &error->suggestion_scores);
+    } else {
+        error->suggestions = generate_ranked_suggestions(token->word, dictionary, &error->suggestion_count,
+                                                         &error->suggestion_scores);
+        checker->profile.suggestion_calls++;
+    }
+    profile_stop(&checker->profile.suggestion_seconds, started);
+    
+    return true;
+}
+
+/**
+ * Work item and partial result for one contiguous range of tokens
+ */
+typedef struct SpellCheckChunk {
+    TextDocument* doc;          // Document being checked (read-only)
+    int start;                  // First token index of the range
+    int end;                    // One past the last token index
+    SpellError* errors;         // Errors found in this range, in token order
+    int error_count;            // Number of errors found
+    int error_capacity;         // Allocated size of errors
+    TokenChecker checker;       // Per-thread checking state
+} SpellCheckChunk;
+
+/**
+ * Check whether a word is made of ASCII lowercase letters only, the words
+ * whose one-edit neighbors the context pass enumerates
+ */
+static bool is_ascii_lowercase_word(const char* word, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (word[i] < 'a' || word[i] > 'z') {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Edits of a word are packed into one code: kind (delete, transpose,
+ * substitute, insert), position and letter
+ */
+#define CONTEXT_EDIT_DELETE 0u
+#define CONTEXT_EDIT_TRANSPOSE 1u
+#define CONTEXT_EDIT_SUBSTITUTE 2u
+#define CONTEXT_EDIT_INSERT 3u
+#define CONTEXT_EDIT_CODE(kind, position, letter) (((kind) << 16) | ((uint32_t)(position) << 8) | (uint32_t)(letter))
+
+/**
+ * Write the edit of word described by code into buffer (NUL-terminated)
+ * and return its length; only edits the model knows are spelled out
+ */
+static size_t apply_edit(const char* word, size_t length, uint32_t code, char* buffer) {
+    uint32_t kind = code >> 16;
+    size_t position = (code >> 8) & 0xFF;
+    char letter = (char)(code & 0xFF);
+    
+    memcpy(buffer, word, position);
+    size_t out = position;
+    switch (kind) {
+        case CONTEXT_EDIT_DELETE:
+            memcpy(buffer + out, word + position + 1, length - position - 1);
+            out += length - position - 1;
+            break;
+        case CONTEXT_EDIT_TRANSPOSE:
+            buffer[out++] = word[position + 1];
+            buffer[out++] = word[position];
+            memcpy(buffer + out, word + position + 2, length - position - 2);
+            out += length - position - 2;
+            break;
+        case CONTEXT_EDIT_SUBSTITUTE:
+            buffer[out++] = letter;
+            memcpy(buffer + out, word + position + 1, length - position - 1);
+            out += length - position - 1;
+            break;
+        default:
+            buffer[out++] = letter;
+            memcpy(buffer + out, word + position, length - position);
+            out += length - position;
+            break;
+    }
+    buffer[out] = '\0';
+    return out;
+}
+
+/**
+ * Hash of the edit of word described by code, resumed from the hash of
+ * the unchanged prefix (prefix_hashes[i] covers the first i bytes)
+ */
+static uint64_t edit_hash(const char* word, size_t length, const uint64_t* prefix_hashes, uint32_t code) {
+    uint32_t kind = code >> 16;
+    size_t position = (code >> 8) & 0xFF;
+    char changed[2] = { (char)(code & 0xFF), 0 };
+    
+    uint64_t hash = prefix_hashes[position];
+    switch (kind) {
+        case CONTEXT_EDIT_DELETE:
+            return ngram_word_hash_extend(hash, word + position + 1, length - position - 1);
+        case CONTEXT_EDIT_TRANSPOSE:
+            changed[0] = word[position + 1];
+            changed[1] = word[position];
+            hash = ngram_word_hash_extend(hash, changed, 2);
+            return ngram_word_hash_extend(hash, word + position + 2, length - position - 2);
+        case CONTEXT_EDIT_SUBSTITUTE:
+            hash = ngram_word_hash_extend(hash, changed, 1);
+            return ngram_word_hash_extend(hash, word + position + 1, length - position - 1);
+        default:
+            hash = ngram_word_hash_extend(hash, changed, 1);
+            return ngram_word_hash_extend(hash, word + position, length - position);
+    }
+}
+
+/**
+ * Child of a pointer trie node by lowercase letter, NULL past the tree
+ */
+static const TrieNode* trie_node_child(const TrieNode* node, char letter) {
+    return node ? node->children[letter - 'a'] : NULL;
+}
+
+/**
+ * Mark which edits of word are dictionary words. Every edit walks the
+ * pointer tree on from the node of the unchanged prefix (prefix_nodes[i]
+ * is the node of the first i bytes), so it costs the few steps after it,
+ * and the walks advance one step each in turn with their next node
+ * prefetched, so their cache misses overlap; frozen or minimized
+ * dictionaries are searched for the spelled-out edit instead.
+ */
+static void find_dictionary_edits(Trie* dictionary, const TrieNode* const* prefix_nodes, const char* word,
+                                  size_t length, const uint32_t* codes, int code_count, bool* in_dictionary,
+                                  char* buffer) {
+    if (!dictionary->root) {
+        for (int c = 0; c < code_count; c++) {
+            apply_edit(word, length, codes[c], buffer);
+            in_dictionary[c] = trie_search(dictionary, buffer);
+        }
+        return;
+    }
+    
+    const TrieNode* nodes[CONTEXT_MAX_EDITS];
+    const char* rests[CONTEXT_MAX_EDITS];
+    int walks[CONTEXT_MAX_EDITS];
+    int active = 0;
+    for (int c = 0; c < code_count; c++) {
+        uint32_t kind = codes[c] >> 16;
+        size_t position = (codes[c] >> 8) & 0xFF;
+        char letter = (char)(codes[c] & 0xFF);
+        
+        const TrieNode* node = prefix_nodes[position];
+        const char* rest;
+        switch (kind) {
+            case CONTEXT_EDIT_DELETE:
+                rest = word + position + 1;
+                break;
+            case CONTEXT_EDIT_TRANSPOSE:
+                node = trie_node_child(trie_node_child(node, word[position + 1]), word[position]);
+                rest = word + position + 2;
+                break;
+            case CONTEXT_EDIT_SUBSTITUTE:
+                node = trie_node_child(node, letter);
+                rest = word + position + 1;
+                break;
+            default:
+                node = trie_node_child(node, letter);
+                rest = word + position;
+                break;
+        }
+        
+        in_dictionary[c] = false;
+        if (node) {
+            CONTEXT_PREFETCH(*rest ? (const void*)&node->children[*rest - 'a'] : (const void*)node);
+            nodes[active] = node;
+            rests[active] = rest;
+            walks[active++] = c;
+        }
+    }
+    
+    while (active > 0) {
+        int live = 0;
+        for (int w = 0; w < active; w++) {
+            const char* rest = rests[w];
+            if (!*rest) {
+                in_dictionary[walks[w]] = nodes[w]->is_end_of_word;
+                continue;
+            }
+            const TrieNode* node = nodes[w]->children[*rest++ - 'a'];
+            if (!node) {
+                continue;
+            }
+            CONTEXT_PREFETCH(*rest ? (const void*)&node->children[*rest - 'a'] : (const void*)node);
+            nodes[live] = node;
+            rests[live] = rest;
+            walks[live++] = walks[w];
+        }
+        active = live;
+    }
+}
+
+/**
+ * Keep a neighbor among the most frequent ones found so far
+ * @return New number of neighbors held
+ */
+static int add_neighbor(char** neighbors, uint64_t* hashes, float* counts, int neighbor_count,
+                        const char* word, uint64_t hash, float count) {
+    for (int i = 0; i < neighbor_count; i++) {
+        if (hashes[i] == hash) {
+            return neighbor_count; // Reached by another edit ("aa" -> "a" twice)
+        }
+    }
+    
+    int pos = neighbor_count;
+    while (pos > 0 && counts[pos - 1] < count) {
+        pos--;
+    }
+    if (pos >= CONTEXT_MAX_NEIGHBORS) {
+        return neighbor_count;
+    }
+    
+    char* copy = safe_strdup(word);
+    if (!copy) {
+        return neighbor_count;
+    }
+    if (neighbor_count == CONTEXT_MAX_NEIGHBORS) {
+        free(neighbors[--neighbor_count]);
+    }
+    for (int k = neighbor_count; k > pos; k--) {
+        neighbors[k] = neighbors[k - 1];
+        hashes[k] = hashes[k - 1];
+        counts[k] = counts[k - 1];
+    }
+    neighbors[pos] = copy;
+    hashes[pos] = hash;
+    counts[pos] = count;
+    return neighbor_count + 1;
+}
+
+/**
+ * Find the one-edit neighbors of a cached word that are dictionary words
+ * seen in the context model. Every edit is checked in the dictionary
+ * first, walking on from the word's own path, and only the few it holds
+ * are looked up in the model, in batches.
+ */
+static void find_context_neighbors(TokenChecker* checker, WordCacheEntry* entry) {
+    entry->has_neighbors = true;
+    
+    const char* word = entry->word;
+    size_t length = strlen(word);
+    uint64_t prefix_hashes[CONTEXT_MAX_WORD_LENGTH + 1];
+    prefix_hashes[0] = NGRAM_WORD_HASH_SEED;
+    for (size_t i = 0; i < length; i++) {
+        prefix_hashes[i + 1] = ngram_word_hash_extend(prefix_hashes[i], word + i, 1);
+    }
+    uint64_t word_hash = prefix_hashes[length];
+    const TrieNode* prefix_nodes[CONTEXT_MAX_WORD_LENGTH + 1];
+    prefix_nodes[0] = checker->dictionary->root;
+    for (size_t i = 0; i < length; i++) {
+        prefix_nodes[i + 1] = trie_node_child(prefix_nodes[i], word[i]);
+    }
+    char* neighbors[CONTEXT_MAX_NEIGHBORS];
+    uint64_t neighbor_hashes[CONTEXT_MAX_NEIGHBORS];
+    float neighbor_counts[CONTEXT_MAX_NEIGHBORS];
+    int neighbor_count = 0;
+    
+    // Every distinct edit: deletes, transposes, substitutions, inserts
+    uint32_t codes[CONTEXT_MAX_EDITS];
+    int code_count = 0;
+    for (size_t position = 0; position < length; position++) {
+        codes[code_count++] = CONTEXT_EDIT_CODE(CONTEXT_EDIT_DELETE, position, 0);
+        if (position + 1 < length && word[position] != word[position + 1]) {
+            codes[code_count++] = CONTEXT_EDIT_CODE(CONTEXT_EDIT_TRANSPOSE, position, 0);
+        }
+        for (char letter = 'a'; letter <= 'z'; letter++) {
+            if (letter != word[position]) {
+                codes[code_count++] = CONTEXT_EDIT_CODE(CONTEXT_EDIT_SUBSTITUTE, position, letter);
+            }
+        }
+    }
+    for (size_t position = 0; position <= length; position++) {
+        for (char letter = 'a'; letter <= 'z'; letter++) {
+            codes[code_count++] = CONTEXT_EDIT_CODE(CONTEXT_EDIT_INSERT, position, letter);
+        }
+    }
+    
+    bool in_dictionary[CONTEXT_MAX_EDITS];
+    char buffer[CONTEXT_MAX_WORD_LENGTH + 2];
+    find_dictionary_edits(checker->dictionary, prefix_nodes, word, length, codes, code_count, in_dictionary, buffer);
+    
+    uint32_t hits[CONTEXT_EDIT_BATCH];
+    uint64_t hashes[CONTEXT_EDIT_BATCH];
+    uint64_t keys[CONTEXT_EDIT_BATCH];
+    float counts[CONTEXT_EDIT_BATCH];
+    int hit_count = 0;
+    for (int c = 0; c < code_count; c++) {
+        if (in_dictionary[c]) {
+            hits[hit_count] = codes[c];
+            hashes[hit_count] = edit_hash(word, length, prefix_hashes, codes[c]);
+            keys[hit_count] = ngram_key(&hashes[hit_count], 1);
+            hit_count++;
+        }
+        if (hit_count == 0 || (hit_count < CONTEXT_EDIT_BATCH && c + 1 < code_count)) {
+            continue;
+        }
+        
+        ngram_model_lookup_batch(g_context_model, keys, hit_count, counts);
+        for (int i = 0; i < hit_count; i++) {
+            if (counts[i] == NGRAM_ABSENT || hashes[i] == word_hash) {
+                continue;
+            }
+            apply_edit(word, length, hits[i], buffer);
+            neighbor_count = add_neighbor(neighbors, neighbor_hashes, neighbor_counts, neighbor_count,
+                                          buffer, hashes[i], counts[i]);
+        }
+        hit_count = 0;
+    }
+    
+    if (neighbor_count == 0) {
+        return;
+    }
+    
+    entry->neighbors = malloc(neighbor_count * sizeof(char*));
+    entry->neighbor_hashes = malloc(neighbor_count * sizeof(uint64_t));
+    if (!entry->neighbors || !entry->neighbor_hashes) {
+        free(entry->neighbors);
+        free(entry->neighbor_hashes);
+        entry->neighbors = NULL;
+        entry->neighbor_hashes = NULL;
+        for (int i = 0; i < neighbor_count; i++) {
+            free(neighbors[i]);
+        }
+        return;
+    }
+    
+    size_t bytes = neighbor_count * (sizeof(char*) + sizeof(uint64_t));
+    for (int i = 0; i < neighbor_count; i++) {
+        entry->neighbors[i] = neighbors[i];
+        entry->neighbor_hashes[i] = neighbor_hashes[i];
+        bytes += strlen(neighbors[i]) + 1;
+    }
+    entry->neighbor_count = neighbor_count;
+    word_cache_charge(&checker->cache, bytes);
+}
+
+/**
+ * A word waiting for the windows of its neighbors to be scored
+ */
+typedef struct ContextCandidate {
+    int token;                  // Index of the token in the document
+    float score;                // Score of the word's own window
+    int first_window;           // Window of the first neighbor in the batch
+    char** neighbors;           // The word's neighbors (owned by the word cache)
+    int neighbor_count;         // Number of neighbors
+} ContextCandidate;
+
+/**
+ * Words of a chunk scored together, and the context errors found so far
+ */
+typedef struct ContextBatch {
+    const TextDocument* doc;    // Document being checked
+    uint64_t windows[CONTEXT_SCORE_BATCH * NGRAM_WINDOW];
+    float scores[CONTEXT_SCORE_BATCH];
+    int window_count;           // Windows filled
+    ContextCandidate candidates[CONTEXT_SCORE_BATCH];
+    int candidate_count;        // Words waiting
+    SpellError* errors;         // Context errors found, in token order
+    int error_count;            // Number of errors found
+    int error_capacity;         // Allocated size of errors
+} ContextBatch;
+
+/**
+ * Report a word whose neighbors fit its context better, best first
+ */
+static void add_context_error(ContextBatch* batch, const ContextCandidate* candidate) {
+    const float* scores = batch->scores + candidate->first_window;
+    const TextToken* token = &batch->doc->tokens[candidate->token];
+    
+    if (batch->error_count >= batch->error_capacity) {
+        int new_capacity = (batch->error_capacity == 0) ? 16 : batch->error_capacity * 2;
+        SpellError* new_errors = realloc(batch->errors, new_capacity * sizeof(SpellError));
+        if (!new_errors) {
+            return; // Memory allocation failed, keep the errors found so far
+        }
+        PROFILE_ALLOCATION(new_capacity * sizeof(SpellError));
+        batch->errors = new_errors;
+        batch->error_capacity = new_capacity;
+    }
+    
+    // Neighbors more likely than the word, by decreasing score
+    int order[CONTEXT_MAX_NEIGHBORS];
+    int count = 0;
+    for (int n = 0; n < candidate->neighbor_count; n++) {
+        if (scores[n] <= candidate->score) {
+            continue;
+        }
+        int pos = count++;
+        while (pos > 0 && scores[order[pos - 1]] < scores[n]) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = n;
+    }
+    if (count > MAX_SUGGESTIONS) {
+        count = MAX_SUGGESTIONS;
+    }
+    
+    SpellError* error = &batch->errors[batch->error_count];
+    memset(error, 0, sizeof(SpellError));
+    error->misspelled_word = safe_strdup(token->word);
+    error->original_word = safe_strdup(token->original_word);
+    error->line_number = token->line_number;
+    error->position = token->position;
+    error->context_error = true;
+    error->suggestions = malloc(count * sizeof(char*));
+    error->suggestion_scores = malloc(count * sizeof(float));
+    if (!error->misspelled_word || !error->original_word || !error->suggestions || !error->suggestion_scores) {
+        free_spell_error(error);
+        return;
+    }
+    
+    // Ranked like other suggestions: lower cost is better, here the log2 odds against it
+    for (int i = 0; i < count; i++) {
+        error->suggestions[i] = safe_strdup(candidate->neighbors[order[i]]);
+        if (!error->suggestions[i]) {
+            break;
+        }
+        error->suggestion_scores[i] = candidate->score - scores[order[i]];
+        error->suggestion_count++;
+    }
+    batch->error_count++;
+}
+
+/**
+ * Best score among a candidate's neighbors, from batch->scores
+ */
+static float best_neighbor_score(const ContextBatch* batch, const ContextCandidate* candidate) {
+    const float* scores = batch->scores + candidate->first_window;
+    float best = scores[0];
+    for (int n = 1; n < candidate->neighbor_count; n++) {
+        if (scores[n] > best) {
+            best = scores[n];
+        }
+    }
+    return best;
+}
+
+/**
+ * Score the waiting words and report those a neighbor fits far better.
+ * The neighbor windows are bounded first, which skips their trigrams, and
+ * only the words a neighbor could still beat by enough are scored in full.
+ */
+static void flush_context_batch(ContextBatch* batch) {
+    ngram_model_bound_batch(g_context_model, batch->windows, batch->window_count, batch->scores);
+    
+    for (int c = 0; c < batch->candidate_count; c++) {
+        const ContextCandidate* candidate = &batch->candidates[c];
+        if (best_neighbor_score(batch, candidate) - candidate->score < CONTEXT_MIN_LOG2_RATIO) {
+            continue;
+        }
+        
+        ngram_model_score_batch(g_context_model, batch->windows + (size_t)candidate->first_window * NGRAM_WINDOW,
+                                candidate->neighbor_count, batch->scores + candidate->first_window);
+        if (best_neighbor_score(batch, candidate) - candidate->score >= CONTEXT_MIN_LOG2_RATIO) {
+            add_context_error(batch, candidate);
+        }
+    }
+    
+    batch->window_count = 0;
+    batch->candidate_count = 0;
+}
+
+/**
+ * Merge the chunk's errors and its context errors, both in token order
+ */
+static void merge_context_errors(SpellCheckChunk* chunk, ContextBatch* batch) {
+    int total = chunk->error_count + batch->error_count;
+    SpellError* merged = malloc(total * sizeof(SpellError));
+    if (!merged) {
+        for (int i = 0; i < batch->error_count; i++) {
+            free_spell_error(&batch->errors[i]);
+        }
+        return; // Memory allocation failed, keep the spelling errors only
+    }
+    PROFILE_ALLOCATION(total * sizeof(SpellError));
+    
+    int a = 0;
+    int b = 0;
+    for (int k = 0; k < total; k++) {
+        const SpellError* next_a = (a < chunk->error_count) ? &chunk->errors[a] : NULL;
+        const SpellError* next_b = (b < batch->error_count) ? &batch->errors[b] : NULL;
+        bool take_a = next_b == NULL ||
+                      (next_a != NULL && (next_a->line_number < next_b->line_number ||
+                                          (next_a->line_number == next_b->line_number &&
+                                           next_a->position < next_b->position)));
+        merged[k] = take_a ? chunk->errors[a++] : batch->errors[b++];
+    }
+    
+    free(chunk->errors);
+    chunk->errors = merged;
+    chunk->error_count = total;
+    chunk->error_capacity = total;
+}
+
+/**
+ * Queue token i, a word whose window scores score, with one window per
+ * neighbor; its neighbors are looked for the first time the word is seen
+ */
+static void queue_context_candidate(TokenChecker* checker, ContextBatch* batch, int i, const uint64_t* window,
+                                    float score) {
+    const TextToken* token = &batch->doc->tokens[i];
+    
+    // The spelling pass left every checked word in the cache, unless a budget reset it
+    unsigned int hash = hash_word(token->word);
+    WordCacheEntry* entry = (checker->cache.capacity > 0) ? word_cache_slot(&checker->cache, token->word, hash)
+                                                          : NULL;
+    if (!entry || !entry->word) {
+        entry = word_cache_insert(&checker->cache, token->word, hash, trie_search(checker->dictionary, token->word));
+        if (!entry) {
+            return;
+        }
+    }
+    if (!entry->found) {
+        return;
+    }
+    if (!entry->has_neighbors) {
+        find_context_neighbors(checker, entry);
+    }
+    if (entry->neighbor_count == 0) {
+        return;
+    }
+    
+    if (batch->window_count + entry->neighbor_count > CONTEXT_SCORE_BATCH) {
+        flush_context_batch(batch);
+    }
+    
+    ContextCandidate* candidate = &batch->candidates[batch->candidate_count++];
+    candidate->token = i;
+    candidate->score = score;
+    candidate->first_window = batch->window_count;
+    candidate->neighbors = entry->neighbors;
+    candidate->neighbor_count = entry->neighbor_count;
+    for (int n = 0; n < entry->neighbor_count; n++) {
+        uint64_t* copy = batch->windows + (size_t)batch->window_count * NGRAM_WINDOW;
+        memcpy(copy, window, NGRAM_WINDOW * sizeof(uint64_t));
+        copy[2] = entry->neighbor_hashes[n];
+        batch->window_count++;
+    }
+}
+
+/**
+ * Check the dictionary words of a chunk's range against their context.
+ * The words in and around the range are hashed once, and those of the
+ * range are screened by their bigrams and then by the score of their own
+ * window (see ngram_model_score_sequence()); every word left with
+ * neighbors is queued with one window per neighbor, to be scored in
+ * batches.
+ */
+static void check_context_range(SpellCheckChunk* chunk) {
+    const TextDocument* doc = chunk->doc;
+    TokenChecker* checker = &chunk->checker;
+    int first = (chunk->start >= 2) ? chunk->start - 2 : 0;
+    int last = (chunk->end + 2 <= doc->token_count) ? chunk->end + 2 : doc->token_count;
+    if (last <= first) {
+        return;
+    }
+    
+    // Each token adds at most four boundaries, and the end of the document two more
+    int range = chunk->end - chunk->start;
+    int capacity = (last - first) * 5 + 2;
+    uint64_t* sequence = malloc(capacity * sizeof(uint64_t));
+    float* scores = malloc(capacity * sizeof(float));
+    bool* wanted = calloc(capacity, sizeof(bool));
+    int* positions = malloc(range * sizeof(int));
+    ContextBatch* batch = calloc(1, sizeof(ContextBatch));
+    bool ok = sequence && scores && wanted && positions && batch;
+    
+    // One pass over the tokens lays them out as the model counted them,
+    // each sentence between two boundaries on both sides, so the window of
+    // every word is the two words (or boundaries) each side of it; words
+    // of the range the check looks at are marked on the way
+    uint64_t boundary = ngram_word_hash(NGRAM_BOUNDARY, strlen(NGRAM_BOUNDARY));
+    int length = 0;
+    for (int i = first; ok && i < last; i++) {
+        const TextToken* token = &doc->tokens[i];
+        size_t word_length = strlen(token->word);
+        bool starts_sentence = ngram_is_sentence_start(doc, i);
+        if (starts_sentence) {
+            if (i > first) {
+                sequence[length++] = boundary;
+                sequence[length++] = boundary;
+            }
+            sequence[length++] = boundary;
+            sequence[length++] = boundary;
+        }
+        sequence[length] = ngram_word_hash(token->word, word_length);
+        if (i >= chunk->start && i < chunk->end) {
+            // Capitalized words inside a sentence are names more often than not
+            positions[i - chunk->start] = length;
+            wanted[length] = word_length >= CONTEXT_MIN_WORD_LENGTH && word_length <= CONTEXT_MAX_WORD_LENGTH &&
+                             is_ascii_lowercase_word(token->word, word_length) &&
+                             (starts_sentence || token->original_word[0] < 'A' || token->original_word[0] > 'Z');
+        }
+        length++;
+    }
+    if (ok && last == doc->token_count) {
+        sequence[length++] = boundary;
+        sequence[length++] = boundary;
+    }
+    
+    if (!ok ||
+        !ngram_model_score_sequence(g_context_model, sequence, length, CONTEXT_SCREEN_LOG2_COUNT, wanted, scores)) {
+        free(sequence);
+        free(scores);
+        free(wanted);
+        free(positions);
+        free(batch);
+        return; // Memory allocation failed, skip the context check
+    }
+    
+    // No window scores above 0, so a word whose own window scores above
+    // -CONTEXT_MIN_LOG2_RATIO cannot be beaten by that much
+    batch->doc = doc;
+    for (int i = chunk->start; i < chunk->end; i++) {
+        int position = positions[i - chunk->start];
+        if (wanted[position] && scores[position] <= -CONTEXT_MIN_LOG2_RATIO) {
+            queue_context_candidate(checker, batch, i, sequence + position - 2, scores[position]);
+        }
+    }
+    if (batch->candidate_count > 0) {
+        flush_context_batch(batch);
+    }
+    
+    if (batch->error_count > 0) {
+        merge_context_errors(chunk, batch);
+    }
+    free(batch->errors);
+    free(batch);
+    free(sequence);
+    free(scores);
+    free(wanted);
+    free(positions);
+}
+
+/**
+ * Check every token in a chunk's range, appending errors to the chunk
+ */
+static void check_token_range(SpellCheckChunk* chunk) {
+    for (int i = chunk->start; i < chunk->end; i++) {
+        SpellError error;
+        if (!check_token(&chunk->checker, &chunk->doc->tokens[i], &error)) {
+            continue;
+        }
+        
+        // Expand error array if needed
+        if (chunk->error_count >= chunk->error_capacity) {
+            int new_capacity = (chunk->error_capacity == 0) ? 100 : chunk->error_capacity * 2;
+            SpellError* new_errors = realloc(chunk->errors, new_capacity * sizeof(SpellError));
+            if (!new_errors) {
+                free_spell_error(&error);
+                break; // Memory allocation failed, return partial results
+            }
+            PROFILE_ALLOCATION(new_capacity * sizeof(SpellError));
+            chunk->errors = new_errors;
+            chunk->error_capacity = new_capacity;
+        }
+        
+        chunk->errors[chunk->error_count++] = error;
+    }
+    
+    // Real-word errors are looked for once the range's spelling is known
+    if (g_context_model) {
+        double started = profile_clock();
+        check_context_range(chunk);
+        profile_stop(&chunk->checker.profile.context_seconds, started);
+    }
+}
+
+/**
+ * Thread entry point wrapping check_token_range(); the work counters of
+ * this thread are the chunk's
+ */
+static void* spell_check_worker(void* arg) {
+    SpellCheckChunk* chunk = (SpellCheckChunk*)arg;
+    ProfileCounters before = profile_read_counters();
+    check_token_range(chunk);
+    ProfileCounters after = profile_read_counters();
+    profile_add_counters(&chunk->checker.profile, &before, &after);
+    return NULL;
+}
+
+/**
+ * Bytes held by an error's strings and suggestion arrays
+ */
+static size_t spell_error_memory(const SpellError* error) {
+    size_t bytes = 0;
+    if (error->misspelled_word) bytes += strlen(error->misspelled_word) + 1;
+    if (error->original_word) bytes += strlen(error->original_word) + 1;
+    if (error->suggestions) {
+        bytes += error->suggestion_count * (sizeof(char*) + sizeof(float));
+        for (int i = 0; i < error->suggestion_count; i++) {
+            bytes += strlen(error->suggestions[i]) + 1;
+        }
+    }
+    return bytes;
+}
+
+/**
+ * Bytes an error takes without its suggestions
+ */
+static size_t spell_error_base_memory(const SpellError* error) {
+    size_t bytes = sizeof(SpellError);
+    if (error->misspelled_word) bytes += strlen(error->misspelled_word) + 1;
+    if (error->original_word) bytes += strlen(error->original_word) + 1;
+    return bytes;
+}
+
+/**
+ * Fit a result's errors in the results budget and set its memory_used.
+ * Errors come before suggestions: every error is kept once room for all
+ * of them is reserved, with its suggestions while those still fit. Only
+ * when the errors alone are over budget are the last ones dropped. A
+ * warning tells what was given up.
+ */
+static void apply_results_budget(SpellCheckResult* result) {
+    size_t remaining_base = 0;
+    for (int i = 0; i < result->error_count; i++) {
+        remaining_base += spell_error_base_memory(&result->errors[i]);
+    }
+    
+    size_t bytes = sizeof(SpellCheckResult);
+    int stripped = 0;
+    int kept = 0;
+    for (; kept < result->error_count; kept++) {
+        SpellError* error = &result->errors[kept];
+        size_t base = spell_error_base_memory(error);
+        remaining_base -= base;
+        
+        size_t full = sizeof(SpellError) + spell_error_memory(error);
+        if (stripped == 0 && !memory_would_exceed(MEMORY_COMPONENT_RESULTS, bytes + full + remaining_base)) {
+            bytes += full;
+            continue;
+        }
+        if (memory_would_exceed(MEMORY_COMPONENT_RESULTS, bytes + base)) {
+            break;
         }
         
-        if (error->suggestion_scores) {
+        if (error->suggestions) {
+            for (int j = 0; j < error->suggestion_count; j++) {
+                free(error->suggestions[j]);
+            }
+            free(error->suggestions);
             free(error->suggestion_scores);
+            error->suggestions = NULL;
+            error->suggestion_scores = NULL;
+            error->suggestion_count = 0;
+            stripped++;
+        }
+        bytes += base;
+    }
+    
+    int dropped = result->error_count - kept;
+    for (int i = kept; i < result->error_count; i++) {
+        free_spell_error(&result->errors[i]);
+    }
+    result->error_count = kept;
+    if (kept == 0) {
+        free(result->errors);
+        result->errors = NULL;
+    } else if (dropped > 0) {
+        SpellError* errors = realloc(result->errors, kept * sizeof(SpellError));
+        if (errors) {
+            result->errors = errors;
         }
     }
     
+    if (stripped > 0 || dropped > 0) {
+        fprintf(stderr, "Warning: Results memory budget reached: suggestions dropped from %d errors, %d errors dropped\n",
+                stripped, dropped);
+    }
+    result->memory_used = bytes;
+}
+
+/**
+ * Collect the document's unique out-of-dictionary words and validate them
+ * through the API in one concurrent batch, before checking starts
+ */
+static void validate_unknown_words(TextDocument* doc, Trie* dictionary, WordCache* answers) {
+    const char** unknown = NULL;
+    int unknown_count = 0;
+    int unknown_capacity = 0;
+    
+    for (int i = 0; i < doc->token_count; i++) {
+        const char* word = doc->tokens[i].word;
+        if (!is_valid_word(word) || !is_alphabetic_word(word)) {
+            continue;
+        }
+        
+        unsigned int hash = hash_word(word);
+        if (answers->capacity > 0 && word_cache_slot(answers, word, hash)->word != NULL) {
+            continue; // Already collected
+        }
+        if (trie_search(dictionary, word)) {
+            continue;
+        }
+        
+        if (unknown_count >= unknown_capacity) {
+            int new_capacity = (unknown_capacity == 0) ? 64 : unknown_capacity * 2;
+            const char** grown = realloc(unknown, new_capacity * sizeof(const char*));
+            if (!grown) {
+                break; // Validate what was collected; the rest is checked per word
+            }
+            unknown = grown;
+            unknown_capacity = new_capacity;
+        }
+        
+        if (!word_cache_insert(answers, word, hash, false)) {
+            break;
+        }
+        unknown[unknown_count++] = word;
+    }
+    
+    int* results = (unknown_count > 0) ? malloc(unknown_count * sizeof(int)) : NULL;
+    if (results) {
+        if (!g_quiet) {
+            printf("🔍 Checking %d unknown words via API...\n", unknown_count);
+        }
+        fetch_batch_from_api(unknown, unknown_count, results);
+        
+        for (int i = 0; i < unknown_count; i++) {
+            word_cache_slot(answers, unknown[i], hash_word(unknown[i]))->found = (results[i] == 1);
+            if (g_quiet) {
+                continue;
+            }
+            if (results[i] == 1) {
+                printf("✅ Word '%s' validated by API\n", unknown[i]);
+            } else if (results[i] == -1) {
+                printf("⚠️  API error for '%s', using local dictionary only\n", unknown[i]);
+            }
+        }
+    } else if (unknown_count > 0) {
+        // Batch could not run: forget the words so they are checked one by one
+        word_cache_free(answers);
+    }
+    
+    free(results);
+    free(unknown);
+}
+
+/**
+ * Allocate an empty result for a check of doc
+ */
+static SpellCheckResult* create_result(const TextDocument* doc) {
+    SpellCheckResult* result = malloc(sizeof(SpellCheckResult));
+    if (!result) {
+        return NULL;
+    }
+    
+    result->errors = NULL;
+    result->error_count = 0;
+    result->total_words_checked = 0;
+    result->processing_time = 0.0;
+    result->memory_used = 0;
+    result->cache_hits = 0;
+    result->cache_misses = 0;
+    memset(&result->profile, 0, sizeof(SpellCheckProfile));
+    if (PROFILE_ENABLED()) {
+        result->profile.tokenize_seconds = doc->tokenize_seconds;
+    }
+    return result;
+}
+
+/**
+ * Move the errors and counters of checked chunks into a result, in chunk
+ * order, and release the chunks' caches and buffers (not the array).
+ * Returns false if the merged error array cannot be allocated, in which
+ * case the chunks' errors are freed.
+ */
+static bool merge_chunk_results(SpellCheckResult* result, SpellCheckChunk* chunks, int chunk_count) {
+    int total_errors = 0;
+    for (int t = 0; t < chunk_count; t++) {
+        total_errors += chunks[t].error_count;
+        result->total_words_checked += chunks[t].checker.words_checked;
+        result->cache_hits += chunks[t].checker.cache_hits;
+        result->cache_misses += chunks[t].checker.cache_misses;
+        profile_merge(&result->profile, &chunks[t].checker.profile);
+        word_cache_free(&chunks[t].checker.cache);
+    }
+    
+    if (chunk_count == 1) {
+        result->errors = chunks[0].errors; // Transfer ownership
+        result->error_count = chunks[0].error_count;
+    } else if (total_errors > 0) {
+        result->errors = malloc(total_errors * sizeof(SpellError));
+        for (int t = 0; t < chunk_count; t++) {
+            if (result->errors && chunks[t].error_count > 0) {
+                memcpy(&result->errors[result->error_count], chunks[t].errors,
+                       chunks[t].error_count * sizeof(SpellError));
+                result->error_count += chunks[t].error_count;
+            } else if (!result->errors) {
+                // Memory allocation failed: release the chunk's errors
+                for (int i = 0; i < chunks[t].error_count; i++) {
+                    free_spell_error(&chunks[t].errors[i]);
+                }
+            }
+            free(chunks[t].errors);
+        }
+        if (!result->errors) {
+            return false;
+        }
+    } else {
+        for (int t = 0; t < chunk_count; t++) {
+            free(chunks[t].errors);
+        }
+    }
+    
+    apply_results_budget(result);
+    memory_charge(MEMORY_COMPONENT_RESULTS, result->memory_used);
+    return true;
+}
+
+/**
+ * Simple spell checking function
+ */
+SpellCheckResult* spell_check_document(TextDocument* doc, Trie* dictionary) {
+    return spell_check_document_parallel(doc, dictionary, 1);
+}
+
+/**
+ * Spell check a document with its tokens split across worker threads
+ */
+SpellCheckResult* spell_check_document_parallel(TextDocument* doc, Trie* dictionary, int thread_count) {
+    if (!doc || !dictionary) {
+        return NULL;
+    }
+    
+    // Allocate result structure
+    double check_started = timing_now_seconds();
+    ProfileCounters counters_before = profile_read_counters();
+    SpellCheckResult* result = create_result(doc);
+    if (!result) {
+        return NULL;
+    }
+    
+    // Never use more threads than tokens
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > MAX_CHECK_THREADS) thread_count = MAX_CHECK_THREADS;
+    if (thread_count > doc->token_count) thread_count = (doc->token_count > 0) ? doc->token_count : 1;
+    
+    SpellCheckChunk* chunks = calloc(thread_count, sizeof(SpellCheckChunk));
+    pthread_t* threads = calloc(thread_count, sizeof(pthread_t));
+    bool* started = calloc(thread_count, sizeof(bool));
+    if (!chunks || !threads || !started) {
+        free(chunks);
+        free(threads);
+        free(started);
+        free(result);
+        return NULL;
+    }
+    
+    // Validate all unknown words up front so checking never waits on the network
+    WordCache api_answers = { NULL, 0, 0, 0 };
+    if (is_api_initialized()) {
+        double started = profile_clock();
+        validate_unknown_words(doc, dictionary, &api_answers);
+        profile_stop(&result->profile.api_seconds, started);
+    }
+    
+    // Contiguous ranges keep each chunk's errors in document order
+    for (int t = 0; t < thread_count; t++) {
+        chunks[t].doc = doc;
+        chunks[t].checker.dictionary = dictionary;
+        chunks[t].checker.api_answers = &api_answers;
+        chunks[t].start = (int)((long long)doc->token_count * t / thread_count);
+        chunks[t].end = (int)((long long)doc->token_count * (t + 1) / thread_count);
+    }
+    
+    // The calling thread takes the first range; others run on workers
+    for (int t = 1; t < thread_count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, spell_check_worker, &chunks[t]) == 0;
+    }
+    check_token_range(&chunks[0]);
+    
+    for (int t = 1; t < thread_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        } else {
+            check_token_range(&chunks[t]); // Thread creation failed, run inline
+        }
+    }
+    ProfileCounters counters_after = profile_read_counters();
+    profile_add_counters(&result->profile, &counters_before, &counters_after);
+    
+    // Merge per-thread buffers in range order so output matches the serial path
+    bool merged = merge_chunk_results(result, chunks, thread_count);
+    word_cache_free(&api_answers);
+    
+    free(chunks);
+    free(threads);
+    free(started);
+    
+    if (!merged) {
+        free(result);
+        return NULL;
+    }
+    
+    result->processing_time = timing_now_seconds() - check_started;
+    return result;
+}
+
+/**
+ * Adapter state for spell_check_stream()
+ */
+typedef struct StreamCheckContext {
+    TokenChecker checker;           // Checking state for the whole stream
+    SpellErrorCallback callback;    // Caller's error callback
+    void* user_data;                // Caller's callback argument
+    int error_count;                // Errors reported so far
+    double checking_seconds;        // Time checking tokens and in the callback (profiling only)
+} StreamCheckContext;
+
+/**
+ * Token callback: check the token and hand any error to the caller
+ */
+static bool stream_check_token(const TextToken* token, void* user_data) {
+    StreamCheckContext* ctx = (StreamCheckContext*)user_data;
+    
+    SpellError error;
+    double started = profile_clock();
+    if (!check_token(&ctx->checker, token, &error)) {
+        profile_stop(&ctx->checking_seconds, started);
+        return true;
+    }
+    
+    ctx->error_count++;
+    bool keep_going = ctx->callback(&error, ctx->user_data);
+    free_spell_error(&error);
+    profile_stop(&ctx->checking_seconds, started);
+    return keep_going;
+}
+
+/**
+ * Spell check a file token by token, reporting errors as they are found
+ */
+bool spell_check_stream(const char* filename, Trie* dictionary,
+                        SpellErrorCallback callback, void* user_data, SpellCheckResult* summary) {
+    if (!filename || !dictionary || !callback) {
+        return false;
+    }
+    
+    StreamCheckContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.checker.dictionary = dictionary;
+    ctx.checker.cache_limit = STREAM_CACHE_MAX_WORDS;
+    ctx.callback = callback;
+    ctx.user_data = user_data;
+    
+    double started = timing_now_seconds();
+    ProfileCounters before = profile_read_counters();
+    bool ok = stream_text_file(filename, stream_check_token, &ctx);
+    ProfileCounters after = profile_read_counters();
+    double elapsed = timing_now_seconds() - started;
+    
+    if (summary) {
+        summary->errors = NULL;
+        summary->error_count = ctx.error_count;
+        summary->total_words_checked = ctx.checker.words_checked;
+        summary->processing_time = elapsed;
+        summary->memory_used = 0;
+        summary->cache_hits = ctx.checker.cache_hits;
+        summary->cache_misses = ctx.checker.cache_misses;
+        summary->profile = ctx.checker.profile;
+        profile_add_counters(&summary->profile, &before, &after);
+        
+        // Reading and tokenizing is what the stream spends outside the checker and callback
+        if (PROFILE_ENABLED()) {
+            summary->profile.tokenize_seconds = elapsed - ctx.checking_seconds;
+        }
+    }
+    
+    word_cache_free(&ctx.checker.cache);
+    return ok;
+}
+
+/**
+ * Tokens per check task of a batch; longer documents are split so that
+ * idle workers can steal parts of them
+ */
+#define BATCH_CHUNK_TOKENS 16384
+
+/**
+ * A check task of a batch: one token range of one document
+ */
+typedef struct BatchTask {
+    int document;               // Index of the document
+    int chunk;                  // Index of the range within the document
+} BatchTask;
+
+/**
+ * A worker's double-ended task queue. The owner pushes and pops at the
+ * tail (newest first, while the document is still in cache); thieves take
+ * from the head (oldest first).
+ */
+typedef struct BatchDeque {
+    BatchTask* tasks;           // Task slots; queued tasks are [head, tail)
+    int head;                   // Oldest task
+    int tail;                   // One past the newest task
+    int capacity;               // Allocated slots
+} BatchDeque;
+
+/**
+ * State of one document while its batch runs
+ */
+typedef struct BatchDocument {
+    TextDocument* doc;          // Tokenized document, freed once checked
+    SpellCheckChunk* chunks;    // One per check task
+    int chunk_count;            // Number of check tasks
+    int chunks_pending;         // Check tasks not finished yet
+    WordCache api_answers;      // API validation of the document's unknown words
+    SpellCheckBatchItem item;   // What the callback receives
+    double check_started;       // When the document's check tasks were queued
+    bool done;                  // Ready to be handed to the callback
+} BatchDocument;
+
+/**
+ * Shared state of a spell_check_batch() run. Queues, counters and flags
+ * are guarded by lock; a document's chunks belong to whoever runs them.
+ */
+typedef struct BatchPool {
+    const char* const* filenames;     // Input list
+    Trie* dictionary;                 // Dictionary (read-only)
+    SpellBatchCallback callback;      // Caller's document callback
+    void* user_data;                  // Caller's callback argument
+    BatchDocument* documents;         // One per input file
+    int document_count;               // Number of input files
+    BatchDeque* deques;               // One task queue per worker
+    int worker_count;                 // Number of workers
+    pthread_mutex_t lock;             // Guards everything below
+    pthread_cond_t work_available;    // Signaled when tasks are queued or a load finishes
+    int next_file;                    // Next file to load
+    int loading;                      // Workers reading and tokenizing a file
+    int next_emit;                    // Next document for the callback
+    bool emitting;                    // A worker is running callbacks
+    bool stopped;                     // The callback asked to stop
+    SpellCheckBatchSummary summary;   // Totals so far
+} BatchPool;
+
+/**
+ * Argument of a batch worker thread
+ */
+typedef struct BatchWorker {
+    BatchPool* pool;            // Shared state
+    int id;                     // Index of the worker's own queue
+} BatchWorker;
+
+/**
+ * Queue a task at the tail of a deque. Returns false on memory allocation failure.
+ */
+static bool batch_deque_push(BatchDeque* deque, BatchTask task) {
+    if (deque->tail == deque->capacity) {
+        if (deque->head > 0) {
+            // Reuse the slots of stolen tasks before growing
+            memmove(deque->tasks, deque->tasks + deque->head, (deque->tail - deque->head) * sizeof(BatchTask));
+            deque->tail -= deque->head;
+            deque->head = 0;
+        } else {
+            int new_capacity = (deque->capacity == 0) ? 64 : deque->capacity * 2;
+            BatchTask* grown = realloc(deque->tasks, new_capacity * sizeof(BatchTask));
+            if (!grown) {
+                return false;
+            }
+            deque->tasks = grown;
+            deque->capacity = new_capacity;
+        }
+    }
+    
+    deque->tasks[deque->tail++] = task;
+    return true;
+}
+
+/**
+ * Take the newest task of a deque (its owner's end)
+ */
+static bool batch_deque_pop(BatchDeque* deque, BatchTask* task) {
+    if (deque->head == deque->tail) {
+        return false;
+    }
+    *task = deque->tasks[--deque->tail];
+    if (deque->head == deque->tail) {
+        deque->head = deque->tail = 0;
+    }
+    return true;
+}
+
+/**
+ * Take the oldest task of a deque (the end thieves use)
+ */
+static bool batch_deque_steal(BatchDeque* deque, BatchTask* task) {
+    if (deque->head == deque->tail) {
+        return false;
+    }
+    *task = deque->tasks[deque->head++];
+    if (deque->head == deque->tail) {
+        deque->head = deque->tail = 0;
+    }
+    return true;
+}
+
+/**
+ * Hand every finished document at the front of the input order to the
+ * callback. Called with the pool lock held; the lock is released around
+ * each callback, and only one worker runs callbacks at a time.
+ */
+static void batch_emit_ready(BatchPool* pool) {
+    if (pool->emitting) {
+        return; // That worker picks up this document too
+    }
+    
+    pool->emitting = true;
+    while (pool->next_emit < pool->document_count && pool->documents[pool->next_emit].done) {
+        BatchDocument* entry = &pool->documents[pool->next_emit];
+        bool deliver = !pool->stopped;
+        if (deliver && entry->item.result) {
+            pool->summary.documents_checked++;
+            pool->summary.total_words_checked += entry->item.result->total_words_checked;
+            pool->summary.total_errors += entry->item.result->error_count;
+        } else if (deliver) {
+            pool->summary.documents_failed++;
+        }
+        
+        pthread_mutex_unlock(&pool->lock);
+        bool keep_going = !deliver || pool->callback(&entry->item, pool->user_data);
+        free_spell_check_result(entry->item.result);
+        entry->item.result = NULL;
+        pthread_mutex_lock(&pool->lock);
+        
+        if (!keep_going) {
+            pool->stopped = true;
+        }
+        pool->next_emit++;
+    }
+    pool->emitting = false;
+}
+
+/**
+ * Merge a document's chunks once its last check task finished, release
+ * the document and pass it on in input order
+ */
+static void batch_finish_document(BatchPool* pool, BatchDocument* entry) {
+    SpellCheckResult* result = entry->item.result;
+    if (merge_chunk_results(result, entry->chunks, entry->chunk_count)) {
+        result->processing_time = timing_now_seconds() - entry->check_started;
+    } else {
+        free(result);
+        entry->item.result = NULL;
+    }
+    
+    word_cache_free(&entry->api_answers);
+    free(entry->chunks);
+    entry->chunks = NULL;
+    free_text_document(entry->doc);
+    entry->doc = NULL;
+    
+    pthread_mutex_lock(&pool->lock);
+    entry->done = true;
+    batch_emit_ready(pool);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Run one check task (skip means the batch was stopped: only account for it)
+ */
+static void batch_check_chunk(BatchPool* pool, BatchTask task, bool skip) {
+    BatchDocument* entry = &pool->documents[task.document];
+    SpellCheckChunk* chunk = &entry->chunks[task.chunk];
+    
+    if (!skip) {
+        ProfileCounters before = profile_read_counters();
+        check_token_range(chunk);
+        ProfileCounters after = profile_read_counters();
+        profile_add_counters(&chunk->checker.profile, &before, &after);
+    }
+    
+    pthread_mutex_lock(&pool->lock);
+    bool last = --entry->chunks_pending == 0;
+    pthread_mutex_unlock(&pool->lock);
+    
+    if (last) {
+        batch_finish_document(pool, entry);
+    }
+}
+
+/**
+ * Read and tokenize one file and split it into check tasks (not queued
+ * yet). On failure the document is left without chunks.
+ */
+static void batch_load_document(BatchPool* pool, int index) {
+    BatchDocument* entry = &pool->documents[index];
+    entry->item.index = index;
+    entry->item.filename = pool->filenames[index];
+    
+    double started = timing_now_seconds();
+    TextDocument* doc = load_text_file_quiet(pool->filenames[index]);
+    entry->item.load_seconds = timing_now_seconds() - started;
+    if (!doc) {
+        return;
+    }
+    entry->item.token_count = doc->token_count;
+    entry->item.bytes = doc->text_size;
+    
+    int chunk_count = (doc->token_count + BATCH_CHUNK_TOKENS - 1) / BATCH_CHUNK_TOKENS;
+    if (chunk_count < 1) {
+        chunk_count = 1;
+    }
+    
+    SpellCheckChunk* chunks = calloc(chunk_count, sizeof(SpellCheckChunk));
+    SpellCheckResult* result = create_result(doc);
+    if (!chunks || !result) {
+        free(chunks);
+        free(result);
+        free_text_document(doc);
+        return;
+    }
+    
+    // Validate all unknown words up front so checking never waits on the network
+    if (is_api_initialized()) {
+        double api_started = profile_clock();
+        validate_unknown_words(doc, pool->dictionary, &entry->api_answers);
+        profile_stop(&result->profile.api_seconds, api_started);
+    }
+    
+    // Contiguous ranges keep each chunk's errors in document order
+    for (int c = 0; c < chunk_count; c++) {
+        chunks[c].doc = doc;
+        chunks[c].checker.dictionary = pool->dictionary;
+        chunks[c].checker.api_answers = &entry->api_answers;
+        chunks[c].start = (int)((long long)doc->token_count * c / chunk_count);
+        chunks[c].end = (int)((long long)doc->token_count * (c + 1) / chunk_count);
+    }
+    
+    entry->doc = doc;
+    entry->chunks = chunks;
+    entry->chunk_count = chunk_count;
+    entry->chunks_pending = chunk_count;
+    entry->item.result = result;
+    entry->check_started = timing_now_seconds();
+}
+
+/**
+ * Queue the check tasks of a freshly loaded document on a worker's own
+ * deque, or pass a failed document on. Called with the pool lock held.
+ */
+static void batch_queue_document(BatchPool* pool, int worker, int index) {
+    BatchDocument* entry = &pool->documents[index];
+    if (!entry->doc) {
+        entry->done = true;
+        batch_emit_ready(pool);
+        return;
+    }
+    
+    // Pushed last to first, so the owner checks the document front to back
+    for (int c = entry->chunk_count - 1; c >= 0; c--) {
+        BatchTask task = { index, c };
+        if (!batch_deque_push(&pool->deques[worker], task)) {
+            // Out of memory: check the range right away instead
+            pool->summary.tasks_run++;
+            pthread_mutex_unlock(&pool->lock);
+            batch_check_chunk(pool, task, false);
+            pthread_mutex_lock(&pool->lock);
+        }
+    }
+}
+
+/**
+ * Batch worker: run own tasks, then steal, then load the next file
+ */
+static void* batch_worker(void* arg) {
+    BatchWorker* worker = (BatchWorker*)arg;
+    BatchPool* pool = worker->pool;
+    
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        BatchTask task;
+        bool found = batch_deque_pop(&pool->deques[worker->id], &task);
+        bool stolen = false;
+        for (int k = 1; !found && k < pool->worker_count; k++) {
+            found = stolen = batch_deque_steal(&pool->deques[(worker->id + k) % pool->worker_count], &task);
+        }
+        
+        if (found) {
+            pool->summary.tasks_run++;
+            if (stolen) {
+                pool->summary.tasks_stolen++;
+            }
+            bool skip = pool->stopped;
+            pthread_mutex_unlock(&pool->lock);
+            batch_check_chunk(pool, task, skip);
+            pthread_mutex_lock(&pool->lock);
+            continue;
+        }
+        
+        if (!pool->stopped && pool->next_file < pool->document_count) {
+            int index = pool->next_file++;
+            pool->loading++;
+            pool->summary.tasks_run++;
+            pthread_mutex_unlock(&pool->lock);
+            batch_load_document(pool, index);
+            pthread_mutex_lock(&pool->lock);
+            pool->loading--;
+            batch_queue_document(pool, worker->id, index);
+            pthread_cond_broadcast(&pool->work_available);
+            continue;
+        }
+        
+        // Only a load in progress can still produce tasks
+        if (pool->loading == 0) {
+            break;
+        }
+        pthread_cond_wait(&pool->work_available, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * Spell check many files on a work-stealing pool, reporting in input order
+ */
+bool spell_check_batch(const char* const* filenames, int file_count, Trie* dictionary, int thread_count,
+                       SpellBatchCallback callback, void* user_data, SpellCheckBatchSummary* summary) {
+    if (!filenames || file_count < 0 || !dictionary || !callback) {
+        return false;
+    }
+    
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > MAX_CHECK_THREADS) thread_count = MAX_CHECK_THREADS;
+    
+    BatchPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.filenames = filenames;
+    pool.dictionary = dictionary;
+    pool.callback = callback;
+    pool.user_data = user_data;
+    pool.document_count = file_count;
+    pool.worker_count = thread_count;
+    pool.documents = calloc(file_count > 0 ? file_count : 1, sizeof(BatchDocument));
+    pool.deques = calloc(thread_count, sizeof(BatchDeque));
+    BatchWorker* workers = calloc(thread_count, sizeof(BatchWorker));
+    pthread_t* threads = calloc(thread_count, sizeof(pthread_t));
+    bool* started = calloc(thread_count, sizeof(bool));
+    if (!pool.documents || !pool.deques || !workers || !threads || !started) {
+        free(pool.documents);
+        free(pool.deques);
+        free(workers);
+        free(threads);
+        free(started);
+        return false;
+    }
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.work_available, NULL);
+    
+    double batch_started = timing_now_seconds();
+    
+    // The calling thread is worker 0
+    for (int t = 0; t < thread_count; t++) {
+        workers[t].pool = &pool;
+        workers[t].id = t;
+    }
+    for (int t = 1; t < thread_count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, batch_worker, &workers[t]) == 0;
+    }
+    batch_worker(&workers[0]);
+    for (int t = 1; t < thread_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    
+    // Documents finished after a stop were never handed out
+    for (int i = pool.next_emit; i < file_count; i++) {
+        free_spell_check_result(pool.documents[i].item.result);
+    }
+    for (int t = 0; t < thread_count; t++) {
+        free(pool.deques[t].tasks);
+    }
+    
+    pool.summary.elapsed_seconds = timing_now_seconds() - batch_started;
+    if (summary) {
+        *summary = pool.summary;
+    }
+    
+    pthread_cond_destroy(&pool.work_available);
+    pthread_mutex_destroy(&pool.lock);
+    free(pool.documents);
+    free(pool.deques);
+    free(workers);
+    free(threads);
+    free(started);
+    return true;
+}
+
+/**
+ * Unique words a session remembers before its cache is reset
+ */
+#define SESSION_CACHE_MAX_WORDS 16384
+
+/**
+ * Bytes of free space a session's text buffer starts with
+ */
+#define SESSION_INITIAL_GAP 4096
+
+/**
+ * A token of a session and its check outcome
+ */
+typedef struct SessionToken {
+    char* word;                 // Normalized word; the original follows it in the same block
+    char* original_word;        // Original word
+    size_t offset;              // Before the gap: byte offset; behind it: bytes from the token to the end
+    size_t length;              // Length of the original word in bytes
+    int line;                   // Before the gap: line number; behind it: newlines from the token to the end
+    int position;               // Byte position within its line
+    bool counted;               // Counted as a checked word
+    bool has_error;             // error holds the token's misspelling
+    SpellError error;           // Line and position are filled in when copied out
+} SessionToken;
+
+/**
+ * An incremental spell check session (see spell_check.h)
+ */
+struct SpellSession {
+    TokenChecker checker;       // Dictionary and word cache kept across edits
+    char* text;                 // Gap buffer: text is [0, gap_start) then [gap_end, capacity)
+    size_t capacity;            // Bytes allocated for text
+    size_t gap_start;           // First free byte
+    size_t gap_end;             // One past the last free byte
+    int newlines;               // Line breaks in the whole text
+    int newlines_before_gap;    // Line breaks in [0, gap_start)
+    SessionToken* tokens;       // Gap array: tokens are [0, token_gap_start) then [token_gap_end, token_capacity)
+    int token_capacity;         // Slots allocated for tokens
+    int token_gap_start;        // First free slot
+    int token_gap_end;          // One past the last free slot
+    int error_count;            // Tokens with an error
+    int words_checked;          // Tokens counted as checked words
+};
+
+/**
+ * Length of a session's text in bytes
+ */
+static size_t session_length(const SpellSession* session) {
+    return session->capacity - (session->gap_end - session->gap_start);
+}
+
+/**
+ * Byte at an offset of a session's text
+ */
+static char session_byte(const SpellSession* session, size_t offset) {
+    if (offset < session->gap_start) {
+        return session->text[offset];
+    }
+    return session->text[offset + (session->gap_end - session->gap_start)];
+}
+
+/**
+ * Count the line breaks in a byte range
+ */
+static int count_newlines(const char* text, size_t length) {
+    int count = 0;
+    const char* end = text + length;
+    while ((text = memchr(text, '\n', end - text)) != NULL) {
+        count++;
+        text++;
+    }
+    return count;
+}
+
+/**
+ * Move the text gap so that it starts at offset
+ */
+static void session_move_gap(SpellSession* session, size_t offset) {
+    if (offset < session->gap_start) {
+        size_t moved = session->gap_start - offset;
+        session->newlines_before_gap -= count_newlines(session->text + offset, moved);
+        session->gap_end -= moved;
+        memmove(session->text + session->gap_end, session->text + offset, moved);
+        session->gap_start = offset;
+    } else if (offset > session->gap_start) {
+        size_t moved = offset - session->gap_start;
+        memmove(session->text + session->gap_start, session->text + session->gap_end, moved);
+        session->newlines_before_gap += count_newlines(session->text + session->gap_start, moved);
+        session->gap_start += moved;
+        session->gap_end += moved;
+    }
+}
+
+/**
+ * Make the text gap at least needed bytes long. Returns false on memory
+ * allocation failure.
+ */
+static bool session_reserve_text(SpellSession* session, size_t needed) {
+    size_t gap = session->gap_end - session->gap_start;
+    if (gap >= needed) {
+        return true;
+    }
+    
+    size_t length = session_length(session);
+    size_t capacity = session->capacity * 2;
+    if (capacity < length + needed + SESSION_INITIAL_GAP) {
+        capacity = length + needed + SESSION_INITIAL_GAP;
+    }
+    
+    char* text = malloc(capacity);
+    if (!text) {
+        return false;
+    }
+    size_t tail = session->capacity - session->gap_end;
+    memcpy(text, session->text, session->gap_start);
+    memcpy(text + capacity - tail, session->text + session->gap_end, tail);
+    free(session->text);
+    session->text = text;
+    session->gap_end = capacity - tail;
+    session->capacity = capacity;
+    return true;
+}
+
+/**
+ * Make the token gap at least needed slots long. Returns false on memory
+ * allocation failure.
+ */
+static bool session_reserve_tokens(SpellSession* session, int needed) {
+    if (session->token_gap_end - session->token_gap_start >= needed) {
+        return true;
+    }
+    
+    int used = session->token_capacity - (session->token_gap_end - session->token_gap_start);
+    int capacity = session->token_capacity * 2;
+    if (capacity < used + needed + 64) {
+        capacity = used + needed + 64;
+    }
+    
+    SessionToken* tokens = malloc(capacity * sizeof(SessionToken));
+    if (!tokens) {
+        return false;
+    }
+    int tail = session->token_capacity - session->token_gap_end;
+    if (session->tokens) {
+        memcpy(tokens, session->tokens, session->token_gap_start * sizeof(SessionToken));
+        memcpy(tokens + capacity - tail, session->tokens + session->token_gap_end, tail * sizeof(SessionToken));
+        free(session->tokens);
+    }
+    session->tokens = tokens;
+    session->token_gap_end = capacity - tail;
+    session->token_capacity = capacity;
+    return true;
+}
+
+/**
+ * Move the token gap so that exactly the tokens starting before offset
+ * precede it, switching moved tokens between counting from the start and
+ * from the end of the text
+ */
+static void session_move_token_gap(SpellSession* session, size_t offset) {
+    size_t length = session_length(session);
+    
+    while (session->token_gap_start > 0 && session->tokens[session->token_gap_start - 1].offset >= offset) {
+        SessionToken token = session->tokens[--session->token_gap_start];
+        token.offset = length - token.offset;
+        token.line = session->newlines - (token.line - 1);
+        session->tokens[--session->token_gap_end] = token;
+    }
+    
+    while (session->token_gap_end < session->token_capacity &&
+           length - session->tokens[session->token_gap_end].offset < offset) {
+        SessionToken token = session->tokens[session->token_gap_end++];
+        token.offset = length - token.offset;
+        token.line = session->newlines - token.line + 1;
+        session->tokens[session->token_gap_start++] = token;
+    }
+}
+
+/**
+ * Whether a new token is certain to get the same check outcome as an old
+ * one: same original text, and both or neither starting a line (see
+ * is_likely_proper_noun())
+ */
+static bool same_check_outcome(const SessionToken* old, const TextToken* token) {
+    return (old->position == 0) == (token->position == 0) &&
+           strcmp(old->original_word, token->original_word) == 0;
+}
+
+/**
+ * Release a session token's strings and error
+ */
+static void free_session_token(SessionToken* token) {
+    free(token->word);
+    if (token->has_error) {
+        free_spell_error(&token->error);
+    }
+}
+
+/**
+ * Start a session: an empty text, then one edit inserting all of it
+ */
+SpellSession* spell_session_create(Trie* dictionary, const char* text, size_t length) {
+    if (!dictionary || (!text && length > 0)) {
+        return NULL;
+    }
+    
+    SpellSession* session = calloc(1, sizeof(SpellSession));
+    if (!session) {
+        return NULL;
+    }
+    session->checker.dictionary = dictionary;
+    session->checker.cache_limit = SESSION_CACHE_MAX_WORDS;
+    session->capacity = length + SESSION_INITIAL_GAP;
+    session->text = malloc(session->capacity);
+    if (!session->text) {
+        free(session);
+        return NULL;
+    }
+    session->gap_end = session->capacity;
+    
+    if (!spell_session_edit(session, 0, 0, text, length, NULL)) {
+        spell_session_destroy(session);
+        return NULL;
+    }
+    return session;
+}
+
+/**
+ * Apply an edit and re-check the lines it touches
+ */
+bool spell_session_edit(SpellSession* session, size_t offset, size_t removed,
+                        const char* inserted, size_t inserted_length, SpellSessionEdit* edit) {
+    if (!session || (!inserted && inserted_length > 0)) {
+        return false;
+    }
+    size_t length = session_length(session);
+    if (offset > length || removed > length - offset) {
+        return false;
+    }
+    
+    double started = timing_now_seconds();
+    
+    // Tokens never span a line break and a line tokenizes the same whatever
+    // surrounds it, so re-tokenizing the touched lines is enough
+    size_t start = offset;
+    while (start > 0 && session_byte(session, start - 1) != '\n') {
+        start--;
+    }
+    size_t end = offset + removed;
+    while (end < length && session_byte(session, end) != '\n') {
+        end++;
+    }
+    
+    // The old lines are contiguous once the gap sits at their start
+    session_move_gap(session, start);
+    const char* old_lines = session->text + session->gap_end;
+    size_t old_size = end - start;
+    size_t new_size = old_size - removed + inserted_length;
+    if (!session_reserve_text(session, new_size + 1)) {
+        return false;
+    }
+    old_lines = session->text + session->gap_end;
+    
+    char* new_lines = malloc(new_size + 1);
+    if (!new_lines) {
+        return false;
+    }
+    size_t kept_before = offset - start;
+    memcpy(new_lines, old_lines, kept_before);
+    if (inserted_length > 0) {
+        memcpy(new_lines + kept_before, inserted, inserted_length);
+    }
+    memcpy(new_lines + kept_before + inserted_length, old_lines + kept_before + removed, old_size - kept_before - removed);
+    
+    TextDocument* doc = load_text_buffer(new_lines, new_size);
+    if (!doc) {
+        free(new_lines);
+        return false;
+    }
+    
+    // The old tokens of the lines follow the token gap
+    session_move_token_gap(session, start);
+    int old_count = 0;
+    while (session->token_gap_end + old_count < session->token_capacity &&
+           length - session->tokens[session->token_gap_end + old_count].offset < end) {
+        old_count++;
+    }
+    
+    int new_count = doc->token_count;
+    SessionToken* fresh = calloc(new_count > 0 ? new_count : 1, sizeof(SessionToken));
+    bool allocated = fresh != NULL && session_reserve_tokens(session, new_count - old_count);
+    for (int i = 0; allocated && i < new_count; i++) {
+        size_t word_size = strlen(doc->tokens[i].word) + 1;
+        size_t original_size = strlen(doc->tokens[i].original_word) + 1;
+        fresh[i].word = malloc(word_size + original_size);
+        if (!fresh[i].word) {
+            allocated = false;
+            break;
+        }
+        memcpy(fresh[i].word, doc->tokens[i].word, word_size);
+        fresh[i].original_word = memcpy(fresh[i].word + word_size, doc->tokens[i].original_word, original_size);
+    }
+    if (!allocated) {
+        for (int i = 0; fresh && i < new_count; i++) {
+            free(fresh[i].word);
+        }
+        free(fresh);
+        free_text_document(doc);
+        free(new_lines);
+        return false;
+    }
+    
+    // Typing changes a token or two in the middle of a line: the tokens of
+    // the common prefix and suffix keep their outcome
+    SessionToken* old = &session->tokens[session->token_gap_end];
+    int prefix = 0;
+    while (prefix < old_count && prefix < new_count && same_check_outcome(&old[prefix], &doc->tokens[prefix])) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < old_count - prefix && suffix < new_count - prefix &&
+           same_check_outcome(&old[old_count - 1 - suffix], &doc->tokens[new_count - 1 - suffix])) {
+        suffix++;
+    }
+    
+    int errors_removed = 0;
+    int counted_removed = 0;
+    for (int j = 0; j < old_count; j++) {
+        errors_removed += old[j].has_error;
+        counted_removed += old[j].counted;
+    }
+    
+    int base_line = session->newlines_before_gap + 1;
+    int errors_added = 0;
+    int counted_added = 0;
+    int tokens_checked = 0;
+    for (int i = 0; i < new_count; i++) {
+        const TextToken* token = &doc->tokens[i];
+        SessionToken* entry = &fresh[i];
+        entry->offset = start + token->offset;
+        entry->length = token->length;
+        entry->line = base_line + token->line_number - 1;
+        entry->position = token->position;
+        
+        int reused = -1;
+        if (i < prefix) {
+            reused = i;
+        } else if (i >= new_count - suffix) {
+            reused = old_count - (new_count - i);
+        }
+        
+        if (reused >= 0) {
+            entry->counted = old[reused].counted;
+            entry->has_error = old[reused].has_error;
+            entry->error = old[reused].error;
+            old[reused].has_error = false; // Moved to the new token
+        } else {
+            int words_before = session->checker.words_checked;
+            entry->has_error = check_token(&session->checker, token, &entry->error);
+            entry->counted = session->checker.words_checked > words_before;
+            tokens_checked++;
+        }
+        errors_added += entry->has_error;
+        counted_added += entry->counted;
+    }
+    
+    // Replace the old lines and their tokens
+    for (int j = 0; j < old_count; j++) {
+        free_session_token(&old[j]);
+    }
+    session->token_gap_end += old_count;
+    memcpy(session->tokens + session->token_gap_start, fresh, new_count * sizeof(SessionToken));
+    session->token_gap_start += new_count;
+    
+    int removed_newlines = count_newlines(old_lines, old_size);
+    int added_newlines = count_newlines(new_lines, new_size);
+    session->gap_end += old_size;
+    memcpy(session->text + session->gap_start, new_lines, new_size);
+    session->gap_start += new_size;
+    session->newlines += added_newlines - removed_newlines;
+    session->newlines_before_gap += added_newlines;
+    
+    session->error_count += errors_added - errors_removed;
+    session->words_checked += counted_added - counted_removed;
+    
+    if (edit) {
+        edit->start = start;
+        edit->end = start + new_size;
+        edit->tokens_removed = old_count;
+        edit->tokens_added = new_count;
+        edit->tokens_checked = tokens_checked;
+        edit->errors_removed = errors_removed;
+        edit->errors_added = errors_added;
+        edit->processing_time = timing_now_seconds() - started;
+    }
+    
+    free(fresh);
+    free_text_document(doc);
+    free(new_lines);
+    return true;
+}
+
+/**
+ * Get the session's text, closing the gap at its end
+ */
+const char* spell_session_text(SpellSession* session, size_t* length) {
+    if (!session) {
+        return NULL;
+    }
+    
+    // The gap is never empty, so there is always room for the terminator
+    size_t text_length = session_length(session);
+    session_move_gap(session, text_length);
+    session->text[text_length] = '\0';
+    if (length) {
+        *length = text_length;
+    }
+    return session->text;
+}
+
+int spell_session_error_count(const SpellSession* session) {
+    return session ? session->error_count : 0;
+}
+
+/**
+ * Copy an error with its strings and suggestions. Returns false on memory
+ * allocation failure, leaving *copy empty.
+ */
+static bool copy_spell_error(const SpellError* error, SpellError* copy) {
+    *copy = *error;
+    copy->misspelled_word = safe_strdup(error->misspelled_word);
+    copy->original_word = safe_strdup(error->original_word);
+    copy->suggestions = copy_suggestions(error->suggestions, error->suggestion_scores, error->suggestion_count,
+                                         &copy->suggestion_count, &copy->suggestion_scores);
+    if (!copy->misspelled_word || !copy->original_word || (error->suggestion_count > 0 && !copy->suggestions)) {
+        free_spell_error(copy);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Copy the session's errors into a new result, in text order
+ */
+SpellCheckResult* spell_session_result(const SpellSession* session) {
+    if (!session) {
+        return NULL;
+    }
+    
+    SpellCheckResult* result = calloc(1, sizeof(SpellCheckResult));
+    if (!result) {
+        return NULL;
+    }
+    if (session->error_count > 0) {
+        result->errors = malloc(session->error_count * sizeof(SpellError));
+        if (!result->errors) {
+            free(result);
+            return NULL;
+        }
+    }
+    
+    double started = timing_now_seconds();
+    for (int i = 0; i < session->token_capacity; i++) {
+        if (i == session->token_gap_start) {
+            i = session->token_gap_end;
+            if (i == session->token_capacity) {
+                break;
+            }
+        }
+        const SessionToken* token = &session->tokens[i];
+        if (!token->has_error) {
+            continue;
+        }
+        
+        SpellError* error = &result->errors[result->error_count];
+        if (!copy_spell_error(&token->error, error)) {
+            free_spell_check_result(result);
+            return NULL;
+        }
+        error->line_number = (i < session->token_gap_start) ? token->line : session->newlines - token->line + 1;
+        error->position = token->position;
+        result->error_count++;
+    }
+    
+    result->total_words_checked = session->words_checked;
+    result->cache_hits = session->checker.cache_hits;
+    result->cache_misses = session->checker.cache_misses;
+    apply_results_budget(result);
+    memory_charge(MEMORY_COMPONENT_RESULTS, result->memory_used);
+    result->processing_time = timing_now_seconds() - started;
+    return result;
+}
+
+void spell_session_destroy(SpellSession* session) {
+    if (!session) {
+        return;
+    }
+    
+    for (int i = 0; i < session->token_capacity; i++) {
+        if (i == session->token_gap_start) {
+            i = session->token_gap_end;
+            if (i == session->token_capacity) {
+                break;
+            }
+        }
+        free_session_token(&session->tokens[i]);
+    }
+    free(session->tokens);
+    free(session->text);
+    word_cache_free(&session->checker.cache);
+    free(session);
+}
+
+/**
+ * Free all memory associated with a SpellCheckResult
+ */
+void free_spell_check_result(SpellCheckResult* result) {
+    if (!result) {
+        return;
+    }
+    
+    memory_release(MEMORY_COMPONENT_RESULTS, result->memory_used);
+    
+    // Free each error and its associated data
+    for (int i = 0; i < result->error_count; i++) {
+        free_spell_error(&result->errors[i]);
+    }
+    
     // Free errors array
     if (result->errors) {
         free(result->errors);
@@ -0,0 +1,376 @@
+#include "../include/symspell.h"
+#include "../include/edit_distance.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Candidates verified per call to edit_distance_batch_within()
+ */
+#define SYMSPELL_VERIFY_BATCH 64
+
+/**
+ * One hash table slot: the postings of all words sharing a delete hash
+ */
+typedef struct SymSpellBucket {
+    uint32_t hash;              // Hash of the delete string
+    uint32_t start;             // First index in postings
+    uint32_t count;             // Number of word ids (0 marks an empty slot)
+} SymSpellBucket;
+
+struct SymSpellIndex {
+    char* word_storage;         // All words, NUL-terminated, in alphabetical order
+    uint32_t* word_offsets;     // Start of word id in word_storage
+    int* word_frequencies;      // Frequency of word id in the source Trie
+    int word_count;             // Number of indexed words
+    int max_distance;           // Distance the deletes were generated for
+    SymSpellBucket* buckets;    // Open-addressing table keyed by delete hash
+    size_t bucket_mask;         // Slot count - 1 (slot count is a power of two)
+    size_t key_count;           // Occupied slots
+    uint32_t* postings;         // Word ids grouped by bucket, ascending within a bucket
+    size_t posting_count;       // Length of postings
+    size_t memory_usage;        // Bytes allocated by the index
+};
+
+/**
+ * Growable list of 64-bit values: (hash << 32) | word id while building,
+ * plain hashes or word ids while looking up
+ */
+typedef struct ValueList {
+    uint64_t* items;
+    size_t count;
+    size_t capacity;
+    uint32_t word_id;           // Id attached to hashes by collect_deletes()
+    bool failed;                // Set when growing failed
+} ValueList;
+
+/**
+ * FNV-1a hash of a string span
+ */
+static uint32_t hash_span(const char* text, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * Append a value, doubling the list when full
+ */
+static void value_list_push(ValueList* list, uint64_t value) {
+    if (list->failed) {
+        return;
+    }
+    
+    if (list->count == list->capacity) {
+        size_t new_capacity = (list->capacity == 0) ? 256 : list->capacity * 2;
+        uint64_t* grown = (uint64_t*)realloc(list->items, new_capacity * sizeof(uint64_t));
+        if (grown == NULL) {
+            list->failed = true;
+            return;
+        }
+        list->items = grown;
+        list->capacity = new_capacity;
+    }
+    list->items[list->count++] = value;
+}
+
+/**
+ * qsort comparator for 64-bit values
+ */
+static int compare_values(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Sort a list and drop duplicate values
+ */
+static void value_list_sort_unique(ValueList* list) {
+    if (list->count < 2) {
+        return;
+    }
+    
+    qsort(list->items, list->count, sizeof(uint64_t), compare_values);
+    size_t unique = 1;
+    for (size_t i = 1; i < list->count; i++) {
+        if (list->items[i] != list->items[unique - 1]) {
+            list->items[unique++] = list->items[i];
+        }
+    }
+    list->count = unique;
+}
+
+/**
+ * Visit a word and every string reachable by deleting up to remaining
+ * characters. Deletions happen at non-decreasing positions so each set of
+ * deleted positions is generated once.
+ * @param word Current string (not necessarily NUL-terminated)
+ * @param len Length of word
+ * @param start First position that may still be deleted
+ * @param remaining Deletions left
+ * @param list Receives (hash << 32) | list->word_id for every visited string
+ */
+static void collect_deletes(const char* word, size_t len, size_t start, int remaining, ValueList* list) {
+    value_list_push(list, ((uint64_t)hash_span(word, len) << 32) | list->word_id);
+    if (remaining == 0 || len == 0) {
+        return;
+    }
+    
+    char shorter[TRIE_MAX_WORD_LENGTH];
+    for (size_t i = start; i < len; i++) {
+        memcpy(shorter, word, i);
+        memcpy(shorter + i, word + i + 1, len - i - 1);
+        collect_deletes(shorter, len - 1, i, remaining - 1, list);
+    }
+}
+
+/**
+ * Find the bucket for a delete hash, or NULL if no word produces it
+ */
+static const SymSpellBucket* find_bucket(const SymSpellIndex* index, uint32_t hash) {
+    size_t slot = hash & index->bucket_mask;
+    while (index->buckets[slot].count != 0) {
+        if (index->buckets[slot].hash == hash) {
+            return &index->buckets[slot];
+        }
+        slot = (slot + 1) & index->bucket_mask;
+    }
+    return NULL;
+}
+
+/**
+ * Copy the words of a Trie into one block, indexed by alphabetical id
+ */
+static bool copy_words(SymSpellIndex* index, Trie* trie) {
+    char** words = NULL;
+    int count = 0;
+    trie_get_all_words(trie, &words, &count);
+    
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        total += strlen(words[i]) + 1;
+    }
+    
+    index->word_storage = (char*)malloc(total > 0 ? total : 1);
+    index->word_offsets = (uint32_t*)malloc((count > 0 ? count : 1) * sizeof(uint32_t));
+    index->word_frequencies = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    bool ok = index->word_storage != NULL && index->word_offsets != NULL &&
+              index->word_frequencies != NULL && total <= UINT32_MAX;
+    
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        size_t len = strlen(words[i]) + 1;
+        if (ok) {
+            memcpy(index->word_storage + used, words[i], len);
+            index->word_offsets[i] = (uint32_t)used;
+            index->word_frequencies[i] = trie_get_frequency(trie, words[i]);
+            used += len;
+        }
+        free(words[i]);
+    }
+    free(words);
+    
+    index->word_count = ok ? count : 0;
+    index->memory_usage += total + count * (sizeof(uint32_t) + sizeof(int));
+    return ok;
+}
+
+SymSpellIndex* symspell_build(Trie* trie, int max_distance) {
+    if (trie == NULL || max_distance < 1 || max_distance > SYMSPELL_MAX_DISTANCE) {
+        return NULL;
+    }
+    
+    SymSpellIndex* index = (SymSpellIndex*)calloc(1, sizeof(SymSpellIndex));
+    if (index == NULL) {
+        return NULL;
+    }
+    index->max_distance = max_distance;
+    index->memory_usage = sizeof(SymSpellIndex);
+    
+    if (!copy_words(index, trie)) {
+        symspell_destroy(index);
+        return NULL;
+    }
+    
+    // Expand every word into its deletes, tagged with the word id
+    ValueList pairs = { NULL, 0, 0, 0, false };
+    for (int id = 0; id < index->word_count; id++) {
+        const char* word = index->word_storage + index->word_offsets[id];
+        size_t len = strlen(word);
+        if (len > TRIE_MAX_WORD_LENGTH) {
+            continue; // Out of reach of any valid query, like in trie_fuzzy_search()
+        }
+        
+        pairs.word_id = (uint32_t)id;
+        collect_deletes(word, len, 0, max_distance, &pairs);
+    }
+    
+    // Sorting groups equal hashes; ids stay ascending within each group
+    value_list_sort_unique(&pairs);
+    
+    size_t key_count = 0;
+    for (size_t i = 0; i < pairs.count; i++) {
+        if (i == 0 || (pairs.items[i] >> 32) != (pairs.items[i - 1] >> 32)) {
+            key_count++;
+        }
+    }
+    
+    size_t slot_count = 16;
+    while (slot_count < key_count * 2) {
+        slot_count *= 2;
+    }
+    
+    index->buckets = (SymSpellBucket*)calloc(slot_count, sizeof(SymSpellBucket));
+    index->postings = (uint32_t*)malloc((pairs.count > 0 ? pairs.count : 1) * sizeof(uint32_t));
+    if (pairs.failed || index->buckets == NULL || index->postings == NULL) {
+        free(pairs.items);
+        symspell_destroy(index);
+        return NULL;
+    }
+    
+    index->bucket_mask = slot_count - 1;
+    index->key_count = key_count;
+    index->posting_count = pairs.count;
+    index->memory_usage += slot_count * sizeof(SymSpellBucket) + pairs.count * sizeof(uint32_t);
+    
+    // Lay out postings group by group and point a bucket at each group
+    size_t group_start = 0;
+    while (group_start < pairs.count) {
+        uint32_t hash = (uint32_t)(pairs.items[group_start] >> 32);
+        size_t group_end = group_start;
+        while (group_end < pairs.count && (uint32_t)(pairs.items[group_end] >> 32) == hash) {
+            index->postings[group_end] = (uint32_t)(pairs.items[group_end] & 0xFFFFFFFFu);
+            group_end++;
+        }
+        
+        size_t slot = hash & index->bucket_mask;
+        while (index->buckets[slot].count != 0) {
+            slot = (slot + 1) & index->bucket_mask;
+        }
+        index->buckets[slot].hash = hash;
+        index->buckets[slot].start = (uint32_t)group_start;
+        index->buckets[slot].count = (uint32_t)(group_end - group_start);
+        group_start = group_end;
+    }
+    
+    free(pairs.items);
+    return index;
+}
+
+int symspell_lookup(const SymSpellIndex* index, const char* word, int max_distance,
+                    TrieMatch* matches, int max_matches) {
+    if (index == NULL || word == NULL || matches == NULL || max_matches <= 0 ||
+        max_distance < 0 || max_distance > index->max_distance) {
+        return 0;
+    }
+    
+    size_t query_len = strlen(word);
+    if (query_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    // Hashes of the query's deletes, deduplicated
+    ValueList hashes = { NULL, 0, 0, 0, false };
+    collect_deletes(word, query_len, 0, max_distance, &hashes);
+    for (size_t i = 0; i < hashes.count; i++) {
+        hashes.items[i] >>= 32;
+    }
+    value_list_sort_unique(&hashes);
+    if (hashes.failed) {
+        free(hashes.items);
+        return 0;
+    }
+    
+    // Every word listed under one of them is a candidate
+    ValueList candidates = { NULL, 0, 0, 0, false };
+    for (size_t i = 0; i < hashes.count; i++) {
+        const SymSpellBucket* bucket = find_bucket(index, (uint32_t)hashes.items[i]);
+        if (bucket == NULL) {
+            continue;
+        }
+        for (uint32_t j = 0; j < bucket->count; j++) {
+            value_list_push(&candidates, index->postings[bucket->start + j]);
+        }
+    }
+    free(hashes.items);
+    
+    // Ascending ids are alphabetical order, matching the trie walk
+    value_list_sort_unique(&candidates);
+    
+    // Verify candidates in batches with the bit-parallel kernel
+    int match_count = 0;
+    const char* batch[SYMSPELL_VERIFY_BATCH];
+    uint32_t batch_ids[SYMSPELL_VERIFY_BATCH];
+    int distances[SYMSPELL_VERIFY_BATCH];
+    size_t next = 0;
+    
+    while (next < candidates.count && !candidates.failed) {
+        int batch_count = 0;
+        for (; next < candidates.count && batch_count < SYMSPELL_VERIFY_BATCH; next++) {
+            uint32_t id = (uint32_t)candidates.items[next];
+            batch[batch_count] = index->word_storage + index->word_offsets[id];
+            batch_ids[batch_count] = id;
+            batch_count++;
+        }
+        
+        edit_distance_batch_within(word, batch, batch_count, max_distance, distances);
+        
+        for (int i = 0; i < batch_count; i++) {
+            int distance = distances[i];
+            if (distance < 0) {
+                continue;
+            }
+            
+            // Insert after every match at the same or a smaller distance
+            int pos = match_count;
+            while (pos > 0 && matches[pos - 1].distance > distance) {
+                pos--;
+            }
+            if (pos >= max_matches) {
+                continue;
+            }
+            
+            int last = (match_count < max_matches) ? match_count : max_matches - 1;
+            for (int k = last; k > pos; k--) {
+                matches[k] = matches[k - 1];
+            }
+            const char* candidate = index->word_storage + index->word_offsets[batch_ids[i]];
+            memcpy(matches[pos].word, candidate, strlen(candidate) + 1);
+            matches[pos].distance = distance;
+            matches[pos].frequency = index->word_frequencies[batch_ids[i]];
+            
+            if (match_count < max_matches) {
+                match_count++;
+            }
+        }
+    }
+    
+    bool failed = candidates.failed;
+    free(candidates.items);
+    return failed ? 0 : match_count;
+}
+
+size_t symspell_get_key_count(const SymSpellIndex* index) {
+    return (index != NULL) ? index->key_count : 0;
+}
+
+size_t symspell_get_memory_usage(const SymSpellIndex* index) {
+    return (index != NULL) ? index->memory_usage : 0;
+}
+
+void symspell_destroy(SymSpellIndex* index) {
+    if (index == NULL) {
+        return;
+    }
+    
+    free(index->word_storage);
+    free(index->word_offsets);
+    free(index->word_frequencies);
+    free(index->buckets);
+    free(index->postings);
+    free(index);
+}
@@ -0,0 +1,73 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "../include/timing.h"
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+
+double timing_now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+size_t timing_peak_rss_bytes(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return (size_t)counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;             // Bytes on macOS
+#else
+    return (size_t)usage.ru_maxrss * 1024;      // Kilobytes on Linux and the BSDs
+#endif
+#endif
+}
+
+/**
+ * qsort comparator for doubles, ascending
+ */
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+double timing_percentile(double* samples, size_t count, double percentile) {
+    if (samples == NULL || count == 0) {
+        return 0.0;
+    }
+
+    qsort(samples, count, sizeof(double), compare_doubles);
+
+    // Nearest rank: the smallest sample with at least percentile% of samples at or below it
+    double rank = ceil(percentile / 100.0 * (double)count);
+    size_t index = rank < 1.0 ? 0 : (size_t)rank - 1;
+    if (index >= count) {
+        index = count - 1;
+    }
+    return samples[index];
+}
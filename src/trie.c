@@ -1,117 +1,319 @@
 #include "../include/trie.h"
+#include "../include/compact_trie.h"
+#include "../include/dawg.h"
+#include "../include/word_set.h"
+#include "../include/profile.h"
+#include "../include/memory_budget.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 /**
- * Create a new TrieNode with all children initialized to NULL
+ * Number of nodes in the first arena chunk; later chunks double in size
+ * up to TRIE_CHUNK_MAX_NODES so large dictionaries need only a few chunks
+ */
+#define TRIE_CHUNK_MIN_NODES 1024
+#define TRIE_CHUNK_MAX_NODES 65536
+
+/**
+ * Arena chunk holding a contiguous block of TrieNodes
+ */
+struct TrieNodeChunk {
+    struct TrieNodeChunk* next; ///< Previously allocated chunk
+    size_t capacity;            ///< Number of node slots in this chunk
+    size_t used;                ///< Number of slots handed out
+    TrieNode nodes[];           ///< Node storage
+};
+
+/**
+ * Add bytes to the trie's size and to the accounted dictionary memory
+ * @param trie Trie that allocated the bytes
+ * @param bytes Number of bytes allocated
+ */
+static void trie_charge(Trie* trie, size_t bytes) {
+    trie->memory_usage += bytes;
+    memory_charge(MEMORY_COMPONENT_DICTIONARY, bytes);
+}
+
+/**
+ * Remove freed bytes from the trie's size and the accounted dictionary memory
+ * @param trie Trie that freed the bytes
+ * @param bytes Number of bytes freed
+ */
+static void trie_discharge(Trie* trie, size_t bytes) {
+    trie->memory_usage -= bytes;
+    memory_release(MEMORY_COMPONENT_DICTIONARY, bytes);
+}
+
+/**
+ * Allocate an arena chunk of capacity nodes and push it onto the trie's chunk list
+ * @param trie Trie that owns the chunk
+ * @param capacity Number of node slots
+ * @return true on success, false on memory allocation failure
+ */
+static bool trie_chunk_add(Trie* trie, size_t capacity) {
+    size_t bytes = sizeof(TrieNodeChunk) + capacity * sizeof(TrieNode);
+    TrieNodeChunk* chunk = (TrieNodeChunk*)malloc(bytes);
+    if (chunk == NULL) {
+        return false;
+    }
+    
+    chunk->next = trie->chunks;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    trie->chunks = chunk;
+    trie_charge(trie, bytes);
+    
+    return true;
+}
+
+/**
+ * Allocate the next arena chunk, doubling the newest one's size up to
+ * TRIE_CHUNK_MAX_NODES
+ * @param trie Trie that owns the chunk
+ * @return true on success, false on memory allocation failure
+ */
+static bool trie_chunk_grow(Trie* trie) {
+    size_t capacity = TRIE_CHUNK_MIN_NODES;
+    if (trie->chunks != NULL) {
+        capacity = trie->chunks->capacity * 2;
+        if (capacity > TRIE_CHUNK_MAX_NODES) {
+            capacity = TRIE_CHUNK_MAX_NODES;
+        }
+        if (capacity < TRIE_CHUNK_MIN_NODES) {
+            capacity = TRIE_CHUNK_MIN_NODES; // After a small reserved chunk
+        }
+    }
+    return trie_chunk_add(trie, capacity);
+}
+
+/**
+ * Create a new TrieNode from the trie's arena with all children initialized to NULL
+ * @param trie Trie that owns the node
  * @return Pointer to newly created TrieNode, or NULL on memory allocation failure
  */
-static TrieNode* trie_node_create(void) {
-    TrieNode* node = (TrieNode*)malloc(sizeof(TrieNode));
-    if (node == NULL) {
-        return NULL;
+static TrieNode* trie_node_create(Trie* trie) {
+    if (trie->chunks == NULL || trie->chunks->used == trie->chunks->capacity) {
+        if (!trie_chunk_grow(trie)) {
+            return NULL;
+        }
     }
     
+    TrieNode* node = &trie->chunks->nodes[trie->chunks->used++];
+    trie->node_count++;
+    
     // Initialize all children to NULL
     for (int i = 0; i < 26; i++) {
         node->children[i] = NULL;
     }
+    node->extended = NULL;
+    node->next = NULL;
+    node->label = 0;
     
     node->is_end_of_word = false;
+    node->frequency_bound = 0;
     node->word_count = 0;
     
     return node;
 }
 
 /**
- * Recursively destroy a TrieNode and all its children
- * @param node Pointer to the TrieNode to destroy
+ * Fold a word byte to the label it is stored under
+ * @param c Byte of a word
+ * @return Lowercased ASCII letter, or c itself
  */
-static void trie_node_destroy(TrieNode* node) {
-    if (node == NULL) {
-        return;
+static inline unsigned char trie_label(char c) {
+    return (unsigned char)tolower((unsigned char)c);
+}
+
+/**
+ * Locate the link holding the child for a byte: a-z live in children[],
+ * bytes >= 0x80 (UTF-8 sequences) in the sorted extended list
+ * @param node Parent node
+ * @param c Folded byte
+ * @return Link to the child, or to the list position where it belongs
+ *         (holding a node with a larger label or NULL); NULL if the byte
+ *         cannot be stored
+ */
+static TrieNode** trie_child_link(TrieNode* node, unsigned char c) {
+    if (c >= 'a' && c <= 'z') {
+        return &node->children[c - 'a'];
     }
-    
-    // Recursively destroy all children
-    for (int i = 0; i < 26; i++) {
-        if (node->children[i] != NULL) {
-            trie_node_destroy(node->children[i]);
-        }
+    if (c < 0x80) {
+        return NULL;
     }
     
-    free(node);
+    TrieNode** link = &node->extended;
+    while (*link != NULL && (*link)->label < c) {
+        link = &(*link)->next;
+    }
+    return link;
 }
 
 /**
- * Recursively count memory usage of a TrieNode and its children
- * @param node Pointer to the TrieNode
- * @return Memory usage in bytes
+ * Find the child for a byte
+ * @param node Parent node
+ * @param c Folded byte
+ * @return Child node, or NULL if there is none
  */
-static size_t trie_node_memory_usage(TrieNode* node) {
-    if (node == NULL) {
-        return 0;
+static TrieNode* trie_child(TrieNode* node, unsigned char c) {
+    TrieNode** link = trie_child_link(node, c);
+    return (link != NULL && *link != NULL && (*link)->label == c) ? *link : NULL;
+}
+
+/**
+ * Iterate the children of a node in label order (a-z, then bytes >= 0x80)
+ * @param node Parent node
+ * @param child Previous child, or NULL to start
+ * @return Next child, or NULL when all were visited
+ */
+static TrieNode* trie_next_child(const TrieNode* node, const TrieNode* child) {
+    if (child != NULL && child->label >= 0x80) {
+        return child->next;
     }
     
-    size_t usage = sizeof(TrieNode);
-    
-    // Add memory usage of all children
-    for (int i = 0; i < 26; i++) {
+    for (int i = (child == NULL) ? 0 : child->label - 'a' + 1; i < 26; i++) {
         if (node->children[i] != NULL) {
-            usage += trie_node_memory_usage(node->children[i]);
+            return node->children[i];
         }
     }
+    return node->extended;
+}
+
+/**
+ * Release every arena chunk owned by the trie, and with them all nodes
+ * @param trie Trie whose nodes are freed
+ */
+static void trie_free_chunks(Trie* trie) {
+    TrieNodeChunk* chunk = trie->chunks;
+    while (chunk != NULL) {
+        TrieNodeChunk* next = chunk->next;
+        trie_discharge(trie, sizeof(TrieNodeChunk) + chunk->capacity * sizeof(TrieNode));
+        free(chunk);
+        chunk = next;
+    }
     
-    return usage;
+    trie->chunks = NULL;
+    trie->root = NULL;
+    trie->node_count = 0;
+}
+
+/**
+ * Release the exact lookup table, sending lookups back to the tree
+ * @param trie Trie whose table is freed
+ */
+static void trie_release_word_set(Trie* trie) {
+    if (trie->word_set != NULL) {
+        trie_discharge(trie, word_set_get_memory_usage(trie->word_set));
+        word_set_destroy(trie->word_set);
+        trie->word_set = NULL;
+    }
 }
 
 Trie* trie_create(void) {
+    return trie_create_with_capacity(0);
+}
+
+Trie* trie_create_with_capacity(size_t node_count) {
     Trie* trie = (Trie*)malloc(sizeof(Trie));
     if (trie == NULL) {
         return NULL;
     }
     
-    trie->root = trie_node_create();
+    trie->chunks = NULL;
+    trie->node_count = 0;
+    trie->total_words = 0;
+    trie->memory_usage = 0;
+    trie->compact = NULL;
+    trie->dawg = NULL;
+    trie->word_set = NULL;
+    trie_charge(trie, sizeof(Trie));
+    
+    if (node_count > 0 && !trie_chunk_add(trie, node_count)) {
+        trie_destroy(trie);
+        return NULL;
+    }
+    trie->root = trie_node_create(trie);
     if (trie->root == NULL) {
-        free(trie);
+        trie_destroy(trie);
         return NULL;
     }
     
-    trie->total_words = 0;
-    trie->memory_usage = sizeof(Trie) + sizeof(TrieNode);
-    
     return trie;
 }
 
+unsigned char trie_encode_frequency_bound(int frequency) {
+    if (frequency < 1) {
+        return 0;
+    }
+    
+    // Exponent and the 3-bit mantissa rounded up, so the code never underestimates
+    int exponent = 0;
+    while ((frequency >> exponent) > 1) {
+        exponent++;
+    }
+    unsigned long long remainder = (unsigned long long)frequency - (1ULL << exponent);
+    unsigned int mantissa = (unsigned int)((remainder * 8 + (1ULL << exponent) - 1) >> exponent);
+    if (mantissa == 8) {
+        exponent++;
+        mantissa = 0;
+    }
+    return (unsigned char)(1 + exponent * 8 + mantissa);
+}
+
+unsigned int trie_decode_frequency_bound(unsigned char code) {
+    if (code == 0) {
+        return 0;
+    }
+    
+    int exponent = (code - 1) >> 3;
+    unsigned long long mantissa = (code - 1) & 7;
+    return (unsigned int)((1ULL << exponent) + ((mantissa << exponent) >> 3));
+}
+
 bool trie_insert(Trie* trie, const char* word) {
-    if (trie == NULL || word == NULL || strlen(word) == 0) {
+    return trie_insert_with_frequency(trie, word, 1);
+}
+
+bool trie_insert_with_frequency(Trie* trie, const char* word, int frequency) {
+    if (trie == NULL || word == NULL || strlen(word) == 0 || frequency < 1) {
         return false;
     }
     
+    // A frozen trie is read-only
+    if (trie->root == NULL) {
+        return false;
+    }
+    
+    // The lookup table is a snapshot; drop it rather than serve stale answers
+    trie_release_word_set(trie);
+    
     TrieNode* current = trie->root;
     size_t word_len = strlen(word);
     
-    // Traverse/create path for each character in the word
+    // Traverse/create path for each byte in the word
     for (size_t i = 0; i < word_len; i++) {
-        char c = tolower(word[i]);
+        unsigned char c = trie_label(word[i]);
         
-        // Only accept alphabetic characters
-        if (c < 'a' || c > 'z') {
+        // Only accept letters and the bytes of UTF-8 sequences
+        TrieNode** link = trie_child_link(current, c);
+        if (link == NULL) {
             return false;
         }
         
-        int index = c - 'a';
-        
         // Create child node if it doesn't exist
-        if (current->children[index] == NULL) {
-            current->children[index] = trie_node_create();
-            if (current->children[index] == NULL) {
+        if (*link == NULL || (*link)->label != c) {
+            TrieNode* child = trie_node_create(trie);
+            if (child == NULL) {
                 return false; // Memory allocation failed
             }
-            trie->memory_usage += sizeof(TrieNode);
+            child->label = c;
+            child->next = *link;
+            *link = child;
         }
         
-        current = current->children[index];
+        current = *link;
     }
     
     // Mark end of word and update statistics
@@ -119,40 +321,713 @@ bool trie_insert(Trie* trie, const char* word) {
         current->is_end_of_word = true;
         trie->total_words++;
     }
-    current->word_count++;
+    // Saturate instead of overflowing on huge corpus counts
+    current->word_count = (current->word_count > INT_MAX - frequency) ? INT_MAX
+                                                                        : current->word_count + frequency;
+    
+    // Raise the frequency bound of every node on the path, root included
+    unsigned char bound = trie_encode_frequency_bound(current->word_count);
+    TrieNode* node = trie->root;
+    for (size_t i = 0; node != NULL; i++) {
+        if (node->frequency_bound < bound) {
+            node->frequency_bound = bound;
+        }
+        node = (i < word_len) ? trie_child(node, trie_label(word[i])) : NULL;
+    }
     
     return true;
 }
 
+/**
+ * Follow a word's path from the root of a pointer-based trie
+ * @param trie Trie that is not frozen
+ * @param word Word to follow
+ * @return Node reached by the last character, or NULL if the path is missing
+ */
+static TrieNode* trie_find_node(Trie* trie, const char* word) {
+    TrieNode* current = trie->root;
+    size_t word_len = strlen(word);
+    
+    // Traverse path for each byte in the word
+    for (size_t i = 0; i < word_len; i++) {
+        // If path doesn't exist, word is not in trie
+        current = trie_child(current, trie_label(word[i]));
+        if (current == NULL) {
+            return NULL;
+        }
+        PROFILE_COUNT(trie_nodes_visited, 1);
+    }
+    
+    return current;
+}
+
 bool trie_search(Trie* trie, const char* word) {
     if (trie == NULL || word == NULL || strlen(word) == 0) {
         return false;
     }
     
+    if (trie->word_set != NULL) {
+        return word_set_find(trie->word_set, word, NULL);
+    }
+    
+    if (trie->compact != NULL) {
+        return compact_trie_search(trie->compact, word);
+    }
+    
+    if (trie->dawg != NULL) {
+        return dawg_search(trie->dawg, word);
+    }
+    
+    // Word exists only if we reached a node marked as end of word
+    TrieNode* node = trie_find_node(trie, word);
+    return node != NULL && node->is_end_of_word;
+}
+
+int trie_get_frequency(Trie* trie, const char* word) {
+    if (trie == NULL || word == NULL || strlen(word) == 0) {
+        return 0;
+    }
+    
+    if (trie->word_set != NULL) {
+        int frequency = 0;
+        word_set_find(trie->word_set, word, &frequency);
+        return frequency;
+    }
+    
+    if (trie->compact != NULL) {
+        return compact_trie_get_frequency(trie->compact, word);
+    }
+    
+    if (trie->dawg != NULL) {
+        return dawg_get_frequency(trie->dawg, word);
+    }
+    
+    TrieNode* node = trie_find_node(trie, word);
+    return (node != NULL && node->is_end_of_word) ? node->word_count : 0;
+}
+
+/**
+ * State shared across the recursive fuzzy search walk
+ */
+typedef struct FuzzySearchContext {
+    const char* query;      ///< Query word
+    int query_len;          ///< Length of the query word
+    int max_distance;       ///< Caller-requested distance bound
+    int* rows;              ///< One DP row of (query_len + 1) ints per depth
+    int max_depth;          ///< Deepest level worth exploring
+    char prefix[TRIE_MAX_WORD_LENGTH + 1]; ///< Word spelled by the current path
+    TrieMatch* matches;     ///< Output buffer, kept sorted by distance
+    int match_count;        ///< Number of matches currently held
+    int max_matches;        ///< Capacity of the output buffer
+} FuzzySearchContext;
+
+/**
+ * Current pruning bound: once the buffer is full only strictly better
+ * words can displace the worst match, so the bound tightens accordingly
+ * @param ctx Search context
+ * @return Largest distance still worth reporting
+ */
+static int fuzzy_effective_bound(const FuzzySearchContext* ctx) {
+    if (ctx->match_count < ctx->max_matches) {
+        return ctx->max_distance;
+    }
+    return ctx->matches[ctx->max_matches - 1].distance - 1;
+}
+
+/**
+ * Insert a word into the sorted match buffer, keeping earlier (alphabetically
+ * smaller) words ahead of later ones at equal distance
+ * @param ctx Search context
+ * @param length Length of the word held in ctx->prefix
+ * @param distance Edit distance of the word from the query
+ * @param frequency Frequency of the word
+ */
+static void fuzzy_add_match(FuzzySearchContext* ctx, int length, int distance, int frequency) {
+    int pos = ctx->match_count;
+    while (pos > 0 && ctx->matches[pos - 1].distance > distance) {
+        pos--;
+    }
+    if (pos >= ctx->max_matches) {
+        return;
+    }
+    
+    int last = (ctx->match_count < ctx->max_matches) ? ctx->match_count : ctx->max_matches - 1;
+    for (int i = last; i > pos; i--) {
+        ctx->matches[i] = ctx->matches[i - 1];
+    }
+    
+    memcpy(ctx->matches[pos].word, ctx->prefix, (size_t)length);
+    ctx->matches[pos].word[length] = '\0';
+    ctx->matches[pos].distance = distance;
+    ctx->matches[pos].frequency = frequency;
+    
+    if (ctx->match_count < ctx->max_matches) {
+        ctx->match_count++;
+    }
+}
+
+/**
+ * Score one child from its parent's DP row and recurse into it if any
+ * word below it can still come within range
+ * @param ctx Search context
+ * @param child Child node
+ * @param c Label of the child (passed in so pruned children are never touched)
+ * @param depth Depth of the parent (its row is ctx->rows[depth])
+ */
+static void trie_fuzzy_visit(FuzzySearchContext* ctx, TrieNode* child, char c, int depth);
+
+/**
+ * Recursively score the children of a node, deriving each child's DP row
+ * from the parent row at the given depth
+ * @param ctx Search context
+ * @param node Node whose children are being explored
+ * @param depth Depth of node (its row is ctx->rows[depth])
+ */
+static void trie_fuzzy_walk(FuzzySearchContext* ctx, TrieNode* node, int depth) {
+    for (int i = 0; i < 26; i++) {
+        if (node->children[i] != NULL) {
+            trie_fuzzy_visit(ctx, node->children[i], (char)('a' + i), depth);
+        }
+    }
+    for (TrieNode* child = node->extended; child != NULL; child = child->next) {
+        trie_fuzzy_visit(ctx, child, (char)child->label, depth);
+    }
+}
+
+static void trie_fuzzy_visit(FuzzySearchContext* ctx, TrieNode* child, char c, int depth) {
+    int cols = ctx->query_len + 1;
+    const int* prev_row = ctx->rows + (size_t)depth * cols;
+    int* row = ctx->rows + (size_t)(depth + 1) * cols;
+    
+    row[0] = depth + 1;
+    int row_min = row[0];
+    PROFILE_COUNT(trie_nodes_visited, 1);
+    PROFILE_COUNT(dp_cells, cols - 1);
+    
+    for (int j = 1; j < cols; j++) {
+        int cost = (ctx->query[j - 1] == c) ? 0 : 1;
+        int substitute = prev_row[j - 1] + cost;
+        int insert = row[j - 1] + 1;
+        int delete = prev_row[j] + 1;
+        
+        int best = (substitute < insert) ? substitute : insert;
+        row[j] = (best < delete) ? best : delete;
+        if (row[j] < row_min) {
+            row_min = row[j];
+        }
+    }
+    
+    // No word below this child can come back within range
+    if (row_min > fuzzy_effective_bound(ctx)) {
+        return;
+    }
+    
+    ctx->prefix[depth] = c;
+    
+    if (child->is_end_of_word && row[cols - 1] <= fuzzy_effective_bound(ctx)) {
+        fuzzy_add_match(ctx, depth + 1, row[cols - 1], child->word_count);
+    }
+    
+    if (depth + 1 < ctx->max_depth) {
+        trie_fuzzy_walk(ctx, child, depth + 1);
+    }
+}
+
+bool trie_starts_with(Trie* trie, const char* prefix) {
+    if (trie == NULL || prefix == NULL || trie->total_words == 0) {
+        return false;
+    }
+    
+    if (trie->compact != NULL) {
+        return compact_trie_starts_with(trie->compact, prefix);
+    }
+    
+    if (trie->dawg != NULL) {
+        return dawg_starts_with(trie->dawg, prefix);
+    }
+    
     TrieNode* current = trie->root;
+    for (size_t i = 0; prefix[i] != '\0'; i++) {
+        current = trie_child(current, trie_label(prefix[i]));
+        if (current == NULL) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool trie_freeze(Trie* trie) {
+    if (trie == NULL) {
+        return false;
+    }
+    
+    if (trie->compact != NULL) {
+        return true; // Already frozen
+    }
+    
+    if (trie->dawg != NULL) {
+        return false; // The nodes a compact image is built from are gone
+    }
+    
+    trie->compact = compact_trie_build(trie);
+    if (trie->compact == NULL) {
+        return false;
+    }
+    
+    trie_free_chunks(trie);
+    trie_charge(trie, compact_trie_get_memory_usage(trie->compact));
+    
+    return true;
+}
+
+bool trie_minimize(Trie* trie) {
+    if (trie == NULL) {
+        return false;
+    }
+    
+    if (trie->dawg != NULL) {
+        return true; // Already minimized
+    }
+    
+    trie->dawg = dawg_build(trie);
+    if (trie->dawg == NULL) {
+        return false;
+    }
+    
+    // The word set holds its own copy of the words, so it stays valid
+    trie_free_chunks(trie);
+    if (trie->compact != NULL) {
+        trie_discharge(trie, compact_trie_get_memory_usage(trie->compact));
+        compact_trie_destroy(trie->compact);
+        trie->compact = NULL;
+    }
+    trie_charge(trie, dawg_get_memory_usage(trie->dawg));
+    
+    return true;
+}
+
+bool trie_adopt_compact(Trie* trie, CompactTrie* compact) {
+    if (trie == NULL || compact == NULL || trie->compact != NULL || trie->dawg != NULL) {
+        return false;
+    }
+    
+    trie_free_chunks(trie);
+    trie_release_word_set(trie);
+    trie->compact = compact;
+    trie->total_words = compact->total_words;
+    trie_charge(trie, compact_trie_get_memory_usage(compact));
+    
+    return true;
+}
+
+bool trie_graft(Trie* trie, Trie* donor) {
+    if (trie == NULL || donor == NULL || trie == donor || trie->root == NULL || donor->root == NULL) {
+        return false;
+    }
+    
+    for (int i = 0; i < 26; i++) {
+        if (donor->root->children[i] != NULL && trie->root->children[i] != NULL) {
+            return false;
+        }
+    }
+    for (TrieNode* child = donor->root->extended; child != NULL; child = child->next) {
+        if (trie_child(trie->root, child->label) != NULL) {
+            return false;
+        }
+    }
+    
+    trie_release_word_set(trie);
+    trie_release_word_set(donor);
+    
+    for (int i = 0; i < 26; i++) {
+        if (donor->root->children[i] != NULL) {
+            trie->root->children[i] = donor->root->children[i];
+        }
+    }
+    
+    // Merge the sorted lists of children for bytes >= 0x80
+    TrieNode* moved = donor->root->extended;
+    while (moved != NULL) {
+        TrieNode* following = moved->next;
+        TrieNode** link = trie_child_link(trie->root, moved->label);
+        moved->next = *link;
+        *link = moved;
+        moved = following;
+    }
+    
+    // Splice the donor's chunks in behind our newest chunk, which keeps
+    // handing out its free slots; the donor's root slot stays unused
+    TrieNodeChunk* last = donor->chunks;
+    while (last->next != NULL) {
+        last = last->next;
+    }
+    last->next = trie->chunks->next;
+    trie->chunks->next = donor->chunks;
+    
+    if (trie->root->frequency_bound < donor->root->frequency_bound) {
+        trie->root->frequency_bound = donor->root->frequency_bound;
+    }
+    
+    trie->node_count += donor->node_count - 1;
+    trie->total_words += donor->total_words;
+    // The donor's nodes are already accounted; only its structure goes away
+    trie->memory_usage += donor->memory_usage - sizeof(Trie);
+    memory_release(MEMORY_COMPONENT_DICTIONARY, sizeof(Trie));
+    
+    free(donor);
+    return true;
+}
+
+/**
+ * Recursively add the words below a pointer node to a word set
+ * @param set Word set being filled
+ * @param node Current node
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @return true on success, false if a word could not be added
+ */
+static bool trie_fill_word_set(WordSet* set, const TrieNode* node, char* prefix, int depth) {
+    if (node->is_end_of_word && !word_set_add(set, prefix, (size_t)depth, node->word_count)) {
+        return false;
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return true;
+    }
+    
+    for (const TrieNode* child = trie_next_child(node, NULL); child != NULL; child = trie_next_child(node, child)) {
+        prefix[depth] = (char)child->label;
+        if (!trie_fill_word_set(set, child, prefix, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Recursively add the words below a compact node to a word set
+ * @param set Word set being filled
+ * @param ctrie Compact trie
+ * @param node Current node index
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @return true on success, false if a word could not be added
+ */
+static bool compact_fill_word_set(WordSet* set, const CompactTrie* ctrie, uint32_t node, char* prefix, int depth) {
+    const CompactTrieNode* current = &ctrie->nodes[node];
+    int frequency = current->word_count > INT_MAX ? INT_MAX : (int)current->word_count;
+    if (current->is_end_of_word && !word_set_add(set, prefix, (size_t)depth, frequency)) {
+        return false;
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return true;
+    }
+    
+    uint32_t end = current->first_child + current->child_count;
+    for (uint32_t child = current->first_child; child < end; child++) {
+        prefix[depth] = (char)ctrie->labels[child];
+        if (!compact_fill_word_set(set, ctrie, child, prefix, depth + 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Recursively add the words accepted from a Dawg state to a word set
+ * @param set Word set being filled
+ * @param dawg Minimal automaton
+ * @param state Current state
+ * @param rank Number of words sorting before the current path
+ * @param prefix Buffer holding the current path
+ * @param depth Length of the current path
+ * @return true on success, false if a word could not be added
+ */
+static bool dawg_fill_word_set(WordSet* set, const Dawg* dawg, uint32_t state, uint32_t rank, char* prefix, int depth) {
+    const DawgState* current = &dawg->states[state];
+    if (current->is_final) {
+        int frequency = (dawg->frequencies == NULL) ? 1
+                      : (dawg->frequencies[rank] > INT_MAX) ? INT_MAX : (int)dawg->frequencies[rank];
+        if (!word_set_add(set, prefix, (size_t)depth, frequency)) {
+            return false;
+        }
+        rank++;
+    }
+    
+    if (depth >= TRIE_MAX_WORD_LENGTH) {
+        return true;
+    }
+    
+    uint32_t end = current->first_edge + current->edge_count;
+    for (uint32_t edge = current->first_edge; edge < end; edge++) {
+        prefix[depth] = (char)dawg->labels[edge];
+        if (!dawg_fill_word_set(set, dawg, dawg->targets[edge], rank, prefix, depth + 1)) {
+            return false;
+        }
+        rank += dawg->states[dawg->targets[edge]].word_count;
+    }
+    return true;
+}
+
+bool trie_build_word_set(Trie* trie) {
+    if (trie == NULL) {
+        return false;
+    }
+    
+    if (trie->word_set != NULL) {
+        return true; // Already built
+    }
+    
+    WordSet* set = word_set_create((size_t)trie->total_words);
+    if (set == NULL) {
+        return false;
+    }
+    
+    char prefix[TRIE_MAX_WORD_LENGTH + 1];
+    bool filled;
+    if (trie->compact != NULL) {
+        filled = compact_fill_word_set(set, trie->compact, 0, prefix, 0);
+    } else if (trie->dawg != NULL) {
+        filled = dawg_fill_word_set(set, trie->dawg, 0, 0, prefix, 0);
+    } else {
+        filled = trie_fill_word_set(set, trie->root, prefix, 0);
+    }
+    if (!filled) {
+        word_set_destroy(set);
+        return false;
+    }
+    
+    trie->word_set = set;
+    trie_charge(trie, word_set_get_memory_usage(set));
+    
+    return true;
+}
+
+int trie_fuzzy_search(Trie* trie, const char* word, int max_distance, TrieMatch* matches, int max_matches) {
+    if (trie == NULL || word == NULL || matches == NULL || max_matches <= 0 || max_distance < 0) {
+        return 0;
+    }
+    
+    if (trie->compact != NULL) {
+        return compact_trie_fuzzy_search(trie->compact, word, max_distance, matches, max_matches);
+    }
+    
+    if (trie->dawg != NULL) {
+        return dawg_fuzzy_search(trie->dawg, word, max_distance, matches, max_matches);
+    }
+    
     size_t word_len = strlen(word);
+    if (word_len == 0 || word_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
     
-    // Traverse path for each character in the word
-    for (size_t i = 0; i < word_len; i++) {
-        char c = tolower(word[i]);
-        
-        // Only accept alphabetic characters
-        if (c < 'a' || c > 'z') {
+    FuzzySearchContext ctx;
+    ctx.query = word;
+    ctx.query_len = (int)word_len;
+    ctx.max_distance = max_distance;
+    ctx.matches = matches;
+    ctx.match_count = 0;
+    ctx.max_matches = max_matches;
+    
+    // Rows beyond query_len + max_distance can never get back within range
+    ctx.max_depth = ctx.query_len + max_distance;
+    if (ctx.max_depth > TRIE_MAX_WORD_LENGTH) {
+        ctx.max_depth = TRIE_MAX_WORD_LENGTH;
+    }
+    
+    int cols = ctx.query_len + 1;
+    ctx.rows = (int*)malloc((size_t)(ctx.max_depth + 1) * cols * sizeof(int));
+    if (ctx.rows == NULL) {
+        return 0;
+    }
+    
+    // Row for the empty prefix: distance j to the first j query characters
+    for (int j = 0; j < cols; j++) {
+        ctx.rows[j] = j;
+    }
+    
+    trie_fuzzy_walk(&ctx, trie->root, 0);
+    
+    free(ctx.rows);
+    return ctx.match_count;
+}
+
+/**
+ * Entry of the completion queue: a subtree still to explore, or a word
+ */
+typedef struct CompletionEntry {
+    const TrieNode* node;   ///< Root of the subtree, or the node ending the word
+    unsigned int key;       ///< Frequency bound of the subtree, or frequency of the word
+    bool is_word;           ///< Whether the entry is a finished word
+    int length;             ///< Length of the path spelled by word
+    char word[TRIE_MAX_WORD_LENGTH + 1]; ///< Path from the root to node (NUL-terminated)
+} CompletionEntry;
+
+/**
+ * Completion queue: a binary max-heap of entries
+ */
+typedef struct CompletionQueue {
+    CompletionEntry* entries; ///< Heap array
+    int count;                ///< Number of entries
+    int capacity;             ///< Allocated entries
+} CompletionQueue;
+
+/**
+ * Order of completion entries: higher key first, then alphabetical. A
+ * subtree sorts before a word just when the subtree's words all would,
+ * so a word leaves the queue only after every word that ranks above it.
+ * @param a First entry
+ * @param b Second entry
+ * @return true if a leaves the queue before b
+ */
+static bool completion_before(const CompletionEntry* a, const CompletionEntry* b) {
+    if (a->key != b->key) {
+        return a->key > b->key;
+    }
+    return strcmp(a->word, b->word) < 0;
+}
+
+/**
+ * Add an entry to the completion queue
+ * @param queue Completion queue
+ * @param node Subtree root or word node
+ * @param key Frequency bound or word frequency
+ * @param is_word Whether the entry is a finished word
+ * @param word Path to node
+ * @param length Length of the path
+ * @return true on success, false on memory allocation failure
+ */
+static bool completion_push(CompletionQueue* queue, const TrieNode* node, unsigned int key, bool is_word,
+                            const char* word, int length) {
+    if (queue->count == queue->capacity) {
+        int capacity = (queue->capacity == 0) ? 64 : queue->capacity * 2;
+        CompletionEntry* entries = (CompletionEntry*)realloc(queue->entries, capacity * sizeof(CompletionEntry));
+        if (entries == NULL) {
             return false;
         }
+        queue->entries = entries;
+        queue->capacity = capacity;
+    }
+    
+    CompletionEntry entry;
+    entry.node = node;
+    entry.key = key;
+    entry.is_word = is_word;
+    entry.length = length;
+    memcpy(entry.word, word, (size_t)length);
+    entry.word[length] = '\0';
+    
+    // Sift up
+    int index = queue->count++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!completion_before(&entry, &queue->entries[parent])) {
+            break;
+        }
+        queue->entries[index] = queue->entries[parent];
+        index = parent;
+    }
+    queue->entries[index] = entry;
+    return true;
+}
+
+/**
+ * Remove the first entry of the completion queue
+ * @param queue Non-empty completion queue
+ * @param out Receives the removed entry
+ */
+static void completion_pop(CompletionQueue* queue, CompletionEntry* out) {
+    *out = queue->entries[0];
+    CompletionEntry last = queue->entries[--queue->count];
+    
+    // Sift the last entry down from the root
+    int index = 0;
+    for (;;) {
+        int child = 2 * index + 1;
+        if (child >= queue->count) {
+            break;
+        }
+        if (child + 1 < queue->count && completion_before(&queue->entries[child + 1], &queue->entries[child])) {
+            child++;
+        }
+        if (!completion_before(&queue->entries[child], &last)) {
+            break;
+        }
+        queue->entries[index] = queue->entries[child];
+        index = child;
+    }
+    if (queue->count > 0) {
+        queue->entries[index] = last;
+    }
+}
+
+int trie_complete(Trie* trie, const char* prefix, TrieMatch* matches, int max_matches) {
+    if (trie == NULL || prefix == NULL || matches == NULL || max_matches <= 0) {
+        return 0;
+    }
+    
+    if (trie->compact != NULL) {
+        return compact_trie_complete(trie->compact, prefix, matches, max_matches);
+    }
+    
+    if (trie->dawg != NULL) {
+        return dawg_complete(trie->dawg, prefix, matches, max_matches);
+    }
+    
+    size_t prefix_len = strlen(prefix);
+    if (prefix_len > TRIE_MAX_WORD_LENGTH) {
+        return 0;
+    }
+    
+    // Descend to the prefix node, spelling the path as stored
+    char path[TRIE_MAX_WORD_LENGTH + 1];
+    const TrieNode* start = trie->root;
+    for (size_t i = 0; i < prefix_len && start != NULL; i++) {
+        path[i] = (char)trie_label(prefix[i]);
+        start = trie_child((TrieNode*)start, (unsigned char)path[i]);
+    }
+    if (start == NULL || start->frequency_bound == 0) {
+        return 0;
+    }
+    
+    CompletionQueue queue = { NULL, 0, 0 };
+    int found = 0;
+    bool ok = completion_push(&queue, start, trie_decode_frequency_bound(start->frequency_bound), false,
+                              path, (int)prefix_len);
+    
+    while (ok && found < max_matches && queue.count > 0) {
+        CompletionEntry entry;
+        completion_pop(&queue, &entry);
         
-        int index = c - 'a';
-        
-        // If path doesn't exist, word is not in trie
-        if (current->children[index] == NULL) {
-            return false;
+        if (entry.is_word) {
+            TrieMatch* match = &matches[found++];
+            memcpy(match->word, entry.word, (size_t)entry.length + 1);
+            match->distance = entry.length - (int)prefix_len;
+            match->frequency = entry.node->word_count;
+            continue;
         }
         
-        current = current->children[index];
+        // Expand the subtree: its own word and one entry per child
+        const TrieNode* node = entry.node;
+        PROFILE_COUNT(trie_nodes_visited, 1);
+        if (node->is_end_of_word) {
+            ok = completion_push(&queue, node, (unsigned int)node->word_count, true, entry.word, entry.length);
+        }
+        if (entry.length == TRIE_MAX_WORD_LENGTH) {
+            continue;
+        }
+        for (const TrieNode* child = trie_next_child(node, NULL); ok && child != NULL;
+             child = trie_next_child(node, child)) {
+            entry.word[entry.length] = (char)child->label;
+            ok = completion_push(&queue, child, trie_decode_frequency_bound(child->frequency_bound), false,
+                                 entry.word, entry.length + 1);
+        }
     }
     
-    // Word exists only if we reached a node marked as end of word
-    return current->is_end_of_word;
+    free(queue.entries);
+    return ok ? found : 0;
 }
 
 size_t trie_get_memory_usage(Trie* trie) {
@@ -160,7 +1035,7 @@ size_t trie_get_memory_usage(Trie* trie) {
         return 0;
     }
     
-    return sizeof(Trie) + trie_node_memory_usage(trie->root);
+    return trie->memory_usage;
 }
 
 /**
@@ -197,18 +1072,16 @@ static void trie_collect_words(TrieNode* node, char* prefix, char*** words, int*
     
     // Recursively collect words from all children
     size_t prefix_len = strlen(prefix);
-    for (int i = 0; i < 26; i++) {
-        if (node->children[i] != NULL) {
-            // Extend prefix with current character
-            char* new_prefix = (char*)malloc((prefix_len + 2) * sizeof(char));
-            if (new_prefix != NULL) {
-                strcpy(new_prefix, prefix);
-                new_prefix[prefix_len] = 'a' + i;
-                new_prefix[prefix_len + 1] = '\0';
-                
-                trie_collect_words(node->children[i], new_prefix, words, count, capacity);
-                free(new_prefix);
-            }
+    for (TrieNode* child = trie_next_child(node, NULL); child != NULL; child = trie_next_child(node, child)) {
+        // Extend prefix with current byte
+        char* new_prefix = (char*)malloc((prefix_len + 2) * sizeof(char));
+        if (new_prefix != NULL) {
+            strcpy(new_prefix, prefix);
+            new_prefix[prefix_len] = (char)child->label;
+            new_prefix[prefix_len + 1] = '\0';
+            
+            trie_collect_words(child, new_prefix, words, count, capacity);
+            free(new_prefix);
         }
     }
 }
@@ -220,6 +1093,16 @@ void trie_get_all_words(Trie* trie, char*** words, int* count) {
         return;
     }
     
+    if (trie->compact != NULL) {
+        compact_trie_get_all_words(trie->compact, words, count);
+        return;
+    }
+    
+    if (trie->dawg != NULL) {
+        dawg_get_all_words(trie->dawg, words, count);
+        return;
+    }
+    
     *count = 0;
     int capacity = 100; // Initial capacity
     *words = (char**)malloc(capacity * sizeof(char*));
@@ -246,6 +1129,10 @@ void trie_destroy(Trie* trie) {
         return;
     }
     
-    trie_node_destroy(trie->root);
+    trie_free_chunks(trie);
+    memory_release(MEMORY_COMPONENT_DICTIONARY, trie->memory_usage);
+    compact_trie_destroy(trie->compact);
+    dawg_destroy(trie->dawg);
+    word_set_destroy(trie->word_set);
     free(trie);
 }
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "../include/utf8.h"
+
+// SSE2 is part of the x86-64 baseline, so no runtime check is needed
+#if defined(__SSE2__) || defined(_M_X64)
+#define UTF8_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+ * ASCII character classes, identical to the C locale's ctype
+ */
+#define ASCII_SEPARATOR 1   ///< isspace(), ispunct() or NUL
+#define ASCII_CONTROL   2   ///< !isprint() && !isspace()
+#define ASCII_LETTER    4   ///< isalpha()
+
+/**
+ * Classes of the ASCII bytes (combinations of the ASCII_* flags)
+ */
+static const unsigned char ascii_classes[128] = {
+    3, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 2, 2,   // NUL, controls, \t..\r
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,   // space, ! .. /
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,   // 0 .. 9, : .. ?
+    1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,   // @, A .. O
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 1, 1, 1, 1, 1,   // P .. Z, [ .. _
+    1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,   // `, a .. o
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 1, 1, 1, 1, 2    // p .. z, { .. ~, DEL
+};
+
+#ifdef UTF8_HAVE_SSE2
+/**
+ * Mask of the bytes of v within [lo, hi]; bytes >= 0x80 never match
+ */
+static inline __m128i bytes_in_range(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8((char)(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8((char)(hi + 1))));
+}
+
+/**
+ * Bit mask of the ASCII separators among 16 bytes
+ */
+static inline unsigned separator_mask(__m128i v) {
+    __m128i mask = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    mask = _mm_or_si128(mask, bytes_in_range(v, '\t', '\r'));
+    mask = _mm_or_si128(mask, bytes_in_range(v, 0x21, 0x2F));
+    mask = _mm_or_si128(mask, bytes_in_range(v, 0x3A, 0x40));
+    mask = _mm_or_si128(mask, bytes_in_range(v, 0x5B, 0x60));
+    mask = _mm_or_si128(mask, bytes_in_range(v, 0x7B, 0x7E));
+    return (unsigned)_mm_movemask_epi8(mask);
+}
+
+/**
+ * Bit mask of the ASCII control characters (other than whitespace) among 16 bytes
+ */
+static inline unsigned control_mask(__m128i v) {
+    __m128i mask = bytes_in_range(v, 0x00, 0x08);
+    mask = _mm_or_si128(mask, bytes_in_range(v, 0x0E, 0x1F));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F)));
+    return (unsigned)_mm_movemask_epi8(mask);
+}
+
+/**
+ * Index of the lowest set bit of a non-zero mask
+ */
+static inline size_t lowest_bit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_ctz(mask);
+#else
+    size_t index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+#endif
+
+/**
+ * Count the leading ASCII bytes whose class shares no flag with stop
+ * @param text Text to scan
+ * @param length Number of bytes in text
+ * @param stop ASCII_* flags that end the run (bytes >= 0x80 always end it)
+ * @param invert Stop at bytes that lack every flag in stop instead
+ * @return Length of the run
+ */
+static inline size_t ascii_span(const char* text, size_t length, int stop, bool invert) {
+    size_t i = 0;
+#ifdef UTF8_HAVE_SSE2
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(text + i));
+        unsigned high = (unsigned)_mm_movemask_epi8(v);
+        unsigned flagged = 0;
+        if (stop & ASCII_SEPARATOR) {
+            flagged |= separator_mask(v);
+        }
+        if (stop & ASCII_CONTROL) {
+            flagged |= control_mask(v);
+        }
+        // Non-ASCII bytes carry no ASCII flag
+        unsigned ends = high | (invert ? (~flagged & 0xFFFFu & ~high) : flagged);
+        if (ends != 0) {
+            return i + lowest_bit(ends);
+        }
+    }
+#endif
+    
+    for (; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 0x80) {
+            break;
+        }
+        bool flagged = (ascii_classes[c] & stop) != 0;
+        if (flagged != invert) {
+            break;
+        }
+    }
+    return i;
+}
+
+size_t utf8_sequence_length(unsigned char lead) {
+    if (lead < 0x80) {
+        return 1;
+    }
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return 2;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        return 3;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        return 4;
+    }
+    return 0;
+}
+
+size_t utf8_decode(const char* text, size_t available, uint32_t* code_point) {
+    if (text == NULL || available == 0) {
+        return 0;
+    }
+    
+    const unsigned char* bytes = (const unsigned char*)text;
+    size_t length = utf8_sequence_length(bytes[0]);
+    if (length == 0 || length > available) {
+        return 0;
+    }
+    if (length == 1) {
+        *code_point = bytes[0];
+        return 1;
+    }
+    
+    uint32_t value = bytes[0] & (0x7F >> length);
+    for (size_t i = 1; i < length; i++) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (bytes[i] & 0x3F);
+    }
+    
+    // Overlong forms, surrogates and values beyond Unicode
+    static const uint32_t minimum[UTF8_MAX_SEQUENCE_LENGTH + 1] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (value < minimum[length] || (value >= 0xD800 && value <= 0xDFFF) || value > 0x10FFFF) {
+        return 0;
+    }
+    
+    *code_point = value;
+    return length;
+}
+
+size_t utf8_encode(uint32_t code_point, char* out) {
+    if (code_point < 0x80) {
+        out[0] = (char)code_point;
+        return 1;
+    }
+    if (code_point < 0x800) {
+        out[0] = (char)(0xC0 | (code_point >> 6));
+        out[1] = (char)(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if ((code_point >= 0xD800 && code_point <= 0xDFFF) || code_point > 0x10FFFF) {
+        return 0;
+    }
+    if (code_point < 0x10000) {
+        out[0] = (char)(0xE0 | (code_point >> 12));
+        out[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code_point >> 18));
+    out[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code_point & 0x3F));
+    return 4;
+}
+
+bool utf8_is_separator(uint32_t code_point) {
+    if (code_point < 0x80) {
+        return (ascii_classes[code_point] & ASCII_SEPARATOR) != 0;
+    }
+    
+    // Latin-1 punctuation and symbols (but not the ordinal and micro signs)
+    if (code_point >= 0xA0 && code_point <= 0xBF) {
+        return code_point != 0xAA && code_point != 0xB5 && code_point != 0xBA;
+    }
+    if (code_point == 0xD7 || code_point == 0xF7) {
+        return true;
+    }
+    
+    // Punctuation inside script blocks (Greek, Armenian, Hebrew, Arabic, Devanagari)
+    switch (code_point) {
+        case 0x037E: case 0x0387: case 0x0589: case 0x05BE: case 0x05C0: case 0x05C3:
+        case 0x05F3: case 0x05F4: case 0x060C: case 0x061B: case 0x061F: case 0x06D4:
+        case 0x0964: case 0x0965:
+            return true;
+        default:
+            break;
+    }
+    if (code_point >= 0x055A && code_point <= 0x055F) {
+        return true;
+    }
+    
+    return (code_point >= 0x2000 && code_point <= 0x2BFF) ||   // General Punctuation .. Misc Symbols and Arrows
+           (code_point >= 0x2E00 && code_point <= 0x2E7F) ||   // Supplemental Punctuation
+           (code_point >= 0x3000 && code_point <= 0x303F) ||   // CJK Symbols and Punctuation
+           (code_point >= 0xFE00 && code_point <= 0xFE1F) ||   // Variation selectors, vertical forms
+           (code_point >= 0xFE30 && code_point <= 0xFE6F) ||   // CJK compatibility and small forms
+           code_point == 0xFEFF ||                             // Byte order mark
+           (code_point >= 0xFF01 && code_point <= 0xFF0F) ||   // Fullwidth punctuation
+           (code_point >= 0xFF1A && code_point <= 0xFF20) ||
+           (code_point >= 0xFF3B && code_point <= 0xFF40) ||
+           (code_point >= 0xFF5B && code_point <= 0xFF65) ||
+           (code_point >= 0xFFF0 && code_point <= 0xFFFF) ||   // Specials
+           (code_point >= 0x1F000 && code_point <= 0x1FAFF);   // Emoji and pictographs
+}
+
+bool utf8_is_control(uint32_t code_point) {
+    if (code_point < 0x80) {
+        return (ascii_classes[code_point] & ASCII_CONTROL) != 0;
+    }
+    return code_point <= 0x9F;
+}
+
+bool utf8_is_letter(uint32_t code_point) {
+    if (code_point < 0x80) {
+        return (ascii_classes[code_point] & ASCII_LETTER) != 0;
+    }
+    
+    // Decimal digits of other scripts behave like ASCII digits
+    if ((code_point >= 0x0660 && code_point <= 0x0669) || (code_point >= 0x06F0 && code_point <= 0x06F9) ||
+        (code_point >= 0x0966 && code_point <= 0x096F) || (code_point >= 0xFF10 && code_point <= 0xFF19)) {
+        return false;
+    }
+    return !utf8_is_control(code_point) && !utf8_is_separator(code_point);
+}
+
+uint32_t utf8_to_lower(uint32_t code_point) {
+    if (code_point < 0x80) {
+        return (code_point >= 'A' && code_point <= 'Z') ? code_point + 0x20 : code_point;
+    }
+    
+    // Latin-1 Supplement
+    if (code_point >= 0xC0 && code_point <= 0xDE && code_point != 0xD7) {
+        return code_point + 0x20;
+    }
+    
+    // Latin Extended-A: pairs of capital and small letters
+    if (code_point >= 0x0100 && code_point <= 0x017F) {
+        if (code_point == 0x0130) {
+            return 'i';                         // Capital I with dot above
+        }
+        if (code_point == 0x0178) {
+            return 0xFF;                        // Capital Y with diaeresis
+        }
+        bool odd_capitals = (code_point >= 0x0139 && code_point <= 0x0148) ||
+                            (code_point >= 0x0179 && code_point <= 0x017E);
+        bool paired = odd_capitals || (code_point <= 0x0137 && code_point != 0x0131) ||
+                      (code_point >= 0x014A && code_point <= 0x0177);
+        if (paired && (code_point & 1u) == (odd_capitals ? 1u : 0u)) {
+            return code_point + 1;
+        }
+        return code_point;
+    }
+    
+    // Greek
+    if (code_point == 0x0386) {
+        return 0x03AC;
+    }
+    if (code_point >= 0x0388 && code_point <= 0x038A) {
+        return code_point + 0x25;
+    }
+    if (code_point == 0x038C) {
+        return 0x03CC;
+    }
+    if (code_point == 0x038E || code_point == 0x038F) {
+        return code_point + 0x3F;
+    }
+    if (code_point >= 0x0391 && code_point <= 0x03AB && code_point != 0x03A2) {
+        return code_point + 0x20;
+    }
+    
+    // Cyrillic
+    if (code_point >= 0x0400 && code_point <= 0x040F) {
+        return code_point + 0x50;
+    }
+    if (code_point >= 0x0410 && code_point <= 0x042F) {
+        return code_point + 0x20;
+    }
+    if (((code_point >= 0x0460 && code_point <= 0x0481) || (code_point >= 0x048A && code_point <= 0x04BF)) &&
+        (code_point & 1u) == 0) {
+        return code_point + 1;
+    }
+    
+    // Armenian
+    if (code_point >= 0x0531 && code_point <= 0x0556) {
+        return code_point + 0x30;
+    }
+    
+    // Latin Extended Additional (Vietnamese and others)
+    if (((code_point >= 0x1E00 && code_point <= 0x1E95) || (code_point >= 0x1EA0 && code_point <= 0x1EFF)) &&
+        (code_point & 1u) == 0) {
+        return code_point + 1;
+    }
+    
+    return code_point;
+}
+
+size_t utf8_token_start(const char* text, size_t length) {
+    size_t i = 0;
+    
+    for (;;) {
+        i += ascii_span(text + i, length - i, ASCII_SEPARATOR, true);
+        if (i >= length || (unsigned char)text[i] < 0x80) {
+            return i;
+        }
+        
+        uint32_t code_point;
+        size_t n = utf8_decode(text + i, length - i, &code_point);
+        if (n == 0 || !utf8_is_separator(code_point)) {
+            return i;
+        }
+        i += n;
+    }
+}
+
+size_t utf8_token_end(const char* text, size_t length) {
+    size_t i = 0;
+    
+    for (;;) {
+        i += ascii_span(text + i, length - i, ASCII_SEPARATOR, false);
+        if (i >= length || (unsigned char)text[i] < 0x80) {
+            return i;
+        }
+        
+        // Malformed bytes stay inside the word; validation rejects it later
+        uint32_t code_point;
+        size_t n = utf8_decode(text + i, length - i, &code_point);
+        if (n == 0) {
+            i++;
+        } else if (utf8_is_separator(code_point)) {
+            return i;
+        } else {
+            i += n;
+        }
+    }
+}
+
+size_t utf8_separator_length(const char* text, size_t length) {
+    if (length == 0) {
+        return 0;
+    }
+    
+    uint32_t code_point;
+    size_t n = utf8_decode(text, length, &code_point);
+    return (n == 0) ? 1 : n;
+}
+
+size_t utf8_find_invalid(const char* text, size_t length) {
+    size_t i = 0;
+    
+    for (;;) {
+        i += ascii_span(text + i, length - i, ASCII_CONTROL, false);
+        if (i >= length || (unsigned char)text[i] < 0x80) {
+            return i;
+        }
+        
+        uint32_t code_point;
+        size_t n = utf8_decode(text + i, length - i, &code_point);
+        if (n == 0 || utf8_is_control(code_point)) {
+            return i;
+        }
+        i += n;
+    }
+}
@@ -0,0 +1,291 @@
+#include "../include/word_set.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Bloom filter geometry: 512-bit blocks (one cache line) probed six times
+ */
+#define WORD_SET_BLOOM_BLOCK_WORDS 8
+#define WORD_SET_BLOOM_BLOCK_BITS 512
+#define WORD_SET_BLOOM_PROBES 6
+
+/**
+ * Largest supported capacity, so table indices and pool offsets fit in 32 bits
+ */
+#define WORD_SET_MAX_CAPACITY ((size_t)1 << 30)
+
+/**
+ * Lowercase an ASCII letter, leaving every other byte unchanged
+ * @param c Byte to fold
+ * @return Folded byte
+ */
+static inline unsigned char fold_byte(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c | 0x20) : c;
+}
+
+/**
+ * Finish an FNV-1a hash with the MurmurHash3 finalizer, so that both the
+ * low bits (table index) and the high bits (tag, Bloom block) are well mixed
+ * @param hash Raw FNV-1a state
+ * @return Mixed 64-bit hash
+ */
+static inline uint64_t finish_hash(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Round up to a power of two
+ * @param value Value to round (>= 1)
+ * @return Smallest power of two >= value
+ */
+static size_t round_up_power_of_two(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+/**
+ * Locate the Bloom block of a hash
+ * @param set Word set
+ * @param hash Mixed hash of the word
+ * @return First word of the block
+ */
+static inline uint64_t* bloom_block(const WordSet* set, uint64_t hash) {
+    return set->bloom + (size_t)((uint32_t)(hash >> 32) & set->bloom_mask) * WORD_SET_BLOOM_BLOCK_WORDS;
+}
+
+/**
+ * Derive the bit positions probed within a block from a second hash;
+ * multiplying by an odd constant keeps them independent of the block index
+ * @param hash Mixed hash of the word
+ * @return Six 9-bit bit positions packed into the low 54 bits
+ */
+static inline uint64_t bloom_bits(uint64_t hash) {
+    return hash * 0x9e3779b97f4a7c15ULL;
+}
+
+/**
+ * Set the Bloom bits of a word
+ * @param set Word set
+ * @param hash Mixed hash of the word
+ */
+static void bloom_add(WordSet* set, uint64_t hash) {
+    uint64_t* block = bloom_block(set, hash);
+    uint64_t bits = bloom_bits(hash);
+    
+    for (int i = 0; i < WORD_SET_BLOOM_PROBES; i++) {
+        unsigned bit = (unsigned)(bits & (WORD_SET_BLOOM_BLOCK_BITS - 1));
+        block[bit >> 6] |= 1ULL << (bit & 63);
+        bits >>= 9;
+    }
+}
+
+/**
+ * Test the Bloom bits of a word
+ * @param set Word set
+ * @param hash Mixed hash of the word
+ * @return false if the word is certainly absent, true if it may be present
+ */
+static inline bool bloom_may_contain(const WordSet* set, uint64_t hash) {
+    const uint64_t* block = bloom_block(set, hash);
+    uint64_t bits = bloom_bits(hash);
+    
+    for (int i = 0; i < WORD_SET_BLOOM_PROBES; i++) {
+        unsigned bit = (unsigned)(bits & (WORD_SET_BLOOM_BLOCK_BITS - 1));
+        if ((block[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            return false;
+        }
+        bits >>= 9;
+    }
+    return true;
+}
+
+/**
+ * Find the slot holding a word, or the empty slot ending its probe chain
+ * @param set Word set
+ * @param folded Lowercased word
+ * @param length Length of the word
+ * @param hash Mixed hash of the word
+ * @return Matching slot, or the first empty slot of the chain
+ */
+static WordSetSlot* find_slot(const WordSet* set, const char* folded, size_t length, uint64_t hash) {
+    uint32_t tag = (uint32_t)(hash >> 32);
+    uint32_t index = (uint32_t)hash & set->slot_mask;
+    
+    // The table is at most half full, so every chain ends at an empty slot
+    for (;;) {
+        WordSetSlot* slot = &set->slots[index];
+        if (slot->length == 0) {
+            return slot;
+        }
+        if (slot->tag == tag && slot->length == length &&
+            memcmp(set->pool + slot->offset, folded, length) == 0) {
+            return slot;
+        }
+        index = (index + 1) & set->slot_mask;
+    }
+}
+
+/**
+ * Make room for more bytes in the string pool
+ * @param set Word set
+ * @param needed Bytes that must fit after the current end
+ * @return true on success, false on memory allocation failure or pool overflow
+ */
+static bool pool_reserve(WordSet* set, size_t needed) {
+    if (set->pool_size + needed <= set->pool_capacity) {
+        return true;
+    }
+    
+    size_t capacity = set->pool_capacity * 2;
+    while (capacity < set->pool_size + needed) {
+        capacity *= 2;
+    }
+    if (capacity > UINT32_MAX) {
+        return false;
+    }
+    
+    char* pool = (char*)realloc(set->pool, capacity);
+    if (pool == NULL) {
+        return false;
+    }
+    set->pool = pool;
+    set->pool_capacity = capacity;
+    return true;
+}
+
+WordSet* word_set_create(size_t capacity) {
+    if (capacity > WORD_SET_MAX_CAPACITY) {
+        return NULL;
+    }
+    
+    WordSet* set = (WordSet*)calloc(1, sizeof(WordSet));
+    if (set == NULL) {
+        return NULL;
+    }
+    
+    size_t slot_count = round_up_power_of_two(capacity * 2 < 16 ? 16 : capacity * 2);
+    size_t bloom_bits_needed = (capacity < 1 ? 1 : capacity) * WORD_SET_BLOOM_BITS_PER_WORD;
+    size_t block_count = round_up_power_of_two((bloom_bits_needed + WORD_SET_BLOOM_BLOCK_BITS - 1) /
+                                               WORD_SET_BLOOM_BLOCK_BITS);
+    
+    set->slots = (WordSetSlot*)calloc(slot_count, sizeof(WordSetSlot));
+    set->bloom = (uint64_t*)calloc(block_count * WORD_SET_BLOOM_BLOCK_WORDS, sizeof(uint64_t));
+    set->pool_capacity = 64 + capacity * 10; // Room for the average dictionary word plus its NUL
+    set->pool = (char*)malloc(set->pool_capacity);
+    if (set->slots == NULL || set->bloom == NULL || set->pool == NULL) {
+        word_set_destroy(set);
+        return NULL;
+    }
+    
+    set->slot_mask = (uint32_t)(slot_count - 1);
+    set->bloom_mask = (uint32_t)(block_count - 1);
+    set->capacity = capacity;
+    
+    return set;
+}
+
+bool word_set_add(WordSet* set, const char* word, size_t length, int frequency) {
+    if (set == NULL || word == NULL || length == 0 || length > WORD_SET_MAX_WORD_LENGTH) {
+        return false;
+    }
+    
+    char folded[WORD_SET_MAX_WORD_LENGTH];
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        folded[i] = (char)fold_byte((unsigned char)word[i]);
+        hash ^= (unsigned char)folded[i];
+        hash *= 1099511628211ULL;
+    }
+    hash = finish_hash(hash);
+    
+    WordSetSlot* slot = find_slot(set, folded, length, hash);
+    if (slot->length != 0) {
+        slot->frequency = frequency;
+        return true;
+    }
+    
+    if (set->count >= set->capacity || !pool_reserve(set, length + 1)) {
+        return false;
+    }
+    
+    memcpy(set->pool + set->pool_size, folded, length);
+    set->pool[set->pool_size + length] = '\0';
+    
+    slot->tag = (uint32_t)(hash >> 32);
+    slot->offset = (uint32_t)set->pool_size;
+    slot->frequency = frequency;
+    slot->length = (uint16_t)length;
+    
+    set->pool_size += length + 1;
+    set->count++;
+    bloom_add(set, hash);
+    
+    return true;
+}
+
+bool word_set_find(const WordSet* set, const char* word, int* frequency) {
+    if (set == NULL || word == NULL) {
+        return false;
+    }
+    
+    // Fold, measure and hash the query in a single pass
+    char folded[WORD_SET_MAX_WORD_LENGTH];
+    uint64_t hash = 14695981039346656037ULL;
+    size_t length = 0;
+    for (; word[length] != '\0'; length++) {
+        if (length == WORD_SET_MAX_WORD_LENGTH) {
+            return false;
+        }
+        folded[length] = (char)fold_byte((unsigned char)word[length]);
+        hash ^= (unsigned char)folded[length];
+        hash *= 1099511628211ULL;
+    }
+    if (length == 0) {
+        return false;
+    }
+    hash = finish_hash(hash);
+    
+    if (!bloom_may_contain(set, hash)) {
+        return false;
+    }
+    
+    const WordSetSlot* slot = find_slot(set, folded, length, hash);
+    if (slot->length == 0) {
+        return false;
+    }
+    
+    if (frequency != NULL) {
+        *frequency = slot->frequency;
+    }
+    return true;
+}
+
+size_t word_set_get_memory_usage(const WordSet* set) {
+    if (set == NULL) {
+        return 0;
+    }
+    
+    return sizeof(WordSet) +
+           ((size_t)set->slot_mask + 1) * sizeof(WordSetSlot) +
+           ((size_t)set->bloom_mask + 1) * WORD_SET_BLOOM_BLOCK_WORDS * sizeof(uint64_t) +
+           set->pool_capacity;
+}
+
+void word_set_destroy(WordSet* set) {
+    if (set == NULL) {
+        return;
+    }
+    
+    free(set->slots);
+    free(set->bloom);
+    free(set->pool);
+    free(set);
+}